@@ -9,7 +9,7 @@
 // Update:
 //  1. Write constructor that takes an xml element
 //  2. EntityDef header and constructor (EntityDef::EntityDef)
-//	3. SEntityFactory::CreateEntityFromDef
+//	3. EntityDef::CompilePrefab
 //  4. Register component in Game.cpp
 
 
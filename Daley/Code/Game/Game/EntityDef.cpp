@@ -33,6 +33,7 @@ void EntityDef::LoadFromXML()
 
         // Emplace new definition using the constructor that takes an Xml Element
         s_entityDefs.emplace_back(entityDefElem);
+        s_entityDefs.back().CompilePrefab(*g_ecs);
 
         entityDefElem = entityDefElem->NextSiblingElement("EntityDef");
     }
@@ -48,6 +49,37 @@ void EntityDef::Shutdown()
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Components must be registered before this, which they are by the time SEntityFactory::Startup loads the defs
+//
+void EntityDef::CompilePrefab(AdminSystem const& admin)
+{
+    m_prefab.Clear();
+
+    if (m_ability.has_value())              m_prefab.AddComponent<CAbility>(admin, *m_ability);
+    if (m_ai.has_value())                   m_prefab.AddComponent<CAIController>(admin, *m_ai);
+    if (m_animation.has_value())            m_prefab.AddComponent<CAnimation>(admin, *m_animation);
+    if (m_attachment.has_value())           m_prefab.AddComponent<CAttachment>(admin, *m_attachment);
+    if (m_collision.has_value())            m_prefab.AddComponent<CCollision>(admin, *m_collision);
+    if (m_collisionEffect.has_value())      m_prefab.AddComponent<CCollisionEffect>(admin, *m_collisionEffect);
+    if (m_death.has_value())                m_prefab.AddComponent<CDeath>(admin, *m_death);
+    if (m_health.has_value())               m_prefab.AddComponent<CHealth>(admin, *m_health);
+    if (m_lifetime.has_value())             m_prefab.AddComponent<CLifetime>(admin, *m_lifetime);
+    if (m_movement.has_value())             m_prefab.AddComponent<CMovement>(admin, *m_movement);
+    if (m_placeable.has_value())            m_prefab.AddComponent<CPlaceable>(admin, *m_placeable);
+    if (m_proj.has_value())                 m_prefab.AddComponent<CProjectile>(admin, *m_proj);
+    if (m_render.has_value())               m_prefab.AddComponent<CRender>(admin, *m_render);
+    if (m_tags.has_value())                 m_prefab.AddComponent<CTags>(admin, *m_tags);
+    if (m_time.has_value())                 m_prefab.AddComponent<CTime>(admin, *m_time);
+    if (m_transform.has_value())            m_prefab.AddComponent<CTransform>(admin, *m_transform);
+
+    CEntityName entityName;
+    entityName.m_defName = m_name;
+    m_prefab.AddComponent<CEntityName>(admin, entityName);
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 EntityDef const* EntityDef::GetEntityDef(uint8_t id)
 {
@@ -3,6 +3,7 @@
 #include "AllComponents.h"
 #include "Engine/Core/XmlUtils.h"
 #include "Engine/Core/Name.h"
+#include "Engine/ECS/EntityPrefab.h"
 #include <vector>
 #include <optional>
 
@@ -24,6 +25,8 @@ public:
 
 private:
 
+    void CompilePrefab(AdminSystem const& admin);
+
     static std::vector<EntityDef> s_entityDefs;
 
 public:
@@ -47,5 +50,8 @@ public:
     std::optional<CTime>                m_time;
     std::optional<CTransform>           m_transform;
     std::optional<CTags>                m_tags;
+
+    // Every component above plus CEntityName, compiled once on load so spawning skips the per component RTTI lookups
+    EntityPrefab                        m_prefab;
 };
     
\ No newline at end of file
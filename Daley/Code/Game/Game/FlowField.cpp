@@ -10,7 +10,8 @@ FlowField::FlowField(TagQuery tileTagQuery) :
 	m_costField(0),
 	m_distanceField(StaticWorldSettings::s_maximumFlowDistance),
 	m_gradient(Vec2::ZeroVector),
-	m_consideredCells(false)
+	m_consideredCells(false),
+	m_queuedBuckets(BucketQueue<FlowGenerationCoords>::s_notQueued)
 {
 }
 
@@ -45,18 +46,51 @@ void FlowField::AddSeedsToOpenList()
 	// Only iterate over the playable world. Any flow outside of that is irrelevant since entities cannot go there.
 	for (IntVec2 const& seed : m_seeds)
 	{
-		m_openList.push(FlowGenerationCoords(seed, 0.f));
+		PushOpenList(seed, 0.f);
 	}
 }
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+void FlowField::PushOpenList(IntVec2 const& tileCoords, float distance)
+{
+	m_openList.PushOrUpdate(FlowGenerationCoords(tileCoords, distance), distance, m_queuedBuckets.GetRef(tileCoords));
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool FlowField::PopOpenList(FlowGenerationCoords& out_coords)
+{
+	while (!m_openList.IsEmpty())
+	{
+		int bucket = 0;
+		FlowGenerationCoords coords = m_openList.Pop(&bucket);
+
+		// Entries left behind in a higher bucket when the tile's distance went down are stale
+		int& queuedBucket = m_queuedBuckets.GetRef(coords.m_tileCoords);
+		if (queuedBucket != bucket)
+		{
+			continue;
+		}
+		queuedBucket = BucketQueue<FlowGenerationCoords>::s_notQueued;
+		out_coords = coords;
+		return true;
+	}
+	return false;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void FlowField::Reset()
 {
 	m_hasGeneratedFlow = false;
 	m_seeds.clear();
 	m_consideredCells.SetAll(false);
+	m_openList.Clear();
+	m_queuedBuckets.SetAll(BucketQueue<FlowGenerationCoords>::s_notQueued);
 	m_costField.SetAll(0);
 	m_distanceField.SetAll(StaticWorldSettings::s_maximumFlowDistance);
 	m_gradient.SetAll(Vec2::ZeroVector);
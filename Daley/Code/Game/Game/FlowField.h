@@ -2,12 +2,12 @@
 #pragma once
 #include "Engine/Core/TagQuery.h"
 #include "Engine/DataStructures/BitArray.h"
+#include "Engine/DataStructures/BucketQueue.h"
 #include "Engine/Math/FastGrid.h"
 #include "Engine/Math/IntVec2.h"
 #include "Engine/Math/Vec2.h"
 #include "FlowGenerationCoords.h"
 #include "WorldSettings.h"
-#include <queue>
 
 
 
@@ -21,6 +21,8 @@ public:
 	bool Seed(IntVec2 const& tileCoords);
 	bool SeedUnsafe(IntVec2 const& tileCoords); // Call if you've already validated the tile coords
 	void AddSeedsToOpenList();
+	void PushOpenList(IntVec2 const& tileCoords, float distance);	// Decrease-key if the tile is already queued
+	bool PopOpenList(FlowGenerationCoords& out_coords);			// Skips stale entries, false once the open list is empty
 
 	void Reset();
 	void ResetConsideredCells();
@@ -31,7 +33,7 @@ public:
 
 public:
 
-	std::priority_queue<FlowGenerationCoords> m_openList;
+	BucketQueue<FlowGenerationCoords> m_openList;
 
 	TagQuery m_tileTagQuery; // Tiles that match this query will be considered for flow generation
 	bool m_hasGeneratedFlow = false;
@@ -40,5 +42,6 @@ public:
 	FastGrid<float, StaticWorldSettings::s_worldSizePowerOfTwo> m_distanceField;
 	FastGrid<Vec2, StaticWorldSettings::s_worldSizePowerOfTwo> m_gradient;
 	BitArray<StaticWorldSettings::s_numTilesInWorld> m_consideredCells;
+	FastGrid<int, StaticWorldSettings::s_worldSizePowerOfTwo> m_queuedBuckets; // Open list bucket each tile is queued in
 };
 
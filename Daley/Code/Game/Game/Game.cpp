@@ -112,6 +112,7 @@ void Game::ConfigureEngine(Engine* engine)
     engine->RegisterSubsystem(g_audioSystem);
 
     RendererConfig rendererConfig;
+    rendererConfig.m_headless = g_app->HasCommandLineArg("-headless"); // No GPU, draws and state changes are only counted
 	rendererConfig.m_startupUserSettings.m_vsyncEnabled = false;
 	rendererConfig.m_startupUserSettings.m_msaaEnabled = true;
     g_renderer = RendererUtils::MakeRenderer(rendererConfig);
@@ -24,6 +24,7 @@ void SAIController::Startup()
     if (numThreads > 1)
     {
         m_systemSplittingNumJobs = numThreads - 1; // Leave one thread for the main thread to run other systems on
+        SetSystemSplittingGroup<CTransform, CMovement, CAIController>();
     }
 }
 
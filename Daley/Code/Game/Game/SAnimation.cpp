@@ -21,6 +21,7 @@ void SAnimation::Startup()
     if (numThreads > 1)
     {
 		SetSystemSplittingNumJobs(numThreads - 1);
+		SetSystemSplittingGroup<CRender, CAnimation>();
     }
 }
 
@@ -30,6 +30,7 @@ public:
 
 	int m_towerPlacementIndex = -1;	// Index into SCEntityFactory::m_towerPlacements
 	TowerPlacementRequest m_towerPlacementRequest;
+	TowerPlacementResult m_towerPlacementResult = TowerPlacementResult::Success; // What placing the request would do right now
 
 private:
 
@@ -19,6 +19,7 @@ void SDeath::Startup()
 	if (numThreads > 1)
 	{
 		m_systemSplittingNumJobs = numThreads - 1; // Leave one thread for the main thread to run other systems on
+		SetSystemSplittingGroup<CHealth, CDeath, CLifetime>();
 	}
 }
 
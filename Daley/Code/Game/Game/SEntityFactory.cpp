@@ -40,14 +40,7 @@ void SEntityFactory::Run(SystemContext const& context) const
     factory.m_entitiesToDestroy.clear();
 
     // Spawn second
-    for (SpawnInfo& spawnInfo : factory.m_entitiesToSpawn)
-    {
-        EntityID id = SpawnEntity(context, spawnInfo);
-        if (id == EntityID::Invalid)
-        {
-            continue;
-		}
-    }
+    SpawnEntities(context, factory.m_entitiesToSpawn);
     factory.m_entitiesToSpawn.clear();
 }
 
@@ -63,39 +56,40 @@ EntityID SEntityFactory::CreateEntityFromDef(SystemContext const& context, Entit
 
 	ASSERT_OR_DIE(def != nullptr, "Null entity definition passed to SEntityFactory::CreateEntityFromDef");
 
-    EntityID id = context.CreateEntity();
+    EntityID id = context.Instantiate(def->m_prefab);
     if (id == EntityID::Invalid)
     {
         DevConsoleUtils::LogError("Max entities (%i) reached, cannot spawn entity from definition: %s", MAX_ENTITIES, def->m_name.ToCStr());
         return EntityID::Invalid;
     }
 
-    // Add components that exist in the def
-    if (def->m_ability.has_value())             context.AddComponent<CAbility>(id, *def->m_ability);
-    if (def->m_ai.has_value())                  context.AddComponent<CAIController>(id, *def->m_ai);
-    if (def->m_animation.has_value())           context.AddComponent<CAnimation>(id, *def->m_animation);
-    if (def->m_attachment.has_value())          context.AddComponent<CAttachment>(id, *def->m_attachment);
-    if (def->m_collision.has_value())           context.AddComponent<CCollision>(id, *def->m_collision);
-    if (def->m_collisionEffect.has_value())     context.AddComponent<CCollisionEffect>(id, *def->m_collisionEffect);
-    if (def->m_death.has_value())               context.AddComponent<CDeath>(id, *def->m_death);
-    if (def->m_health.has_value())              context.AddComponent<CHealth>(id, *def->m_health);
-    if (def->m_lifetime.has_value())            context.AddComponent<CLifetime>(id, *def->m_lifetime);
-    if (def->m_movement.has_value())            context.AddComponent<CMovement>(id, *def->m_movement);
-    if (def->m_placeable.has_value())           context.AddComponent<CPlaceable>(id, *def->m_placeable);
-    if (def->m_proj.has_value())                context.AddComponent<CProjectile>(id, *def->m_proj);
-    if (def->m_render.has_value())              context.AddComponent<CRender>(id, *def->m_render);
-    if (def->m_tags.has_value())                context.AddComponent<CTags>(id, *def->m_tags);
-    if (def->m_time.has_value())                context.AddComponent<CTime>(id, *def->m_time);
-    if (def->m_transform.has_value())           context.AddComponent<CTransform>(id, *def->m_transform);
-
-    CEntityName* nameComponent = context.AddComponent<CEntityName>(id);
-    nameComponent->m_defName = def->m_name;
-
     return id;
 }
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Appends the new entities to out_ids, returns how many were created
+//
+int SEntityFactory::CreateEntitiesFromDef(SystemContext const& context, EntityDef const* def, int count, std::vector<EntityID>& out_ids)
+{
+    if (!context.HasFullECSAccess())
+    {
+        ERROR_AND_DIE("SEntityFactory::CreateEntitiesFromDef - SystemContext does not have full ECS access, cannot spawn entities.");
+    }
+
+    ASSERT_OR_DIE(def != nullptr, "Null entity definition passed to SEntityFactory::CreateEntitiesFromDef");
+
+    int numCreated = context.Instantiate(def->m_prefab, count, out_ids);
+    if (numCreated < count)
+    {
+        DevConsoleUtils::LogError("Max entities (%i) reached, cannot spawn %i entities from definition: %s", MAX_ENTITIES, count - numCreated, def->m_name.ToCStr());
+    }
+    return numCreated;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 EntityID SEntityFactory::SpawnEntity(SystemContext const& context, SpawnInfo const& spawnInfo)
 {
@@ -110,6 +104,44 @@ EntityID SEntityFactory::SpawnEntity(SystemContext const& context, SpawnInfo con
         return EntityID::Invalid;
     }
 
+    ApplySpawnInfo(context, id, spawnInfo);
+    return id;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Wave spawns queue up long runs of the same def, so each run is instantiated as one batch before the per spawn changes
+//
+void SEntityFactory::SpawnEntities(SystemContext const& context, std::vector<SpawnInfo> const& spawnInfos)
+{
+    std::vector<EntityID> ids;
+    int runBegin = 0;
+    while (runBegin < (int) spawnInfos.size())
+    {
+        EntityDef const* def = spawnInfos[runBegin].m_def;
+        int runEnd = runBegin + 1;
+        while (runEnd < (int) spawnInfos.size() && spawnInfos[runEnd].m_def == def)
+        {
+            ++runEnd;
+        }
+
+        ids.clear();
+        int numCreated = CreateEntitiesFromDef(context, def, runEnd - runBegin, ids);
+        for (int i = 0; i < numCreated; ++i)
+        {
+            ApplySpawnInfo(context, ids[i], spawnInfos[runBegin + i]);
+        }
+
+        runBegin = runEnd;
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void SEntityFactory::ApplySpawnInfo(SystemContext const& context, EntityID id, SpawnInfo const& spawnInfo)
+{
     if (CTransform* transform = context.GetComponent<CTransform>(id))
     {
         transform->m_pos = spawnInfo.m_spawnPos;
@@ -174,6 +206,4 @@ EntityID SEntityFactory::SpawnEntity(SystemContext const& context, SpawnInfo con
             tags->AddTag(spawnInfo.m_spawnTags[i]);
         }
 	}
-
-    return id;
 }
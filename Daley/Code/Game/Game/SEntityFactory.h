@@ -2,6 +2,7 @@
 #pragma once
 #include "Engine/ECS/EntityID.h"
 #include "Engine/ECS/System.h"
+#include <vector>
 
 
 
@@ -22,5 +23,11 @@ public:
     void Run(SystemContext const& context) const override;
 
     static EntityID CreateEntityFromDef(SystemContext const& context, EntityDef const* def);
+    static int CreateEntitiesFromDef(SystemContext const& context, EntityDef const* def, int count, std::vector<EntityID>& out_ids);
 	static EntityID SpawnEntity(SystemContext const& context, SpawnInfo const& spawnInfo); // Usage requires write all dependencies
+    static void SpawnEntities(SystemContext const& context, std::vector<SpawnInfo> const& spawnInfos); // Usage requires write all dependencies
+
+private:
+
+    static void ApplySpawnInfo(SystemContext const& context, EntityID id, SpawnInfo const& spawnInfo);
 };
@@ -20,6 +20,7 @@ void SEntityTime::Startup()
 	if (numThreads > 1)
 	{
 		SetSystemSplittingNumJobs(numThreads - 1);
+		SetSystemSplittingGroup<CTime>();
 	}
 }
 
@@ -7,7 +7,7 @@
 #include "Engine/ECS/SystemContext.h"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Performance/ScopedTimer.h"
-#include <queue>
+#include <cfloat>
 
 
 
@@ -176,22 +176,24 @@ float CalculateDistance_FMM(IntVec2 const& tileCoords, FlowField& flowField, SCW
     }
 
     // Delta = 2 * neighborCost - (dx-dy)^2;
-    // if Delta >= 0
+    // if Delta >= 0 and the solution is upwind of both neighbors
     //     D(j) = (dx + dy + sqrt(Delta)) / 2;
     // else
     //     D(j) = min(dx + W(j), dy + W(j));
     // end
 
+    // Without the upwind check a tile could solve lower than the neighbor it was solved from, which breaks the open
+    // list's buckets (tiles in the same bucket pop in no particular order)
     float delta = 2 * cost - MathUtils::PowF(dx - dy, 2);
 
-    float result;
+    float result = MathUtils::Min(dx + cost, dy + cost);
     if (delta >= 0)
     {
-        result = (dx + dy + MathUtils::SqrtF(delta)) / 2.f;
-    }
-    else
-    {
-        result = MathUtils::Min(dx + cost, dy + cost);
+        float twoSidedResult = (dx + dy + MathUtils::SqrtF(delta)) / 2.f;
+        if (twoSidedResult >= MathUtils::Max(dx, dy))
+        {
+            result = twoSidedResult;
+        }
     }
 
     return result;
@@ -206,11 +208,9 @@ void SFlowField::GenerateDistanceField(FlowField& flowField, SCWorld const& worl
 
     flowField.AddSeedsToOpenList();
 
-    while (!flowField.m_openList.empty())
+    FlowGenerationCoords flowGenCoords(IntVec2::ZeroVector, 0.f);
+    while (flowField.PopOpenList(flowGenCoords))
     {
-        FlowGenerationCoords flowGenCoords = flowField.m_openList.top();
-        flowField.m_openList.pop();
-
         IntVec2 const& currentTileCoords = flowGenCoords.m_tileCoords;
 
         int currentIndex = flowField.m_distanceField.GetIndexForCoords(currentTileCoords);
@@ -255,7 +255,7 @@ void SFlowField::GenerateDistanceField(FlowField& flowField, SCWorld const& worl
             if (calculatedNeighborDistance < flowField.m_distanceField.Get(neighborTileCoords))
             {
                 flowField.m_distanceField.Set(neighborTileCoords, calculatedNeighborDistance);
-                flowField.m_openList.emplace(neighborTileCoords, calculatedNeighborDistance);
+                flowField.PushOpenList(neighborTileCoords, calculatedNeighborDistance);
             }
         }
     }
@@ -272,11 +272,9 @@ void SFlowField::GenerateGradient(FlowField& flowField, SCWorld const& world)
 
     flowField.AddSeedsToOpenList();
 
-    while (!flowField.m_openList.empty())
+    FlowGenerationCoords flowGenCoords(IntVec2::ZeroVector, 0.f);
+    while (flowField.PopOpenList(flowGenCoords))
     {
-        FlowGenerationCoords flowGenCoords = flowField.m_openList.top();
-        flowField.m_openList.pop();
-
         IntVec2 const& currentTileCoords = flowGenCoords.m_tileCoords;
         int currentTileIndex = flowField.m_gradient.GetIndexForCoords(flowGenCoords.m_tileCoords);
 
@@ -325,25 +323,25 @@ void SFlowField::GenerateGradient(FlowField& flowField, SCWorld const& world)
         int northIndex = flowField.m_gradient.GetIndexForCoords(northTile);
         if (isNorthValid && !flowField.m_consideredCells.Get(northIndex))
         {
-            flowField.m_openList.push({ northTile, northDistance });
+            flowField.PushOpenList(northTile, northDistance);
         }
 
 		int southIndex = flowField.m_gradient.GetIndexForCoords(southTile);
         if (isSouthValid && !flowField.m_consideredCells.Get(southIndex))
         {
-            flowField.m_openList.push({ southTile, southDistance });
+            flowField.PushOpenList(southTile, southDistance);
 		}
 
 		int eastIndex = flowField.m_gradient.GetIndexForCoords(eastTile);
         if (isEastValid && !flowField.m_consideredCells.Get(eastIndex))
         {
-            flowField.m_openList.push({ eastTile, eastDistance });
+            flowField.PushOpenList(eastTile, eastDistance);
         }
 
 		int westIndex = flowField.m_gradient.GetIndexForCoords(westTile);
         if (isWestValid && !flowField.m_consideredCells.Get(westIndex))
         {
-            flowField.m_openList.push({ westTile, westDistance });
+            flowField.PushOpenList(westTile, westDistance);
 		}
     }
 }
@@ -7,12 +7,14 @@
 #include "SCEntityFactory.h"
 #include "SCEventSystem.h"
 #include "SCFloatingText.h"
+#include "SCFlowField.h"
 #include "SCGameState.h"
 #include "SCInputSystem.h"
 #include "SCRunData.h"
 #include "SCWaves.h"
 #include "SCWindow.h"
 #include "SCWorld.h"
+#include "STowerSpawner.h"
 #include "WorldSettings.h"
 #include "Engine/Core/NamedProperties.h"
 #include "Engine/ECS/SystemContext.h"
@@ -39,6 +41,7 @@ void SInput::Run(SystemContext const& context) const
 	SCWindow const& scWindow = context.GetSingletonConst<SCWindow>();
 	SCWorld const& world = context.GetSingletonConst<SCWorld>();
 	SCWaves const& waves = context.GetSingletonConst<SCWaves>();
+	SCFlowField const& scFlowField = context.GetSingletonConst<SCFlowField>();
 	auto& placeableStorage = context.GetMapStorageConst<CPlaceable>();
 	auto& transformStorage = context.GetArrayStorageConst<CTransform>();
 
@@ -112,10 +115,12 @@ void SInput::Run(SystemContext const& context) const
 		PlaceableTower const& placeableTower = runData.m_placeableTowers[scInput.m_towerPlacementIndex];
 		bool canAfford = SInput::CanAffordTower(placeableTower, runData);
 		scInput.m_towerPlacementRequest = SInput::MakeTowerPlacementRequest(placeableTower.m_towerName, scInput.m_mouseWorldLocation, world, false, placeableTower.m_cost, canAfford);
+		scInput.m_towerPlacementResult = STowerSpawner::CanPlaceTower(scInput.m_towerPlacementRequest, world, scFlowField.m_toGoalFlowField);
 	}
 	else
 	{
 		scInput.m_towerPlacementRequest = TowerPlacementRequest();
+		scInput.m_towerPlacementResult = TowerPlacementResult::Success;
 	}
 
 	if (scInput.m_towerPlacementIndex != -1)
@@ -18,6 +18,7 @@ void SMovementAnimation::Startup()
     if (numThreads > 1)
     {
         m_systemSplittingNumJobs = numThreads - 1; // Leave one thread for the main thread to run other systems on
+        SetSystemSplittingGroup<CMovement, CAnimation, CRender>();
     }
 }
 
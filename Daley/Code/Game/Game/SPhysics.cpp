@@ -21,6 +21,7 @@ void SPhysics::Startup()
     if (numThreads > 1)
     {
         m_systemSplittingNumJobs = numThreads - 1; // Leave one thread for the main thread to run other systems on
+        SetSystemSplittingGroup<CMovement, CTransform>();
     }
 }
 
@@ -70,7 +70,7 @@ void SRenderUI::Run(SystemContext const& context) const
 
 		scWorld.ForEachPlayableTileInRegion(placementInfo.m_botLeftTileCoords, placementInfo.m_topRightTileCoords, [&](IntVec2 const& tileCoords)
 		{
-			bool isTileValid = scWorld.DoesTileMatchTagQuery(tileCoords, placeable.m_tileTagQuery);
+			bool isTileValid = scInput.m_towerPlacementResult != TowerPlacementResult::BlocksPath && scWorld.DoesTileMatchTagQuery(tileCoords, placeable.m_tileTagQuery);
 			Rgba8 tileTint = isTileValid ? Rgba8(0, 255, 0, 127) : Rgba8(255, 0, 0, 127);
 			tileTint = placementInfo.m_canAfford ? tileTint : Rgba8(255, 255, 0, 127); // Orange if can't afford
 			VertexUtils::AddVertsForAABB2(untexturedVerts, scWorld.GetTileBounds(tileCoords), tileTint);
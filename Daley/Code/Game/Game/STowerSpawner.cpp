@@ -4,13 +4,24 @@
 #include "EntityDef.h"
 #include "SCEntityFactory.h"
 #include "SCFloatingText.h"
+#include "SCFlowField.h"
 #include "SCRunData.h"
 #include "SCWorld.h"
 #include "SEntityFactory.h"
-#include "SFlowField.h"
 #include "WorldSettings.h"
 #include "Engine/Core/StringUtils.h"
 #include "Engine/ECS/SystemContext.h"
+#include <queue>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Same 4 neighbors the flow field generates through
+static IntVec2 const s_flowNeighborOffsets[4] = { IntVec2(1,  0),
+                                                  IntVec2(-1,  0),
+                                                  IntVec2(0,  1),
+                                                  IntVec2(0, -1) };
 
 
 
@@ -36,6 +47,7 @@ void STowerSpawner::Run(SystemContext const& context) const
 	auto const& placeableStorage = context.GetMapStorageConst<CPlaceable>();
 	auto const& transformStorage = context.GetArrayStorageConst<CTransform>();
 	auto const& nameStorage = context.GetArrayStorageConst<CEntityName>();
+	SCFlowField const& scFlowField = context.GetSingletonConst<SCFlowField>();
 
 	// Write Dependencies
 	SCEntityFactory& factory = context.GetSingleton<SCEntityFactory>();
@@ -98,7 +110,7 @@ void STowerSpawner::Run(SystemContext const& context) const
 
     for (TowerPlacementRequest const& placementInfo : factory.m_towerPlacements)
     {
-        TowerPlacementResult result = CanPlaceTower(placementInfo, world);
+        TowerPlacementResult result = CanPlaceTower(placementInfo, world, scFlowField.m_toGoalFlowField);
         if (result == TowerPlacementResult::Success)
         {
             PlaceTowerInWorld(placementInfo, world);
@@ -144,86 +156,26 @@ void STowerSpawner::Run(SystemContext const& context) const
 
 
 //----------------------------------------------------------------------------------------------------------------------
-TowerPlacementResult STowerSpawner::CanPlaceTower(TowerPlacementRequest const& info, SCWorld const& world) const
+// Doesn't modify the world, so it's cheap enough to run on the placement preview every frame
+//
+TowerPlacementResult STowerSpawner::CanPlaceTower(TowerPlacementRequest const& info, SCWorld const& world, FlowField const& toGoalFlowField)
 {
 	if (info.m_canAfford == false)
 	{
 		return TowerPlacementResult::CannotAfford;
 	}
 
-    SCWorld copy;
-	copy.m_cachedSpawnLocations = world.m_cachedSpawnLocations;
-	copy.m_tiles = world.m_tiles;
-    if (!info.m_isGenerated)
-    {
-        copy.m_numEnemiesInTile = world.m_numEnemiesInTile;
-    }
-
-    copy.m_solidnessOfPathTileChanged = false;
-
-    if (!PlaceTowerInWorld(info, copy))
+    if (!world.DoTilesInRegionMatchQuery(info.m_botLeftTileCoords, info.m_topRightTileCoords, info.m_tileTagQuery))
     {
         return TowerPlacementResult::Blocked;
     }
 
-    if (!copy.m_solidnessOfPathTileChanged)
+    if (!WillChangePathSolidness(info, world))
     {
         return TowerPlacementResult::Success;
     }
 
-    TagQuery tileTagQuery;
-    tileTagQuery.m_hasAnyTags |= (uint8_t) TileTag::IsPath;
-    tileTagQuery.m_hasAnyTags |= (uint8_t) TileTag::IsGoal;
-    tileTagQuery.m_doesNotHaveAnyTags |= (uint8_t) TileTag::Solid;
-
-    FlowField proxyWorldFlowField(tileTagQuery);
-
-    SFlowField::SeedFlowField(proxyWorldFlowField, world);
-    SFlowField::SetCostField(proxyWorldFlowField, copy);
-    SFlowField::GenerateDistanceField(proxyWorldFlowField, copy, true);
-    proxyWorldFlowField.m_hasGeneratedFlow = true;
-
-    bool isFlowfieldValid = true;
-    copy.ForEachCachedEdgePathTile([&](IntVec2 const& tileCoords)
-    {
-        Tile const& tile = copy.m_tiles.Get(tileCoords);
-        if (tile.IsPath())
-        {
-            float distanceOnEdgePath = proxyWorldFlowField.GetDistanceAtTileCoords(tileCoords);
-            if (distanceOnEdgePath == StaticWorldSettings::s_maximumFlowDistance)
-            {
-				// If a path edge tile is blocked, then the flowfield is invalid and the tower placement is invalid
-                isFlowfieldValid = false;
-                return false; // stop iterating
-            }
-        }
-        return true; // keep iterating
-    });
-
-	copy.ForEachPlayableTile([&](IntVec2 const& tileCoords)
-	{
-		// Check if there is an enemy in this tile, and if so, we cannot place a tower here
-		// Also, if this tower would block pathing to a tile with an enemy in it, we cannot place a tower here
-        if (!copy.IsTileOnPath(tileCoords))
-        {
-            return true;
-        }
-
-        int numEnemies = info.m_isGenerated ? 0 : copy.m_numEnemiesInTile.Get(tileCoords);
-        if (numEnemies > 0)
-        {
-		    float distanceToTileWithEnemy = proxyWorldFlowField.GetDistanceAtTileCoords(tileCoords);
-			if (distanceToTileWithEnemy == StaticWorldSettings::s_maximumFlowDistance)
-			{
-				isFlowfieldValid = false;
-				return false; // stop iterating
-			}
-        }
-
-        return true;
-	});
-
-    return isFlowfieldValid ? TowerPlacementResult::Success : TowerPlacementResult::BlocksPath;
+    return WillBlockPath(info, world, toGoalFlowField) ? TowerPlacementResult::BlocksPath : TowerPlacementResult::Success;
 }
 
 
@@ -250,7 +202,7 @@ bool STowerSpawner::PlaceTowerInWorld(TowerPlacementRequest const& placementInfo
 
 
 //----------------------------------------------------------------------------------------------------------------------
-bool STowerSpawner::WillChangePathSolidness(TowerPlacementRequest const& placementInfo, SCWorld const& world) const
+bool STowerSpawner::WillChangePathSolidness(TowerPlacementRequest const& placementInfo, SCWorld const& world)
 {
 	bool isValidPlacement = world.DoTilesInRegionMatchQuery(placementInfo.m_botLeftTileCoords, placementInfo.m_topRightTileCoords, placementInfo.m_tileTagQuery);
 	if (!isValidPlacement)
@@ -273,3 +225,201 @@ bool STowerSpawner::WillChangePathSolidness(TowerPlacementRequest const& placeme
 
     return willChangePathSolidness;
 }
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Would making the footprint solid cut a spawn edge tile, or a path tile with an enemy in it, off from the goal?
+//
+// Paths through the footprint have to enter and leave through the walkable tiles in the ring around it. If the
+// walkable ring tiles next to the footprint are all connected to each other around the ring, every path through the
+// footprint can go around it instead, which answers most placements without leaving the ring. Otherwise each separate
+// arc of the ring searches for the goal, expanding tiles nearest the goal first by the current distance field (only a
+// guide, it may be stale). An arc whose search runs out of tiles is cut off, which blocks the path if its region has
+// a spawn or an enemy in it.
+//
+bool STowerSpawner::WillBlockPath(TowerPlacementRequest const& placementInfo, SCWorld const& world, FlowField const& toGoalFlowField)
+{
+	// Same clamp as ForEachPlayableTileInRegion, tiles outside the playable world don't get a tower
+	IntVec2 footprintMins = IntVec2(MathUtils::Max(0, placementInfo.m_botLeftTileCoords.x), MathUtils::Max(0, placementInfo.m_botLeftTileCoords.y));
+	IntVec2 footprintMaxs = IntVec2(MathUtils::Min(StaticWorldSettings::s_playableWorldEndIndexX, placementInfo.m_topRightTileCoords.x), MathUtils::Min(StaticWorldSettings::s_playableWorldEndIndexY, placementInfo.m_topRightTileCoords.y));
+
+	auto isInFootprint = [&](IntVec2 const& tileCoords)
+	{
+		return tileCoords.x >= footprintMins.x && tileCoords.x <= footprintMaxs.x && tileCoords.y >= footprintMins.y && tileCoords.y <= footprintMaxs.y;
+	};
+	auto isWalkable = [&](IntVec2 const& tileCoords)
+	{
+		return world.m_tiles.IsValidCoords(tileCoords) && !isInFootprint(tileCoords) && world.DoesTileMatchTagQuery(tileCoords, toGoalFlowField.m_tileTagQuery);
+	};
+	auto hasEnemies = [&](IntVec2 const& tileCoords)
+	{
+		return !placementInfo.m_isGenerated && world.IsTileOnPath(tileCoords) && world.m_numEnemiesInTile.Get(tileCoords) > 0;
+	};
+
+	// Covering a spawn or an enemy blocks them outright
+	for (IntVec2 const& spawnCoords : world.m_cachedSpawnLocations)
+	{
+		if (isInFootprint(spawnCoords))
+		{
+			return true;
+		}
+	}
+	bool coversEnemy = false;
+	world.ForEachPlayableTileInRegion(footprintMins, footprintMaxs, [&](IntVec2 const& tileCoords)
+	{
+		coversEnemy = hasEnemies(tileCoords);
+		return !coversEnemy;
+	});
+	if (coversEnemy)
+	{
+		return true;
+	}
+
+	// Ring around the footprint in order, so consecutive tiles are neighbors. The corners never touch the footprint.
+	std::vector<IntVec2> ring;
+	ring.reserve(2 * (footprintMaxs.x - footprintMins.x + footprintMaxs.y - footprintMins.y) + 8);
+	for (int x = footprintMins.x - 1; x <= footprintMaxs.x; ++x)
+	{
+		ring.emplace_back(x, footprintMins.y - 1);
+	}
+	for (int y = footprintMins.y - 1; y <= footprintMaxs.y; ++y)
+	{
+		ring.emplace_back(footprintMaxs.x + 1, y);
+	}
+	for (int x = footprintMaxs.x + 1; x >= footprintMins.x; --x)
+	{
+		ring.emplace_back(x, footprintMaxs.y + 1);
+	}
+	for (int y = footprintMaxs.y + 1; y >= footprintMins.y; --y)
+	{
+		ring.emplace_back(footprintMins.x - 1, y);
+	}
+
+	int numRingTiles = static_cast<int>(ring.size());
+	int firstUnwalkableIndex = -1;
+	for (int i = 0; i < numRingTiles; ++i)
+	{
+		if (!isWalkable(ring[i]))
+		{
+			firstUnwalkableIndex = i;
+			break;
+		}
+	}
+	if (firstUnwalkableIndex == -1)
+	{
+		return false; // Can walk all the way around
+	}
+
+	// One tile from each arc of walkable ring tiles that touches the footprint
+	std::vector<IntVec2> arcStarts;
+	bool isInArc = false;
+	bool arcTouchesFootprint = false;
+	for (int step = 1; step <= numRingTiles; ++step)
+	{
+		IntVec2 const& tileCoords = ring[(firstUnwalkableIndex + step) % numRingTiles];
+		bool isCorner = (tileCoords.x == footprintMins.x - 1 || tileCoords.x == footprintMaxs.x + 1) && (tileCoords.y == footprintMins.y - 1 || tileCoords.y == footprintMaxs.y + 1);
+		if (isWalkable(tileCoords))
+		{
+			if (!isInArc)
+			{
+				arcStarts.push_back(tileCoords);
+				arcTouchesFootprint = false;
+			}
+			isInArc = true;
+			arcTouchesFootprint |= !isCorner;
+		}
+		else
+		{
+			if (isInArc && !arcTouchesFootprint)
+			{
+				arcStarts.pop_back();
+			}
+			isInArc = false;
+		}
+	}
+	if (arcStarts.size() <= 1)
+	{
+		return false;
+	}
+
+	BitArray<StaticWorldSettings::s_numTilesInWorld> visitedTiles(false);
+	BitArray<StaticWorldSettings::s_numTilesInWorld> connectedTiles(false);
+	std::vector<IntVec2> searchedTiles;
+	for (IntVec2 const& arcStart : arcStarts)
+	{
+		int arcStartIndex = world.m_tiles.GetIndexForCoords(arcStart);
+		if (visitedTiles.Get(arcStartIndex))
+		{
+			continue; // Same region as an earlier arc
+		}
+
+		searchedTiles.clear();
+		std::priority_queue<FlowGenerationCoords> openList;
+		openList.emplace(arcStart, toGoalFlowField.GetDistanceAtTileCoords(arcStart));
+		visitedTiles.Set(arcStartIndex);
+		searchedTiles.push_back(arcStart);
+
+		bool isConnected = false;
+		while (!openList.empty() && !isConnected)
+		{
+			IntVec2 currentCoords = openList.top().m_tileCoords;
+			openList.pop();
+			if (world.IsTileInGoal(currentCoords))
+			{
+				isConnected = true;
+				break;
+			}
+
+			for (IntVec2 const& neighborOffset : s_flowNeighborOffsets)
+			{
+				IntVec2 neighborCoords = currentCoords + neighborOffset;
+				if (!isWalkable(neighborCoords))
+				{
+					continue;
+				}
+				int neighborIndex = world.m_tiles.GetIndexForCoords(neighborCoords);
+				if (connectedTiles.Get(neighborIndex))
+				{
+					isConnected = true;
+					break;
+				}
+				if (!visitedTiles.Get(neighborIndex))
+				{
+					visitedTiles.Set(neighborIndex);
+					searchedTiles.push_back(neighborCoords);
+					openList.emplace(neighborCoords, toGoalFlowField.GetDistanceAtTileCoords(neighborCoords));
+				}
+			}
+		}
+
+		if (isConnected)
+		{
+			for (IntVec2 const& tileCoords : searchedTiles)
+			{
+				connectedTiles.Set(world.m_tiles.GetIndexForCoords(tileCoords));
+			}
+			continue;
+		}
+
+		// Searched the whole region without reaching the goal. Earlier cut off regions had no spawns, so any visited
+		// spawn that isn't connected is in this one.
+		for (IntVec2 const& spawnCoords : world.m_cachedSpawnLocations)
+		{
+			int spawnIndex = world.m_tiles.GetIndexForCoords(spawnCoords);
+			if (visitedTiles.Get(spawnIndex) && !connectedTiles.Get(spawnIndex))
+			{
+				return true;
+			}
+		}
+		for (IntVec2 const& tileCoords : searchedTiles)
+		{
+			if (hasEnemies(tileCoords))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
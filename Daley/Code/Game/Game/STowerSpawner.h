@@ -1,26 +1,16 @@
 // Bradley Christensen - 2022-2026
 #pragma once
+#include "TowerPlacementRequest.h"
 #include "Engine/ECS/System.h"
 
 
 
 struct SCEntityFactory;
-struct TowerPlacementRequest;
+class FlowField;
 class SCWorld;
 
 
 
-//----------------------------------------------------------------------------------------------------------------------
-enum class TowerPlacementResult
-{
-    Success,
-    Blocked,
-    BlocksPath,
-    CannotAfford,
-};
-
-
-
 //----------------------------------------------------------------------------------------------------------------------
 class STowerSpawner : public System
 {
@@ -31,7 +21,8 @@ public:
     void Shutdown() const override;
     void Run(SystemContext const& context) const override;
 
-    TowerPlacementResult CanPlaceTower(TowerPlacementRequest const& info, SCWorld const& world) const;
+    static TowerPlacementResult CanPlaceTower(TowerPlacementRequest const& info, SCWorld const& world, FlowField const& toGoalFlowField);
     bool PlaceTowerInWorld(TowerPlacementRequest const& placementInfo, SCWorld& world) const;
-	bool WillChangePathSolidness(TowerPlacementRequest const& placementInfo, SCWorld const& world) const;
+	static bool WillChangePathSolidness(TowerPlacementRequest const& placementInfo, SCWorld const& world);
+	static bool WillBlockPath(TowerPlacementRequest const& placementInfo, SCWorld const& world, FlowField const& toGoalFlowField);
 };
@@ -8,6 +8,17 @@
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+enum class TowerPlacementResult
+{
+    Success,
+    Blocked,
+    BlocksPath,
+    CannotAfford,
+};
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 struct TowerPlacementRequest
 {
@@ -104,3 +104,17 @@ int BinaryUtils::FirstUnsetBit(size_t mask, int firstValidIndex)
 
 	return FirstUnsetBit(maskExcludingInvalidLowerBits);
 }
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+uint64_t BinaryUtils::HashBytes(void const* bytes, size_t numBytes, uint64_t hash)
+{
+	uint8_t const* byte = static_cast<uint8_t const*>(bytes);
+	for (size_t i = 0; i < numBytes; ++i)
+	{
+		hash ^= byte[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
@@ -1,5 +1,7 @@
 // Bradley Christensen - 2022-2026
 #pragma once
+#include <cstddef>
+#include <cstdint>
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -14,4 +16,8 @@ namespace BinaryUtils
 	int FirstSetBit(size_t mask, int firstValidIndex);
 	int FirstUnsetBit(size_t mask);
 	int FirstUnsetBit(size_t mask, int firstValidIndex);
+
+	// FNV-1a, stable across builds and platforms. Pass a previous hash to continue hashing more bytes.
+	constexpr uint64_t HASH_BYTES_SEED = 14695981039346656037ull;
+	uint64_t HashBytes(void const* bytes, size_t numBytes, uint64_t hash = HASH_BYTES_SEED);
 }
\ No newline at end of file
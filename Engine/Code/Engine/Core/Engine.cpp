@@ -12,6 +12,10 @@
 #include "Engine/Time/Time.h"
 #endif
 
+#if defined(PERF_WINDOW_DISPLAY_ENGINE_SECTION)
+#include "Engine/Performance/ScopedTimer.h"
+#endif
+
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -85,7 +89,7 @@ void Engine::BeginFrame()
     #endif
 
     #if defined(PERF_WINDOW_DISPLAY_ENGINE_SECTION)
-        PerfWindowScopedTimer scopedTimer("Engine","BeginFrame");
+        PerfWindowScopedTimer scopedTimer(STATIC_NAME("Engine"), STATIC_NAME("BeginFrame"));
     #endif
 
     for (EngineSubsystem*& subsystem : m_subsystems)
@@ -109,7 +113,7 @@ void Engine::Update()
     #endif
 
     #if defined(PERF_WINDOW_DISPLAY_ENGINE_SECTION)
-        PerfWindowScopedTimer scopedTimer("Engine", "Update");
+        PerfWindowScopedTimer scopedTimer(STATIC_NAME("Engine"), STATIC_NAME("Update"));
     #endif
 
     for (EngineSubsystem*& subsystem : m_subsystems)
@@ -127,7 +131,7 @@ void Engine::Update()
 void Engine::Render() const
 {
     #if defined(PERF_WINDOW_DISPLAY_ENGINE_SECTION)
-        PerfWindowScopedTimer scopedTimer("Engine", "Render");
+        PerfWindowScopedTimer scopedTimer(STATIC_NAME("Engine"), STATIC_NAME("Render"));
     #endif
 
     for (int i = (int) m_subsystems.size() - 1; i >= 0; --i)
@@ -146,7 +150,7 @@ void Engine::Render() const
 void Engine::EndFrame()
 {
     #if defined(PERF_WINDOW_DISPLAY_ENGINE_SECTION)
-        PerfWindowScopedTimer scopedTimer("Engine", "EndFrame");
+        PerfWindowScopedTimer scopedTimer(STATIC_NAME("Engine"), STATIC_NAME("EndFrame"));
     #endif
 
     for (int i = (int) m_subsystems.size() - 1; i >= 0; --i)
@@ -20,40 +20,30 @@ Name::Name() : Name(s_invalidNameString)
 
 
 //----------------------------------------------------------------------------------------------------------------------
-Name::Name(std::string const& string)
+Name::Name(std::string const& string) : Name(std::string_view(string))
 {
-    ASSERT_OR_DIE(g_nameTable, "Name table does not exist yet.");
+}
 
-    #if defined(NAME_USE_DEBUG_STRING)
-        m_debugString = string;
-    #endif
 
-	// Need to lock a mutex for insertion into the name table, since this could be happening on multiple threads at once
-	// After that, the name table itself is a deque, which means that pointers to strings in the table will not be invalidated by future insertions
-    // so no mutex lock is needed for comparing names or looking up the corresponding string.
-	std::unique_lock<std::mutex> lock(g_nameTable->m_lookupTableMutex);
 
-    auto it = g_nameTable->m_lookupTable.find(string);
-    if (it == g_nameTable->m_lookupTable.end())
-    {
-        m_nameIndex = static_cast<uint32_t>(g_nameTable->m_nameTable.size());
-        g_nameTable->m_lookupTable[string] = m_nameIndex;
-        g_nameTable->m_nameTable.push_back(string);
-    }
-    else
-    {
-        m_nameIndex = static_cast<uint32_t>(it->second);
-    }
+//----------------------------------------------------------------------------------------------------------------------
+Name::Name(const char* string) : Name(std::string_view(string))
+{
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-Name::Name(const char* string) : Name(std::string(string))
+Name::Name(std::string_view string)
 {
+    ASSERT_OR_DIE(g_nameTable, "Name table does not exist yet.");
+
     #if defined(NAME_USE_DEBUG_STRING)
         m_debugString = string;
     #endif
+
+    // Lock free unless the string is new, see NameTable
+    m_nameIndex = g_nameTable->FindOrAdd(string);
 }
 
 
@@ -89,7 +79,7 @@ std::string const& Name::ToString() const
 {
     if (g_nameTable && IsValid())
     {
-        return g_nameTable->m_nameTable[m_nameIndex];
+        return g_nameTable->GetString(m_nameIndex);
     }
     return s_invalidNameString;
 }
@@ -101,7 +91,7 @@ const char* Name::ToCStr() const
 {
     if (g_nameTable && IsValid())
     {
-        return g_nameTable->m_nameTable[m_nameIndex].c_str();
+        return g_nameTable->GetString(m_nameIndex).c_str();
     }
     return s_invalidNameString.c_str();
 }
@@ -2,6 +2,7 @@
 #pragma once
 #include "Game/Framework/EngineBuildPreferences.h"
 #include <string>
+#include <string_view>
 #include <cstdint>
 
 
@@ -11,6 +12,9 @@
 //
 // Index into the name string array
 //
+// Constructing a Name is a lock free lookup in g_nameTable once the string has been added. For names built over and
+// over on hot paths, STATIC_NAME("Literal") looks the string up once and then just copies the index.
+//
 struct Name
 {
 public:
@@ -18,6 +22,7 @@ public:
 	Name();
 	Name(std::string const& string);
 	Name(const char* string);
+	Name(std::string_view string);
 	Name(Name const& other);
 
 	bool IsValid() const;
@@ -65,4 +70,12 @@ namespace std
 			return static_cast<size_t>(std::hash<uint32_t>()(name.GetNameIndex()));
 		}
 	};
-}
\ No newline at end of file
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Name that is only looked up the first time this line runs. The index is only valid for the g_nameTable it was made
+// with, so don't use this in code that runs across name tables (unit tests that make a new table per test).
+//
+#define STATIC_NAME(string) ([]() -> Name const& { static Name const s_staticName(string); return s_staticName; }())
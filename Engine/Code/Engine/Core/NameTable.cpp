@@ -1,6 +1,7 @@
 // Bradley Christensen - 2022-2026
 #include "NameTable.h"
 #include "Name.h"
+#include "Engine/Core/ErrorUtils.h"
 
 
 
@@ -11,6 +12,14 @@ NameTable* g_nameTable = nullptr;
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+NameTable::~NameTable()
+{
+	Shutdown();
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void NameTable::Startup()
 {
@@ -22,6 +31,155 @@ void NameTable::Startup()
 //----------------------------------------------------------------------------------------------------------------------
 void NameTable::Shutdown()
 {
-	m_nameTable.clear();
-	m_lookupTable.clear();
+	for (Shard& shard : m_shards)
+	{
+		shard.m_currentSlots = nullptr;
+		shard.m_allSlots.clear();
+	}
+	for (std::atomic<std::string*>& block : m_nameBlocks)
+	{
+		delete[] block.exchange(nullptr);
+	}
+	m_numNames = 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t NameTable::FindOrAdd(std::string_view string)
+{
+	uint32_t hash = static_cast<uint32_t>(StringUtils::CaseInsensitiveStringHash()(string));
+	Shard& shard = m_shards[hash & (s_numShards - 1)];
+
+	// Almost every call is for a name that already exists, which never locks
+	HashSlots const* slots = shard.m_currentSlots.load(std::memory_order_acquire);
+	if (slots)
+	{
+		uint32_t index = Find(*slots, hash, string);
+		if (index != s_notFound)
+		{
+			return index;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(shard.m_insertMutex);
+
+	// Another thread may have added it, or grown the shard, since the lookup above
+	HashSlots* currentSlots = shard.m_currentSlots.load(std::memory_order_relaxed);
+	if (currentSlots)
+	{
+		uint32_t index = Find(*currentSlots, hash, string);
+		if (index != s_notFound)
+		{
+			return index;
+		}
+	}
+
+	uint32_t index = m_numNames.fetch_add(1, std::memory_order_relaxed);
+	uint32_t blockIndex = index >> s_namesPerBlockPowerOfTwo;
+	ASSERT_OR_DIE(blockIndex < s_maxNumBlocks, "NameTable is full.");
+
+	std::string* block = m_nameBlocks[blockIndex].load(std::memory_order_acquire);
+	if (!block)
+	{
+		// Blocks are shared by every shard, so two shards can race to allocate the same one
+		std::string* newBlock = new std::string[s_namesPerBlock];
+		if (m_nameBlocks[blockIndex].compare_exchange_strong(block, newBlock, std::memory_order_acq_rel))
+		{
+			block = newBlock;
+		}
+		else
+		{
+			delete[] newBlock;
+		}
+	}
+	block[index & (s_namesPerBlock - 1)] = string;
+
+	// Keep the load factor at or under half, so probes stay short and always hit an empty slot
+	uint32_t capacity = currentSlots ? currentSlots->m_mask + 1 : 0;
+	if (!currentSlots || (currentSlots->m_numUsed + 1) * 2 > capacity)
+	{
+		HashSlots* grownSlots = shard.m_allSlots.emplace_back(std::make_unique<HashSlots>(currentSlots ? capacity * 2 : s_initialShardCapacity)).get();
+		for (uint32_t i = 0; i < capacity; ++i)
+		{
+			uint64_t slot = currentSlots->m_slots[i].load(std::memory_order_relaxed);
+			if (slot != 0)
+			{
+				Insert(*grownSlots, static_cast<uint32_t>(slot >> 32), static_cast<uint32_t>(slot) - 1);
+			}
+		}
+		shard.m_currentSlots.store(grownSlots, std::memory_order_release);
+		currentSlots = grownSlots;
+	}
+
+	Insert(*currentSlots, hash, index);
+	return index;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+std::string const& NameTable::GetString(uint32_t index) const
+{
+	std::string const* block = m_nameBlocks[index >> s_namesPerBlockPowerOfTwo].load(std::memory_order_acquire);
+	return block[index & (s_namesPerBlock - 1)];
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t NameTable::GetNumNames() const
+{
+	return m_numNames.load(std::memory_order_relaxed);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+uint32_t NameTable::Find(HashSlots const& slots, uint32_t hash, std::string_view string) const
+{
+	// The low bits picked the shard, so start probing from the bits above them
+	for (uint32_t i = (hash >> s_numShardsPowerOfTwo) & slots.m_mask; true; i = (i + 1) & slots.m_mask)
+	{
+		uint64_t slot = slots.m_slots[i].load(std::memory_order_acquire);
+		if (slot == 0)
+		{
+			return s_notFound;
+		}
+		if (static_cast<uint32_t>(slot >> 32) == hash)
+		{
+			uint32_t index = static_cast<uint32_t>(slot) - 1;
+			if (StringUtils::CaseInsensitiveStringEquals()(GetString(index), string))
+			{
+				return index;
+			}
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NameTable::Insert(HashSlots& slots, uint32_t hash, uint32_t index) const
+{
+	uint32_t i = (hash >> s_numShardsPowerOfTwo) & slots.m_mask;
+	while (slots.m_slots[i].load(std::memory_order_relaxed) != 0)
+	{
+		i = (i + 1) & slots.m_mask;
+	}
+
+	// Release, so a thread that finds this slot also sees the string it points to
+	slots.m_slots[i].store((static_cast<uint64_t>(hash) << 32) | (index + 1), std::memory_order_release);
+	++slots.m_numUsed;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+NameTable::HashSlots::HashSlots(uint32_t capacity) : m_mask(capacity - 1), m_slots(new std::atomic<uint64_t>[capacity])
+{
+	for (uint32_t i = 0; i < capacity; ++i)
+	{
+		m_slots[i].store(0, std::memory_order_relaxed);
+	}
 }
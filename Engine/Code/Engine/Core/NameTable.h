@@ -1,9 +1,12 @@
 // Bradley Christensen - 2022-2026
 #pragma once
 #include "StringUtils.h"
-#include <unordered_map>
-#include <queue>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <string_view>
+#include <vector>
 
 
 
@@ -20,18 +23,57 @@ extern class NameTable* g_nameTable;
 //
 // String set, case insensitive.
 //
+// Lookups are lock free: each shard is an open addressing table of atomic slots, and strings live in blocks that
+// never move, so any thread can find a name or get the string for an index without locking. Adding a name locks only
+// the shard it hashes to. A shard grows by publishing a bigger copy of its slots, and the outgrown slots are kept until
+// Shutdown so a lookup still probing them stays valid (it just misses newer names, and rechecks under the lock).
+//
 class NameTable
 {
 public:
 
+	~NameTable();
+
 	void Startup();
 	void Shutdown();
 
+	uint32_t FindOrAdd(std::string_view string);
+	std::string const& GetString(uint32_t index) const;
+	uint32_t GetNumNames() const;
+
+protected:
+
+	// Each slot is (hash << 32) | (name index + 1), so 0 is empty
+	struct HashSlots
+	{
+		explicit HashSlots(uint32_t capacity);
+
+		uint32_t m_mask = 0;
+		uint32_t m_numUsed = 0; // Only touched with the shard's insert mutex locked
+		std::unique_ptr<std::atomic<uint64_t>[]> m_slots;
+	};
+
+	struct Shard
+	{
+		std::mutex m_insertMutex;
+		std::atomic<HashSlots*> m_currentSlots = nullptr;
+		std::vector<std::unique_ptr<HashSlots>> m_allSlots; // Current and outgrown, freed on Shutdown
+	};
+
+	uint32_t Find(HashSlots const& slots, uint32_t hash, std::string_view string) const;
+	void Insert(HashSlots& slots, uint32_t hash, uint32_t index) const;
+
 protected:
 
-	std::mutex m_lookupTableMutex;
-	std::unordered_map<std::string, size_t, StringUtils::CaseInsensitiveStringHash, StringUtils::CaseInsensitiveStringEquals> m_lookupTable;
-	std::deque<std::string> m_nameTable; // Deque to avoid reallocations that would invalidate pointers to strings in the table, for thread safety
+	static constexpr uint32_t s_notFound = UINT32_MAX;
+	static constexpr uint32_t s_numShardsPowerOfTwo = 4;
+	static constexpr uint32_t s_numShards = 1 << s_numShardsPowerOfTwo;
+	static constexpr uint32_t s_initialShardCapacity = 256;
+	static constexpr uint32_t s_namesPerBlockPowerOfTwo = 10;
+	static constexpr uint32_t s_namesPerBlock = 1 << s_namesPerBlockPowerOfTwo;
+	static constexpr uint32_t s_maxNumBlocks = 4096;
 
-	friend struct Name;
-};
\ No newline at end of file
+	Shard m_shards[s_numShards];
+	std::atomic<std::string*> m_nameBlocks[s_maxNumBlocks] = {};
+	std::atomic<uint32_t> m_numNames = 0;
+};
@@ -407,7 +407,7 @@ bool StringUtils::DoesStringContainChar(std::string const& string, uint8_t chara
 
 
 //----------------------------------------------------------------------------------------------------------------------
-std::size_t StringUtils::CaseInsensitiveStringHash::operator()(const std::string& input) const noexcept
+std::size_t StringUtils::CaseInsensitiveStringHash::operator()(std::string_view input) const noexcept
 {
     #if INTPTR_MAX == INT64_MAX
         constexpr size_t FNV_offset = 1469598103934665603ULL;
@@ -433,7 +433,7 @@ std::size_t StringUtils::CaseInsensitiveStringHash::operator()(const std::string
 
 
 //----------------------------------------------------------------------------------------------------------------------
-bool StringUtils::CaseInsensitiveStringEquals::operator()(const std::string& a, const std::string& b) const noexcept
+bool StringUtils::CaseInsensitiveStringEquals::operator()(std::string_view a, std::string_view b) const noexcept
 {
     size_t aSize = a.size();
     size_t bSize = b.size();
@@ -3,6 +3,7 @@
 #include "Engine/Math/Vec2.h"
 #include "Engine/Renderer/Rgba8.h"
 #include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -74,7 +75,7 @@ namespace StringUtils
     //----------------------------------------------------------------------------------------------------------------------
     struct CaseInsensitiveStringHash
     {
-        std::size_t operator()(const std::string& input) const noexcept;
+        std::size_t operator()(std::string_view input) const noexcept;
     };
 
 
@@ -82,6 +83,6 @@ namespace StringUtils
     //----------------------------------------------------------------------------------------------------------------------
     struct CaseInsensitiveStringEquals
     {
-        bool operator()(const std::string& a, const std::string& b) const noexcept;
+        bool operator()(std::string_view a, std::string_view b) const noexcept;
     };
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Core/ErrorUtils.h"
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Bucket Queue
+//
+// Priority queue for non-negative float keys, quantized into buckets of m_bucketWidth (Dial's algorithm). Push and pop
+// are O(1) amortized instead of O(log n), popping scans forward to the next non empty bucket. Elements in the same
+// bucket pop in no particular order, so results are only exact if no key depends on another key in the same bucket.
+// For fast marching with an upwind (causal) update and costs >= 1 the error is a small fraction of the bucket width.
+//
+// Decrease-key: PushOrUpdate takes the bucket the element is already queued in (tracked by the caller, per element),
+// and only pushes again if the new key lands in a different bucket. Pop returns the bucket it popped from, so callers
+// can tell an element's live entry from a stale one left in the bucket it was queued in before.
+//
+template<typename T>
+class BucketQueue
+{
+public:
+
+	static constexpr int s_notQueued = -1;
+
+	explicit BucketQueue(float bucketWidth = 0.5f);
+
+	void Push(T const& value, float key);
+	bool PushOrUpdate(T const& value, float key, int& inout_queuedBucket);	// Returns true if it pushed a new entry
+	T Pop(int* out_bucket = nullptr);										// Don't pop when empty
+	void Clear();
+
+	bool IsEmpty() const;
+	int Size() const;
+	int GetBucket(float key) const;
+	float GetBucketWidth() const;
+
+private:
+
+	std::vector<std::vector<T>> m_buckets;	// Indexed by bucket, only grows, so pushing again after Clear doesn't allocate
+	float m_oneOverBucketWidth	= 2.f;
+	int m_currentBucket			= 0;		// No non empty buckets below this
+	int m_size					= 0;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+BucketQueue<T>::BucketQueue(float bucketWidth /*= 0.5f*/) : m_oneOverBucketWidth(1.f / bucketWidth)
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+void BucketQueue<T>::Push(T const& value, float key)
+{
+	int bucket = GetBucket(key);
+	if (bucket >= (int) m_buckets.size())
+	{
+		m_buckets.resize(bucket + 1);
+	}
+	m_buckets[bucket].push_back(value);
+
+	if (m_size == 0 || bucket < m_currentBucket)
+	{
+		m_currentBucket = bucket;
+	}
+	++m_size;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+bool BucketQueue<T>::PushOrUpdate(T const& value, float key, int& inout_queuedBucket)
+{
+	int bucket = GetBucket(key);
+	if (bucket == inout_queuedBucket)
+	{
+		// Already has an entry in this bucket, which pops at the same time the new key would
+		return false;
+	}
+
+	Push(value, key);
+	inout_queuedBucket = bucket;
+	return true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+T BucketQueue<T>::Pop(int* out_bucket /*= nullptr*/)
+{
+	ASSERT_OR_DIE(m_size > 0, "BucketQueue::Pop called on an empty queue");
+
+	while (m_buckets[m_currentBucket].empty())
+	{
+		++m_currentBucket;
+	}
+
+	std::vector<T>& bucket = m_buckets[m_currentBucket];
+	T value = bucket.back();
+	bucket.pop_back();
+	--m_size;
+
+	if (out_bucket)
+	{
+		*out_bucket = m_currentBucket;
+	}
+	return value;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+void BucketQueue<T>::Clear()
+{
+	for (std::vector<T>& bucket : m_buckets)
+	{
+		bucket.clear();
+	}
+	m_currentBucket = 0;
+	m_size = 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+bool BucketQueue<T>::IsEmpty() const
+{
+	return m_size == 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+int BucketQueue<T>::Size() const
+{
+	return m_size;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+int BucketQueue<T>::GetBucket(float key) const
+{
+	return key <= 0.f ? 0 : static_cast<int>(key * m_oneOverBucketWidth);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+float BucketQueue<T>::GetBucketWidth() const
+{
+	return 1.f / m_oneOverBucketWidth;
+}
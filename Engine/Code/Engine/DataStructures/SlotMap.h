@@ -0,0 +1,224 @@
+// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Core/ErrorUtils.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Slot Map
+//
+// Pointers stored in slots, looked up by a 32 bit ID that packs a slot index and a generation. Removing bumps the
+// slot's generation and puts the slot on a freelist, so old IDs for a reused slot fail to look up instead of returning
+// whatever lives there now. The ID is never 0 or UINT32_MAX (RendererUtils::InvalidID).
+//
+// Get is lock free: slots live in fixed size blocks that never move once allocated. Add, Remove, and Clear lock a
+// mutex, and it's on the caller not to Get an ID on one thread while Removing it on another (the value is freed).
+//
+template<typename T>
+class SlotMap
+{
+public:
+
+	static constexpr uint32_t s_indexBits = 20;
+	static constexpr uint32_t s_indexMask = (1u << s_indexBits) - 1;
+	static constexpr uint32_t s_maxGeneration = (UINT32_MAX >> s_indexBits) - 1; // All ones is reserved, so the ID can't be UINT32_MAX
+	static constexpr uint32_t s_slotsPerBlockPowerOfTwo = 8;
+	static constexpr uint32_t s_slotsPerBlock = 1u << s_slotsPerBlockPowerOfTwo;
+	static constexpr uint32_t s_maxNumBlocks = (s_indexMask + 1) / s_slotsPerBlock;
+
+	SlotMap() = default;
+	SlotMap(SlotMap const&) = delete;
+	~SlotMap();
+
+	uint32_t Add(T* value);
+	T* Get(uint32_t id) const;
+	T* Remove(uint32_t id);		// Returns the removed value for the caller to free, or nullptr if the ID isn't live
+	void Clear();				// Doesn't free the values
+
+	template<typename Func>
+	void ForEach(Func&& func) const;	// func(uint32_t id, T* value) for every live slot, don't Add or Remove inside
+
+	int Size() const;
+
+private:
+
+	struct Slot
+	{
+		std::atomic<T*> m_value = nullptr;
+		std::atomic<uint32_t> m_generation = 1;
+	};
+
+	Slot* GetSlot(uint32_t index) const;
+
+private:
+
+	mutable std::mutex m_mutex;
+	std::atomic<Slot*> m_blocks[s_maxNumBlocks] = {};
+	std::vector<uint32_t> m_freeList;
+	uint32_t m_numSlots = 0;
+	int m_size = 0;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+SlotMap<T>::~SlotMap()
+{
+	for (std::atomic<Slot*>& block : m_blocks)
+	{
+		delete[] block.load();
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+uint32_t SlotMap<T>::Add(T* value)
+{
+	ASSERT_OR_DIE(value, "Can't add null to a SlotMap, null marks a free slot.");
+	std::unique_lock lock(m_mutex);
+
+	uint32_t index;
+	if (!m_freeList.empty())
+	{
+		index = m_freeList.back();
+		m_freeList.pop_back();
+	}
+	else
+	{
+		index = m_numSlots++;
+		ASSERT_OR_DIE(index <= s_indexMask, "SlotMap is full.");
+
+		uint32_t blockIndex = index >> s_slotsPerBlockPowerOfTwo;
+		if (!m_blocks[blockIndex].load(std::memory_order_relaxed))
+		{
+			m_blocks[blockIndex].store(new Slot[s_slotsPerBlock], std::memory_order_release);
+		}
+	}
+
+	Slot* slot = GetSlot(index);
+	slot->m_value.store(value, std::memory_order_release);
+	uint32_t generation = slot->m_generation.load(std::memory_order_relaxed);
+
+	++m_size;
+	return (generation << s_indexBits) | index;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+T* SlotMap<T>::Get(uint32_t id) const
+{
+	uint32_t index = id & s_indexMask;
+	Slot const* block = m_blocks[index >> s_slotsPerBlockPowerOfTwo].load(std::memory_order_acquire);
+	if (!block)
+	{
+		return nullptr;
+	}
+
+	Slot const& slot = block[index & (s_slotsPerBlock - 1)];
+	if (slot.m_generation.load(std::memory_order_acquire) != (id >> s_indexBits))
+	{
+		return nullptr;
+	}
+	return slot.m_value.load(std::memory_order_acquire);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+T* SlotMap<T>::Remove(uint32_t id)
+{
+	std::unique_lock lock(m_mutex);
+
+	uint32_t index = id & s_indexMask;
+	if (index >= m_numSlots)
+	{
+		return nullptr;
+	}
+
+	Slot* slot = GetSlot(index);
+	uint32_t generation = slot->m_generation.load(std::memory_order_relaxed);
+	T* value = slot->m_value.load(std::memory_order_relaxed);
+	if (generation != (id >> s_indexBits) || !value)
+	{
+		return nullptr;
+	}
+
+	uint32_t nextGeneration = (generation == s_maxGeneration) ? 1 : generation + 1;
+	slot->m_generation.store(nextGeneration, std::memory_order_release);
+	slot->m_value.store(nullptr, std::memory_order_relaxed);
+	m_freeList.push_back(index);
+	--m_size;
+	return value;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+void SlotMap<T>::Clear()
+{
+	std::unique_lock lock(m_mutex);
+
+	// Bump every live slot's generation like Remove would, so IDs from before the clear stay invalid
+	m_freeList.clear();
+	for (uint32_t index = m_numSlots; index-- > 0;)
+	{
+		Slot* slot = GetSlot(index);
+		if (slot->m_value.load(std::memory_order_relaxed))
+		{
+			uint32_t generation = slot->m_generation.load(std::memory_order_relaxed);
+			slot->m_generation.store((generation == s_maxGeneration) ? 1 : generation + 1, std::memory_order_release);
+			slot->m_value.store(nullptr, std::memory_order_relaxed);
+		}
+		m_freeList.push_back(index);
+	}
+	m_size = 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+template<typename Func>
+void SlotMap<T>::ForEach(Func&& func) const
+{
+	for (uint32_t index = 0; index < m_numSlots; ++index)
+	{
+		Slot const* slot = GetSlot(index);
+		T* value = slot->m_value.load(std::memory_order_relaxed);
+		if (value)
+		{
+			func((slot->m_generation.load(std::memory_order_relaxed) << s_indexBits) | index, value);
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+int SlotMap<T>::Size() const
+{
+	std::unique_lock lock(m_mutex);
+	return m_size;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+typename SlotMap<T>::Slot* SlotMap<T>::GetSlot(uint32_t index) const
+{
+	Slot* block = m_blocks[index >> s_slotsPerBlockPowerOfTwo].load(std::memory_order_acquire);
+	return &block[index & (s_slotsPerBlock - 1)];
+}
@@ -1,8 +1,11 @@
 // Bradley Christensen - 2022-2026
 #include "AdminSystem.h"
+#include "EntityPrefab.h"
 #include "System.h"
+#include "SystemContext.h"
 #include "SystemScheduler.h"
 #include "Engine/Core/ErrorUtils.h"
+#include "Engine/Math/MathUtils.h"
 #include "Engine/Time/Time.h"
 
 
@@ -65,6 +68,14 @@ void AdminSystem::Shutdown()
 
 	m_componentStorage.clear();
 	m_componentBitMasks.clear();
+
+	int numEntityQueries = m_numEntityQueries.load(std::memory_order_acquire);
+	for (int queryIndex = 0; queryIndex < numEntityQueries; ++queryIndex)
+	{
+		delete m_entityQueries[queryIndex];
+		m_entityQueries[queryIndex] = nullptr;
+	}
+	m_numEntityQueries.store(0, std::memory_order_release);
 	
 	delete m_systemScheduler;
 	m_systemScheduler = nullptr;
@@ -103,7 +114,7 @@ void AdminSystem::RunSystemSubgraph(SystemSubgraphID subgraphID, float deltaSeco
 		deltaSeconds = m_config.m_maxDeltaSeconds;
 	}
 
-	m_systemScheduler->RunSubgraph(m_systemSubgraphs[subgraphID], deltaSeconds);
+	m_systemScheduler->RunSubgraph(subgraphID, m_systemSubgraphs[subgraphID], deltaSeconds);
 }
 
 
@@ -118,7 +129,7 @@ bool AdminSystem::DestroyEntity(EntityID entityID)
 
 	int entityIndex = entityID.GetIndex();
 	m_entities.Unset(entityIndex);
-	m_entityComposition[entityIndex] = (BitMask) 0;
+	SetEntityComposition(entityIndex, (BitMask) 0);
 	m_entityGeneration[entityIndex] = (m_entityGeneration[entityIndex] + 1) & ENTITY_GENERATION_MASK;
 
 	for (auto it = m_componentStorage.begin(); it != m_componentStorage.end(); ++it)
@@ -131,6 +142,14 @@ bool AdminSystem::DestroyEntity(EntityID entityID)
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+int AdminSystem::CountGroup(BitMask groupMask) const
+{
+	return GetOrCreateQuery(groupMask).Count();
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 int AdminSystem::NumEntities() const
 {
@@ -139,6 +158,14 @@ int AdminSystem::NumEntities() const
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+int AdminSystem::GetHighWatermarkEntityID() const
+{
+	return m_highWatermarkEntityID;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 System* AdminSystem::GetSystemByName(Name name) const
 {
@@ -366,8 +393,36 @@ void AdminSystem::RemoveComponent(EntityID entityID, BitMask componentBit)
 		return;
 	}
 
-	BitMask& entityComp = m_entityComposition[entityID.GetIndex()];
-	entityComp &= (~componentBit);
+	int entityIndex = entityID.GetIndex();
+	BitMask& entityComp = m_entityComposition[entityIndex];
+	BitMask removedBits = entityComp & componentBit;
+	SetEntityComposition(entityIndex, entityComp & ~componentBit);
+	DestroyComponentData(entityIndex, removedBits);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void AdminSystem::DestroyComponentData(int entityIndex, BitMask componentBits)
+{
+	if (componentBits == 0)
+	{
+		return;
+	}
+
+	for (auto& [typeIndex, bitMask] : m_componentBitMasks)
+	{
+		if ((componentBits & bitMask) == 0)
+		{
+			continue;
+		}
+
+		auto storageIt = m_componentStorage.find(typeIndex);
+		if (storageIt != m_componentStorage.end())
+		{
+			storageIt->second->Destroy(entityIndex);
+		}
+	}
 }
 
 
@@ -412,6 +467,108 @@ bool AdminSystem::IsValid(EntityID entityID) const
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+void AdminSystem::SetEntityComposition(int entityIndex, BitMask newComposition)
+{
+	BitMask oldComposition = m_entityComposition[entityIndex];
+	if (oldComposition == newComposition)
+	{
+		return;
+	}
+
+	m_entityComposition[entityIndex] = newComposition;
+
+	int numEntityQueries = m_numEntityQueries.load(std::memory_order_acquire);
+	for (int queryIndex = 0; queryIndex < numEntityQueries; ++queryIndex)
+	{
+		m_entityQueries[queryIndex]->OnCompositionChanged(entityIndex, oldComposition, newComposition);
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+GroupIter AdminSystem::IterateGroup(BitMask groupMask, SystemContext const* context) const
+{
+	EntityQuery const& query = GetOrCreateQuery(groupMask);
+
+	GroupIter result;
+	result.m_groupMask = groupMask;
+	result.m_queryEntities = &query.m_entities;
+
+	int firstIndex = 0;
+	int lastIndex = query.Count() - 1;
+	if (context && context->m_didSystemSplit)
+	{
+		// Split the matching entities rather than the index space, so each job gets an even share of the real work
+		MathUtils::SplitIndices(query.Count(), context->m_systemSplittingNumJobs, context->m_systemSplittingJobID, firstIndex, lastIndex);
+	}
+
+	result.m_queryFirstIndex = firstIndex;
+	result.m_queryIndex = lastIndex;
+	if (result.IsValid())
+	{
+		result.m_currentIndex = query.m_entities[lastIndex];
+	}
+	return result;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Lock free once the query exists, which is every call after the first frame. Only creating a query takes the lock.
+//
+EntityQuery& AdminSystem::GetOrCreateQuery(BitMask groupMask) const
+{
+	if (EntityQuery* existingQuery = FindQuery(groupMask))
+	{
+		return *existingQuery;
+	}
+
+	std::unique_lock lock(m_entityQueriesMutex);
+
+	// Another thread may have made it while we waited
+	if (EntityQuery* existingQuery = FindQuery(groupMask))
+	{
+		return *existingQuery;
+	}
+
+	int numEntityQueries = m_numEntityQueries.load(std::memory_order_relaxed);
+	ASSERT_OR_DIE(numEntityQueries < MAX_ENTITY_QUERIES, "AdminSystem::GetOrCreateQuery - Too many distinct groups, raise MAX_ENTITY_QUERIES.");
+
+	// First time this group has been iterated, do one full scan to seed the query
+	EntityQuery* query = new EntityQuery(groupMask);
+	for (int entityIndex = 0; entityIndex <= m_highWatermarkEntityID; ++entityIndex)
+	{
+		if (m_entities.Get(entityIndex) && (m_entityComposition[entityIndex] & groupMask) == groupMask)
+		{
+			query->Add(entityIndex);
+		}
+	}
+	m_entityQueries[numEntityQueries] = query;
+	m_numEntityQueries.store(numEntityQueries + 1, std::memory_order_release);
+	return *query;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+EntityQuery* AdminSystem::FindQuery(BitMask groupMask) const
+{
+	int numEntityQueries = m_numEntityQueries.load(std::memory_order_acquire);
+	for (int queryIndex = 0; queryIndex < numEntityQueries; ++queryIndex)
+	{
+		EntityQuery* query = m_entityQueries[queryIndex];
+		if (query->m_groupMask == groupMask)
+		{
+			return query;
+		}
+	}
+	return nullptr;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 EntityID AdminSystem::GetNextEntityWithGroup(BitMask groupMask, int startIndex, int endIndex) const
 {
@@ -488,6 +645,138 @@ EntityID AdminSystem::CreateEntityInPlace(int entityID)
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+EntityID AdminSystem::Instantiate(EntityPrefab const& prefab)
+{
+	EntityID result = EntityID::Invalid;
+	InstantiateInternal(prefab, 1, &result);
+	return result;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int AdminSystem::Instantiate(EntityPrefab const& prefab, int count, std::vector<EntityID>& out_ids)
+{
+	if (count <= 0)
+	{
+		return 0;
+	}
+
+	size_t firstNewID = out_ids.size();
+	out_ids.resize(firstNewID + count, EntityID::Invalid);
+	int numCreated = InstantiateInternal(prefab, count, out_ids.data() + firstNewID);
+	out_ids.resize(firstNewID + numCreated);
+	return numCreated;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Takes the first run of count free indices if there is one, so the component copies walk storage in order, otherwise
+// fills whatever holes there are. Every new entity goes from no components to the prefab's composition, so each query
+// is checked once for the whole batch instead of once per component per entity.
+//
+int AdminSystem::InstantiateInternal(EntityPrefab const& prefab, int count, EntityID* out_ids)
+{
+	int numCreated = 0;
+	int firstIndex = FindFreeEntityRun(count);
+	if (firstIndex != -1)
+	{
+		for (; numCreated < count; ++numCreated)
+		{
+			int entityIndex = firstIndex + numCreated;
+			m_entities.Set(entityIndex);
+			out_ids[numCreated] = EntityID(entityIndex, m_entityGeneration[entityIndex]);
+		}
+	}
+	else
+	{
+		int searchBeginEntityID = 0;
+		for (; numCreated < count && searchBeginEntityID < (int) MAX_ENTITIES; ++numCreated)
+		{
+			int entityIndex = m_entities.SetNextUnsetIndex(searchBeginEntityID);
+			if (entityIndex == -1)
+			{
+				break;
+			}
+			out_ids[numCreated] = EntityID(entityIndex, m_entityGeneration[entityIndex]);
+			searchBeginEntityID = entityIndex + 1;
+		}
+	}
+
+	if (numCreated == 0)
+	{
+		return 0;
+	}
+
+	// Indices are handed out in ascending order
+	int lastIndex = out_ids[numCreated - 1].GetIndex();
+	if (lastIndex > m_highWatermarkEntityID)
+	{
+		m_highWatermarkEntityID = lastIndex;
+	}
+
+	BitMask composition = prefab.m_composition;
+	for (int i = 0; i < numCreated; ++i)
+	{
+		m_entityComposition[out_ids[i].GetIndex()] = composition;
+	}
+
+	if (composition != 0)
+	{
+		int numEntityQueries = m_numEntityQueries.load(std::memory_order_acquire);
+		for (int queryIndex = 0; queryIndex < numEntityQueries; ++queryIndex)
+		{
+			EntityQuery* query = m_entityQueries[queryIndex];
+			if ((composition & query->m_groupMask) == query->m_groupMask)
+			{
+				for (int i = 0; i < numCreated; ++i)
+				{
+					query->Add(out_ids[i].GetIndex());
+				}
+			}
+		}
+	}
+
+	for (EntityPrefab::PrefabComponent const& component : prefab.m_components)
+	{
+		component.m_copyFunc(component.m_storage, component.m_component.get(), out_ids, numCreated);
+	}
+
+	return numCreated;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Returns the first index of count consecutive free entities, or -1 if there isn't a run that long
+//
+int AdminSystem::FindFreeEntityRun(int count) const
+{
+	int runBegin = m_entities.GetNextUnsetIndex(0);
+	while (runBegin != -1)
+	{
+		int runEnd = m_entities.GetNextSetIndex(runBegin);
+		if (runEnd == -1)
+		{
+			runEnd = (int) MAX_ENTITIES;
+		}
+		if (runEnd - runBegin >= count)
+		{
+			return runBegin;
+		}
+		if (runEnd >= (int) MAX_ENTITIES)
+		{
+			return -1;
+		}
+		runBegin = m_entities.GetNextUnsetIndex(runEnd);
+	}
+	return -1;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void AdminSystem::DestroyAllEntities()
 {
@@ -1,16 +1,20 @@
 // Bradley Christensen - 2022-2026
 #pragma once
 #include "ComponentStorage.h"
+#include "EntityQuery.h"
 #include "GroupIter.h"
 #include "EntityID.h"
 #include "Engine/Core/Name.h"
 #include "SystemSubgraph.h"
+#include <atomic>
 #include <vector>
+#include <mutex>
 #include <unordered_map>
 #include <typeindex>
 
 
 
+class EntityPrefab;
 class System;
 class TaskSystem;
 class SystemScheduler;
@@ -40,6 +44,7 @@ struct AdminSystemConfig
 class AdminSystem
 {
 	friend struct GroupIter;
+	friend class EntityPrefab;
 
 public:
 
@@ -78,6 +83,9 @@ public:
 	
 	template <typename CType>
 	void RegisterComponentMap();
+
+	template <typename CType>
+	void RegisterComponentSparseSet();
 	
 	template <typename CType>
 	void RegisterTag();
@@ -90,6 +98,8 @@ public:
 private:
 
 	void RegisterComponentBit(std::type_index typeIndex);
+	void DestroyComponentData(int entityIndex, BitMask componentBits);
+	void SetEntityComposition(int entityIndex, BitMask newComposition);
 
 //----------------------------------------------------------------------------------------------------------------------
 // CREATING/DESTROYING ENTITIES
@@ -101,6 +111,16 @@ public:
 	void DestroyAllEntities();
 	bool DestroyEntity(EntityID entityID);
 
+	// Creates entities with a copy of every component in the prefab. The batch version appends the new IDs to out_ids and
+	// returns how many were made, which is less than count if MAX_ENTITIES is reached.
+	EntityID Instantiate(EntityPrefab const& prefab);
+	int Instantiate(EntityPrefab const& prefab, int count, std::vector<EntityID>& out_ids);
+
+private:
+
+	int InstantiateInternal(EntityPrefab const& prefab, int count, EntityID* out_ids);
+	int FindFreeEntityRun(int count) const;
+
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -138,7 +158,9 @@ public:
 	template <typename...CTypes>
 	int Count() const;
 
+	int CountGroup(BitMask groupMask) const;
 	int NumEntities() const;
+	int GetHighWatermarkEntityID() const;
 
 
 
@@ -164,6 +186,9 @@ public:
 	template <typename CType>
 	MapStorage<CType>& GetMapStorage() const;
 
+	template <typename CType>
+	SparseSetStorage<CType>& GetSparseSetStorage() const;
+
 	template <typename CType>
 	TagStorage<CType>& GetTagStorage() const;
 
@@ -192,6 +217,10 @@ public:
 	template <typename...CTypes>
 	BitMask GetComponentBitMask() const;
 
+	GroupIter IterateGroup(BitMask groupMask, SystemContext const* context = nullptr) const;
+	EntityQuery& GetOrCreateQuery(BitMask groupMask) const;
+	EntityQuery* FindQuery(BitMask groupMask) const;
+
 	EntityID GetNextEntityWithGroup(BitMask groupMask, int startIndex, int endIndex) const;
 	int GetNextEntityIndexWithGroup(BitMask groupMask, int startIndex, int endIndex) const;
 
@@ -240,10 +269,17 @@ protected:
 	BitArray<MAX_ENTITIES>			m_entities;
 	BitMask							m_entityComposition[MAX_ENTITIES] = { 0 }; // Todo: if user needs more than 32 or 64 components, allow them to use a fixed size BitArray for entity composition, so the max component count would be uncapped
 	uint16_t						m_entityGeneration[MAX_ENTITIES] = { 0 }; // 8 bit to match the 8 bits inside of EntityID
-	int								m_highWatermarkEntityID = 0; // highest entity ID ever allocated, speeds up system iteration by only searching up to this ID
+	int								m_highWatermarkEntityID = 0; // highest entity ID ever allocated, bounds the scan when seeding a new query
 
 	std::unordered_map<std::type_index, BaseStorage*>	m_componentStorage;
 	std::unordered_map<std::type_index, BitMask>		m_componentBitMasks;
+
+	// One cached query per distinct group mask passed to Iterate. Queries are only ever added: a new one is written to
+	// the table before the count is bumped, so FindQuery can read the first m_numEntityQueries entries without a lock.
+	// Composition only changes inside systems with full ECS access, so the mutex just guards creating queries.
+	mutable EntityQuery*								m_entityQueries[MAX_ENTITY_QUERIES] = {};
+	mutable std::atomic<int>							m_numEntityQueries = 0;
+	mutable std::mutex									m_entityQueriesMutex;
 };
 
 
@@ -302,6 +338,20 @@ void AdminSystem::RegisterComponentMap()
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+void AdminSystem::RegisterComponentSparseSet()
+{
+	std::type_index typeIndex(typeid(CType));
+	if (m_componentStorage.find(typeIndex) == m_componentStorage.end())
+	{
+		m_componentStorage.emplace(typeIndex, new SparseSetStorage<CType>());
+		RegisterComponentBit(typeIndex);
+	}
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 template <typename CType>
 void AdminSystem::RegisterTag()
@@ -349,7 +399,7 @@ CType* AdminSystem::AddComponent(EntityID entityID, Args const& ...args)
 		return typedStorage->Get(entityIndex);
 	}
 
-	m_entityComposition[entityIndex] |= (componentBitMask);
+	SetEntityComposition(entityIndex, m_entityComposition[entityIndex] | componentBitMask);
 	return typedStorage->Add(entityIndex, CType(args...));
 }
 
@@ -374,7 +424,7 @@ CType* AdminSystem::AddComponent(EntityID entityID, CType const& copy)
 		return typedStorage->Get(entityIndex);
 	}
 
-	m_entityComposition[entityIndex] |= (componentBitMask);
+	SetEntityComposition(entityIndex, m_entityComposition[entityIndex] | componentBitMask);
 
 	return typedStorage->Add(entityIndex, copy);
 }
@@ -448,6 +498,17 @@ MapStorage<CType>& AdminSystem::GetMapStorage() const
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+SparseSetStorage<CType>& AdminSystem::GetSparseSetStorage() const
+{
+	std::type_index typeIndex(typeid(CType));
+	SparseSetStorage<CType>* typedStorage = dynamic_cast<SparseSetStorage<CType>*>(m_componentStorage.at(typeIndex));
+	return *typedStorage;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 template <typename CType>
 TagStorage<CType>& AdminSystem::GetTagStorage() const
@@ -471,7 +532,18 @@ void AdminSystem::RemoveComponent(EntityID entityID)
 	int entityIndex = entityID.GetIndex();
 	BitMask& entityComp = m_entityComposition[entityIndex];
 	BitMask& componentBitMask = m_componentBitMasks[typeIndex];
-	entityComp &= (~componentBitMask);
+	if ((entityComp & componentBitMask) == 0)
+	{
+		return;
+	}
+	SetEntityComposition(entityIndex, entityComp & ~componentBitMask);
+
+	// Sparse sets must drop the data too, or the removed component would still show up when iterating the dense array
+	auto storageIt = m_componentStorage.find(typeIndex);
+	if (storageIt != m_componentStorage.end())
+	{
+		storageIt->second->Destroy(entityIndex);
+	}
 }
 
 
@@ -480,18 +552,7 @@ void AdminSystem::RemoveComponent(EntityID entityID)
 template <typename...CTypes>
 GroupIter AdminSystem::IterateAll() const
 {
-	GroupIter result;
-
-	result.m_groupMask = GetComponentBitMask<CTypes...>();
-
-	result.m_currentIndex = GetNextEntityIndexWithGroup(result.m_groupMask, 0, MAX_ENTITIES - 1);
-
-	if (m_highWatermarkEntityID < result.m_endIndex)
-	{
-		result.m_endIndex = g_ecs->m_highWatermarkEntityID;
-	}
-
-	return result;
+	return IterateGroup(GetComponentBitMask<CTypes...>());
 }
 
 
@@ -500,17 +561,7 @@ GroupIter AdminSystem::IterateAll() const
 template <typename...CTypes>
 GroupIter AdminSystem::Iterate(SystemContext const& context) const
 {
-	GroupIter result(context);
-
-	if (m_highWatermarkEntityID < result.m_endIndex)
-	{
-		result.m_endIndex = g_ecs->m_highWatermarkEntityID;
-	}
-
-	result.m_groupMask = GetComponentBitMask<CTypes...>();
-
-	result.m_currentIndex = GetNextEntityIndexWithGroup(result.m_groupMask, result.m_currentIndex, result.m_endIndex);
-	return result;
+	return IterateGroup(GetComponentBitMask<CTypes...>(), &context);
 }
 
 
@@ -571,19 +622,5 @@ inline bool AdminSystem::HasComponentUnsafe(int entityIndex) const
 template <typename...CTypes>
 int AdminSystem::Count() const
 {
-	BitMask groupMask = GetComponentBitMask<CTypes...>();
-
-	int result = 0;
-	for (int i = 0; i < MAX_ENTITIES; i++)
-	{
-		if (m_entities.Get(i))
-		{
-			BitMask const& entityComp = m_entityComposition[i];
-			if ((entityComp & groupMask) == groupMask)
-			{
-				result++;
-			}
-		}
-	}
-	return result;
+	return CountGroup(GetComponentBitMask<CTypes...>());
 }
@@ -1,6 +1,8 @@
 // Bradley Christensen - 2022-2026
 #pragma once
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include "EntityID.h"
 #include "GroupIter.h"
 #include "Engine/DataStructures/BitArray.h"
@@ -251,6 +253,180 @@ public:
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Sparse Set Storage - useful for components used by a moderate number of entities
+//
+// Components are packed contiguously in a dense array, and a paged sparse table maps entity index -> dense index.
+// Destroy swaps the last component into the hole, so pointers into this storage are invalidated by any Add or Destroy.
+// Iterating begin()/end() only visits live components, use GetEntityIndex(denseIndex) to get back to the entity.
+//
+constexpr int SPARSE_SET_PAGE_SIZE = 4096;
+constexpr int SPARSE_SET_INVALID_INDEX = -1;
+
+template<typename CType>
+class SparseSetStorage : public TypedBaseStorage<CType>
+{
+public:
+
+	SparseSetStorage() = default;
+	SparseSetStorage(const SparseSetStorage&) = delete;
+	SparseSetStorage& operator=(const SparseSetStorage&) = delete;
+	virtual ~SparseSetStorage() override = default;
+
+	virtual CType*			Get(int entityIndex)							override
+	{
+		int denseIndex = GetDenseIndex(entityIndex);
+		return (denseIndex != SPARSE_SET_INVALID_INDEX) ? &m_data[denseIndex] : nullptr;
+	}
+
+	virtual CType const*	Get(int entityIndex)							const override
+	{
+		int denseIndex = GetDenseIndex(entityIndex);
+		return (denseIndex != SPARSE_SET_INVALID_INDEX) ? &m_data[denseIndex] : nullptr;
+	}
+
+	virtual CType*			Get(EntityID entityID)							override
+	{
+		return Get((int) entityID.GetIndex());
+	}
+
+	virtual CType const*	Get(EntityID entityID)							const override
+	{
+		return Get((int) entityID.GetIndex());
+	}
+
+	virtual CType*			Get(GroupIter const& it)						override
+	{
+		return Get(it.m_currentIndex);
+	}
+
+	virtual CType const*	Get(GroupIter const& it)						const override
+	{
+		return Get(it.m_currentIndex);
+	}
+
+	virtual CType*			Add(int entityIndex)							override
+	{
+		return Add(entityIndex, CType());
+	}
+
+	virtual CType*			Add(int entityIndex, CType const& copy)			override
+	{
+		int& sparseSlot = GetOrCreateSparseSlot(entityIndex);
+		if (sparseSlot != SPARSE_SET_INVALID_INDEX)
+		{
+			m_data[sparseSlot] = copy;
+			return &m_data[sparseSlot];
+		}
+
+		sparseSlot = (int) m_data.size();
+		m_data.push_back(copy);
+		m_denseToEntity.push_back(entityIndex);
+		return &m_data.back();
+	}
+
+	virtual void			Destroy(int entityIndex)						override
+	{
+		int* sparseSlot = GetSparseSlot(entityIndex);
+		if (!sparseSlot || *sparseSlot == SPARSE_SET_INVALID_INDEX)
+		{
+			return;
+		}
+
+		// Swap-remove: move the last component into the hole so the dense array stays packed
+		int denseIndex = *sparseSlot;
+		int lastDenseIndex = (int) m_data.size() - 1;
+		if (denseIndex != lastDenseIndex)
+		{
+			int movedEntityIndex = m_denseToEntity[lastDenseIndex];
+			m_data[denseIndex] = std::move(m_data[lastDenseIndex]);
+			m_denseToEntity[denseIndex] = movedEntityIndex;
+			*GetSparseSlot(movedEntityIndex) = denseIndex;
+		}
+
+		m_data.pop_back();
+		m_denseToEntity.pop_back();
+		*sparseSlot = SPARSE_SET_INVALID_INDEX;
+	}
+
+	virtual void			Clear()											override
+	{
+		m_data.clear();
+		m_denseToEntity.clear();
+		m_sparsePages.clear();
+	}
+
+	void Reserve(int numComponents)
+	{
+		m_data.reserve(numComponents);
+		m_denseToEntity.reserve(numComponents);
+	}
+
+	inline int Count() const { return (int) m_data.size(); }
+	inline bool Contains(int entityIndex) const { return GetDenseIndex(entityIndex) != SPARSE_SET_INVALID_INDEX; }
+	inline int GetEntityIndex(int denseIndex) const { return m_denseToEntity[denseIndex]; }
+	inline CType& GetDense(int denseIndex) { return m_data[denseIndex]; }
+	inline CType const& GetDense(int denseIndex) const { return m_data[denseIndex]; }
+
+	inline int GetDenseIndex(int entityIndex) const
+	{
+		int pageIndex = entityIndex / SPARSE_SET_PAGE_SIZE;
+		if (pageIndex >= (int) m_sparsePages.size() || m_sparsePages[pageIndex].empty())
+		{
+			return SPARSE_SET_INVALID_INDEX;
+		}
+		return m_sparsePages[pageIndex][entityIndex % SPARSE_SET_PAGE_SIZE];
+	}
+
+	auto begin() { return m_data.begin(); }
+	auto begin() const { return m_data.begin(); }
+	auto end() { return m_data.end(); }
+	auto end() const { return m_data.end(); }
+
+	inline CType& operator [](int id) { return *Get(id); }
+	inline CType const& operator [](int id) const { return *Get(id); }
+	inline CType& operator [](EntityID id) { return *Get((int) id.GetIndex()); }
+	inline CType const& operator [](EntityID id) const { return *Get((int) id.GetIndex()); }
+	inline CType& operator [](GroupIter const& it) { return *Get(it.m_currentIndex); }
+	inline CType const& operator [](GroupIter const& it) const { return *Get(it.m_currentIndex); }
+
+private:
+
+	int* GetSparseSlot(int entityIndex)
+	{
+		int pageIndex = entityIndex / SPARSE_SET_PAGE_SIZE;
+		if (pageIndex >= (int) m_sparsePages.size() || m_sparsePages[pageIndex].empty())
+		{
+			return nullptr;
+		}
+		return &m_sparsePages[pageIndex][entityIndex % SPARSE_SET_PAGE_SIZE];
+	}
+
+	int& GetOrCreateSparseSlot(int entityIndex)
+	{
+		int pageIndex = entityIndex / SPARSE_SET_PAGE_SIZE;
+		if (pageIndex >= (int) m_sparsePages.size())
+		{
+			m_sparsePages.resize((size_t) pageIndex + 1);
+		}
+
+		std::vector<int>& page = m_sparsePages[pageIndex];
+		if (page.empty())
+		{
+			page.resize(SPARSE_SET_PAGE_SIZE, SPARSE_SET_INVALID_INDEX);
+		}
+		return page[entityIndex % SPARSE_SET_PAGE_SIZE];
+	}
+
+public:
+
+	std::vector<CType> m_data;						// Dense, packed components
+	std::vector<int> m_denseToEntity;				// Dense index -> entity index
+	std::vector<std::vector<int>> m_sparsePages;	// Entity index -> dense index, pages are only allocated once touched
+};
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // Singleton Storage - useful for global data
 //
@@ -22,6 +22,21 @@ constexpr float SYSTEM_MIN_TIME_STEP = 0.001f;
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// System splitting tuning. Split systems get at least this many entities per job, aren't split at all if their measured
+// cost is below the min, and otherwise get roughly one job per target cost (capped by the system's max num jobs).
+constexpr int SYSTEM_SPLITTING_MIN_ENTITIES_PER_JOB = 64;
+constexpr float SYSTEM_SPLITTING_MIN_COST_SECONDS = 0.0002f;
+constexpr float SYSTEM_SPLITTING_TARGET_JOB_COST_SECONDS = 0.0001f;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Max distinct group masks that can be iterated, queries live in a fixed table so finding one never takes a lock
+constexpr int MAX_ENTITY_QUERIES = 256;
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 // Component bit mask, used to keep track of entity composition
 typedef size_t BitMask;
\ No newline at end of file
@@ -0,0 +1,272 @@
+// Bradley Christensen - 2022-2026
+#include "EntityCommandBuffer.h"
+#include "AdminSystem.h"
+#include <algorithm>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+	DestroyPendingComponents();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+DeferredEntityID EntityCommandBuffer::CreateEntity()
+{
+	DeferredEntityID result;
+	result.m_index = m_numDeferredEntities++;
+
+	Command command;
+	command.m_type = CommandType::CreateEntity;
+	command.m_deferredIndex = result.m_index;
+	m_commands.push_back(command);
+
+	return result;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+DeferredEntityID EntityCommandBuffer::Instantiate(EntityPrefab const& prefab, int count)
+{
+	DeferredEntityID result;
+	result.m_index = m_numDeferredEntities;
+	m_numDeferredEntities += count;
+
+	Command command;
+	command.m_type = CommandType::Instantiate;
+	command.m_deferredIndex = result.m_index;
+	command.m_count = count;
+	command.m_prefab = &prefab;
+	m_commands.push_back(command);
+
+	return result;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::DestroyEntity(EntityID entityID)
+{
+	Command command;
+	command.m_type = CommandType::DestroyEntity;
+	command.m_entityID = entityID;
+	m_commands.push_back(command);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::OnEntityCreated(DeferredEntityID entity, std::function<void(EntityID)> const& callback)
+{
+	Command command;
+	command.m_type = CommandType::EntityCreated;
+	command.m_deferredIndex = entity.m_index;
+	command.m_callbackIndex = (int) m_callbacks.size();
+	m_callbacks.push_back([callback](EntityID const* entityIDs, int)
+	{
+		callback(entityIDs[0]);
+	});
+	m_commands.push_back(command);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::OnEntitiesCreated(DeferredEntityID first, int count, std::function<void(EntityID const* entityIDs, int count)> const& callback)
+{
+	Command command;
+	command.m_type = CommandType::EntitiesCreated;
+	command.m_deferredIndex = first.m_index;
+	command.m_count = count;
+	command.m_callbackIndex = (int) m_callbacks.size();
+	m_callbacks.push_back(callback);
+	m_commands.push_back(command);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Bump allocates from the current block, moving on to the next block (or a new one) when it doesn't fit
+//
+void* EntityCommandBuffer::AllocateComponent(size_t size, size_t alignment)
+{
+	while (m_currentBlock < m_componentBlocks.size())
+	{
+		ComponentBlock& block = m_componentBlocks[m_currentBlock];
+		size_t alignedOffset = (m_currentBlockOffset + alignment - 1) & ~(alignment - 1);
+		if (alignedOffset + size <= block.m_size)
+		{
+			m_currentBlockOffset = alignedOffset + size;
+			return block.m_bytes.get() + alignedOffset;
+		}
+		++m_currentBlock;
+		m_currentBlockOffset = 0;
+	}
+
+	ComponentBlock newBlock;
+	newBlock.m_size = size > s_componentBlockSize ? size : s_componentBlockSize;
+	newBlock.m_bytes = std::make_unique<uint8_t[]>(newBlock.m_size);
+	m_componentBlocks.push_back(std::move(newBlock));
+	m_currentBlock = m_componentBlocks.size() - 1;
+	m_currentBlockOffset = size;
+	return m_componentBlocks.back().m_bytes.get();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Stored components that were never played back, e.g. cleared early or their entity was destroyed first
+//
+void EntityCommandBuffer::DestroyPendingComponents()
+{
+	for (Command& command : m_commands)
+	{
+		if (command.m_component)
+		{
+			command.m_componentFunction(nullptr, EntityID::Invalid, command.m_component);
+			command.m_component = nullptr;
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::Append(EntityCommandBuffer& other)
+{
+	int deferredIndexOffset = m_numDeferredEntities;
+	int callbackIndexOffset = (int) m_callbacks.size();
+	for (Command& command : other.m_commands)
+	{
+		if (command.m_deferredIndex >= 0)
+		{
+			command.m_deferredIndex += deferredIndexOffset;
+		}
+		if (command.m_callbackIndex >= 0)
+		{
+			command.m_callbackIndex += callbackIndexOffset;
+		}
+		m_commands.push_back(command);
+	}
+	m_numDeferredEntities += other.m_numDeferredEntities;
+	for (std::function<void(EntityID const*, int)>& callback : other.m_callbacks)
+	{
+		m_callbacks.push_back(std::move(callback));
+	}
+
+	// The appended commands point into other's used blocks, so swap those for our spare blocks (the ones after our
+	// current block), which keeps both block counts steady from frame to frame
+	bool otherUsedBlocks = other.m_currentBlock > 0 || other.m_currentBlockOffset > 0;
+	if (otherUsedBlocks)
+	{
+		bool usedBlocks = m_currentBlock > 0 || m_currentBlockOffset > 0;
+		size_t firstIndex = usedBlocks ? m_currentBlock + 1 : 0;
+		for (size_t i = 0; i <= other.m_currentBlock; ++i)
+		{
+			size_t index = firstIndex + i;
+			if (index < m_componentBlocks.size())
+			{
+				std::swap(m_componentBlocks[index], other.m_componentBlocks[i]);
+			}
+			else
+			{
+				m_componentBlocks.push_back(std::move(other.m_componentBlocks[i]));
+			}
+		}
+		m_currentBlock = firstIndex + other.m_currentBlock;
+		m_currentBlockOffset = other.m_currentBlockOffset;
+
+		auto isMovedFrom = [](ComponentBlock const& block) { return block.m_bytes == nullptr; };
+		other.m_componentBlocks.erase(std::remove_if(other.m_componentBlocks.begin(), other.m_componentBlocks.end(), isMovedFrom), other.m_componentBlocks.end());
+	}
+
+	other.m_commands.clear();
+	other.Clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::Playback(AdminSystem& admin)
+{
+	m_createdEntities.assign(m_numDeferredEntities, EntityID::Invalid);
+
+	for (Command& command : m_commands)
+	{
+		if (command.m_type == CommandType::CreateEntity)
+		{
+			// Invalid if we hit max entities, in which case the rest of this entity's commands are skipped
+			m_createdEntities[command.m_deferredIndex] = admin.CreateEntity();
+			continue;
+		}
+		if (command.m_type == CommandType::Instantiate)
+		{
+			// Any that don't fit under max entities stay invalid, same as CreateEntity
+			m_instantiatedEntities.clear();
+			int numCreated = admin.Instantiate(*command.m_prefab, command.m_count, m_instantiatedEntities);
+			for (int i = 0; i < numCreated; ++i)
+			{
+				m_createdEntities[command.m_deferredIndex + i] = m_instantiatedEntities[i];
+			}
+			continue;
+		}
+		if (command.m_type == CommandType::EntitiesCreated)
+		{
+			m_callbacks[command.m_callbackIndex](m_createdEntities.data() + command.m_deferredIndex, command.m_count);
+			continue;
+		}
+
+		EntityID entityID = command.m_deferredIndex >= 0 ? m_createdEntities[command.m_deferredIndex] : command.m_entityID;
+		if (!admin.IsValid(entityID))
+		{
+			continue;
+		}
+
+		switch (command.m_type)
+		{
+			case CommandType::DestroyEntity:
+				admin.DestroyEntity(entityID);
+				break;
+			case CommandType::AddComponent:
+				command.m_componentFunction(&admin, entityID, command.m_component);
+				command.m_component = nullptr;
+				break;
+			case CommandType::EntityCreated:
+				m_callbacks[command.m_callbackIndex](&entityID, 1);
+				break;
+			case CommandType::RemoveComponent:
+				admin.RemoveComponent(entityID, admin.GetComponentBit(command.m_componentType));
+				break;
+			default:
+				break;
+		}
+	}
+
+	Clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityCommandBuffer::Clear()
+{
+	DestroyPendingComponents();
+	m_commands.clear();
+	m_callbacks.clear();
+	m_createdEntities.clear();
+	m_numDeferredEntities = 0;
+	m_currentBlock = 0;
+	m_currentBlockOffset = 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool EntityCommandBuffer::IsEmpty() const
+{
+	return m_commands.empty();
+}
@@ -0,0 +1,218 @@
+// Bradley Christensen - 2022-2026
+#pragma once
+#include "AdminSystem.h"
+#include "EntityID.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <typeindex>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Handle to an entity created through an EntityCommandBuffer. It only means something to the buffer that made it, and
+// becomes a real EntityID when that buffer is played back.
+//
+struct DeferredEntityID
+{
+	int m_index = -1;
+
+	bool IsValid() const { return m_index >= 0; }
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Entity Command Buffer
+//
+// Records structural changes (create/destroy entities, add/remove components) so systems running in parallel can
+// request them without full ECS access. The scheduler gives every job its own buffer and plays them all back on the
+// main thread at the end of each subgraph, in system priority order.
+//
+// Commands play back in the order they were recorded. Commands on an entity that has been destroyed by the time they
+// play back are skipped.
+//
+class EntityCommandBuffer
+{
+public:
+
+	EntityCommandBuffer() = default;
+	EntityCommandBuffer(EntityCommandBuffer const&) = delete;
+	EntityCommandBuffer& operator=(EntityCommandBuffer const&) = delete;
+	~EntityCommandBuffer();
+
+	DeferredEntityID CreateEntity();
+	void DestroyEntity(EntityID entityID);
+
+	// Creates count entities from the prefab in one AdminSystem::Instantiate call during playback. Returns the first of
+	// count consecutive deferred IDs. The prefab must outlive playback.
+	DeferredEntityID Instantiate(EntityPrefab const& prefab, int count = 1);
+
+	template <typename CType, typename...Args>
+	void AddComponent(EntityID entityID, Args const& ...args);
+
+	template <typename CType, typename...Args>
+	void AddComponent(DeferredEntityID entity, Args const& ...args);
+
+	template <typename CType>
+	void RemoveComponent(EntityID entityID);
+
+	// Adds or removes a tag registered with RegisterTag. For activity tags (awake, on screen, etc.) that a system
+	// re-evaluates every frame: compare against the tag storage first and only set it when it changes, so queries on the
+	// tag are kept up to date incrementally instead of being rebuilt.
+	template <typename CType>
+	void SetTag(EntityID entityID, bool isTagged);
+
+	// Called during playback with the real ID, once the entity and any components recorded before this are added
+	void OnEntityCreated(DeferredEntityID entity, std::function<void(EntityID)> const& callback);
+
+	// Same as OnEntityCreated but once for count consecutive deferred entities, e.g. from Instantiate. Entities that
+	// could not be created (max entities) are passed as EntityID::Invalid.
+	void OnEntitiesCreated(DeferredEntityID first, int count, std::function<void(EntityID const* entityIDs, int count)> const& callback);
+
+	// Moves other's commands onto the end of this buffer. Deferred IDs handed out by other are no longer valid after
+	void Append(EntityCommandBuffer& other);
+
+	void Playback(AdminSystem& admin);
+	void Clear();
+	bool IsEmpty() const;
+
+private:
+
+	enum class CommandType : uint8_t
+	{
+		CreateEntity,
+		Instantiate,
+		DestroyEntity,
+		AddComponent,
+		RemoveComponent,
+		EntityCreated,
+		EntitiesCreated,
+	};
+
+	// Adds the stored component to the entity if admin is set, then destroys the stored copy either way
+	using ComponentFunction = void(*)(AdminSystem* admin, EntityID entityID, void* component);
+
+	struct Command
+	{
+		CommandType		m_type				= CommandType::CreateEntity;
+		EntityID		m_entityID			= EntityID::Invalid;
+		int				m_deferredIndex		= -1;					// >= 0 if this targets an entity created by this buffer
+		int				m_count				= 1;					// Instantiate and EntitiesCreated only
+		int				m_callbackIndex		= -1;					// EntityCreated and EntitiesCreated only, index into m_callbacks
+		EntityPrefab const* m_prefab		= nullptr;				// Instantiate only
+		std::type_index	m_componentType		= typeid(void);			// RemoveComponent only
+		void*			m_component			= nullptr;				// AddComponent only, lives in m_componentBlocks
+		ComponentFunction m_componentFunction = nullptr;			// AddComponent only
+	};
+
+	// Blocks never move once allocated so stored components don't either, and are reused after Clear
+	struct ComponentBlock
+	{
+		std::unique_ptr<uint8_t[]>	m_bytes;
+		size_t						m_size = 0;
+	};
+
+	template <typename CType>
+	static void AddAndDestroyComponent(AdminSystem* admin, EntityID entityID, void* component);
+
+	template <typename CType, typename...Args>
+	void AddComponentInternal(EntityID entityID, int deferredIndex, Args const& ...args);
+
+	void* AllocateComponent(size_t size, size_t alignment);
+	void DestroyPendingComponents();
+
+private:
+
+	static constexpr size_t s_componentBlockSize = 4096;
+
+	std::vector<Command>						m_commands;
+	std::vector<std::function<void(EntityID const*, int)>>	m_callbacks;
+	std::vector<EntityID>						m_createdEntities;	// Deferred index -> real ID, filled in during playback
+	std::vector<EntityID>						m_instantiatedEntities;
+	int											m_numDeferredEntities = 0;
+
+	std::vector<ComponentBlock>	m_componentBlocks;
+	size_t						m_currentBlock			= 0;
+	size_t						m_currentBlockOffset	= 0;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType, typename...Args>
+void EntityCommandBuffer::AddComponent(EntityID entityID, Args const& ...args)
+{
+	AddComponentInternal<CType>(entityID, -1, args...);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType, typename...Args>
+void EntityCommandBuffer::AddComponent(DeferredEntityID entity, Args const& ...args)
+{
+	AddComponentInternal<CType>(EntityID::Invalid, entity.m_index, args...);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+void EntityCommandBuffer::AddAndDestroyComponent(AdminSystem* admin, EntityID entityID, void* component)
+{
+	CType* typedComponent = static_cast<CType*>(component);
+	if (admin)
+	{
+		admin->AddComponent<CType>(entityID, *typedComponent);
+	}
+	typedComponent->~CType();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType, typename...Args>
+void EntityCommandBuffer::AddComponentInternal(EntityID entityID, int deferredIndex, Args const& ...args)
+{
+	static_assert(alignof(CType) <= alignof(std::max_align_t), "EntityCommandBuffer - over aligned components are not supported");
+
+	Command command;
+	command.m_type = CommandType::AddComponent;
+	command.m_entityID = entityID;
+	command.m_deferredIndex = deferredIndex;
+	command.m_component = new (AllocateComponent(sizeof(CType), alignof(CType))) CType(args...);
+	command.m_componentFunction = &AddAndDestroyComponent<CType>;
+	m_commands.push_back(command);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+void EntityCommandBuffer::RemoveComponent(EntityID entityID)
+{
+	Command command;
+	command.m_type = CommandType::RemoveComponent;
+	command.m_entityID = entityID;
+	command.m_componentType = typeid(CType);
+	m_commands.push_back(command);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+void EntityCommandBuffer::SetTag(EntityID entityID, bool isTagged)
+{
+	if (isTagged)
+	{
+		AddComponent<CType>(entityID);
+	}
+	else
+	{
+		RemoveComponent<CType>(entityID);
+	}
+}
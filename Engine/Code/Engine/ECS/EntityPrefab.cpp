@@ -0,0 +1,35 @@
+// Bradley Christensen - 2022-2026
+#include "EntityPrefab.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+BitMask EntityPrefab::GetComposition() const
+{
+	return m_composition;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int EntityPrefab::GetNumComponents() const
+{
+	return (int) m_components.size();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool EntityPrefab::IsEmpty() const
+{
+	return m_components.empty();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityPrefab::Clear()
+{
+	m_composition = 0;
+	m_components.clear();
+}
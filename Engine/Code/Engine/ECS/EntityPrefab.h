@@ -0,0 +1,155 @@
+// Bradley Christensen - 2022-2026
+#pragma once
+#include "AdminSystem.h"
+#include "ComponentStorage.h"
+#include "EntityID.h"
+#include "Engine/Core/ErrorUtils.h"
+#include <memory>
+#include <typeindex>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Entity Prefab
+//
+// A set of components compiled once (composition bits, storage pointers, and a copy function per component) so that
+// AdminSystem::Instantiate can stamp out entities without any RTTI lookups. Holds pointers into the admin system's
+// storage, so build it after the components are registered and don't use it past AdminSystem::Shutdown.
+//
+class EntityPrefab
+{
+	friend class AdminSystem;
+
+public:
+
+	template <typename CType>
+	void AddComponent(AdminSystem const& admin, CType const& component);
+
+	BitMask GetComposition() const;
+	int GetNumComponents() const;
+	bool IsEmpty() const;
+	void Clear();
+
+private:
+
+	// Copies one prefab component into the storage for every entity in entityIDs
+	typedef void (*CopyComponentFunc)(BaseStorage* storage, void const* component, EntityID const* entityIDs, int count);
+
+	template <typename CType>
+	static void CopyToArrayStorage(BaseStorage* storage, void const* component, EntityID const* entityIDs, int count);
+
+	template <typename CType>
+	static void CopyToSparseSetStorage(BaseStorage* storage, void const* component, EntityID const* entityIDs, int count);
+
+	template <typename CType>
+	static void CopyToStorage(BaseStorage* storage, void const* component, EntityID const* entityIDs, int count);
+
+	struct PrefabComponent
+	{
+		BitMask							m_componentBit = 0;
+		BaseStorage*					m_storage = nullptr;
+		std::shared_ptr<void const>		m_component;
+		CopyComponentFunc				m_copyFunc = nullptr;
+	};
+
+private:
+
+	BitMask m_composition = 0;
+	std::vector<PrefabComponent> m_components;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// TEMPLATE FUNCTION IMPLEMENTATIONS																				  //
+//----------------------------------------------------------------------------------------------------------------------
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Does the RTTI lookups for this component type once, adding the same type again replaces the stored component
+//
+template <typename CType>
+void EntityPrefab::AddComponent(AdminSystem const& admin, CType const& component)
+{
+	std::type_index typeIndex(typeid(CType));
+	auto storageIt = admin.m_componentStorage.find(typeIndex);
+	ASSERT_OR_DIE(storageIt != admin.m_componentStorage.end(), "EntityPrefab::AddComponent - Component type is not registered.");
+	ASSERT_OR_DIE(dynamic_cast<SingletonStorage<CType>*>(storageIt->second) == nullptr, "EntityPrefab::AddComponent - Singletons can't be part of a prefab.");
+
+	PrefabComponent prefabComponent;
+	prefabComponent.m_componentBit = admin.GetComponentBit(typeIndex);
+	prefabComponent.m_storage = storageIt->second;
+	prefabComponent.m_component = std::make_shared<CType>(component);
+	if (dynamic_cast<ArrayStorage<CType>*>(storageIt->second))
+	{
+		prefabComponent.m_copyFunc = &CopyToArrayStorage<CType>;
+	}
+	else if (dynamic_cast<SparseSetStorage<CType>*>(storageIt->second))
+	{
+		prefabComponent.m_copyFunc = &CopyToSparseSetStorage<CType>;
+	}
+	else
+	{
+		prefabComponent.m_copyFunc = &CopyToStorage<CType>;
+	}
+
+	if (m_composition & prefabComponent.m_componentBit)
+	{
+		for (PrefabComponent& existing : m_components)
+		{
+			if (existing.m_componentBit == prefabComponent.m_componentBit)
+			{
+				existing = prefabComponent;
+				return;
+			}
+		}
+	}
+
+	m_composition |= prefabComponent.m_componentBit;
+	m_components.push_back(prefabComponent);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+void EntityPrefab::CopyToArrayStorage(BaseStorage* storage, void const* component, EntityID const* entityIDs, int count)
+{
+	ArrayStorage<CType>& arrayStorage = *static_cast<ArrayStorage<CType>*>(storage);
+	CType const& prefabComponent = *static_cast<CType const*>(component);
+	for (int i = 0; i < count; ++i)
+	{
+		arrayStorage[entityIDs[i].GetIndex()] = prefabComponent;
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+void EntityPrefab::CopyToSparseSetStorage(BaseStorage* storage, void const* component, EntityID const* entityIDs, int count)
+{
+	SparseSetStorage<CType>& sparseSetStorage = *static_cast<SparseSetStorage<CType>*>(storage);
+	CType const& prefabComponent = *static_cast<CType const*>(component);
+	sparseSetStorage.Reserve(sparseSetStorage.Count() + count);
+	for (int i = 0; i < count; ++i)
+	{
+		sparseSetStorage.Add(entityIDs[i].GetIndex(), prefabComponent);
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+void EntityPrefab::CopyToStorage(BaseStorage* storage, void const* component, EntityID const* entityIDs, int count)
+{
+	TypedBaseStorage<CType>& typedStorage = *static_cast<TypedBaseStorage<CType>*>(storage);
+	CType const& prefabComponent = *static_cast<CType const*>(component);
+	for (int i = 0; i < count; ++i)
+	{
+		typedStorage.Add(entityIDs[i].GetIndex(), prefabComponent);
+	}
+}
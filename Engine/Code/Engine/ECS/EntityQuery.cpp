@@ -0,0 +1,95 @@
+// Bradley Christensen - 2022-2026
+#include "EntityQuery.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+EntityQuery::EntityQuery(BitMask groupMask) : m_groupMask(groupMask)
+{
+
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityQuery::OnCompositionChanged(int entityIndex, BitMask oldComposition, BitMask newComposition)
+{
+	bool wasInQuery = (oldComposition & m_groupMask) == m_groupMask;
+	bool isInQuery = (newComposition & m_groupMask) == m_groupMask;
+	if (wasInQuery == isInQuery)
+	{
+		return;
+	}
+
+	if (isInQuery)
+	{
+		Add(entityIndex);
+	}
+	else
+	{
+		Remove(entityIndex);
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityQuery::Add(int entityIndex)
+{
+	if (entityIndex >= (int) m_denseIndexByEntity.size())
+	{
+		m_denseIndexByEntity.resize((size_t) entityIndex + 1, -1);
+	}
+
+	if (m_denseIndexByEntity[entityIndex] != -1)
+	{
+		return;
+	}
+
+	m_denseIndexByEntity[entityIndex] = (int) m_entities.size();
+	m_entities.push_back(entityIndex);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityQuery::Remove(int entityIndex)
+{
+	if (!Contains(entityIndex))
+	{
+		return;
+	}
+
+	int denseIndex = m_denseIndexByEntity[entityIndex];
+	int lastEntityIndex = m_entities.back();
+	m_entities[denseIndex] = lastEntityIndex;
+	m_denseIndexByEntity[lastEntityIndex] = denseIndex;
+
+	m_entities.pop_back();
+	m_denseIndexByEntity[entityIndex] = -1;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityQuery::Clear()
+{
+	m_entities.clear();
+	m_denseIndexByEntity.clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool EntityQuery::Contains(int entityIndex) const
+{
+	return entityIndex < (int) m_denseIndexByEntity.size() && m_denseIndexByEntity[entityIndex] != -1;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int EntityQuery::Count() const
+{
+	return (int) m_entities.size();
+}
@@ -0,0 +1,37 @@
+// Bradley Christensen - 2022-2026
+#pragma once
+#include "EntityID.h"
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Entity Query
+//
+// Packed list of every entity whose composition contains all bits of m_groupMask. The AdminSystem creates one per
+// distinct group mask passed to Iterate and keeps it up to date as components are added and removed, so iterating a
+// group is O(matches) instead of O(highest entity index).
+//
+// Removal swaps the last entity into the hole, so the list is unordered. GroupIter walks it back to front, which keeps
+// destroying the current entity mid-iteration safe.
+//
+class EntityQuery
+{
+public:
+
+	explicit EntityQuery(BitMask groupMask);
+
+	void OnCompositionChanged(int entityIndex, BitMask oldComposition, BitMask newComposition);
+	void Add(int entityIndex);
+	void Remove(int entityIndex);
+	void Clear();
+
+	bool Contains(int entityIndex) const;
+	int Count() const;
+
+public:
+
+	BitMask				m_groupMask			= 0;
+	std::vector<int>	m_entities;						// Packed entity indices
+	std::vector<int>	m_denseIndexByEntity;			// Entity index -> index into m_entities, -1 if not in the query
+};
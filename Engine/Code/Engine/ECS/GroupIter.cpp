@@ -1,23 +1,13 @@
 // Bradley Christensen - 2022-2026
 #include "GroupIter.h"
 #include "AdminSystem.h"
-#include "SystemContext.h"
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-GroupIter::GroupIter(SystemContext const& context)
-{
-	m_currentIndex = context.m_startEntityID;
-	m_endIndex = context.m_endEntityID;
-}
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
 bool GroupIter::IsValid() const
 {
-	return m_currentIndex <= m_endIndex;
+	return m_queryIndex >= m_queryFirstIndex;
 }
 
 
@@ -25,15 +15,18 @@ bool GroupIter::IsValid() const
 //----------------------------------------------------------------------------------------------------------------------
 void GroupIter::Next()
 {
-	do
+	// Clamp in case entities earlier in the list were removed mid-iteration and the list shrank past us
+	int lastIndex = (int) m_queryEntities->size() - 1;
+	--m_queryIndex;
+	if (m_queryIndex > lastIndex)
+	{
+		m_queryIndex = lastIndex;
+	}
+
+	if (m_queryIndex >= m_queryFirstIndex)
 	{
-		++m_currentIndex;
-		if ((g_ecs->m_entityComposition[m_currentIndex] & m_groupMask) == m_groupMask)
-		{
-			return;
-		}
+		m_currentIndex = (*m_queryEntities)[m_queryIndex];
 	}
-	while (m_currentIndex <= m_endIndex);
 }
 
 
@@ -1,17 +1,15 @@
 // Bradley Christensen - 2022-2026
 #pragma once
 #include "EntityID.h"
-
-
-
-struct SystemContext;
+#include <vector>
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
 // Group Iterator
 //
-// Iterates over entities that have all of the components specified
+// Iterates over entities that have all of the components specified, walking the cached EntityQuery for that group
+// from m_queryIndex down to m_queryFirstIndex. m_currentIndex is the entity index of the current element.
 //
 struct GroupIter
 {
@@ -20,7 +18,6 @@ protected:
 	friend class AdminSystem;
 
 	GroupIter() = default;
-	explicit GroupIter(SystemContext const& context);
 
 public:
 
@@ -33,6 +30,9 @@ public:
 public:
 
 	int						m_currentIndex		= 0;
-	int						m_endIndex			= MAX_ENTITIES - 1;
 	BitMask					m_groupMask			= 0;
-};
\ No newline at end of file
+
+	std::vector<int> const* m_queryEntities		= nullptr;
+	int						m_queryIndex		= -1;
+	int						m_queryFirstIndex	= 0;
+};
@@ -20,6 +20,32 @@ void System::ToggleIsActive()
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Const because the scheduler only holds const systems. Only RunSystem calls this, after the system's run, and the
+// scheduler never runs two instances of the same system at once, so the measured cost has one writer at a time and is
+// only read by that same RunSystem call before the run.
+//
+void System::RecordMeasuredCost(int numEntities, float seconds) const
+{
+	if (numEntities <= 0)
+	{
+		return;
+	}
+
+	// Smooth over a handful of ticks so one slow frame doesn't flip the job count back and forth
+	float secondsPerEntity = seconds / (float) numEntities;
+	if (m_measuredSecondsPerEntity <= 0.f)
+	{
+		m_measuredSecondsPerEntity = secondsPerEntity;
+	}
+	else
+	{
+		m_measuredSecondsPerEntity += (secondsPerEntity - m_measuredSecondsPerEntity) * 0.1f;
+	}
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 Rgba8 const& System::GetDebugTint() const
 {
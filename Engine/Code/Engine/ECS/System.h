@@ -45,6 +45,9 @@ public:
 	int	 GetGlobalPriority() const									{ return m_globalPriority; }
 	int	 GetSystemSplittingNumJobs() const							{ return m_systemSplittingNumJobs; }
 	void SetSystemSplittingNumJobs(int numThreads)					{ m_systemSplittingNumJobs = numThreads; }
+	BitMask GetSystemSplittingGroup() const							{ return m_systemSplittingGroupMask; }
+	float GetMeasuredSecondsPerEntity() const						{ return m_measuredSecondsPerEntity; }
+	void RecordMeasuredCost(int numEntities, float seconds) const;	// Called by the scheduler after each run
 	Name GetName() const											{ return m_name; }
 	Rgba8 const& GetDebugTint() const;
 
@@ -59,6 +62,10 @@ protected:
 	template<typename...CTypes>
 	void AddReadDependencies();
 
+	// The group Run iterates, so the scheduler can size split jobs by how many entities actually match
+	template<typename...CTypes>
+	void SetSystemSplittingGroup();
+
 	void AddWriteAllDependencies();
 
 private:
@@ -72,7 +79,9 @@ protected:
 	bool				m_isActive					= true;
 	bool				m_ignoreRun					= false;
 	bool				m_runWhilePaused			= true;
-	int					m_systemSplittingNumJobs	= 1; // 0-1 means do not split the system
+	int					m_systemSplittingNumJobs	= 1; // Max jobs to split into, 0-1 means do not split the system
+	BitMask				m_systemSplittingGroupMask	= 0; // 0 means the system's cost scales with all entities
+	mutable float		m_measuredSecondsPerEntity	= 0.f; // Rolling average, 0 until the system has run on some entities. See RecordMeasuredCost for threading.
 
 	int					m_localPriority				= -1;
 	int					m_globalPriority			= -1;
@@ -97,3 +106,13 @@ void System::AddReadDependencies()
 {
 	(m_readDependenciesBitMask |= ... |= GetComponentBitInternal(std::type_index(typeid(CTypes))));
 }
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename...CTypes>
+void System::SetSystemSplittingGroup()
+{
+	m_systemSplittingGroupMask = 0;
+	(m_systemSplittingGroupMask |= ... |= GetComponentBitInternal(std::type_index(typeid(CTypes))));
+}
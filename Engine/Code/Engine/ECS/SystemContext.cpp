@@ -1,6 +1,7 @@
 ﻿// Bradley Christensen - 2022-2026
 #include "SystemContext.h"
 #include "AdminSystem.h"
+#include "EntityCommandBuffer.h"
 #include "System.h"
 
 
@@ -73,6 +74,33 @@ bool SystemContext::DestroyEntity(EntityID entityID) const
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+EntityID SystemContext::Instantiate(EntityPrefab const& prefab) const
+{
+    ASSERT_OR_DIE(HasFullECSAccess(), "SystemContext::Instantiate - System does not have full ECS access, cannot create entity.");
+    return g_ecs->Instantiate(prefab);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int SystemContext::Instantiate(EntityPrefab const& prefab, int count, std::vector<EntityID>& out_ids) const
+{
+    ASSERT_OR_DIE(HasFullECSAccess(), "SystemContext::Instantiate - System does not have full ECS access, cannot create entities.");
+    return g_ecs->Instantiate(prefab, count, out_ids);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+EntityCommandBuffer& SystemContext::GetCommandBuffer() const
+{
+    ASSERT_OR_DIE(m_commandBuffer != nullptr, "SystemContext::GetCommandBuffer - Context was not created by the scheduler, no command buffer.");
+    return *m_commandBuffer;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void SystemContext::RemoveComponent(EntityID entityID, BitMask componentBit) const
 {
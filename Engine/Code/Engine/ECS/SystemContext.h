@@ -8,6 +8,8 @@
 
 
 class AdminSystem;
+class EntityCommandBuffer;
+class EntityPrefab;
 class System;
 
 
@@ -56,6 +58,12 @@ public:
     template <typename CType>
     MapStorage<CType> const& GetMapStorageConst() const;
 
+    template <typename CType>
+    SparseSetStorage<CType>& GetSparseSetStorage() const;
+
+    template <typename CType>
+    SparseSetStorage<CType> const& GetSparseSetStorageConst() const;
+
     template <typename CType>
     TagStorage<CType>& GetTagStorage() const;
 
@@ -77,6 +85,12 @@ public:
     EntityID CreateEntity(int searchBeginEntityID = 0) const;
     bool DestroyEntity(EntityID entityID) const;
 
+    EntityID Instantiate(EntityPrefab const& prefab) const;
+    int Instantiate(EntityPrefab const& prefab, int count, std::vector<EntityID>& out_ids) const;
+
+    // Structural changes without full ECS access, played back by the scheduler at the end of the subgraph
+    EntityCommandBuffer& GetCommandBuffer() const;
+
     //----------------------------------------------------------------------------------------------------------------------
     // ADD COMPONENTS
     //
@@ -129,11 +143,10 @@ public:
     float		    m_deltaSeconds				= 0.f;
 
     bool            m_isPreOrPostRun            = false;
+    EntityCommandBuffer* m_commandBuffer        = nullptr; // Owned by the scheduler, one per job
 
     // System Splitting Params
     bool		    m_didSystemSplit	        = false;
-    int	            m_startEntityID				= 0;
-    int	            m_endEntityID				= MAX_ENTITIES - 1;
     int			    m_systemSplittingJobID		= 0; // Index ranging from 0 to (SystemSplittingNumJobs - 1)
     int             m_systemSplittingNumJobs    = 0;
 };
@@ -240,6 +253,26 @@ MapStorage<CType> const& SystemContext::GetMapStorageConst() const
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+SparseSetStorage<CType>& SystemContext::GetSparseSetStorage() const
+{
+    ASSERT_OR_DIE(IsComponentAccessValid(typeid(CType), true), "SystemContext::GetSparseSetStorage - Does not have write access.");
+    return g_ecs->GetSparseSetStorage<CType>();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template <typename CType>
+SparseSetStorage<CType> const& SystemContext::GetSparseSetStorageConst() const
+{
+    ASSERT_OR_DIE(IsComponentAccessValid(typeid(CType), false), "SystemContext::GetSparseSetStorageConst - Does not have read access.");
+    return g_ecs->GetSparseSetStorage<CType>();
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 template <typename CType>
 TagStorage<CType>& SystemContext::GetTagStorage() const
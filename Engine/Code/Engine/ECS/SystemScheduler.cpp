@@ -2,6 +2,7 @@
 #include "SystemScheduler.h"
 #include "AdminSystem.h"
 #include "Config.h"
+#include "EntityCommandBuffer.h"
 #include "System.h"
 #include "SystemContext.h"
 #include "SystemSubgraph.h"
@@ -15,25 +16,24 @@
 
 
 //----------------------------------------------------------------------------------------------------------------------
-static std::string s_ecsSectionName = "ECS";
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-void RunSystem(SystemContext& context);
-void SplitSystem(SystemContext const& context, int numJobs);
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-// Calls PreRun, Run (or splits system into multiple RunSystemJob), and PostRun on a system
+// Calls Run on a system
 //
-struct AutoMultithreadedRunSystemJob : public Job
+struct SplitSystemJob : public Job
 {
 public:
 
-	explicit AutoMultithreadedRunSystemJob(SystemContext const& context) : m_context(context)
+	explicit SplitSystemJob(SystemContext const& context) : m_context(context)
+	{
+		// Owned and reused by a SplitSystemJobCache
+		m_needsComplete = true;
+		m_deleteAfterCompletion = false;
+		SetContext(context);
+	}
+
+	void SetContext(SystemContext const& context)
 	{
+		m_context = context;
+		m_context.m_commandBuffer = &m_commandBuffer;
 		m_priority = context.m_system->GetLocalPriority();
 		m_jobDependencies.m_readDependencies = context.m_system->GetReadDependencies();
 		m_jobDependencies.m_writeDependencies = context.m_system->GetWriteDependencies();
@@ -41,25 +41,63 @@ public:
 
 	virtual void Execute() override
 	{
-		RunSystem(m_context);
+		double startTime = Time::GetCurrentTimeSeconds();
+		m_context.m_system->Run(m_context);
+		m_runSeconds = (float) (Time::GetCurrentTimeSeconds() - startTime);
 	}
 
-protected:
+public:
 
 	SystemContext m_context;
+	EntityCommandBuffer m_commandBuffer;	// Appended to the system's own buffer once every split job is done
+	float m_runSeconds = 0.f;	// Time spent in Run, summed by SplitSystem to measure the system's total cost
 };
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-// Calls Run on a system
+// Split jobs and receipts reused every time a system splits, instead of allocating them per tick
 //
-struct SplitSystemJob : public Job
+struct SplitSystemJobCache
+{
+	~SplitSystemJobCache()
+	{
+		for (SplitSystemJob* job : m_jobs)
+		{
+			delete job;
+		}
+	}
+
+	std::vector<SplitSystemJob*> m_jobs;
+	std::vector<JobID> m_jobReceipts;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void RunSystem(SystemContext& context, SplitSystemJobCache& splitJobCache);
+float SplitSystem(SystemContext const& context, int numJobs, SplitSystemJobCache& splitJobCache);
+int CountSystemEntities(System const& system);
+int ChooseSystemSplittingNumJobs(System const& system, int numEntities);
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Calls PreRun, Run (or splits system into multiple RunSystemJob), and PostRun on a system
+//
+struct AutoMultithreadedRunSystemJob : public Job
 {
 public:
 
-	explicit SplitSystemJob(SystemContext const& context) : m_context(context)
+	explicit AutoMultithreadedRunSystemJob(SystemContext const& context) : m_context(context)
 	{
+		SetContext(context);
+	}
+
+	void SetContext(SystemContext const& context)
+	{
+		m_context = context;
+		m_context.m_commandBuffer = &m_commandBuffer;
 		m_priority = context.m_system->GetLocalPriority();
 		m_jobDependencies.m_readDependencies = context.m_system->GetReadDependencies();
 		m_jobDependencies.m_writeDependencies = context.m_system->GetWriteDependencies();
@@ -67,12 +105,31 @@ public:
 
 	virtual void Execute() override
 	{
-		m_context.m_system->Run(m_context);
+		// The graph is reused across ticks, so systems that shouldn't run this tick (e.g. paused) just no-op
+		if (m_context.m_system->ShouldRun(m_context.m_deltaSeconds))
+		{
+			RunSystem(m_context, m_splitJobCache);
+		}
 	}
 
-protected:
+public:
 
 	SystemContext m_context;
+	SplitSystemJobCache m_splitJobCache;
+	EntityCommandBuffer m_commandBuffer;	// Played back once the whole graph is done
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// A subgraph's systems, compiled into a job graph that is reused tick to tick
+//
+struct SystemJobGraph
+{
+	std::vector<System*> m_systems;					// Snapshot of the subgraph's systems when the graph was built
+	std::vector<bool> m_systemsActive;				// and whether each one was active
+	std::vector<AutoMultithreadedRunSystemJob*> m_runSystemJobs;
+	JobGraph m_jobGraph;
 };
 
 
@@ -80,7 +137,36 @@ protected:
 //----------------------------------------------------------------------------------------------------------------------
 SystemScheduler::SystemScheduler(AdminSystem* admin) : g_ecs(admin)
 {
+	m_mainThreadSplitJobs = new SplitSystemJobCache();
+	m_mainThreadCommandBuffer = new EntityCommandBuffer();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+SystemScheduler::~SystemScheduler()
+{
+	for (SystemJobGraph* jobGraph : m_jobGraphs)
+	{
+		if (jobGraph)
+		{
+			RecycleJobGraphJobs(*jobGraph);
+			delete jobGraph;
+		}
+	}
+	m_jobGraphs.clear();
 
+	for (AutoMultithreadedRunSystemJob* job : m_runSystemJobPool)
+	{
+		delete job;
+	}
+	m_runSystemJobPool.clear();
+
+	delete m_mainThreadSplitJobs;
+	m_mainThreadSplitJobs = nullptr;
+
+	delete m_mainThreadCommandBuffer;
+	m_mainThreadCommandBuffer = nullptr;
 }
 
 
@@ -146,13 +232,13 @@ void SystemScheduler::RunFrame(float deltaSeconds)
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void SystemScheduler::RunSubgraph(SystemSubgraph const& subgraph, float deltaSeconds) const
+void SystemScheduler::RunSubgraph(SystemSubgraphID subgraphID, SystemSubgraph const& subgraph, float deltaSeconds) const
 {
 	SystemSubgraph copy = subgraph;
 	std::sort(copy.m_systems.begin(), copy.m_systems.end(), SystemPriorityComparator);
 	
 	bool multithreaded = g_jobSystem && g_ecs->IsAutoMultithreadingActive();
-	TryRunSubgraph(copy, deltaSeconds, multithreaded);
+	TryRunSubgraph(subgraphID, copy, deltaSeconds, multithreaded);
 }
 
 
@@ -163,8 +249,6 @@ void SystemScheduler::SplitEntities(SystemContext& context, int jobID, int numJo
 	context.m_didSystemSplit = true;
 	context.m_systemSplittingJobID = jobID;
 	context.m_systemSplittingNumJobs = numJobs;
-
-	MathUtils::SplitIndices((int) MAX_ENTITIES, numJobs, jobID, context.m_startEntityID, context.m_endEntityID);
 }
 
 
@@ -172,9 +256,10 @@ void SystemScheduler::SplitEntities(SystemContext& context, int jobID, int numJo
 //----------------------------------------------------------------------------------------------------------------------
 void SystemScheduler::RunFrame_AutoMultithreaded(float deltaSeconds)
 {
-	for (SystemSubgraph* subgraph : m_systemSubgraphs)
+	// ScheduleFrame is given every subgraph, so a subgraph's index is its ID
+	for (SystemSubgraphID subgraphID = 0; subgraphID < m_systemSubgraphs.size(); ++subgraphID)
 	{
-		TryRunSubgraph(*subgraph, deltaSeconds, true);
+		TryRunSubgraph(subgraphID, *m_systemSubgraphs[subgraphID], deltaSeconds, true);
 	}
 }
 
@@ -183,16 +268,16 @@ void SystemScheduler::RunFrame_AutoMultithreaded(float deltaSeconds)
 //----------------------------------------------------------------------------------------------------------------------
 void SystemScheduler::RunFrame_Singlethreaded(float deltaSeconds)
 {
-	for (SystemSubgraph* subgraph : m_systemSubgraphs)
+	for (SystemSubgraphID subgraphID = 0; subgraphID < m_systemSubgraphs.size(); ++subgraphID)
 	{
-		TryRunSubgraph(*subgraph, deltaSeconds, false);
+		TryRunSubgraph(subgraphID, *m_systemSubgraphs[subgraphID], deltaSeconds, false);
 	}
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void SystemScheduler::TryRunSubgraph(SystemSubgraph& subgraph, float deltaSeconds, bool multithreaded) const
+void SystemScheduler::TryRunSubgraph(SystemSubgraphID subgraphID, SystemSubgraph& subgraph, float deltaSeconds, bool multithreaded) const
 {
 	if (subgraph.m_timeStep >= SYSTEM_MIN_TIME_STEP)
 	{
@@ -203,7 +288,7 @@ void SystemScheduler::TryRunSubgraph(SystemSubgraph& subgraph, float deltaSecond
 
 			if (multithreaded)
 			{
-				RunSubgraph_AutoMultithreaded(subgraph, subgraph.m_timeStep);
+				RunSubgraph_AutoMultithreaded(subgraphID, subgraph, subgraph.m_timeStep);
 			}
 			else RunSubgraph_Singlethreaded(subgraph, subgraph.m_timeStep);
 		}
@@ -213,7 +298,7 @@ void SystemScheduler::TryRunSubgraph(SystemSubgraph& subgraph, float deltaSecond
 		// Just call using deltaSeconds
 		if (multithreaded)
 		{
-			RunSubgraph_AutoMultithreaded(subgraph, deltaSeconds);
+			RunSubgraph_AutoMultithreaded(subgraphID, subgraph, deltaSeconds);
 		}
 		else RunSubgraph_Singlethreaded(subgraph, deltaSeconds);
 	}
@@ -222,16 +307,21 @@ void SystemScheduler::TryRunSubgraph(SystemSubgraph& subgraph, float deltaSecond
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void RunSystem(SystemContext& context)
+void RunSystem(SystemContext& context, SplitSystemJobCache& splitJobCache)
 {
 	PerfItemData perfItem;
 	perfItem.m_tint = context.m_system->GetDebugTint();
 	perfItem.m_startTime = Time::GetCurrentTimeSeconds();
 
-	int systemSplittingNumJobs = context.m_system->GetSystemSplittingNumJobs();
-	if (g_ecs->IsSystemSplittingActive() && systemSplittingNumJobs > 1)
+	// Only systems that are allowed to split need their entities counted and their cost measured
+	bool canSplit = g_ecs->IsSystemSplittingActive() && context.m_system->GetSystemSplittingNumJobs() > 1;
+	int numEntities = canSplit ? CountSystemEntities(*context.m_system) : 0;
+	int systemSplittingNumJobs = canSplit ? ChooseSystemSplittingNumJobs(*context.m_system, numEntities) : 1;
+
+	float costSeconds = 0.f;
+	if (systemSplittingNumJobs > 1)
 	{
-		SplitSystem(context, systemSplittingNumJobs);
+		costSeconds = SplitSystem(context, systemSplittingNumJobs, splitJobCache);
 	}
 	else
 	{
@@ -247,28 +337,85 @@ void RunSystem(SystemContext& context)
 
 	perfItem.m_endTime = Time::GetCurrentTimeSeconds();
 
+	if (canSplit)
+	{
+		if (systemSplittingNumJobs <= 1)
+		{
+			costSeconds = (float) (perfItem.m_endTime - perfItem.m_startTime);
+		}
+		context.m_system->RecordMeasuredCost(numEntities, costSeconds);
+	}
+
 	if (g_performanceDebugWindow)
 	{
-		g_performanceDebugWindow->LogItem(perfItem, s_ecsSectionName, context.m_system->GetName());
+		g_performanceDebugWindow->LogItem(perfItem, STATIC_NAME("ECS"), context.m_system->GetName());
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int CountSystemEntities(System const& system)
+{
+	BitMask splittingGroup = system.GetSystemSplittingGroup();
+	if (splittingGroup != 0)
+	{
+		return g_ecs->CountGroup(splittingGroup);
+	}
+	return g_ecs->NumEntities();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Picks how many jobs to split into this tick: never more than the system's max, never so many that a job gets fewer
+// than SYSTEM_SPLITTING_MIN_ENTITIES_PER_JOB, and once the system has been measured, only as many as its cost is worth.
+//
+int ChooseSystemSplittingNumJobs(System const& system, int numEntities)
+{
+	int numJobs = MathUtils::Min(system.GetSystemSplittingNumJobs(), numEntities / SYSTEM_SPLITTING_MIN_ENTITIES_PER_JOB);
+
+	float secondsPerEntity = system.GetMeasuredSecondsPerEntity();
+	if (secondsPerEntity > 0.f)
+	{
+		float estimatedCostSeconds = secondsPerEntity * (float) numEntities;
+		if (estimatedCostSeconds < SYSTEM_SPLITTING_MIN_COST_SECONDS)
+		{
+			return 1;
+		}
+
+		int numJobsForCost = MathUtils::CeilingF(estimatedCostSeconds / SYSTEM_SPLITTING_TARGET_JOB_COST_SECONDS);
+		numJobs = MathUtils::Min(numJobs, numJobsForCost);
 	}
+
+	return MathUtils::Max(numJobs, 1);
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void SplitSystem(SystemContext const& context, int numJobs)
+// Returns the total time spent in PreRun, every split Run and PostRun, rather than wall time, so the measured cost
+// doesn't shrink just because the work was split.
+//
+float SplitSystem(SystemContext const& context, int numJobs, SplitSystemJobCache& splitJobCache)
 {
 	// Split system into multiple run jobs (this can be significantly slower than single threaded if the entity count is low
-	std::vector<JobID> jobReceipts;
+	std::vector<JobID>& jobReceipts = splitJobCache.m_jobReceipts;
 	jobReceipts.clear();
-	jobReceipts.resize(numJobs);
 
 	SystemContext splitContext = context;
 	splitContext.m_didSystemSplit = true;
 	splitContext.m_systemSplittingNumJobs = numJobs;
 
+	while ((int) splitJobCache.m_jobs.size() < numJobs)
+	{
+		splitJobCache.m_jobs.push_back(new SplitSystemJob(splitContext));
+	}
+
+	double preRunStartTime = Time::GetCurrentTimeSeconds();
 	splitContext.m_isPreOrPostRun = true;
 	splitContext.m_system->PreRun(splitContext);
+	float costSeconds = (float) (Time::GetCurrentTimeSeconds() - preRunStartTime);
 
 	splitContext.m_isPreOrPostRun = false;
 	for (int systemSplittingJobID = 0; systemSplittingJobID < numJobs; ++systemSplittingJobID)
@@ -276,16 +423,32 @@ void SplitSystem(SystemContext const& context, int numJobs)
 		// Copy the context, but split the entities amongst them
 		SystemScheduler::SplitEntities(splitContext, systemSplittingJobID, numJobs);
 		
-		Job* job = new SplitSystemJob(splitContext);
-		jobReceipts[systemSplittingJobID] = g_jobSystem->PostJob(job);
+		SplitSystemJob* job = splitJobCache.m_jobs[systemSplittingJobID];
+		job->SetContext(splitContext);
+		jobReceipts.push_back(g_jobSystem->PostJob(job));
 	}
 
 	// Block until all the split jobs are complete
 	g_jobSystem->CompleteJobs(jobReceipts);
 
+	for (int systemSplittingJobID = 0; systemSplittingJobID < numJobs; ++systemSplittingJobID)
+	{
+		SplitSystemJob* job = splitJobCache.m_jobs[systemSplittingJobID];
+		costSeconds += job->m_runSeconds;
+
+		// Fold each job's commands into the system's buffer in job order, so playback order doesn't depend on timing
+		if (context.m_commandBuffer)
+		{
+			context.m_commandBuffer->Append(job->m_commandBuffer);
+		}
+	}
 
+	double postRunStartTime = Time::GetCurrentTimeSeconds();
 	splitContext.m_isPreOrPostRun = true;
 	splitContext.m_system->PostRun(splitContext);
+	costSeconds += (float) (Time::GetCurrentTimeSeconds() - postRunStartTime);
+
+	return costSeconds;
 }
 
 
@@ -303,8 +466,12 @@ void SystemScheduler::RunSubgraph_Singlethreaded(SystemSubgraph const& subgraph,
 		}
 
 		SystemContext context(system, deltaSeconds);
-		RunSystem(context);
+		context.m_commandBuffer = m_mainThreadCommandBuffer;
+		RunSystem(context, *m_mainThreadSplitJobs);
 	}
+
+	// Sync point, nothing else is running
+	m_mainThreadCommandBuffer->Playback(*g_ecs);
 }
 
 
@@ -313,25 +480,106 @@ void SystemScheduler::RunSubgraph_Singlethreaded(SystemSubgraph const& subgraph,
 // Uses a job graph to run a single system subgraph
 // - so system calls within that subgraph can happen simultaneously
 //
-void SystemScheduler::RunSubgraph_AutoMultithreaded(SystemSubgraph const& subgraph, float deltaSeconds) const
+void SystemScheduler::RunSubgraph_AutoMultithreaded(SystemSubgraphID subgraphID, SystemSubgraph const& subgraph, float deltaSeconds) const
 {
-	JobGraph jobGraph;
-	jobGraph.Reserve(subgraph.m_systems.size());
-	
-	for (System* const& system : subgraph.m_systems)
+	SystemJobGraph& jobGraph = GetOrBuildJobGraph(subgraphID, subgraph);
+	for (AutoMultithreadedRunSystemJob* job : jobGraph.m_runSystemJobs)
 	{
-		if (!system->ShouldRun(deltaSeconds))
+		job->m_context.m_deltaSeconds = deltaSeconds;
+	}
+
+	g_jobSystem->ExecuteJobGraph(jobGraph.m_jobGraph);
+
+	// Sync point, every job in the graph is done. Play back in system priority order so results are deterministic
+	for (AutoMultithreadedRunSystemJob* job : jobGraph.m_runSystemJobs)
+	{
+		job->m_commandBuffer.Playback(*g_ecs);
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Each subgraph has one cached graph, rebuilt in place when the subgraph's systems, their order or active state change.
+// Matched by ID rather than address, since RunSubgraph runs a sorted copy.
+//
+SystemJobGraph& SystemScheduler::GetOrBuildJobGraph(SystemSubgraphID subgraphID, SystemSubgraph const& subgraph) const
+{
+	if (subgraphID >= m_jobGraphs.size())
+	{
+		m_jobGraphs.resize(subgraphID + 1, nullptr);
+	}
+
+	SystemJobGraph*& jobGraph = m_jobGraphs[subgraphID];
+	if (!jobGraph)
+	{
+		jobGraph = new SystemJobGraph();
+		BuildJobGraph(*jobGraph, subgraph);
+		return *jobGraph;
+	}
+
+	bool isStale = (jobGraph->m_systems != subgraph.m_systems);
+	for (int i = 0; !isStale && i < (int) subgraph.m_systems.size(); ++i)
+	{
+		isStale = (subgraph.m_systems[i]->IsActive() != jobGraph->m_systemsActive[i]);
+	}
+
+	if (isStale)
+	{
+		BuildJobGraph(*jobGraph, subgraph);
+	}
+	return *jobGraph;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void SystemScheduler::BuildJobGraph(SystemJobGraph& jobGraph, SystemSubgraph const& subgraph) const
+{
+	RecycleJobGraphJobs(jobGraph);
+
+	jobGraph.m_systems = subgraph.m_systems;
+	jobGraph.m_systemsActive.clear();
+	jobGraph.m_jobGraph.Reserve(subgraph.m_systems.size());
+
+	for (System* system : subgraph.m_systems)
+	{
+		jobGraph.m_systemsActive.push_back(system->IsActive());
+		if (!system->IsActive())
 		{
 			continue;
 		}
 
-		SystemContext context(system, deltaSeconds);
-		Job* job = new AutoMultithreadedRunSystemJob(context);
-		jobGraph.AddJob(job);
+		SystemContext context(system);
+		AutoMultithreadedRunSystemJob* job = nullptr;
+		if (!m_runSystemJobPool.empty())
+		{
+			job = m_runSystemJobPool.back();
+			m_runSystemJobPool.pop_back();
+			job->SetContext(context);
+		}
+		else job = new AutoMultithreadedRunSystemJob(context);
+
+		jobGraph.m_runSystemJobs.push_back(job);
+		jobGraph.m_jobGraph.AddJob(job);
+	}
+
+	jobGraph.m_jobGraph.Compile();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void SystemScheduler::RecycleJobGraphJobs(SystemJobGraph& jobGraph) const
+{
+	for (AutoMultithreadedRunSystemJob* job : jobGraph.m_runSystemJobs)
+	{
+		m_runSystemJobPool.push_back(job);
 	}
-	g_jobSystem->ExecuteJobGraph(jobGraph);
+	jobGraph.m_runSystemJobs.clear();
 
-	jobGraph.Cleanup();
+	// The pool owns the jobs now, so the graph forgets them without deleting
+	jobGraph.m_jobGraph.RemoveAllJobs();
 }
 
 
@@ -1,13 +1,17 @@
 // Bradley Christensen - 2022-2026
 #pragma once
+#include "SystemSubgraph.h"
 #include <vector>
 
 
 
 class AdminSystem;
+class EntityCommandBuffer;
 class System;
-class SystemSubgraph;
 struct SystemContext;
+struct SystemJobGraph;
+struct SplitSystemJobCache;
+struct AutoMultithreadedRunSystemJob;
 
 
 
@@ -17,10 +21,11 @@ class SystemScheduler
 public:
 
 	explicit SystemScheduler(AdminSystem* admin);
+	~SystemScheduler();
 
 	void ScheduleFrame(std::vector<SystemSubgraph>& systems);
 	void RunFrame(float deltaSeconds);
-	void RunSubgraph(SystemSubgraph const& subgraph, float deltaSeconds) const;
+	void RunSubgraph(SystemSubgraphID subgraphID, SystemSubgraph const& subgraph, float deltaSeconds) const;
 
 	static void SplitEntities(SystemContext& context, int jobID, int numJobs);
 
@@ -30,13 +35,23 @@ private:
 	void RunFrame_Singlethreaded(float deltaSeconds);
 
 	// Runs a system 0+ times based on its time step params
-	void TryRunSubgraph(SystemSubgraph& subgraph, float deltaSeconds, bool multithreaded) const;
+	void TryRunSubgraph(SystemSubgraphID subgraphID, SystemSubgraph& subgraph, float deltaSeconds, bool multithreaded) const;
 	
 	void RunSubgraph_Singlethreaded(SystemSubgraph const& subgraph, float deltaSeconds) const;
-	void RunSubgraph_AutoMultithreaded(SystemSubgraph const& subgraph, float deltaSeconds) const;
+	void RunSubgraph_AutoMultithreaded(SystemSubgraphID subgraphID, SystemSubgraph const& subgraph, float deltaSeconds) const;
+
+	// Job graphs are built once per subgraph and reused every tick, until its systems, their order or active state change
+	SystemJobGraph& GetOrBuildJobGraph(SystemSubgraphID subgraphID, SystemSubgraph const& subgraph) const;
+	void BuildJobGraph(SystemJobGraph& jobGraph, SystemSubgraph const& subgraph) const;
+	void RecycleJobGraphJobs(SystemJobGraph& jobGraph) const;
 	
 	void Cleanup();
 
 	AdminSystem* g_ecs = nullptr;
 	std::vector<SystemSubgraph*> m_systemSubgraphs;
+
+	mutable std::vector<SystemJobGraph*> m_jobGraphs;					// Indexed by subgraph ID, nullptr until the subgraph first runs multithreaded
+	mutable std::vector<AutoMultithreadedRunSystemJob*> m_runSystemJobPool;
+	SplitSystemJobCache* m_mainThreadSplitJobs = nullptr;	// Split jobs for systems run single threaded from the main thread
+	EntityCommandBuffer* m_mainThreadCommandBuffer = nullptr;
 };
@@ -4,6 +4,7 @@
 #include "Engine/Math/Vec2.h"
 #include "Engine/Math/IntVec2.h"
 #include "Engine/Math/AABB2.h"
+#include <vector>
 
 
 
@@ -378,3 +379,163 @@ float Noise::GetPerlinNoise2D_01(float x, float y, float scale, unsigned int num
 	float noise = GetPerlinNoise2D(x, y, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed);
 	return noise * 0.5f + 0.5f;
 }
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Same math as GetPerlinNoise2D, in the same order, restructured for grids:
+// - Sample x only depends on the column and sample y only on the row, so floors, offsets and weights are per axis
+// - Each lattice point's gradient is hashed once per octave and shared by the (up to) 4 cells touching it
+// - The per sample loop only reads the per axis arrays and the shared gradients, with no hashing or flooring in it
+//
+void Noise::GetPerlinNoise2DGrid(float* out_noise, int originX, int originY, int width, int height, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed, float const* perSampleOctavePersistence)
+{
+	constexpr float OCTAVE_OFFSET = 0.636764989593174f; // Translation/bias to add to each octave
+	constexpr float gradientsX[8] = { +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f, +0.382683432f, +0.923879533f };
+	constexpr float gradientsY[8] = { +0.382683432f, +0.923879533f, +0.923879533f, +0.382683432f, -0.382683432f, -0.923879533f, -0.923879533f, -0.382683432f };
+
+	int numSamples = width * height;
+	if (numSamples <= 0)
+	{
+		return;
+	}
+
+	// Per axis sample locations, and per octave cell data
+	std::vector<float> sampleX(width), sampleY(height);
+	std::vector<int> cellX(width), cellY(height);
+	std::vector<float> toSampleLeft(width), toSampleRight(width), weightRight(width);
+	std::vector<float> toSampleBot(height), toSampleTop(height), weightTop(height);
+	std::vector<unsigned char> latticeGradients;
+
+	float oneOverScale = 1.f / scale;
+	for (int x = 0; x < width; ++x)
+	{
+		sampleX[x] = (float) (originX + x) * oneOverScale + OCTAVE_OFFSET;
+	}
+	for (int y = 0; y < height; ++y)
+	{
+		sampleY[y] = (float) (originY + y) * oneOverScale + OCTAVE_OFFSET;
+	}
+
+	std::vector<float> persistence(numSamples, 1.f);
+	std::vector<float> maxAmplitude(numSamples, 0.f);
+	for (int i = 0; i < numSamples; ++i)
+	{
+		out_noise[i] = 0.f;
+	}
+
+	for (unsigned int octaveIndex = 0; octaveIndex < numOctaves; ++octaveIndex)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			float cellLeft = (float) MathUtils::FloorF(sampleX[x]);
+			cellX[x] = (int) cellLeft;
+			toSampleLeft[x] = sampleX[x] - cellLeft;
+			toSampleRight[x] = sampleX[x] - (cellLeft + 1.f);
+			weightRight[x] = MathUtils::SmoothStep3(toSampleLeft[x]);
+		}
+		for (int y = 0; y < height; ++y)
+		{
+			float cellBot = (float) MathUtils::FloorF(sampleY[y]);
+			cellY[y] = (int) cellBot;
+			toSampleBot[y] = sampleY[y] - cellBot;
+			toSampleTop[y] = sampleY[y] - (cellBot + 1.f);
+			weightTop[y] = MathUtils::SmoothStep3(toSampleBot[y]);
+		}
+
+		// Sample locations increase with x and y, so the lattice under the grid is the first to last cell plus one
+		int latticeMinX = cellX[0];
+		int latticeMinY = cellY[0];
+		int latticeWidth = cellX[width - 1] - latticeMinX + 2;
+		int latticeHeight = cellY[height - 1] - latticeMinY + 2;
+		latticeGradients.resize(latticeWidth * latticeHeight);
+		for (int latticeY = 0; latticeY < latticeHeight; ++latticeY)
+		{
+			for (int latticeX = 0; latticeX < latticeWidth; ++latticeX)
+			{
+				unsigned int noise = GetRawNoise2D(latticeMinX + latticeX, latticeMinY + latticeY, seed);
+				latticeGradients[latticeY * latticeWidth + latticeX] = (unsigned char) (noise & 0x0000'0007);
+			}
+		}
+
+		for (int y = 0; y < height; ++y)
+		{
+			unsigned char const* latticeBot = latticeGradients.data() + (cellY[y] - latticeMinY) * latticeWidth;
+			unsigned char const* latticeTop = latticeBot + latticeWidth;
+			float botToSampleY = toSampleBot[y];
+			float topToSampleY = toSampleTop[y];
+			float weightTopY = weightTop[y];
+			float weightBotY = 1.f - weightTopY;
+
+			float* rowNoise = out_noise + y * width;
+			float* rowPersistence = persistence.data() + y * width;
+			float* rowMaxAmplitude = maxAmplitude.data() + y * width;
+			for (int x = 0; x < width; ++x)
+			{
+				int latticeX = cellX[x] - latticeMinX;
+				int botLeft = latticeBot[latticeX];
+				int botRight = latticeBot[latticeX + 1];
+				int topLeft = latticeTop[latticeX];
+				int topRight = latticeTop[latticeX + 1];
+
+				float dotBotLeft = toSampleLeft[x] * gradientsX[botLeft] + botToSampleY * gradientsY[botLeft];
+				float dotTopLeft = toSampleLeft[x] * gradientsX[topLeft] + topToSampleY * gradientsY[topLeft];
+				float dotTopRight = toSampleRight[x] * gradientsX[topRight] + topToSampleY * gradientsY[topRight];
+				float dotBotRight = toSampleRight[x] * gradientsX[botRight] + botToSampleY * gradientsY[botRight];
+
+				float weightRightX = weightRight[x];
+				float weightLeftX = 1.f - weightRightX;
+				float blendBot = (weightLeftX * dotBotLeft) + (weightRightX * dotBotRight);
+				float blendTop = (weightLeftX * dotTopLeft) + (weightRightX * dotTopRight);
+				float blendTotal = weightTopY * blendTop + weightBotY * blendBot;
+				float noiseThisOctave = blendTotal * (1.f / 0.662578106f); // 2D Perlin is in [-.662578106,.662578106]; map to ~[-1,1]
+
+				rowNoise[x] += noiseThisOctave * rowPersistence[x];
+				rowMaxAmplitude[x] += rowPersistence[x];
+			}
+		}
+
+		// Set data for next iteration
+		for (int i = 0; i < numSamples; ++i)
+		{
+			persistence[i] *= perSampleOctavePersistence ? perSampleOctavePersistence[i] : octavePersistence;
+		}
+		for (int x = 0; x < width; ++x)
+		{
+			sampleX[x] *= octaveScale;
+			sampleX[x] += OCTAVE_OFFSET;
+		}
+		for (int y = 0; y < height; ++y)
+		{
+			sampleY[y] *= octaveScale;
+			sampleY[y] += OCTAVE_OFFSET;
+		}
+		++seed;
+	}
+
+	if (renormalize)
+	{
+		for (int i = 0; i < numSamples; ++i)
+		{
+			if (maxAmplitude[i] > 0)
+			{
+				float totalNoise = out_noise[i] / maxAmplitude[i];
+				totalNoise = (totalNoise * 0.5f) + 0.5f;
+				totalNoise = MathUtils::SmoothStep3(totalNoise);
+				out_noise[i] = (totalNoise * 2.0f) - 1.f;
+			}
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void Noise::GetPerlinNoise2DGrid_01(float* out_noise, int originX, int originY, int width, int height, float scale, unsigned int numOctaves, float octavePersistence, float octaveScale, bool renormalize, unsigned int seed, float const* perSampleOctavePersistence)
+{
+	GetPerlinNoise2DGrid(out_noise, originX, originY, width, height, scale, numOctaves, octavePersistence, octaveScale, renormalize, seed, perSampleOctavePersistence);
+	for (int i = 0; i < width * height; ++i)
+	{
+		out_noise[i] = out_noise[i] * 0.5f + 0.5f;
+	}
+}
@@ -45,6 +45,17 @@ namespace Noise
 	float GetPerlinNoise1D_01(float position, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
 	float GetPerlinNoise2D(float x, float y, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
 	float GetPerlinNoise2D_01(float x, float y, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0);
+
+	//----------------------------------------------------------------------------------------------------------------------
+	// Perlin Noise Grid
+	// 
+	// Fills out_noise (width * height, row major) with GetPerlinNoise2D sampled at every integer point from 
+	// (originX, originY) to (originX + width - 1, originY + height - 1). Much faster than sampling each point separately.
+	// 
+	// perSampleOctavePersistence is optional (width * height, row major), and overrides octavePersistence for each sample.
+	//
+	void GetPerlinNoise2DGrid(float* out_noise, int originX, int originY, int width, int height, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0, float const* perSampleOctavePersistence = nullptr);
+	void GetPerlinNoise2DGrid_01(float* out_noise, int originX, int originY, int width, int height, float scale = 1.f, unsigned int numOctaves = 1, float octavePersistence = 0.5f, float octaveScale = 2.f, bool renormalize = true, unsigned int seed = 0, float const* perSampleOctavePersistence = nullptr);
 }
 
 
@@ -84,6 +84,14 @@ uint32_t Job::GetUniqueID() const
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+JobGraph const* Job::GetOwningGraph() const
+{
+    return m_owningGraph;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 bool Job::operator<(Job const& rhs) const
 {
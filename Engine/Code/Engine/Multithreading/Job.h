@@ -6,6 +6,10 @@
 
 
 
+struct JobGraph;
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 enum class JobStatus : uint8_t
 {
@@ -45,6 +49,7 @@ public:
     bool IsValid() const;
     bool HasDependencies() const;
     uint32_t GetUniqueID() const;
+    JobGraph const* GetOwningGraph() const;
 
     bool operator<(Job const& rhs) const;
 
@@ -61,4 +66,8 @@ protected:
     bool                m_needsComplete                 = true;
     bool                m_deleteAfterCompletion         = true;
     int                 m_priority                      = -1;       // Lower is better
+
+    // Set while the job is running as part of a JobGraph, so finishing it can release its successors
+    JobGraph*           m_owningGraph                   = nullptr;
+    int                 m_graphJobIndex                 = -1;
 };
\ No newline at end of file
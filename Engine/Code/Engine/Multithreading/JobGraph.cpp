@@ -8,7 +8,7 @@
 void JobGraph::AddJob(Job* job)
 {
     m_jobs.push_back(job);
-    SortByPriority();
+    m_isCompiled = false;
 
     job->SetNeedsComplete(true);            // all jobs in a job graph must be completed
     job->SetDeleteAfterCompletion(false);   // job graphs may be recurring, so don't delete the jobs
@@ -17,32 +17,78 @@ void JobGraph::AddJob(Job* job)
 
 
 //----------------------------------------------------------------------------------------------------------------------
-bool JobGraph::IsComplete() const
+void JobGraph::Compile()
 {
-    for (auto& status : m_jobStatuses)
+    SortByPriority();
+
+    int numJobs = (int) m_jobs.size();
+    m_numPredecessors.assign(numJobs, 0);
+    m_successorsBegin.assign((size_t) numJobs + 1, 0);
+    m_successors.clear();
+    m_rootJobs.clear();
+
+    for (int jobIndex = 0; jobIndex < numJobs; ++jobIndex)
+    {
+        m_successorsBegin[jobIndex] = (int) m_successors.size();
+
+        // Any later (lower priority) job sharing dependencies with this one has to wait for it
+        JobDependencies const& jobDeps = m_jobs[jobIndex]->GetJobDependencies();
+        for (int jobAfterIndex = jobIndex + 1; jobAfterIndex < numJobs; ++jobAfterIndex)
+        {
+            if (jobDeps.SharesDependencies(m_jobs[jobAfterIndex]->GetJobDependencies()))
+            {
+                m_successors.push_back(jobAfterIndex);
+                ++m_numPredecessors[jobAfterIndex];
+            }
+        }
+    }
+    m_successorsBegin[numJobs] = (int) m_successors.size();
+
+    for (int jobIndex = 0; jobIndex < numJobs; ++jobIndex)
     {
-        if (status != JobStatus::Completed)
+        if (m_numPredecessors[jobIndex] == 0)
         {
-            return false;
+            m_rootJobs.push_back(jobIndex);
         }
     }
-    return true;
+
+    m_remainingPredecessors = std::make_unique<std::atomic<int>[]>(numJobs);
+    m_isCompiled = true;
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void JobGraph::Cleanup()
+bool JobGraph::IsComplete() const
 {
-    m_jobReceipts.clear();
-    m_jobStatuses.clear();
-    m_jobDeps.clear();
+    return m_numJobsRemaining == 0;
+}
 
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void JobGraph::Cleanup()
+{
     for (auto& job : m_jobs)
     {
         delete job;
     }
+    RemoveAllJobs();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void JobGraph::RemoveAllJobs()
+{
     m_jobs.clear();
+
+    m_numPredecessors.clear();
+    m_successorsBegin.clear();
+    m_successors.clear();
+    m_rootJobs.clear();
+    m_remainingPredecessors.reset();
+    m_isCompiled = false;
 }
 
 
@@ -55,19 +101,43 @@ void JobGraph::Reserve(size_t numExpectedJobs)
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+int JobGraph::GetNumJobs() const
+{
+    return (int) m_jobs.size();
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void JobGraph::Reset()
 {
-    m_jobReceipts.clear();
-    m_jobStatuses.clear();
-    m_jobDeps.clear();
-    
-    m_jobReceipts.resize(m_jobs.size(), JobID::Invalid);
-    m_jobStatuses.resize(m_jobs.size(), JobStatus::Null);
-    
-    for (auto& job : m_jobs)
+    if (!m_isCompiled)
     {
-        m_jobDeps.push_back(job->GetJobDependencies());
+        Compile();
+    }
+
+    for (int jobIndex = 0; jobIndex < (int) m_jobs.size(); ++jobIndex)
+    {
+        m_remainingPredecessors[jobIndex] = m_numPredecessors[jobIndex];
+    }
+    m_numJobsRemaining = (int) m_jobs.size();
+
+    std::unique_lock lock(m_completionMutex);
+    m_isComplete = m_jobs.empty();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void JobGraph::MarkJobExecuted()
+{
+    if (m_numJobsRemaining.fetch_sub(1) == 1)
+    {
+        // Last one out. Notify under the lock so the waiting thread can't return and destroy the graph mid-notify.
+        std::unique_lock lock(m_completionMutex);
+        m_isComplete = true;
+        m_completionCondVar.notify_all();
     }
 }
 
@@ -84,5 +154,5 @@ bool SortJobsByPrioPredicate(Job const* lhs, Job const* rhs)
 //----------------------------------------------------------------------------------------------------------------------
 void JobGraph::SortByPriority()
 {
-    std::sort(m_jobs.begin(), m_jobs.end(), SortJobsByPrioPredicate);
-} 
\ No newline at end of file
+    std::stable_sort(m_jobs.begin(), m_jobs.end(), SortJobsByPrioPredicate);
+}
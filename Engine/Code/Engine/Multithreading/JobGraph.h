@@ -1,5 +1,9 @@
 ﻿// Bradley Christensen - 2022-2026
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include "Job.h"
 #include "JobID.h"
@@ -11,28 +15,54 @@
 //
 // A graph of jobs where each job will complete as it becomes available for it to do so
 //
+// Before the first execution the graph is compiled into explicit edges: job B depends on an earlier (higher priority)
+// job A if they share read/write dependencies. Each execution then only posts the roots, and whichever thread finishes
+// a job decrements its successors' predecessor counters and posts the ones that hit zero.
+//
 struct JobGraph
 {
     friend class JobSystem;
 
 public:
 
+    JobGraph() = default;
+    JobGraph(JobGraph const&) = delete;
+    JobGraph& operator=(JobGraph const&) = delete;
+
     void AddJob(Job* job);
+    void Compile();
     bool IsComplete() const;
     void Cleanup();
+    void RemoveAllJobs();   // Like Cleanup, but for callers that own the jobs and don't want them deleted
     void Reserve(size_t numExpectedJobs);
+    int GetNumJobs() const;
     
 protected:
     
     void Reset();
     void SortByPriority();
+    void MarkJobExecuted();
     
 protected:
     
     std::vector<Job*> m_jobs;
 
+    // Compiled data, rebuilt whenever jobs are added
+    bool m_isCompiled = false;
+    std::vector<int> m_numPredecessors;
+    std::vector<int> m_successorsBegin;     // Successors of job i are m_successors[m_successorsBegin[i], m_successorsBegin[i + 1])
+    std::vector<int> m_successors;
+    std::vector<int> m_rootJobs;
+
     // Transient data
-    std::vector<JobID> m_jobReceipts;
-    std::vector<JobStatus> m_jobStatuses;
-    std::vector<JobDependencies> m_jobDeps;
-};
\ No newline at end of file
+    std::unique_ptr<std::atomic<int>[]> m_remainingPredecessors;
+    std::atomic<int> m_numJobsRemaining = 0;
+
+    // The executing thread sleeps on m_completionCondVar when none of the graph's jobs are queued. Posting a graph job
+    // bumps m_numJobsPosted and wakes it if m_isHelperWaiting, so it can help again instead of only waiting for the end.
+    std::mutex m_completionMutex;
+    std::condition_variable m_completionCondVar;
+    bool m_isComplete = true;               // Guarded by m_completionMutex
+    std::atomic<int> m_numJobsPosted = 0;
+    std::atomic<bool> m_isHelperWaiting = false;
+};
@@ -0,0 +1,161 @@
+﻿// Bradley Christensen - 2022-2026
+#include "JobQueue.h"
+#include "Job.h"
+#include <algorithm>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void JobQueue::Push(Job* job)
+{
+    std::unique_lock lock(m_mutex);
+    m_heap.push_back(job);
+    std::push_heap(m_heap.begin(), m_heap.end(), RunsAfter);
+    ++m_count;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Job* JobQueue::TryPop()
+{
+    if (IsEmpty())
+    {
+        return nullptr;
+    }
+
+    std::unique_lock lock(m_mutex);
+    if (m_heap.empty())
+    {
+        return nullptr;
+    }
+
+    std::pop_heap(m_heap.begin(), m_heap.end(), RunsAfter);
+    Job* result = m_heap.back();
+    m_heap.pop_back();
+    --m_count;
+    return result;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Job* JobQueue::TryRemove(JobID jobID)
+{
+    if (IsEmpty())
+    {
+        return nullptr;
+    }
+
+    std::unique_lock lock(m_mutex);
+    for (int i = 0; i < (int) m_heap.size(); ++i)
+    {
+        Job* job = m_heap[i];
+        if (job->GetUniqueID() == jobID.m_uniqueID)
+        {
+            RemoveAt(i);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Job* JobQueue::TryRemoveAny(std::vector<JobID> const& jobIDs)
+{
+    if (IsEmpty())
+    {
+        return nullptr;
+    }
+
+    std::unique_lock lock(m_mutex);
+    for (int i = 0; i < (int) m_heap.size(); ++i)
+    {
+        Job* job = m_heap[i];
+        for (JobID const& jobID : jobIDs)
+        {
+            if (jobID != JobID::Invalid && job->GetUniqueID() == jobID.m_uniqueID)
+            {
+                RemoveAt(i);
+                return job;
+            }
+        }
+    }
+    return nullptr;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Removes the graph's job that would run first, so helping with a graph keeps its priority order
+//
+Job* JobQueue::TryRemoveAnyFromGraph(JobGraph const* graph)
+{
+    if (IsEmpty())
+    {
+        return nullptr;
+    }
+
+    std::unique_lock lock(m_mutex);
+    int bestIndex = -1;
+    for (int i = 0; i < (int) m_heap.size(); ++i)
+    {
+        Job* job = m_heap[i];
+        if (job->GetOwningGraph() == graph && (bestIndex == -1 || RunsAfter(m_heap[bestIndex], job)))
+        {
+            bestIndex = i;
+        }
+    }
+
+    if (bestIndex == -1)
+    {
+        return nullptr;
+    }
+
+    Job* result = m_heap[bestIndex];
+    RemoveAt(bestIndex);
+    return result;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool JobQueue::IsEmpty() const
+{
+    return m_count.load(std::memory_order_relaxed) == 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int JobQueue::Count() const
+{
+    return m_count;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void JobQueue::RemoveAt(int heapIndex)
+{
+    // Must already hold the lock
+    m_heap[heapIndex] = m_heap.back();
+    m_heap.pop_back();
+    std::make_heap(m_heap.begin(), m_heap.end(), RunsAfter);
+    --m_count;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool JobQueue::RunsAfter(Job const* lhs, Job const* rhs)
+{
+    // std heaps keep the "largest" element at the front, so lhs is "less" if it should run after rhs
+    if (lhs->GetJobPriority() != rhs->GetJobPriority())
+    {
+        return lhs->GetJobPriority() > rhs->GetJobPriority();
+    }
+    return lhs->GetUniqueID() > rhs->GetUniqueID();
+}
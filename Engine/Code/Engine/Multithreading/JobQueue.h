@@ -0,0 +1,45 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "JobID.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+
+
+class Job;
+struct JobGraph;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Job Queue
+//
+// One worker's share of the posted jobs: a priority heap (lowest Job::m_priority first, then oldest first) behind its
+// own lock. Each general worker owns one and steals from the others when it runs dry, so posting and popping from
+// many threads don't all contend on a single mutex.
+//
+class JobQueue
+{
+public:
+
+    void Push(Job* job);
+    Job* TryPop();
+    Job* TryRemove(JobID jobID);
+    Job* TryRemoveAny(std::vector<JobID> const& jobIDs);
+    Job* TryRemoveAnyFromGraph(JobGraph const* graph);
+
+    bool IsEmpty() const; // Lock free, may be stale by the time the caller reads it
+    int Count() const;
+
+private:
+
+    void RemoveAt(int heapIndex);
+    static bool RunsAfter(Job const* lhs, Job const* rhs);
+
+private:
+
+    mutable std::mutex      m_mutex;
+    std::vector<Job*>       m_heap;
+    std::atomic<int>        m_count = 0;
+};
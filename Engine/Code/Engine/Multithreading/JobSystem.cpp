@@ -2,6 +2,7 @@
 #include "Engine/Multithreading/JobSystem.h"
 #include "JobDependencies.h"
 #include "JobGraph.h"
+#include "JobQueue.h"
 #include "JobWorker.h"
 #include "Engine/Core/StringUtils.h"
 #include "Engine/Core/EngineCommon.h"
@@ -15,6 +16,13 @@ JobSystem* g_jobSystem = nullptr;
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Queue index of the general worker running on this thread, -1 for every other thread
+//
+static thread_local int s_workerQueueIndex = -1;
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 JobSystem::JobSystem(JobSystemConfig const& config) : EngineSubsystem("JobSystem"), m_config(config)
 {
@@ -37,6 +45,14 @@ void JobSystem::Startup()
     EngineSubsystem::Startup();
 
 	int numGeneralThreads = (int) m_config.m_threadCount - (m_config.m_deditatedLoadingWorker ? 1 : 0);
+
+    // Always at least one queue, so jobs can still be posted and then done by threads that help out while waiting
+    int numQueues = numGeneralThreads > 1 ? numGeneralThreads : 1;
+    for (int i = 0; i < numQueues; ++i)
+    {
+        m_jobQueues.push_back(new JobQueue());
+    }
+
     for (int id = 0; id < numGeneralThreads; ++id)
     {
         CreateJobWorker(id);
@@ -61,7 +77,10 @@ void JobSystem::Shutdown()
     // Wake up all idle threads and tell them we aren't running anymore
     m_isRunning = false;
     
-    m_jobQueue.Quit();
+    {
+        std::unique_lock lock(m_idleMutex);
+    }
+    m_idleCondVar.notify_all();
     m_loadingJobQueue.Quit();
     
     // Shut down all workers
@@ -73,6 +92,12 @@ void JobSystem::Shutdown()
     }
     
     m_workers.clear();
+
+    for (JobQueue* queue : m_jobQueues)
+    {
+        delete queue;
+    }
+    m_jobQueues.clear();
 }
 
 
@@ -82,6 +107,7 @@ void JobSystem::CreateJobWorker(int threadID, std::string const& name)
 {
     JobWorker* worker = new JobWorker();
     worker->m_threadID = threadID;
+    worker->m_queueIndex = threadID % (int) m_jobQueues.size();
     worker->m_thread = std::thread(&JobSystem::WorkerLoop, this, worker);
     worker->m_name = (!name.empty()) ? name : StringUtils::StringF("JobSystemWorker: %i", threadID);
     m_workers.emplace_back(worker);
@@ -104,7 +130,7 @@ void JobSystem::CreateLoadingJobWorker(int threadID, std::string const& name)
 //----------------------------------------------------------------------------------------------------------------------
 JobID JobSystem::PostJob(Job* job)
 {
-    if (!job || !m_isRunning)
+    if (!job || !m_isRunning || m_jobQueues.empty())
     {
         return JobID::Invalid;
     }
@@ -113,7 +139,18 @@ JobID JobSystem::PostJob(Job* job)
     job->m_id = id;
     
     ++m_numIncompleteJobs;
-    m_jobQueue.Push(job);
+    GetQueueForPosting()->Push(job);
+    ++m_numQueuedJobs;
+
+    // Only pay for the idle lock if someone might be asleep. Workers bump m_numIdleWorkers before re-checking
+    // m_numQueuedJobs under the lock, so either they see this job or we see them and wake one up.
+    if (m_numIdleWorkers > 0)
+    {
+        {
+            std::unique_lock lock(m_idleMutex);
+        }
+        m_idleCondVar.notify_one();
+    }
 
     return id;
 }
@@ -161,19 +198,15 @@ std::vector<JobID> JobSystem::PostJobs(std::vector<Job*>& jobs)
 //----------------------------------------------------------------------------------------------------------------------
 bool JobSystem::TryCancelJob(JobID jobID)
 {
-    m_jobQueue.Lock();
-    for (auto it = m_jobQueue.begin(); it != m_jobQueue.end(); ++it)
+    for (JobQueue* queue : m_jobQueues)
     {
-        if ((*it)->m_id != jobID)
+        if (queue->TryRemove(jobID))
         {
-            continue;
-		}
-        m_numIncompleteJobs--;
-        m_jobQueue.erase(it);
-        m_jobQueue.Unlock();
-        return true;
+            m_numQueuedJobs--;
+            m_numIncompleteJobs--;
+            return true;
+        }
     }
-    m_jobQueue.Unlock();
     return false;
 }
 
@@ -355,18 +388,52 @@ bool JobSystem::WaitForAllJobs(bool blockAndHelp)
 void JobSystem::ExecuteJobGraph(JobGraph& jobGraph, bool helpWithTasksOnThisThread)
 {
     jobGraph.Reset();
-    
-    while (!jobGraph.IsComplete())
+
+    for (int rootJobIndex : jobGraph.m_rootJobs)
     {
-        PostAvailableJobGraphTasks(jobGraph);
+        PostJobGraphJob(jobGraph, rootJobIndex);
+    }
 
-        if (helpWithTasksOnThisThread)
+    // Successors are posted by whichever thread finishes their last predecessor. This thread only helps with the graph's
+    // own jobs, so it never picks up something long running (chunk generation, disk writes) posted by someone else, and
+    // sleeps whenever none of them are queued.
+    if (helpWithTasksOnThisThread)
+    {
+        while (true)
         {
-            TryDoSpecificJobs(jobGraph.m_jobReceipts);
+            int numJobsPosted = jobGraph.m_numJobsPosted.load();
+            if (TryDoJobGraphJob(jobGraph))
+            {
+                continue;
+            }
+
+            std::unique_lock lock(jobGraph.m_completionMutex);
+            jobGraph.m_isHelperWaiting = true;
+            jobGraph.m_completionCondVar.wait(lock, [&jobGraph, numJobsPosted]()
+            {
+                return jobGraph.m_isComplete || jobGraph.m_numJobsPosted.load() != numJobsPosted;
+            });
+            jobGraph.m_isHelperWaiting = false;
+            if (jobGraph.m_isComplete)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        std::unique_lock lock(jobGraph.m_completionMutex);
+        jobGraph.m_completionCondVar.wait(lock, [&jobGraph]() { return jobGraph.m_isComplete; });
+    }
+
+    for (Job* job : jobGraph.m_jobs)
+    {
+        job->m_owningGraph = nullptr;
+        job->m_graphJobIndex = -1;
+        if (job->GetNeedsComplete())
+        {
+            job->Complete();
         }
-        else std::this_thread::yield();
-        
-        CompleteAvailableJobGraphTasks(jobGraph);
     }
 }
 
@@ -383,6 +450,8 @@ uint32_t JobSystem::GetNextJobUniqueID()
 //----------------------------------------------------------------------------------------------------------------------
 void JobSystem::WorkerLoop(JobWorker* worker)
 {
+    s_workerQueueIndex = worker->m_queueIndex;
+
     while (m_isRunning && worker->m_isRunning)
     {
         if (!WorkerLoop_TryDoFirstAvailableJob(worker))
@@ -411,8 +480,58 @@ bool JobSystem::WorkerLoop_TryDoFirstAvailableJob(JobWorker* worker, bool blocki
 //----------------------------------------------------------------------------------------------------------------------
 Job* JobSystem::PopFirstAvailableJob(bool blocking)
 {
-    Job* job = m_jobQueue.Pop(blocking);
-    return job;
+    while (true)
+    {
+        Job* job = TryPopOrStealJob();
+        if (job || !blocking || !m_isRunning)
+        {
+            return job;
+        }
+
+        std::unique_lock lock(m_idleMutex);
+        ++m_numIdleWorkers;
+        m_idleCondVar.wait(lock, [this]() { return m_numQueuedJobs > 0 || !m_isRunning; });
+        --m_numIdleWorkers;
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Job* JobSystem::TryPopOrStealJob()
+{
+    if (m_numQueuedJobs <= 0)
+    {
+        return nullptr;
+    }
+
+    // Start with our own queue, then walk the others so stealing spreads out instead of everyone hitting queue 0
+    int numQueues = (int) m_jobQueues.size();
+    int firstQueueIndex = (s_workerQueueIndex >= 0) ? s_workerQueueIndex : 0;
+    for (int i = 0; i < numQueues; ++i)
+    {
+        Job* job = m_jobQueues[(firstQueueIndex + i) % numQueues]->TryPop();
+        if (job)
+        {
+            --m_numQueuedJobs;
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+JobQueue* JobSystem::GetQueueForPosting()
+{
+    if (s_workerQueueIndex >= 0)
+    {
+        // Jobs posted from inside a job stay local, idle workers will steal them if this one is busy
+        return m_jobQueues[s_workerQueueIndex];
+    }
+    uint32_t queueIndex = m_nextPostQueueIndex.fetch_add(1) % (uint32_t) m_jobQueues.size();
+    return m_jobQueues[queueIndex];
 }
 
 
@@ -441,7 +560,11 @@ void JobSystem::WorkerLoop_ExecuteJob(JobWorker* worker, Job* job)
         RemoveJobFromInProgressQueue(job);
     #endif
 
-    if (job->GetNeedsComplete())
+    if (job->m_owningGraph)
+    {
+        OnJobGraphJobExecuted(job);
+    }
+    else if (job->GetNeedsComplete())
     {
         AddJobToCompletedQueue(job);
     }
@@ -488,26 +611,16 @@ bool JobSystem::LoadingWorkerLoop_TryDoFirstAvailableJob(JobWorker* worker, bool
 //----------------------------------------------------------------------------------------------------------------------
 bool JobSystem::TryDoSpecificJob(JobID jobToExpedite)
 {
-    Job* result = nullptr;
-    
-    m_jobQueue.Lock();
-    for (auto it = m_jobQueue.begin(); it != m_jobQueue.end(); ++it)
+    for (JobQueue* queue : m_jobQueues)
     {
-        Job* job = *it;
-        if (job->m_id == jobToExpedite)
+        Job* result = queue->TryRemove(jobToExpedite);
+        if (result)
         {
-            result = job;
-            m_jobQueue.erase(it);
-            break;
+            --m_numQueuedJobs;
+            WorkerLoop_ExecuteJob(nullptr, result);
+            return true;
         }
     }
-    m_jobQueue.Unlock();
-
-    if (result)
-    {
-        WorkerLoop_ExecuteJob(nullptr, result);
-        return true;
-    }
     return false;
 }
 
@@ -516,100 +629,79 @@ bool JobSystem::TryDoSpecificJob(JobID jobToExpedite)
 //----------------------------------------------------------------------------------------------------------------------
 bool JobSystem::TryDoSpecificJobs(std::vector<JobID> const& jobIDs)
 {
-    Job* result = nullptr;
-    
-    m_jobQueue.Lock();
-    for (auto it = m_jobQueue.begin(); it != m_jobQueue.end(); ++it)
+    for (JobQueue* queue : m_jobQueues)
     {
-        Job* job = *it;
-        for (int i = 0; i < (int) jobIDs.size(); ++i)
-        {
-            if (jobIDs[i] == JobID::Invalid)
-            {
-                continue;
-            }
-            
-            if (job->m_id == jobIDs[i])
-            {
-                result = job;
-                m_jobQueue.erase(it);
-                break;
-            }
-        }
+        Job* result = queue->TryRemoveAny(jobIDs);
         if (result)
         {
-            break;
+            --m_numQueuedJobs;
+            WorkerLoop_ExecuteJob(nullptr, result);
+            return true;
         }
     }
-    m_jobQueue.Unlock();
-
-    if (result)
-    {
-        WorkerLoop_ExecuteJob(nullptr, result);
-        return true;
-    }
     return false;
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void JobSystem::PostAvailableJobGraphTasks(JobGraph& graph)
+bool JobSystem::TryDoJobGraphJob(JobGraph const& jobGraph)
 {
-    for (int jobIndex = 0; jobIndex < (int) graph.m_jobs.size(); ++jobIndex)
+    for (JobQueue* queue : m_jobQueues)
     {
-        auto& status = graph.m_jobStatuses[jobIndex];
-        if (status == JobStatus::Posted || status == JobStatus::Completed)
+        Job* result = queue->TryRemoveAnyFromGraph(&jobGraph);
+        if (result)
         {
-            continue;
+            --m_numQueuedJobs;
+            WorkerLoop_ExecuteJob(nullptr, result);
+            return true;
         }
+    }
+    return false;
+}
 
-        JobDependencies& jobDeps = graph.m_jobDeps[jobIndex];
 
-        bool canRun = true;
-        for (int jobBeforeIndex = 0; jobBeforeIndex < jobIndex; ++jobBeforeIndex)
-        {
-            if (graph.m_jobStatuses[jobBeforeIndex] == JobStatus::Completed)
-            {
-                continue;
-            }
-            
-            JobDependencies& jobBeforeDeps = graph.m_jobDeps[jobBeforeIndex];
-            if (jobDeps.SharesDependencies(jobBeforeDeps))
-            {
-                canRun = false;
-                break;
-            }
-        }
 
-        if (canRun)
-        {
-            Job*& job = graph.m_jobs[jobIndex];
-            graph.m_jobReceipts[jobIndex] = PostJob(job);
-            graph.m_jobStatuses[jobIndex] = JobStatus::Posted;
-        }
+//----------------------------------------------------------------------------------------------------------------------
+void JobSystem::PostJobGraphJob(JobGraph& graph, int jobIndex)
+{
+    Job* job = graph.m_jobs[jobIndex];
+    job->m_owningGraph = &graph;
+    job->m_graphJobIndex = jobIndex;
+    PostJob(job);
+
+    // Wake the executing thread if it's asleep, it can help with this one. Always called before MarkJobExecuted for the
+    // job that posted it, so the graph is still alive.
+    graph.m_numJobsPosted.fetch_add(1);
+    if (graph.m_isHelperWaiting.load())
+    {
+        std::unique_lock lock(graph.m_completionMutex);
+        graph.m_completionCondVar.notify_all();
     }
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void JobSystem::CompleteAvailableJobGraphTasks(JobGraph& graph)
+void JobSystem::OnJobGraphJobExecuted(Job* job)
 {
-    for (int jobIndex = 0; jobIndex < (int) graph.m_jobs.size(); ++jobIndex)
-    {
-        JobStatus& status = graph.m_jobStatuses[jobIndex];
-        if (status == JobStatus::Completed || status == JobStatus::Null)
-        {
-            continue;
-        }
+    // Graph jobs skip the completed queue, ExecuteJobGraph calls Complete on them once the whole graph is done
+    JobGraph& graph = *job->m_owningGraph;
+    int jobIndex = job->m_graphJobIndex;
 
-        JobID id = graph.m_jobReceipts[jobIndex];
-        if (CompleteJob(id, false))
+    for (int i = graph.m_successorsBegin[jobIndex]; i < graph.m_successorsBegin[jobIndex + 1]; ++i)
+    {
+        int successorIndex = graph.m_successors[i];
+        if (graph.m_remainingPredecessors[successorIndex].fetch_sub(1) == 1)
         {
-            status = JobStatus::Completed;
+            PostJobGraphJob(graph, successorIndex);
         }
     }
+
+    --m_numIncompleteJobs;
+
+    // Must be last, the graph may be destroyed as soon as the final job is marked
+    graph.MarkJobExecuted();
 }
 
 
@@ -4,6 +4,7 @@
 #include "Engine/DataStructures/ThreadSafePrioQueue.h"
 #include "Job.h"
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -13,6 +14,7 @@
 struct JobWorker;
 struct JobGraph;
 class Job;
+class JobQueue;
 
 
 
@@ -35,7 +37,8 @@ struct JobSystemConfig
 //----------------------------------------------------------------------------------------------------------------------
 // Job System
 //
-// Owns worker threads and runs jobs. 
+// Owns worker threads and runs jobs. Each general worker has its own JobQueue: jobs posted from a worker go to that
+// worker's queue, jobs posted from other threads are dealt out round robin, and idle workers steal from the others.
 //
 class JobSystem : public EngineSubsystem
 {
@@ -64,7 +67,7 @@ public:
     bool CompleteJobs(std::vector<JobID>& in_out_ids, bool blockAndHelp = true);
     bool WaitForAllJobs(bool blockAndHelp = true);
     
-    void ExecuteJobGraph(JobGraph& jobGraph, bool helpWithTasksOnThisThread = false);
+    void ExecuteJobGraph(JobGraph& jobGraph, bool helpWithTasksOnThisThread = true);
 
     JobSystemConfig const m_config;
 
@@ -74,6 +77,8 @@ protected:
     void WorkerLoop(JobWorker* worker);
     bool WorkerLoop_TryDoFirstAvailableJob(JobWorker* worker, bool blocking = true);
     Job* PopFirstAvailableJob(bool blocking = true);
+    Job* TryPopOrStealJob();
+    JobQueue* GetQueueForPosting();
     Job* PopFirstAvailableLoadingJob(bool blocking = true);
     void WorkerLoop_ExecuteJob(JobWorker* worker, Job* job);
 
@@ -84,9 +89,10 @@ protected:
     // While waiting to complete jobs, threads can try to complete the jobs they are waiting on, which may recur
     bool TryDoSpecificJob(JobID jobToExpedite);
     bool TryDoSpecificJobs(std::vector<JobID> const& jobIDs);
+    bool TryDoJobGraphJob(JobGraph const& jobGraph);
 
-    void PostAvailableJobGraphTasks(JobGraph& graph);
-    void CompleteAvailableJobGraphTasks(JobGraph& graph);
+    void PostJobGraphJob(JobGraph& graph, int jobIndex);
+    void OnJobGraphJobExecuted(Job* job);
 
     void AddJobToInProgressQueue(Job* job);
     void RemoveJobFromInProgressQueue(Job* job);
@@ -105,7 +111,15 @@ protected:
 
     std::vector<JobWorker*>     m_workers;
 
-    ThreadSafePrioQueue<Job>    m_jobQueue;
+    std::vector<JobQueue*>      m_jobQueues;                // One per general worker
+    std::atomic<uint32_t>       m_nextPostQueueIndex        = 0;
+    std::atomic<int>            m_numQueuedJobs             = 0;
+
+    // Idle general workers sleep here until a job is posted
+    std::mutex                  m_idleMutex;
+    std::condition_variable     m_idleCondVar;
+    std::atomic<int>            m_numIdleWorkers            = 0;
+
 	ThreadSafePrioQueue<Job>    m_loadingJobQueue;          // Queue specifically for jobs that touch the disk, always a dedicated worker
     
     std::mutex                  m_inProgressJobsMutex;
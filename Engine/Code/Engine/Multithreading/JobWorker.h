@@ -17,6 +17,7 @@ struct JobWorker
     void Shutdown();
 
     int                     m_threadID      = -1;
+    int                     m_queueIndex    = -1;   // Index of the job queue this worker pops from first
     std::atomic<bool>       m_isRunning     = true;
     Name                    m_name          = "Unnamed Worker";
     std::thread             m_thread;
@@ -135,10 +135,9 @@ D3D11Renderer* D3D11Renderer::Get()
 //----------------------------------------------------------------------------------------------------------------------
 void D3D11Renderer::Present() const
 {
-	auto it = m_renderTargets.find(m_currentRenderTarget);
-	ASSERT_OR_DIE(it != m_renderTargets.end(), "Present called with no render target bound.");
+	RenderTarget* renderTarget = GetRenderTarget(m_currentRenderTarget);
+	ASSERT_OR_DIE(renderTarget, "Present called with no render target bound.");
 
-	RenderTarget* renderTarget = it->second;
 	renderTarget->Present();
 }
 
@@ -147,7 +146,7 @@ void D3D11Renderer::Present() const
 //----------------------------------------------------------------------------------------------------------------------
 void D3D11Renderer::ClearScreen(Rgba8 const& tint)
 {
-	RenderTarget* renderTarget = m_renderTargets.at(m_currentRenderTarget);
+	RenderTarget* renderTarget = GetRenderTarget(m_currentRenderTarget);
 	ASSERT_OR_DIE(renderTarget, "Tried to clear null render target.");
 
 	float colorAsFloats[4] = {};
@@ -165,7 +164,7 @@ void D3D11Renderer::ClearScreen(Rgba8 const& tint)
 //----------------------------------------------------------------------------------------------------------------------
 void D3D11Renderer::ClearDepth(float depth)
 {
-	RenderTarget* renderTarget = m_renderTargets.at(m_currentRenderTarget);
+	RenderTarget* renderTarget = GetRenderTarget(m_currentRenderTarget);
 	ASSERT_OR_DIE(renderTarget && renderTarget->m_depthBuffer, "Tried to clear null depth buffer.");
 
 	D3D11Texture* depthBuffer = dynamic_cast<D3D11Texture*>(GetTexture(renderTarget->m_depthBuffer));
@@ -270,10 +269,7 @@ void D3D11Renderer::BindConstantBuffer(ConstantBufferID id, int slot) const
 TextureID D3D11Renderer::MakeTexture()
 {
 	auto texResult = new D3D11Texture();
-	std::unique_lock lock(m_texturesMutex);
-	TextureID texID = RequestTextureID();
-	m_textures[texID] = texResult;
-	return texID;
+	return m_textures.Add(texResult);
 }
 
 
@@ -282,10 +278,7 @@ TextureID D3D11Renderer::MakeTexture()
 ShaderID D3D11Renderer::MakeShader(ShaderConfig const& config)
 {
 	auto shaderResult = new D3D11Shader(config);
-	std::unique_lock lock(m_shadersMutex);
-	ShaderID shaderID = RequestShaderID();
-	m_shaders[shaderID] = shaderResult;
-	return shaderID;
+	return m_shaders.Add(shaderResult);
 }
 
 
@@ -295,10 +288,7 @@ ConstantBufferID D3D11Renderer::MakeConstantBuffer(size_t initialSize)
 {
 	auto cbResult = new D3D11ConstantBuffer();
 	cbResult->Initialize(initialSize);
-	std::unique_lock lock(m_constantBuffersMutex);
-	ConstantBufferID cbID = RequestConstantBufferID();
-	m_constantBuffers[cbID] = cbResult;
-	return cbID;
+	return m_constantBuffers.Add(cbResult);
 
 }
 
@@ -308,10 +298,7 @@ ConstantBufferID D3D11Renderer::MakeConstantBuffer(size_t initialSize)
 VertexBufferID D3D11Renderer::MakeVertexBuffer()
 {
 	auto vbResult = new D3D11VertexBuffer();
-	std::unique_lock lock(m_vertexBuffersMutex);
-	VertexBufferID vbID = RequestVertexBufferID();
-	m_vertexBuffers[vbID] = vbResult;
-	return vbID;
+	return m_vertexBuffers.Add(vbResult);
 }
 
 
@@ -320,10 +307,7 @@ VertexBufferID D3D11Renderer::MakeVertexBuffer()
 InstanceBufferID D3D11Renderer::MakeInstanceBuffer()
 {
 	auto ibResult = new D3D11InstanceBuffer();
-	std::unique_lock lock(m_instanceBuffersMutex);
-	InstanceBufferID ibID = RequestInstanceBufferID();
-	m_instanceBuffers[ibID] = ibResult;
-	return ibID;
+	return m_instanceBuffers.Add(ibResult);
 }
 
 
@@ -332,10 +316,7 @@ InstanceBufferID D3D11Renderer::MakeInstanceBuffer()
 SwapchainID D3D11Renderer::MakeSwapchain()
 {
 	auto scResult = new D3D11Swapchain();
-	std::unique_lock lock(m_swapchainsMutex);
-	SwapchainID scID = RequestSwapchainID();
-	m_swapchains[scID] = scResult;
-	return scID;
+	return m_swapchains.Add(scResult);
 }
 
 
@@ -406,10 +387,7 @@ RenderTargetID D3D11Renderer::MakeSwapchainRenderTarget(void* hwnd, IntVec2 cons
 	ASSERT_OR_DIE(backBufferSuccess, "Backbuffer failed to init.");
 	ASSERT_OR_DIE(depthBufferSuccess, "Depth buffer failed to init");
 
-	std::unique_lock lock(m_renderTargetsMutex);
-	RenderTargetID newID = RequestRenderTargetID();
-	m_renderTargets[newID] = renderTarget;
-	return newID;
+	return m_renderTargets.Add(renderTarget);
 }
 
 
@@ -442,10 +420,10 @@ ID3D11DeviceContext* D3D11Renderer::GetDeviceContext() const
 void D3D11Renderer::MSAAChanged()
 {
 	// Recreate the depth buffer and backbuffer textures
-	for (auto& rt : m_renderTargets)
+	m_renderTargets.ForEach([this](RenderTargetID id, RenderTarget* renderTarget)
 	{
-		ResizeSwapChainRenderTarget(rt.first, rt.second->m_renderDimensions);
-	}
+		ResizeSwapChainRenderTarget(id, renderTarget->m_renderDimensions);
+	});
 }
 
 
@@ -505,7 +483,7 @@ void D3D11Renderer::BindRenderTarget(RenderTargetID renderTargetID, float letter
 //----------------------------------------------------------------------------------------------------------------------
 void D3D11Renderer::ResizeSwapChainRenderTarget(RenderTargetID renderTargetID, IntVec2 const& newSize)
 {
-	RenderTarget* renderTarget = m_renderTargets[renderTargetID];
+	RenderTarget* renderTarget = GetRenderTarget(renderTargetID);
 	ASSERT_OR_DIE(renderTarget && renderTarget->m_backbufferTexture && renderTarget->m_depthBuffer, "Null render target.");
 
 	D3D11Texture* backBuffer = dynamic_cast<D3D11Texture*>(GetTexture(renderTarget->m_backbufferTexture));
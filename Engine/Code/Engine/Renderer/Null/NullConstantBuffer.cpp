@@ -0,0 +1,21 @@
+﻿// Bradley Christensen - 2022-2026
+#include "NullConstantBuffer.h"
+#include "NullGPUBuffer.h"
+#include "Engine/Core/ErrorUtils.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullConstantBuffer::Initialize(size_t byteWidth)
+{
+	ReleaseResources();
+
+	// Same requirements as the D3D11 constant buffer, so headless runs catch bad sizes too
+	ASSERT_OR_DIE(byteWidth > 0, "NullConstantBuffer::Initialize - Invalid byte width");
+	ASSERT_OR_DIE(byteWidth % 16 == 0, "NullConstantBuffer::Initialize - requested size is not 16 byte aligned.");
+
+	GpuBufferConfig config;
+	config.m_bufferType = BufferType::ConstantBuffer;
+	m_gpuBuffer = new NullGPUBuffer(config);
+	m_gpuBuffer->Initialize(byteWidth);
+}
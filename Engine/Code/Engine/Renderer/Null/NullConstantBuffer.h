@@ -0,0 +1,17 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Renderer/ConstantBuffer.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// NullConstantBuffer
+//
+class NullConstantBuffer : public ConstantBuffer
+{
+	friend class NullRenderer;
+
+public:
+
+	virtual void Initialize(size_t byteWidth) override;
+};
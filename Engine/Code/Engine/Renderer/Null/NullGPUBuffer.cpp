@@ -0,0 +1,52 @@
+﻿// Bradley Christensen - 2022-2026
+#include "NullGPUBuffer.h"
+#include "NullRenderer.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+NullGPUBuffer::NullGPUBuffer(GpuBufferConfig const& config) : GPUBuffer(config)
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullGPUBuffer::Initialize(size_t byteWidth)
+{
+	m_gpuBufferSize = byteWidth;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullGPUBuffer::ReleaseResources()
+{
+	m_gpuBufferSize = 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullGPUBuffer::UpdateGPUBuffer()
+{
+	if (!m_isDirty)
+	{
+		return;
+	}
+
+	if (GetCPUBufferSize() > m_gpuBufferSize)
+	{
+		Initialize(m_cpuBuffer.size());
+	}
+
+	if (!m_cpuBuffer.empty())
+	{
+		NullRenderer* renderer = NullRenderer::Get();
+		if (renderer)
+		{
+			renderer->AddBufferUpload(m_cpuBuffer.size());
+		}
+		m_isDirty = false;
+	}
+}
@@ -0,0 +1,24 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Renderer/GPUBuffer.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Null GPU Buffer
+//
+// Only the CPU side copy, updating the "GPU" buffer just counts the upload on the NullRenderer
+//
+class NullGPUBuffer : public GPUBuffer
+{
+	friend class NullRenderer;
+
+public:
+
+	NullGPUBuffer(GpuBufferConfig const& config);
+
+	virtual void Initialize(size_t byteWidth) override;
+
+	virtual void ReleaseResources() override;
+	virtual void UpdateGPUBuffer() override;
+};
@@ -0,0 +1,22 @@
+﻿// Bradley Christensen - 2022-2026
+#include "NullGPUBuffer.h"
+#include "NullInstanceBuffer.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullInstanceBuffer::InitializeInternal(size_t instanceSize, size_t initialInstanceCount /*= 0*/)
+{
+	ReleaseResources();
+
+	m_instanceSize = instanceSize;
+
+	GpuBufferConfig config;
+	config.m_bufferType = BufferType::InstanceBuffer;
+	m_gpuBuffer = new NullGPUBuffer(config);
+
+	if (instanceSize > 0 && initialInstanceCount > 0)
+	{
+		m_gpuBuffer->Initialize(m_instanceSize * initialInstanceCount);
+	}
+}
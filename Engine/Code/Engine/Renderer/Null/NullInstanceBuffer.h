@@ -0,0 +1,17 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Renderer/InstanceBuffer.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// NullInstanceBuffer
+//
+class NullInstanceBuffer : public InstanceBuffer
+{
+	friend class NullRenderer;
+
+public:
+
+	virtual void InitializeInternal(size_t instanceSize, size_t initialInstanceCount) override;
+};
@@ -0,0 +1,506 @@
+﻿// Bradley Christensen - 2022-2026
+#include "NullRenderer.h"
+#include "NullConstantBuffer.h"
+#include "NullGPUBuffer.h"
+#include "NullInstanceBuffer.h"
+#include "NullShader.h"
+#include "NullSwapchain.h"
+#include "NullTexture.h"
+#include "NullVertexBuffer.h"
+#include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/ErrorUtils.h"
+#include "Engine/Renderer/RenderTarget.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRendererStats::Reset()
+{
+	*this = NullRendererStats();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRendererStats::Add(NullRendererStats const& other)
+{
+	m_numDrawCalls += other.m_numDrawCalls;
+	m_numInstancedDrawCalls += other.m_numInstancedDrawCalls;
+	m_numVertsDrawn += other.m_numVertsDrawn;
+	m_numInstancesDrawn += other.m_numInstancesDrawn;
+
+	m_numVertexBufferBinds += other.m_numVertexBufferBinds;
+	m_numInstanceBufferBinds += other.m_numInstanceBufferBinds;
+	m_numConstantBufferBinds += other.m_numConstantBufferBinds;
+	m_numRenderTargetBinds += other.m_numRenderTargetBinds;
+
+	m_numShaderChanges += other.m_numShaderChanges;
+	m_numTextureChanges += other.m_numTextureChanges;
+	m_numBlendModeChanges += other.m_numBlendModeChanges;
+	m_numSamplerStateChanges += other.m_numSamplerStateChanges;
+	m_numRasterizerStateChanges += other.m_numRasterizerStateChanges;
+	m_numDepthStencilStateChanges += other.m_numDepthStencilStateChanges;
+
+	m_numBufferUploads += other.m_numBufferUploads;
+	m_numBufferUploadBytes += other.m_numBufferUploadBytes;
+
+	m_numClears += other.m_numClears;
+	m_numPresents += other.m_numPresents;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+NullRenderer::NullRenderer(RendererConfig const& config) : Renderer(config)
+{
+
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+NullRenderer* NullRenderer::Get()
+{
+	return dynamic_cast<NullRenderer*>(g_renderer);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BeginFrame()
+{
+	Renderer::BeginFrame();
+	m_frameStats.Reset();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Same as Renderer::EndFrame, minus the sleep, so benchmarks only time the work
+//
+void NullRenderer::EndFrame()
+{
+	if (m_currentCamera)
+	{
+		EndCamera(m_currentCamera);
+	}
+
+	Present();
+
+	if (m_currentRenderTarget != RendererUtils::InvalidID)
+	{
+		UnbindRenderTarget(m_currentRenderTarget);
+	}
+
+	m_totalStats.Add(m_frameStats);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::Present() const
+{
+	RenderTarget* renderTarget = GetRenderTarget(m_currentRenderTarget);
+	ASSERT_OR_DIE(renderTarget, "Present called with no render target bound.");
+
+	renderTarget->Present();
+	m_frameStats.m_numPresents++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::ClearScreen(Rgba8 const& tint)
+{
+	UNUSED(tint);
+	ASSERT_OR_DIE(GetRenderTarget(m_currentRenderTarget), "Tried to clear null render target.");
+	m_frameStats.m_numClears++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::ClearDepth(float depth)
+{
+	UNUSED(depth);
+	RenderTarget* renderTarget = GetRenderTarget(m_currentRenderTarget);
+	ASSERT_OR_DIE(renderTarget && renderTarget->m_depthBuffer, "Tried to clear null depth buffer.");
+	m_frameStats.m_numClears++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BindVertexBuffer(VertexBufferID id, int slot) const
+{
+	VertexBuffer* vbo = GetVertexBuffer(id);
+	ASSERT_OR_DIE(vbo, "Binding invalid vertex buffer");
+
+	BindVertexBuffer(*vbo, slot);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BindVertexBuffer(VertexBuffer& vbo, int slot) const
+{
+	UNUSED(slot);
+	ASSERT_OR_DIE(dynamic_cast<NullVertexBuffer*>(&vbo), "Trying to draw non-null vbo.");
+
+	vbo.UpdateGPUBuffer();
+	m_frameStats.m_numVertexBufferBinds++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BindInstanceBuffer(InstanceBufferID ibo, int slot) const
+{
+	InstanceBuffer* ibuffer = GetInstanceBuffer(ibo);
+	ASSERT_OR_DIE(ibuffer, "Binding invalid instance buffer");
+
+	BindInstanceBuffer(*ibuffer, slot);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BindInstanceBuffer(InstanceBuffer& ibo, int slot) const
+{
+	UNUSED(slot);
+	ASSERT_OR_DIE(dynamic_cast<NullInstanceBuffer*>(&ibo), "Trying to draw null or non-null ibo.");
+
+	ibo.UpdateGPUBuffer();
+	m_frameStats.m_numInstanceBufferBinds++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BindConstantBuffer(ConstantBufferID id, int slot) const
+{
+	UNUSED(slot);
+	NullConstantBuffer* cbo = dynamic_cast<NullConstantBuffer*>(GetConstantBuffer(id));
+	ASSERT_OR_DIE(cbo && cbo->m_gpuBuffer, "Binding invalid constant buffer");
+
+	cbo->m_gpuBuffer->UpdateGPUBuffer();
+	m_frameStats.m_numConstantBufferBinds++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+TextureID NullRenderer::MakeTexture()
+{
+	auto texResult = new NullTexture();
+	return m_textures.Add(texResult);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+ShaderID NullRenderer::MakeShader(ShaderConfig const& config)
+{
+	auto shaderResult = new NullShader(config);
+	return m_shaders.Add(shaderResult);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+ConstantBufferID NullRenderer::MakeConstantBuffer(size_t initialSize)
+{
+	auto cbResult = new NullConstantBuffer();
+	cbResult->Initialize(initialSize);
+	return m_constantBuffers.Add(cbResult);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+VertexBufferID NullRenderer::MakeVertexBuffer()
+{
+	auto vbResult = new NullVertexBuffer();
+	return m_vertexBuffers.Add(vbResult);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+InstanceBufferID NullRenderer::MakeInstanceBuffer()
+{
+	auto ibResult = new NullInstanceBuffer();
+	return m_instanceBuffers.Add(ibResult);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+SwapchainID NullRenderer::MakeSwapchain()
+{
+	auto scResult = new NullSwapchain();
+	return m_swapchains.Add(scResult);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// No window is needed, the hwnd is ignored
+//
+RenderTargetID NullRenderer::MakeSwapchainRenderTarget(void* hwnd, IntVec2 const& resolution)
+{
+	UNUSED(hwnd);
+
+	RenderTarget* renderTarget = new RenderTarget();
+	renderTarget->m_renderDimensions = resolution;
+	renderTarget->m_backbufferTexture = MakeTexture();
+	renderTarget->m_depthBuffer = MakeTexture();
+	renderTarget->m_swapchain = MakeSwapchain();
+
+	NullTexture* backBuffer = dynamic_cast<NullTexture*>(GetTexture(renderTarget->m_backbufferTexture));
+	NullTexture* depthBuffer = dynamic_cast<NullTexture*>(GetTexture(renderTarget->m_depthBuffer));
+
+	ASSERT_OR_DIE(backBuffer, "Invalid backbuffer");
+	ASSERT_OR_DIE(depthBuffer, "Invalid depth buffer");
+
+	backBuffer->InitWithDimensions(resolution);
+	depthBuffer->InitWithDimensions(resolution);
+
+	return m_renderTargets.Add(renderTarget);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+GPUBuffer* NullRenderer::MakeGPUBuffer(GpuBufferConfig const& config)
+{
+	return new NullGPUBuffer(config);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::MSAAChanged()
+{
+	// No multisampled textures to recreate
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BindRenderTarget(RenderTargetID renderTargetID, float letterboxedAspect /*= -1.f*/)
+{
+	UNUSED(letterboxedAspect);
+
+	m_currentRenderTarget = renderTargetID;
+	RenderTarget* renderTarget = GetRenderTarget(renderTargetID);
+	ASSERT_OR_DIE(renderTarget && renderTarget->m_backbufferTexture && renderTarget->m_depthBuffer, "Null render target.");
+
+	m_frameStats.m_numRenderTargetBinds++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::ResizeSwapChainRenderTarget(RenderTargetID renderTargetID, IntVec2 const& newSize)
+{
+	RenderTarget* renderTarget = GetRenderTarget(renderTargetID);
+	ASSERT_OR_DIE(renderTarget && renderTarget->m_backbufferTexture && renderTarget->m_depthBuffer, "Null render target.");
+
+	NullTexture* backBuffer = dynamic_cast<NullTexture*>(GetTexture(renderTarget->m_backbufferTexture));
+	NullTexture* depthBuffer = dynamic_cast<NullTexture*>(GetTexture(renderTarget->m_depthBuffer));
+
+	ASSERT_OR_DIE(backBuffer, "Render target has an invalid backbuffer");
+	ASSERT_OR_DIE(depthBuffer, "Render target has an invalid depth buffer");
+
+	renderTarget->m_renderDimensions = newSize;
+	backBuffer->InitWithDimensions(newSize);
+	depthBuffer->InitWithDimensions(newSize);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool NullRenderer::SetFullscreenState(RenderTargetID renderTargetID, bool fullscreen)
+{
+	UNUSED(fullscreen);
+	ASSERT_OR_DIE(GetRenderTarget(renderTargetID), "Invalid renderTarget");
+	return true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::AddBufferUpload(size_t numBytes)
+{
+	m_frameStats.m_numBufferUploads++;
+	m_frameStats.m_numBufferUploadBytes += numBytes;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+NullRendererStats const& NullRenderer::GetFrameStats() const
+{
+	return m_frameStats;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+NullRendererStats const& NullRenderer::GetTotalStats() const
+{
+	return m_totalStats;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::ResetTotalStats()
+{
+	m_totalStats.Reset();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::Draw(int vertexCount, int vertexOffset)
+{
+	Renderer::Draw(vertexCount, vertexOffset);
+	m_frameStats.m_numDrawCalls++;
+	m_frameStats.m_numVertsDrawn += vertexCount;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::DrawInstanced(int vertexCount, int instanceCount, int vertexOffset, int instanceOffset)
+{
+	Renderer::DrawInstanced(vertexCount, instanceCount, vertexOffset, instanceOffset);
+	m_frameStats.m_numDrawCalls++;
+	m_frameStats.m_numInstancedDrawCalls++;
+	m_frameStats.m_numVertsDrawn += (int64_t) vertexCount * instanceCount;
+	m_frameStats.m_numInstancesDrawn += instanceCount;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::RasterizerStateUpdated()
+{
+	m_frameStats.m_numRasterizerStateChanges++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::DepthStencilStateUpdated()
+{
+	m_frameStats.m_numDepthStencilStateChanges++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BlendModeUpdated()
+{
+	m_frameStats.m_numBlendModeChanges++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::SamplerStateUpdated()
+{
+	m_frameStats.m_numSamplerStateChanges++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BoundTextureUpdated(int slot /*= 0*/)
+{
+	UNUSED(slot);
+	m_frameStats.m_numTextureChanges++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::BoundShaderUpdated()
+{
+	ASSERT_OR_DIE(dynamic_cast<NullShader*>(GetBoundShader()), "Tried to update null or non-null shader.");
+	m_frameStats.m_numShaderChanges++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::CreateDebugLayer()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::CreateDevice()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::CreateBlendStates()
+{
+	// Same default as the D3D11 renderer
+	SetBlendMode(BlendMode::Alpha);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::CreateRasterizerState()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::DestroyDebugLayer()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::DestroyDevice()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::DestroyBlendStates()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::DestroyDepthStencilState()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::DestroySamplerStates()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullRenderer::DestroyRasterizerState()
+{
+}
@@ -0,0 +1,124 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Renderer/Renderer.h"
+#include <cstddef>
+#include <cstdint>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Everything the null renderer was asked to do, for tracking the cost of a frame without a GPU
+//
+struct NullRendererStats
+{
+	void Reset();
+	void Add(NullRendererStats const& other);
+
+	int m_numDrawCalls					= 0;	// Includes instanced draws
+	int m_numInstancedDrawCalls			= 0;
+	int64_t m_numVertsDrawn				= 0;	// Verts per instance * instances for instanced draws
+	int64_t m_numInstancesDrawn			= 0;
+
+	int m_numVertexBufferBinds			= 0;
+	int m_numInstanceBufferBinds		= 0;
+	int m_numConstantBufferBinds		= 0;
+	int m_numRenderTargetBinds			= 0;
+
+	int m_numShaderChanges				= 0;
+	int m_numTextureChanges				= 0;
+	int m_numBlendModeChanges			= 0;
+	int m_numSamplerStateChanges		= 0;
+	int m_numRasterizerStateChanges		= 0;
+	int m_numDepthStencilStateChanges	= 0;
+
+	int m_numBufferUploads				= 0;	// GPU buffer updates that would have mapped and copied
+	size_t m_numBufferUploadBytes		= 0;
+
+	int m_numClears						= 0;
+	int m_numPresents					= 0;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Null Renderer
+//
+// Headless renderer with no device. Buffers only keep their CPU side copy and nothing is drawn, but the whole CPU side of
+// rendering still runs (vert building, pipeline state updates, buffer uploads), and every draw and state change is
+// counted. For benchmarks and soak tests on machines without a GPU. Select with RendererConfig::m_headless.
+//
+class NullRenderer : public Renderer
+{
+public:
+
+	NullRenderer(RendererConfig const& config);
+	static NullRenderer* Get();
+
+	virtual void BeginFrame() override;
+	virtual void EndFrame() override;
+
+	virtual void Present() const override;
+
+	virtual void ClearScreen(Rgba8 const& tint) override;
+	virtual void ClearDepth(float depth) override;
+	virtual void BindVertexBuffer(VertexBufferID vbo, int slot = 0) const override;
+	virtual void BindVertexBuffer(VertexBuffer& vbo, int slot = 0) const override;
+	virtual void BindInstanceBuffer(InstanceBufferID ibo, int slot = 1) const override;
+	virtual void BindInstanceBuffer(InstanceBuffer& ibo, int slot = 1) const override;
+	virtual void BindConstantBuffer(ConstantBufferID cbo, int slot) const override;
+
+	// Factory Functions
+	virtual TextureID MakeTexture() override;
+	virtual ShaderID MakeShader(ShaderConfig const& config) override;
+	virtual ConstantBufferID MakeConstantBuffer(size_t initialSize) override;
+	virtual VertexBufferID MakeVertexBuffer() override;
+	virtual InstanceBufferID MakeInstanceBuffer() override;
+	virtual SwapchainID MakeSwapchain() override;
+	virtual RenderTargetID MakeSwapchainRenderTarget(void* hwnd, IntVec2 const& resolution) override;
+	virtual GPUBuffer* MakeGPUBuffer(GpuBufferConfig const& config) override;    // Does not own lifetime of this buffer
+
+	virtual void MSAAChanged() override;
+
+	virtual void BindRenderTarget(RenderTargetID renderTargetID, float letterboxedAspect = -1.f) override;
+	virtual void ResizeSwapChainRenderTarget(RenderTargetID renderTargetID, IntVec2 const& newSize) override;
+	virtual bool SetFullscreenState(RenderTargetID renderTargetID, bool fullscreen) override;
+
+	void AddBufferUpload(size_t numBytes);
+
+	NullRendererStats const& GetFrameStats() const;		// The frame in progress, or the last one between EndFrame and BeginFrame
+	NullRendererStats const& GetTotalStats() const;		// Every frame ended so far
+	void ResetTotalStats();
+
+private:
+
+	virtual void Draw(int vertexCount, int vertexOffset) override;
+	virtual void DrawInstanced(int vertexCount, int instanceCount, int vertexOffset, int instanceOffset) override;
+
+	// Deferred pipeline updates
+	virtual void RasterizerStateUpdated() override;
+	virtual void DepthStencilStateUpdated() override;
+	virtual void BlendModeUpdated() override;
+	virtual void SamplerStateUpdated() override;
+	virtual void BoundTextureUpdated(int slot = 0) override;
+	virtual void BoundShaderUpdated() override;
+
+	// State creation
+	virtual void CreateDebugLayer() override;
+	virtual void CreateDevice() override;
+	virtual void CreateBlendStates() override;
+	virtual void CreateRasterizerState() override;
+
+	// State cleanup
+	virtual void DestroyDebugLayer() override;
+	virtual void DestroyDevice() override;
+	virtual void DestroyBlendStates() override;
+	virtual void DestroyDepthStencilState() override;
+	virtual void DestroySamplerStates() override;
+	virtual void DestroyRasterizerState() override;
+
+protected:
+
+	// Binds are const on Renderer, but still get counted
+	mutable NullRendererStats m_frameStats;
+	NullRendererStats m_totalStats;
+};
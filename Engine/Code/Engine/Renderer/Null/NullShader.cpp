@@ -0,0 +1,36 @@
+﻿// Bradley Christensen - 2022-2026
+#include "NullShader.h"
+#include "Engine/Core/EngineCommon.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+NullShader::NullShader(ShaderConfig const& config) : Shader(config)
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool NullShader::IsValid()
+{
+	return m_isCompiled;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullShader::ReleaseResources()
+{
+	m_isCompiled = false;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool NullShader::FullCompileFromSource(std::string const& sourceCode)
+{
+	UNUSED(sourceCode);
+	m_isCompiled = true;
+	return true;
+}
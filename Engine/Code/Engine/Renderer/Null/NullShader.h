@@ -0,0 +1,30 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Renderer/Shader.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Null Shader
+//
+// Nothing to compile, any source is accepted
+//
+class NullShader : public Shader
+{
+	friend class NullRenderer;
+
+protected:
+
+	NullShader(ShaderConfig const& config);
+
+public:
+
+	virtual bool IsValid() override;
+	virtual void ReleaseResources() override;
+
+	virtual bool FullCompileFromSource(std::string const& sourceCode) override;
+
+protected:
+
+	bool m_isCompiled = false;
+};
@@ -0,0 +1,16 @@
+﻿// Bradley Christensen - 2022-2026
+#include "NullSwapchain.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullSwapchain::ReleaseResources()
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullSwapchain::Present()
+{
+}
@@ -0,0 +1,24 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Renderer/Swapchain.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// NullSwapchain
+//
+class NullSwapchain : public Swapchain
+{
+	friend class NullRenderer;
+
+protected:
+
+	NullSwapchain() = default;
+	NullSwapchain(NullSwapchain const& copy) = delete;
+	virtual ~NullSwapchain() = default;
+
+public:
+
+	virtual void ReleaseResources() override;
+	virtual void Present() override;
+};
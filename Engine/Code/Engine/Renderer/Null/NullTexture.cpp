@@ -0,0 +1,49 @@
+﻿// Bradley Christensen - 2022-2026
+#include "NullTexture.h"
+#include "Engine/Assets/Image.h"
+#include "Engine/Core/EngineCommon.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullTexture::ReleaseResources()
+{
+	m_isValid = false;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool NullTexture::IsValid() const
+{
+	return m_isValid;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool NullTexture::CreateFromImage(Image const& image, bool createMipMap /*= true*/, bool isRenderTarget /*= false*/)
+{
+	UNUSED(createMipMap);
+	UNUSED(isRenderTarget);
+
+	InitWithDimensions(image.GetPixels().GetDimensions());
+	return true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullTexture::InitWithDimensions(IntVec2 const& dimensions)
+{
+	m_dimensions = dimensions;
+	m_isValid = true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullTexture::CopyTo(Swapchain* swapchain)
+{
+	UNUSED(swapchain);
+}
@@ -0,0 +1,32 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Renderer/Texture.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Null Texture
+//
+// Keeps the dimensions, but not the pixels
+//
+class NullTexture : public Texture
+{
+	friend class NullRenderer;
+
+public:
+
+	virtual void ReleaseResources() override;
+
+	virtual bool IsValid() const override;
+
+	virtual bool CreateFromImage(Image const& image, bool createMipMap = true, bool isRenderTarget = false) override;
+
+	// Backbuffer and depth buffer for a NullRenderer render target
+	void InitWithDimensions(IntVec2 const& dimensions);
+
+	virtual void CopyTo(Swapchain* swapchain) override;
+
+protected:
+
+	bool m_isValid = false;
+};
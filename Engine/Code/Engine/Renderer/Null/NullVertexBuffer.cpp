@@ -0,0 +1,22 @@
+﻿// Bradley Christensen - 2022-2026
+#include "NullGPUBuffer.h"
+#include "NullVertexBuffer.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void NullVertexBuffer::InitializeInternal(size_t vertSize, size_t initialVertCount /*= 0*/)
+{
+	ReleaseResources();
+
+	m_vertSize = vertSize;
+
+	GpuBufferConfig config;
+	config.m_bufferType = BufferType::VertexBuffer;
+	m_gpuBuffer = new NullGPUBuffer(config);
+
+	if (vertSize > 0 && initialVertCount > 0)
+	{
+		m_gpuBuffer->Initialize(m_vertSize * initialVertCount);
+	}
+}
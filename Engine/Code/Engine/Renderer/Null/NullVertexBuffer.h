@@ -0,0 +1,17 @@
+﻿// Bradley Christensen - 2022-2026
+#pragma once
+#include "Engine/Renderer/VertexBuffer.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// NullVertexBuffer
+//
+class NullVertexBuffer : public VertexBuffer
+{
+	friend class NullRenderer;
+
+public:
+
+	virtual void InitializeInternal(size_t vertSize, size_t initialVertCount) override;
+};
@@ -317,13 +317,7 @@ void Renderer::SetVSync(bool vsyncEnabled)
 //----------------------------------------------------------------------------------------------------------------------
 Texture* Renderer::GetTexture(TextureID id) const
 {
-	std::unique_lock lock(m_texturesMutex);
-	auto it = m_textures.find(id);
-	if (it != m_textures.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_textures.Get(id);
 }
 
 
@@ -331,13 +325,7 @@ Texture* Renderer::GetTexture(TextureID id) const
 //----------------------------------------------------------------------------------------------------------------------
 Shader* Renderer::GetShader(ShaderID id) const
 {
-	std::unique_lock lock(m_shadersMutex);
-	auto it = m_shaders.find(id);
-	if (it != m_shaders.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_shaders.Get(id);
 }
 
 
@@ -345,13 +333,7 @@ Shader* Renderer::GetShader(ShaderID id) const
 //----------------------------------------------------------------------------------------------------------------------
 ConstantBuffer* Renderer::GetConstantBuffer(ConstantBufferID id) const
 {
-	std::unique_lock lock(m_constantBuffersMutex);
-	auto it = m_constantBuffers.find(id);
-	if (it != m_constantBuffers.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_constantBuffers.Get(id);
 }
 
 
@@ -359,13 +341,7 @@ ConstantBuffer* Renderer::GetConstantBuffer(ConstantBufferID id) const
 //----------------------------------------------------------------------------------------------------------------------
 VertexBuffer* Renderer::GetVertexBuffer(VertexBufferID id) const
 {
-	std::unique_lock lock(m_vertexBuffersMutex);
-	auto it = m_vertexBuffers.find(id);
-	if (it != m_vertexBuffers.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_vertexBuffers.Get(id);
 }
 
 
@@ -373,13 +349,7 @@ VertexBuffer* Renderer::GetVertexBuffer(VertexBufferID id) const
 //----------------------------------------------------------------------------------------------------------------------
 InstanceBuffer* Renderer::GetInstanceBuffer(InstanceBufferID id) const
 {
-	std::unique_lock lock(m_instanceBuffersMutex);
-	auto it = m_instanceBuffers.find(id);
-	if (it != m_instanceBuffers.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_instanceBuffers.Get(id);
 }
 
 
@@ -387,13 +357,7 @@ InstanceBuffer* Renderer::GetInstanceBuffer(InstanceBufferID id) const
 //----------------------------------------------------------------------------------------------------------------------
 Swapchain* Renderer::GetSwapchain(SwapchainID id) const
 {
-	std::unique_lock lock(m_swapchainsMutex);
-	auto it = m_swapchains.find(id);
-	if (it != m_swapchains.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_swapchains.Get(id);
 }
 
 
@@ -401,13 +365,7 @@ Swapchain* Renderer::GetSwapchain(SwapchainID id) const
 //----------------------------------------------------------------------------------------------------------------------
 RenderTarget* Renderer::GetRenderTarget(RenderTargetID id) const
 {
-	std::unique_lock lock(m_renderTargetsMutex);
-	auto it = m_renderTargets.find(id);
-	if (it != m_renderTargets.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_renderTargets.Get(id);
 }
 
 
@@ -415,14 +373,11 @@ RenderTarget* Renderer::GetRenderTarget(RenderTargetID id) const
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::ReleaseTexture(TextureID id)
 {
-	std::unique_lock lock(m_texturesMutex);
-	auto pair = m_textures.find(id);
-	if (pair != m_textures.end())
+	Texture* texture = m_textures.Remove(id);
+	if (texture)
 	{
-		Texture* texture = pair->second;
 		texture->ReleaseResources();
 		delete texture;
-		m_textures.erase(pair);
 	}
 }
 
@@ -431,14 +386,11 @@ void Renderer::ReleaseTexture(TextureID id)
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::ReleaseShader(ShaderID id)
 {
-	std::unique_lock lock(m_shadersMutex);
-	auto pair = m_shaders.find(id);
-	if (pair != m_shaders.end())
+	Shader* shader = m_shaders.Remove(id);
+	if (shader)
 	{
-		Shader* shader = pair->second;
 		shader->ReleaseResources();
 		delete shader;
-		m_shaders.erase(pair);
 	}
 }
 
@@ -447,14 +399,11 @@ void Renderer::ReleaseShader(ShaderID id)
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::ReleaseConstantBuffer(ConstantBufferID id)
 {
-	std::unique_lock lock(m_constantBuffersMutex);
-	auto pair = m_constantBuffers.find(id);
-	if (pair != m_constantBuffers.end())
+	ConstantBuffer* cb = m_constantBuffers.Remove(id);
+	if (cb)
 	{
-		ConstantBuffer* cb = pair->second;
 		cb->ReleaseResources();
 		delete cb;
-		m_constantBuffers.erase(pair);
 	}
 }
 
@@ -463,14 +412,11 @@ void Renderer::ReleaseConstantBuffer(ConstantBufferID id)
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::ReleaseVertexBuffer(VertexBufferID id)
 {
-	std::unique_lock lock(m_vertexBuffersMutex);
-	auto pair = m_vertexBuffers.find(id);
-	if (pair != m_vertexBuffers.end())
+	VertexBuffer* vb = m_vertexBuffers.Remove(id);
+	if (vb)
 	{
-		VertexBuffer* vb = pair->second;
 		vb->ReleaseResources();
 		delete vb;
-		m_vertexBuffers.erase(pair);
 	}
 }
 
@@ -479,14 +425,11 @@ void Renderer::ReleaseVertexBuffer(VertexBufferID id)
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::ReleaseInstanceBuffer(InstanceBufferID id)
 {
-	std::unique_lock lock(m_instanceBuffersMutex);
-	auto pair = m_instanceBuffers.find(id);
-	if (pair != m_instanceBuffers.end())
+	InstanceBuffer* ib = m_instanceBuffers.Remove(id);
+	if (ib)
 	{
-		InstanceBuffer* ib = pair->second;
 		ib->ReleaseResources();
 		delete ib;
-		m_instanceBuffers.erase(pair);
 	}
 }
 
@@ -495,14 +438,11 @@ void Renderer::ReleaseInstanceBuffer(InstanceBufferID id)
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::ReleaseSwapchain(SwapchainID id)
 {
-	std::unique_lock lock(m_swapchainsMutex);
-	auto pair = m_swapchains.find(id);
-	if (pair != m_swapchains.end())
+	Swapchain* sc = m_swapchains.Remove(id);
+	if (sc)
 	{
-		Swapchain* sc = pair->second;
 		sc->ReleaseResources();
 		delete sc;
-		m_swapchains.erase(pair);
 	}
 }
 
@@ -512,14 +452,11 @@ void Renderer::ReleaseSwapchain(SwapchainID id)
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::ReleaseRenderTarget(RenderTargetID renderTargetID)
 {
-	std::unique_lock lock(m_renderTargetsMutex);
-	auto pair = m_renderTargets.find(renderTargetID);
-	if (pair != m_renderTargets.end())
+	RenderTarget* rt = m_renderTargets.Remove(renderTargetID);
+	if (rt)
 	{
-		RenderTarget* rt = pair->second;
 		rt->ReleaseResources();
 		delete rt;
-		m_renderTargets.erase(pair);
 	}
 }
 
@@ -721,69 +658,6 @@ Texture* Renderer::GetBoundTexture(int slot /*= 0*/) const
 
 
 
-//----------------------------------------------------------------------------------------------------------------------
-TextureID Renderer::RequestTextureID() const
-{
-	static TextureID s_id = 0;
-	return s_id++;
-}
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-ShaderID Renderer::RequestShaderID() const
-{
-	static ShaderID s_id = 0;
-	return s_id++;
-}
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-ConstantBufferID Renderer::RequestConstantBufferID() const
-{
-	static ConstantBufferID s_id = 0;
-	return s_id++;
-}
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-VertexBufferID Renderer::RequestVertexBufferID() const
-{
-	static VertexBufferID s_id = 0;
-	return s_id++;
-}
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-InstanceBufferID Renderer::RequestInstanceBufferID() const
-{
-	static InstanceBufferID s_id = 0;
-	return s_id++;
-}
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-SwapchainID Renderer::RequestSwapchainID() const
-{
-	static SwapchainID s_id = 0;
-	return s_id++;
-}
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-RenderTargetID Renderer::RequestRenderTargetID() const
-{
-	static RenderTargetID s_id = 0;
-	return s_id++;
-}
-
-
-
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::Draw(int vertexCount, int vertexOffset /*= 0*/)
 {
@@ -1005,12 +879,12 @@ void Renderer::DestroyDefaultShader()
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::DestroyShaders()
 {
-	for (auto shader : m_shaders)
+	m_shaders.ForEach([](ShaderID, Shader* shader)
 	{
-		shader.second->ReleaseResources();
-		delete shader.second;
-	}
-	m_shaders.clear();
+		shader->ReleaseResources();
+		delete shader;
+	});
+	m_shaders.Clear();
 }
 
 
@@ -1018,12 +892,12 @@ void Renderer::DestroyShaders()
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::DestroyTextures()
 {
-	for (auto tex : m_textures)
+	m_textures.ForEach([](TextureID, Texture* texture)
 	{
-		tex.second->ReleaseResources();
-		delete tex.second;
-	}
-	m_textures.clear();
+		texture->ReleaseResources();
+		delete texture;
+	});
+	m_textures.Clear();
 }
 
 
@@ -1031,12 +905,12 @@ void Renderer::DestroyTextures()
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::DestroyConstantBuffers()
 {
-	for (auto cbo : m_constantBuffers)
+	m_constantBuffers.ForEach([](ConstantBufferID, ConstantBuffer* cb)
 	{
-		cbo.second->ReleaseResources();
-		delete cbo.second;
-	}
-	m_constantBuffers.clear();
+		cb->ReleaseResources();
+		delete cb;
+	});
+	m_constantBuffers.Clear();
 }
 
 
@@ -1044,12 +918,12 @@ void Renderer::DestroyConstantBuffers()
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::DestroyVertexBuffers()
 {
-	for (auto vb : m_vertexBuffers)
+	m_vertexBuffers.ForEach([](VertexBufferID, VertexBuffer* vb)
 	{
-		vb.second->ReleaseResources();
-		delete vb.second;
-	}
-	m_vertexBuffers.clear();
+		vb->ReleaseResources();
+		delete vb;
+	});
+	m_vertexBuffers.Clear();
 
 
 	#if defined(_DEBUG)
@@ -1062,12 +936,12 @@ void Renderer::DestroyVertexBuffers()
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::DestroyInstanceBuffers()
 {
-	for (auto ib : m_instanceBuffers)
+	m_instanceBuffers.ForEach([](InstanceBufferID, InstanceBuffer* ib)
 	{
-		ib.second->ReleaseResources();
-		delete ib.second;
-	}
-	m_instanceBuffers.clear();
+		ib->ReleaseResources();
+		delete ib;
+	});
+	m_instanceBuffers.Clear();
 }
 
 
@@ -1075,12 +949,12 @@ void Renderer::DestroyInstanceBuffers()
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::DestroySwapchains()
 {
-	for (auto sc : m_swapchains)
+	m_swapchains.ForEach([](SwapchainID, Swapchain* sc)
 	{
-		sc.second->ReleaseResources();
-		delete sc.second;
-	}
-	m_swapchains.clear();
+		sc->ReleaseResources();
+		delete sc;
+	});
+	m_swapchains.Clear();
 }
 
 
@@ -1088,12 +962,12 @@ void Renderer::DestroySwapchains()
 //----------------------------------------------------------------------------------------------------------------------
 void Renderer::DestroyRenderTargets()
 {
-	for (auto rt : m_renderTargets)
+	m_renderTargets.ForEach([](RenderTargetID, RenderTarget* rt)
 	{
-		rt.second->ReleaseResources();
-		delete rt.second;
-	}
-	m_renderTargets.clear();
+		rt->ReleaseResources();
+		delete rt;
+	});
+	m_renderTargets.Clear();
 }
 
 
@@ -2,10 +2,9 @@
 #pragma once
 #include "Engine/Assets/AssetID.h"
 #include "Engine/Core/EngineSubsystem.h"
+#include "Engine/DataStructures/SlotMap.h"
 #include "RendererSettings.h"
 #include "RendererUtils.h"
-#include <unordered_map>
-#include <mutex>
 
 
 
@@ -40,6 +39,7 @@ struct RendererConfig
 {
 	RendererUserSettings m_startupUserSettings;
 	Name m_defaultFontName = "Data/Fonts/Gypsy.fnt";
+	bool m_headless = false; // Use the NullRenderer, nothing is drawn but draws and state changes are counted
 };
 
 
@@ -168,15 +168,6 @@ public:
 
 protected:
 
-    // ID Functions
-    TextureID        RequestTextureID() const;
-    ShaderID         RequestShaderID() const;
-    ConstantBufferID RequestConstantBufferID() const;
-    VertexBufferID   RequestVertexBufferID() const;
-    InstanceBufferID RequestInstanceBufferID() const;
-    SwapchainID      RequestSwapchainID() const;
-    RenderTargetID   RequestRenderTargetID() const;
-
     virtual VertexBufferID MakeTypedVertexBufferInternal(size_t vertSize, size_t numVerts);
     virtual InstanceBufferID MakeTypedInstanceBufferInternal(size_t instanceSize, size_t numInstances);
 
@@ -266,23 +257,14 @@ protected:
     ShaderID            m_defaultShader        = RendererUtils::InvalidID;
     TextureID           m_defaultTexture       = RendererUtils::InvalidID;
 
-    // GPU Objects
-    std::unordered_map<ShaderID, Shader*> m_shaders;
-    std::unordered_map<TextureID, Texture*> m_textures;
-    std::unordered_map<SwapchainID, Swapchain*> m_swapchains;
-    std::unordered_map<VertexBufferID, VertexBuffer*> m_vertexBuffers;
-    std::unordered_map<RenderTargetID, RenderTarget*> m_renderTargets;
-    std::unordered_map<InstanceBufferID, InstanceBuffer*> m_instanceBuffers;
-    std::unordered_map<ConstantBufferID, ConstantBuffer*> m_constantBuffers;
-
-    // Mutexes
-    mutable std::mutex m_shadersMutex;
-    mutable std::mutex m_texturesMutex;
-    mutable std::mutex m_swapchainsMutex;
-    mutable std::mutex m_vertexBuffersMutex;
-    mutable std::mutex m_constantBuffersMutex;
-    mutable std::mutex m_instanceBuffersMutex;
-    mutable std::mutex m_renderTargetsMutex;
+    // GPU Objects, IDs are slot map IDs so Get is lock free and a released ID never finds a newer resource
+    SlotMap<Shader> m_shaders;
+    SlotMap<Texture> m_textures;
+    SlotMap<Swapchain> m_swapchains;
+    SlotMap<VertexBuffer> m_vertexBuffers;
+    SlotMap<RenderTarget> m_renderTargets;
+    SlotMap<InstanceBuffer> m_instanceBuffers;
+    SlotMap<ConstantBuffer> m_constantBuffers;
 
     // Debug
 #if defined(_DEBUG)
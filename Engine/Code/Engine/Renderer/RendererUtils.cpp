@@ -2,6 +2,7 @@
 #include "RendererUtils.h"
 
 #include "Game/Framework/EngineBuildPreferences.h"
+#include "Null/NullRenderer.h"
 
 #if defined(RENDERER_D3D11)
 #include "D3D11/D3D11Renderer.h"
@@ -17,10 +18,15 @@ uint32_t RendererUtils::InvalidID = UINT32_MAX;
 //----------------------------------------------------------------------------------------------------------------------
 Renderer* RendererUtils::MakeRenderer(RendererConfig const& config)
 {
+	if (config.m_headless)
+	{
+		return new NullRenderer(config);
+	}
+
 	#if defined(RENDERER_D3D11)
 		return new D3D11Renderer(config);
 	#else
-		UNUSED(config);
-		return nullptr;
+		// No platform renderer, run headless
+		return new NullRenderer(config);
 	#endif // RENDERER_D3D11
 }
\ No newline at end of file
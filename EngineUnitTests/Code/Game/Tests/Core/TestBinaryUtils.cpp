@@ -108,4 +108,20 @@ namespace TestBinaryUtils
         EXPECT_EQ(FirstUnsetBit(mask, 5), 10);
     }
 
+
+
+    //------------------------------------------------------------------------------------------------------------------
+    // Test: HashBytes matches the published FNV-1a values, and hashing in pieces matches hashing all at once
+    //
+    TEST(BinaryUtils, HashBytes)
+    {
+        EXPECT_EQ(HashBytes(nullptr, 0), HASH_BYTES_SEED);
+        EXPECT_EQ(HashBytes("a", 1), 0xaf63dc4c8601ec8cull);
+        EXPECT_EQ(HashBytes("foobar", 6), 0x85944171f73967e8ull);
+
+        uint64_t hash = HashBytes("foo", 3);
+        EXPECT_EQ(HashBytes("bar", 3, hash), HashBytes("foobar", 6));
+        EXPECT_NE(HashBytes("foobaz", 6), HashBytes("foobar", 6));
+    }
+
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 #include <random>
+#include <string_view>
+#include <thread>
 #include <gtest/gtest.h>
 
 
@@ -174,4 +176,84 @@ namespace TestName
         EXPECT_EQ(std::string(cstr), "Alpha");
     }
 
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Test 7: string_view and std::string make the same name, including views that aren't null terminated
+    //
+    TEST(NameTests, StringView)
+    {
+        NameTableScope scope;
+
+        std::string_view sentence = "BeginFrame EndFrame";
+        Name begin(sentence.substr(0, 10));
+        Name end(sentence.substr(11));
+
+        EXPECT_EQ(begin, Name("BeginFrame"));
+        EXPECT_EQ(end, Name(std::string("endframe")));
+        EXPECT_EQ(begin.ToString(), "BeginFrame");
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Test 8: Enough names to grow every shard of the name table several times, all still found after
+    //
+    TEST(NameTests, TableGrowth)
+    {
+        NameTableScope scope;
+
+        std::vector<Name> names;
+        for (int i = 0; i < 50000; ++i)
+        {
+            names.emplace_back("Grow_" + std::to_string(i));
+        }
+        for (int i = 0; i < 50000; ++i)
+        {
+            std::string string = "GROW_" + std::to_string(i);
+            EXPECT_EQ(Name(string), names[i]);
+        }
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Test 9: Threads making overlapping sets of names at the same time all agree on every index
+    //
+    TEST(NameTests, ConcurrentCreation)
+    {
+        NameTableScope scope;
+
+        constexpr int numThreads = 8;
+        constexpr int numNames = 4096; // Power of two, so stepping by any odd number visits every name
+        std::vector<std::vector<Name>> threadNames(numThreads);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([t, &threadNames]()
+            {
+                // Each thread walks the names in a different order so they race to add different ones
+                std::vector<Name>& names = threadNames[t];
+                names.resize(numNames);
+                for (int i = 0; i < numNames; ++i)
+                {
+                    int nameIndex = (i * (2 * t + 1)) % numNames;
+                    names[nameIndex] = Name("Concurrent_" + std::to_string(nameIndex));
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (int i = 0; i < numNames; ++i)
+        {
+            for (int t = 1; t < numThreads; ++t)
+            {
+                EXPECT_EQ(threadNames[t][i], threadNames[0][i]);
+            }
+            EXPECT_EQ(threadNames[0][i].ToString(), "Concurrent_" + std::to_string(i));
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,329 @@
+// Bradley Christensen 2022-2026
+#include "pch.h"
+#include "Engine/DataStructures/BucketQueue.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <queue>
+#include <random>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Bucket Queue Tests
+//
+namespace TestBucketQueue
+{
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Pops come out in bucket order
+    //
+    TEST(BucketQueue, PopsInBucketOrder)
+    {
+        BucketQueue<int> queue(1.f);
+        queue.Push(5, 5.5f);
+        queue.Push(1, 1.25f);
+        queue.Push(3, 3.f);
+        queue.Push(0, 0.f);
+        EXPECT_EQ(queue.Size(), 4);
+
+        EXPECT_EQ(queue.Pop(), 0);
+        EXPECT_EQ(queue.Pop(), 1);
+        EXPECT_EQ(queue.Pop(), 3);
+        EXPECT_EQ(queue.Pop(), 5);
+        EXPECT_TRUE(queue.IsEmpty());
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Pushing below the current bucket after popping still pops it next
+    //
+    TEST(BucketQueue, PushBelowCurrentBucket)
+    {
+        BucketQueue<int> queue(1.f);
+        queue.Push(10, 10.f);
+        queue.Push(20, 20.f);
+        EXPECT_EQ(queue.Pop(), 10);
+
+        queue.Push(2, 2.f);
+        EXPECT_EQ(queue.Pop(), 2);
+        EXPECT_EQ(queue.Pop(), 20);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Decrease-key only pushes when the key moves to a different bucket, and Pop reports which bucket it came from
+    //
+    TEST(BucketQueue, PushOrUpdate)
+    {
+        BucketQueue<int> queue(0.5f);
+        int queuedBucket = BucketQueue<int>::s_notQueued;
+
+        EXPECT_TRUE(queue.PushOrUpdate(7, 3.2f, queuedBucket));
+        EXPECT_EQ(queuedBucket, queue.GetBucket(3.2f));
+        EXPECT_FALSE(queue.PushOrUpdate(7, 3.1f, queuedBucket));
+        EXPECT_EQ(queue.Size(), 1);
+
+        EXPECT_TRUE(queue.PushOrUpdate(7, 1.f, queuedBucket));
+        EXPECT_EQ(queue.Size(), 2);
+
+        int poppedBucket = BucketQueue<int>::s_notQueued;
+        EXPECT_EQ(queue.Pop(&poppedBucket), 7);
+        EXPECT_EQ(poppedBucket, queuedBucket);
+
+        // The entry left in the old bucket is stale
+        EXPECT_EQ(queue.Pop(&poppedBucket), 7);
+        EXPECT_NE(poppedBucket, queuedBucket);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    TEST(BucketQueue, ClearAndReuse)
+    {
+        BucketQueue<int> queue(1.f);
+        for (int i = 0; i < 100; ++i)
+        {
+            queue.Push(i, (float) i);
+        }
+        queue.Clear();
+        EXPECT_TRUE(queue.IsEmpty());
+
+        queue.Push(42, 50.f);
+        queue.Push(41, 3.f);
+        EXPECT_EQ(queue.Pop(), 41);
+        EXPECT_EQ(queue.Pop(), 42);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Fast marching on a grid shaped like a fully loaded flow field, the way the games generate their distance fields
+    //
+    struct FlowGrid
+    {
+        FlowGrid(int width, unsigned int seed) : m_width(width), m_costs(width * width, 1)
+        {
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<int> roll(0, 99);
+            for (uint8_t& cost : m_costs)
+            {
+                int value = roll(rng);
+                cost = value < 15 ? 255 : (value < 20 ? 10 : (value < 22 ? 50 : 1)); // Walls, water, and deep water
+            }
+            m_costs[0] = 1;
+        }
+
+        bool IsWalkable(int x, int y) const
+        {
+            return x >= 0 && y >= 0 && x < m_width && y < m_width && m_costs[y * m_width + x] != 255;
+        }
+
+        int m_width = 0;
+        std::vector<uint8_t> m_costs;
+    };
+
+    struct GridCell
+    {
+        int m_index = 0;
+        float m_distance = 0.f;
+
+        bool operator<(GridCell const& rhs) const { return m_distance > rhs.m_distance; }
+    };
+
+    constexpr float MAX_DISTANCE = 999999.f;
+    int const s_offsetsX[4] = { 1, -1, 0, 0 };
+    int const s_offsetsY[4] = { 0, 0, 1, -1 };
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    float SolveCell(FlowGrid const& grid, std::vector<float> const& distances, int x, int y)
+    {
+        float dx = FLT_MAX;
+        float dy = FLT_MAX;
+        for (int i = 0; i < 4; ++i)
+        {
+            int nx = x + s_offsetsX[i];
+            int ny = y + s_offsetsY[i];
+            if (!grid.IsWalkable(nx, ny))
+            {
+                continue;
+            }
+            float distance = distances[ny * grid.m_width + nx];
+            if (s_offsetsX[i] != 0)
+            {
+                dx = std::min(dx, distance);
+            }
+            else
+            {
+                dy = std::min(dy, distance);
+            }
+        }
+
+        // Only take the two sided solution if it is upwind of both neighbors, same as FlowFieldUtils::SolveEikonal
+        float cost = (float) grid.m_costs[y * grid.m_width + x];
+        float delta = 2.f * cost - (dx - dy) * (dx - dy);
+        if (delta >= 0.f)
+        {
+            float distance = (dx + dy + std::sqrt(delta)) * 0.5f;
+            if (distance >= std::max(dx, dy))
+            {
+                return distance;
+            }
+        }
+        return std::min(dx + cost, dy + cost);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // The old way, a binary heap that gets a new entry every time a cell improves
+    //
+    void SolveWithPriorityQueue(FlowGrid const& grid, std::vector<float>& out_distances)
+    {
+        out_distances.assign(grid.m_costs.size(), MAX_DISTANCE);
+        std::vector<uint8_t> considered(grid.m_costs.size(), 0);
+        std::priority_queue<GridCell> openList;
+
+        out_distances[0] = 0.f;
+        openList.push({ 0, 0.f });
+        while (!openList.empty())
+        {
+            GridCell current = openList.top();
+            openList.pop();
+            if (considered[current.m_index])
+            {
+                continue;
+            }
+            considered[current.m_index] = 1;
+
+            int x = current.m_index % grid.m_width;
+            int y = current.m_index / grid.m_width;
+            for (int i = 0; i < 4; ++i)
+            {
+                int nx = x + s_offsetsX[i];
+                int ny = y + s_offsetsY[i];
+                int neighborIndex = ny * grid.m_width + nx;
+                if (!grid.IsWalkable(nx, ny) || considered[neighborIndex])
+                {
+                    continue;
+                }
+                float distance = SolveCell(grid, out_distances, nx, ny);
+                if (distance < out_distances[neighborIndex])
+                {
+                    out_distances[neighborIndex] = distance;
+                    openList.push({ neighborIndex, distance });
+                }
+            }
+        }
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    void SolveWithBucketQueue(FlowGrid const& grid, BucketQueue<int>& openList, std::vector<int>& queuedBuckets, std::vector<float>& out_distances)
+    {
+        out_distances.assign(grid.m_costs.size(), MAX_DISTANCE);
+        queuedBuckets.assign(grid.m_costs.size(), BucketQueue<int>::s_notQueued);
+        std::vector<uint8_t> considered(grid.m_costs.size(), 0);
+        openList.Clear();
+
+        out_distances[0] = 0.f;
+        openList.PushOrUpdate(0, 0.f, queuedBuckets[0]);
+        while (!openList.IsEmpty())
+        {
+            int bucket = 0;
+            int currentIndex = openList.Pop(&bucket);
+            if (queuedBuckets[currentIndex] != bucket)
+            {
+                // Stale, the cell moved to a lower bucket and was already popped from there
+                continue;
+            }
+            queuedBuckets[currentIndex] = BucketQueue<int>::s_notQueued;
+            considered[currentIndex] = 1;
+
+            int x = currentIndex % grid.m_width;
+            int y = currentIndex / grid.m_width;
+            for (int i = 0; i < 4; ++i)
+            {
+                int nx = x + s_offsetsX[i];
+                int ny = y + s_offsetsY[i];
+                int neighborIndex = ny * grid.m_width + nx;
+                if (!grid.IsWalkable(nx, ny) || considered[neighborIndex])
+                {
+                    continue;
+                }
+                float distance = SolveCell(grid, out_distances, nx, ny);
+                if (distance < out_distances[neighborIndex])
+                {
+                    out_distances[neighborIndex] = distance;
+                    openList.PushOrUpdate(neighborIndex, distance, queuedBuckets[neighborIndex]);
+                }
+            }
+        }
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Cells within a bucket pop in any order, so the field can differ from the heap's by a fraction of the bucket width
+    //
+    TEST(BucketQueue, FastMarchingMatchesPriorityQueue)
+    {
+        for (unsigned int seed = 0; seed < 8; ++seed)
+        {
+            FlowGrid grid(64, seed);
+            std::vector<float> heapDistances;
+            std::vector<float> bucketDistances;
+            std::vector<int> queuedBuckets;
+            BucketQueue<int> openList(0.5f);
+
+            SolveWithPriorityQueue(grid, heapDistances);
+            SolveWithBucketQueue(grid, openList, queuedBuckets, bucketDistances);
+
+            for (int i = 0; i < (int) heapDistances.size(); ++i)
+            {
+                EXPECT_NEAR(heapDistances[i], bucketDistances[i], 0.01f) << "seed " << seed << " cell " << i;
+            }
+        }
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // A fully loaded 50 unit flow field radius is about 6x6 chunks of 16x16 tiles. Not a pass/fail test, prints results.
+    //
+    TEST(BucketQueue, FastMarchingBenchmark)
+    {
+        constexpr int numIterations = 50;
+        FlowGrid grid(96, 1234);
+        std::vector<float> distances;
+        std::vector<int> queuedBuckets;
+        BucketQueue<int> openList(0.5f);
+
+        auto heapStart = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < numIterations; ++i)
+        {
+            SolveWithPriorityQueue(grid, distances);
+        }
+        auto heapEnd = std::chrono::high_resolution_clock::now();
+
+        for (int i = 0; i < numIterations; ++i)
+        {
+            SolveWithBucketQueue(grid, openList, queuedBuckets, distances);
+        }
+        auto bucketEnd = std::chrono::high_resolution_clock::now();
+
+        double heapMs = std::chrono::duration<double, std::milli>(heapEnd - heapStart).count() / numIterations;
+        double bucketMs = std::chrono::duration<double, std::milli>(bucketEnd - heapEnd).count() / numIterations;
+        std::printf("[ BENCH    ] Fast marching 96x96: priority queue %.3f ms, bucket queue %.3f ms (%.2fx)\n", heapMs, bucketMs, heapMs / bucketMs);
+    }
+}
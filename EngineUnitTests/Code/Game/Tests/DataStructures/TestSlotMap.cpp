@@ -0,0 +1,215 @@
+// Bradley Christensen 2022-2026
+#include "pch.h"
+#include "Engine/DataStructures/SlotMap.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Slot Map Tests
+//
+namespace TestSlotMap
+{
+
+    //----------------------------------------------------------------------------------------------------------------------
+    TEST(SlotMap, AddGetRemove)
+    {
+        int a = 1;
+        int b = 2;
+        SlotMap<int> slotMap;
+
+        uint32_t idA = slotMap.Add(&a);
+        uint32_t idB = slotMap.Add(&b);
+        EXPECT_NE(idA, idB);
+        EXPECT_EQ(slotMap.Size(), 2);
+        EXPECT_EQ(slotMap.Get(idA), &a);
+        EXPECT_EQ(slotMap.Get(idB), &b);
+
+        EXPECT_EQ(slotMap.Remove(idA), &a);
+        EXPECT_EQ(slotMap.Get(idA), nullptr);
+        EXPECT_EQ(slotMap.Remove(idA), nullptr);
+        EXPECT_EQ(slotMap.Get(idB), &b);
+        EXPECT_EQ(slotMap.Size(), 1);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // The renderer treats 0 like no resource in a few asserts, and UINT32_MAX is RendererUtils::InvalidID
+    //
+    TEST(SlotMap, IDsAreNeverZeroOrInvalid)
+    {
+        int value = 0;
+        SlotMap<int> slotMap;
+        EXPECT_EQ(slotMap.Get(0), nullptr);
+        EXPECT_EQ(slotMap.Get(UINT32_MAX), nullptr);
+
+        for (uint32_t i = 0; i < SlotMap<int>::s_maxGeneration + 10; ++i)
+        {
+            uint32_t id = slotMap.Add(&value);
+            EXPECT_NE(id, 0u);
+            EXPECT_NE(id, UINT32_MAX);
+            slotMap.Remove(id);
+        }
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Released slots are reused, but the old ID doesn't find the new value
+    //
+    TEST(SlotMap, StaleIDAfterReuse)
+    {
+        int a = 1;
+        int b = 2;
+        SlotMap<int> slotMap;
+
+        uint32_t idA = slotMap.Add(&a);
+        slotMap.Remove(idA);
+        uint32_t idB = slotMap.Add(&b);
+
+        EXPECT_EQ(idA & SlotMap<int>::s_indexMask, idB & SlotMap<int>::s_indexMask);
+        EXPECT_NE(idA, idB);
+        EXPECT_EQ(slotMap.Get(idA), nullptr);
+        EXPECT_EQ(slotMap.Remove(idA), nullptr);
+        EXPECT_EQ(slotMap.Get(idB), &b);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    TEST(SlotMap, ForEachAndClear)
+    {
+        std::vector<int> values(1000);
+        std::vector<uint32_t> ids;
+        SlotMap<int> slotMap;
+        for (int& value : values)
+        {
+            ids.push_back(slotMap.Add(&value));
+        }
+        for (int i = 0; i < 1000; i += 2)
+        {
+            slotMap.Remove(ids[i]);
+        }
+
+        int numVisited = 0;
+        slotMap.ForEach([&](uint32_t id, int* value)
+        {
+            EXPECT_EQ(slotMap.Get(id), value);
+            EXPECT_EQ((value - values.data()) % 2, 1);
+            ++numVisited;
+        });
+        EXPECT_EQ(numVisited, 500);
+
+        slotMap.Clear();
+        EXPECT_EQ(slotMap.Size(), 0);
+        for (uint32_t id : ids)
+        {
+            EXPECT_EQ(slotMap.Get(id), nullptr);
+        }
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Readers keep looking up IDs that exist the whole time, while another thread adds and removes around them
+    //
+    TEST(SlotMap, ConcurrentGet)
+    {
+        std::vector<int> stableValues(64);
+        std::vector<uint32_t> stableIDs;
+        SlotMap<int> slotMap;
+        for (int& value : stableValues)
+        {
+            stableIDs.push_back(slotMap.Add(&value));
+        }
+
+        std::atomic<bool> done = false;
+        std::atomic<int> numWrongLookups = 0;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+        {
+            readers.emplace_back([&]()
+            {
+                while (!done)
+                {
+                    for (int i = 0; i < (int) stableIDs.size(); ++i)
+                    {
+                        if (slotMap.Get(stableIDs[i]) != &stableValues[i])
+                        {
+                            ++numWrongLookups;
+                        }
+                    }
+                }
+            });
+        }
+
+        std::vector<int> churnValues(5000);
+        for (int round = 0; round < 10; ++round)
+        {
+            std::vector<uint32_t> churnIDs;
+            for (int& value : churnValues)
+            {
+                churnIDs.push_back(slotMap.Add(&value));
+            }
+            for (uint32_t id : churnIDs)
+            {
+                slotMap.Remove(id);
+            }
+        }
+        done = true;
+        for (std::thread& reader : readers)
+        {
+            reader.join();
+        }
+        EXPECT_EQ(numWrongLookups, 0);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Not a pass/fail test, prints results. What the renderer did per Get before, a locked unordered_map find.
+    //
+    TEST(SlotMap, GetBenchmark)
+    {
+        constexpr int numResources = 256;
+        constexpr int numLookups = 1000000;
+        std::vector<int> values(numResources);
+        std::vector<uint32_t> ids;
+        SlotMap<int> slotMap;
+        std::unordered_map<uint32_t, int*> map;
+        std::mutex mapMutex;
+        for (int i = 0; i < numResources; ++i)
+        {
+            values[i] = i;
+            ids.push_back(slotMap.Add(&values[i]));
+            map[i] = &values[i];
+        }
+
+        long long sum = 0;
+        auto mapStart = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < numLookups; ++i)
+        {
+            std::unique_lock lock(mapMutex);
+            auto it = map.find(i % numResources);
+            sum += (it != map.end()) ? *it->second : 0;
+        }
+        auto mapEnd = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < numLookups; ++i)
+        {
+            sum += *slotMap.Get(ids[i % numResources]);
+        }
+        auto slotMapEnd = std::chrono::high_resolution_clock::now();
+
+        double mapNs = std::chrono::duration<double, std::nano>(mapEnd - mapStart).count() / numLookups;
+        double slotMapNs = std::chrono::duration<double, std::nano>(slotMapEnd - mapEnd).count() / numLookups;
+        std::printf("[ BENCH    ] Get: locked unordered_map %.2f ns, slot map %.2f ns (checksum %lld)\n", mapNs, slotMapNs, sum);
+    }
+}
@@ -0,0 +1,277 @@
+// Bradley Christensen 2022-2026
+#include "pch.h"
+#include "Engine/ECS/AdminSystem.h"
+#include "Engine/ECS/EntityCommandBuffer.h"
+#include "Engine/ECS/EntityPrefab.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Entity Command Buffer Tests
+//
+namespace TestEntityCommandBuffer
+{
+    struct CTestComponent
+    {
+        CTestComponent() = default;
+        explicit CTestComponent(int value) : m_value(value) {}
+
+        int m_value = 0;
+    };
+
+    struct CTestTag
+    {
+    };
+
+    // Counts live copies, and owns heap memory so a byte copy of it would be caught by sanitizers
+    struct CTestCounted
+    {
+        CTestCounted() { ++s_numAlive; }
+        explicit CTestCounted(int value) : m_values(1, value) { ++s_numAlive; }
+        CTestCounted(CTestCounted const& other) : m_values(other.m_values) { ++s_numAlive; }
+        ~CTestCounted() { --s_numAlive; }
+
+        std::vector<int> m_values;
+        static int s_numAlive;
+    };
+    int CTestCounted::s_numAlive = 0;
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Nothing happens until playback, then deferred entities get real IDs and their components
+    //
+    TEST(EntityCommandBuffer, CreateAndAddOnPlayback)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentArray<CTestComponent>();
+
+        EntityCommandBuffer commandBuffer;
+        DeferredEntityID deferred = commandBuffer.CreateEntity();
+        commandBuffer.AddComponent<CTestComponent>(deferred, 7);
+
+        EntityID createdID = EntityID::Invalid;
+        commandBuffer.OnEntityCreated(deferred, [&createdID](EntityID id) { createdID = id; });
+
+        EXPECT_EQ(admin.NumEntities(), 0);
+        EXPECT_FALSE(commandBuffer.IsEmpty());
+
+        commandBuffer.Playback(admin);
+
+        EXPECT_TRUE(commandBuffer.IsEmpty());
+        EXPECT_EQ(admin.NumEntities(), 1);
+        ASSERT_TRUE(admin.IsValid(createdID));
+        ASSERT_NE(admin.GetComponent<CTestComponent>(createdID), nullptr);
+        EXPECT_EQ(admin.GetComponent<CTestComponent>(createdID)->m_value, 7);
+        EXPECT_EQ(admin.Count<CTestComponent>(), 1);
+
+        admin.Shutdown();
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Remove and destroy target existing entities, and commands on destroyed entities are skipped
+    //
+    TEST(EntityCommandBuffer, RemoveAndDestroy)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentArray<CTestComponent>();
+
+        EntityID a = admin.CreateEntity();
+        EntityID b = admin.CreateEntity();
+        admin.AddComponent<CTestComponent>(a, 1);
+        admin.AddComponent<CTestComponent>(b, 2);
+
+        EntityCommandBuffer commandBuffer;
+        commandBuffer.RemoveComponent<CTestComponent>(a);
+        commandBuffer.DestroyEntity(b);
+        commandBuffer.AddComponent<CTestComponent>(b, 3);
+        commandBuffer.Playback(admin);
+
+        EXPECT_TRUE(admin.IsValid(a));
+        EXPECT_EQ(admin.GetComponent<CTestComponent>(a), nullptr);
+        EXPECT_FALSE(admin.IsValid(b));
+        EXPECT_EQ(admin.Count<CTestComponent>(), 0);
+
+        admin.Shutdown();
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Toggling a tag moves the entity in and out of queries that include it
+    //
+    TEST(EntityCommandBuffer, SetTagUpdatesQueries)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentArray<CTestComponent>();
+        admin.RegisterTag<CTestTag>();
+
+        EntityQuery& taggedQuery = admin.GetOrCreateQuery(admin.GetComponentBitMask<CTestComponent, CTestTag>());
+
+        EntityID a = admin.CreateEntity();
+        EntityID b = admin.CreateEntity();
+        admin.AddComponent<CTestComponent>(a, 1);
+        admin.AddComponent<CTestComponent>(b, 2);
+
+        EntityCommandBuffer commandBuffer;
+        commandBuffer.SetTag<CTestTag>(a, true);
+        commandBuffer.SetTag<CTestTag>(b, true);
+        commandBuffer.Playback(admin);
+        EXPECT_EQ(taggedQuery.Count(), 2);
+        EXPECT_TRUE(admin.HasComponent<CTestTag>(a));
+
+        // Setting it again is harmless, clearing it leaves the rest of the entity alone
+        commandBuffer.SetTag<CTestTag>(a, true);
+        commandBuffer.SetTag<CTestTag>(b, false);
+        commandBuffer.Playback(admin);
+        EXPECT_EQ(taggedQuery.Count(), 1);
+        EXPECT_TRUE(taggedQuery.Contains(a.GetIndex()));
+        EXPECT_FALSE(admin.HasComponent<CTestTag>(b));
+        ASSERT_NE(admin.GetComponent<CTestComponent>(b), nullptr);
+        EXPECT_EQ(admin.GetComponent<CTestComponent>(b)->m_value, 2);
+
+        admin.Shutdown();
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Appending keeps each buffer's deferred entities distinct
+    //
+    TEST(EntityCommandBuffer, AppendRemapsDeferredEntities)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentArray<CTestComponent>();
+
+        EntityCommandBuffer first;
+        first.AddComponent<CTestComponent>(first.CreateEntity(), 10);
+
+        EntityCommandBuffer second;
+        second.CreateEntity();
+        second.AddComponent<CTestComponent>(second.CreateEntity(), 20);
+
+        first.Append(second);
+        EXPECT_TRUE(second.IsEmpty());
+
+        first.Playback(admin);
+
+        EXPECT_EQ(admin.NumEntities(), 3);
+        EXPECT_EQ(admin.Count<CTestComponent>(), 2);
+
+        auto& storage = admin.GetArrayStorage<CTestComponent>();
+        int sum = 0;
+        for (GroupIter it = admin.IterateAll<CTestComponent>(); it.IsValid(); ++it)
+        {
+            sum += storage.Get(it)->m_value;
+        }
+        EXPECT_EQ(sum, 30);
+
+        admin.Shutdown();
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Recorded components are stored by the buffer until playback, and every stored copy gets destroyed whether it was
+    // played back, skipped, appended to another buffer, or cleared
+    //
+    TEST(EntityCommandBuffer, StoredComponentsAreDestroyed)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentMap<CTestCounted>();
+
+        EntityID destroyed = admin.CreateEntity();
+
+        {
+            EntityCommandBuffer first;
+            EntityCommandBuffer second;
+
+            // Second frame reuses the blocks handed back and forth by the first
+            for (int frame = 1; frame <= 2; ++frame)
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    // Enough to fill several blocks in each buffer
+                    first.AddComponent<CTestCounted>(first.CreateEntity(), i);
+                    second.AddComponent<CTestCounted>(second.CreateEntity(), i);
+                }
+                if (frame == 1)
+                {
+                    first.DestroyEntity(destroyed);
+                    first.AddComponent<CTestCounted>(destroyed, -1);
+                    EXPECT_EQ(CTestCounted::s_numAlive, 2001);
+                }
+
+                first.Append(second);
+                first.Playback(admin);
+                EXPECT_EQ(CTestCounted::s_numAlive, 2000 * frame);
+                EXPECT_EQ(admin.Count<CTestCounted>(), 2000 * frame);
+            }
+
+            int sum = 0;
+            for (auto const& [entityIndex, component] : admin.GetMapStorage<CTestCounted>().m_data)
+            {
+                sum += component.m_values[0];
+            }
+            EXPECT_EQ(sum, 4 * (999 * 1000 / 2));
+
+            // Cleared or destroyed without playing back
+            first.AddComponent<CTestCounted>(first.CreateEntity(), 1);
+            first.Clear();
+            second.AddComponent<CTestCounted>(second.CreateEntity(), 2);
+            EXPECT_EQ(CTestCounted::s_numAlive, 4001);
+        }
+        EXPECT_EQ(CTestCounted::s_numAlive, 4000);
+
+        admin.Shutdown();
+        EXPECT_EQ(CTestCounted::s_numAlive, 0);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Consecutive instantiates get consecutive deferred IDs, so one callback can pick up all of them
+    //
+    TEST(EntityCommandBuffer, InstantiatePrefabs)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentArray<CTestComponent>();
+        admin.RegisterComponentMap<CTestTag>();
+
+        EntityPrefab tagged;
+        tagged.AddComponent(admin, CTestComponent(1));
+        tagged.AddComponent(admin, CTestTag());
+        EntityPrefab untagged;
+        untagged.AddComponent(admin, CTestComponent(2));
+
+        EntityCommandBuffer commandBuffer;
+        DeferredEntityID first = commandBuffer.Instantiate(tagged, 3);
+        DeferredEntityID second = commandBuffer.Instantiate(untagged, 2);
+        EXPECT_EQ(second.m_index, first.m_index + 3);
+        commandBuffer.AddComponent<CTestTag>(DeferredEntityID{ second.m_index + 1 });
+
+        std::vector<EntityID> createdIDs;
+        commandBuffer.OnEntitiesCreated(first, 5, [&createdIDs](EntityID const* entityIDs, int count)
+        {
+            createdIDs.assign(entityIDs, entityIDs + count);
+        });
+
+        commandBuffer.Playback(admin);
+
+        ASSERT_EQ(createdIDs.size(), 5u);
+        int expectedValues[] = { 1, 1, 1, 2, 2 };
+        for (int i = 0; i < 5; ++i)
+        {
+            ASSERT_TRUE(admin.IsValid(createdIDs[i]));
+            EXPECT_EQ(admin.GetComponent<CTestComponent>(createdIDs[i])->m_value, expectedValues[i]);
+            EXPECT_EQ(admin.HasComponent<CTestTag>(createdIDs[i]), i != 3);
+        }
+        EXPECT_EQ(admin.NumEntities(), 5);
+
+        admin.Shutdown();
+    }
+}
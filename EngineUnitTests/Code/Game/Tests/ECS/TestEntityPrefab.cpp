@@ -0,0 +1,156 @@
+// Bradley Christensen 2022-2026
+#include "pch.h"
+#include "Engine/ECS/AdminSystem.h"
+#include "Engine/ECS/EntityPrefab.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Entity Prefab Tests
+//
+namespace TestEntityPrefab
+{
+    struct CArrayComponent
+    {
+        int m_value = 0;
+    };
+
+    struct CMapComponent
+    {
+        int m_value = 0;
+    };
+
+    struct CSparseComponent
+    {
+        float m_value = 0.f;
+    };
+
+    struct CUnusedComponent
+    {
+        int m_value = 0;
+    };
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Every kind of storage gets a copy of the prefab's component, and nothing the prefab doesn't have
+    //
+    TEST(EntityPrefab, InstantiateCopiesComponents)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentArray<CArrayComponent>();
+        admin.RegisterComponentMap<CMapComponent>();
+        admin.RegisterComponentSparseSet<CSparseComponent>();
+        admin.RegisterComponentArray<CUnusedComponent>();
+
+        EntityPrefab prefab;
+        prefab.AddComponent(admin, CArrayComponent{ 1 });
+        prefab.AddComponent(admin, CMapComponent{ 2 });
+        prefab.AddComponent(admin, CSparseComponent{ 3.f });
+        EXPECT_EQ(prefab.GetNumComponents(), 3);
+        BitMask expectedComposition = admin.GetComponentBitMask<CArrayComponent, CMapComponent, CSparseComponent>();
+        EXPECT_EQ(prefab.GetComposition(), expectedComposition);
+
+        std::vector<EntityID> ids;
+        EXPECT_EQ(admin.Instantiate(prefab, 100, ids), 100);
+        ASSERT_EQ((int) ids.size(), 100);
+        EXPECT_EQ(admin.NumEntities(), 100);
+        for (EntityID id : ids)
+        {
+            ASSERT_TRUE(admin.IsValid(id));
+            EXPECT_EQ(admin.GetComponent<CArrayComponent>(id)->m_value, 1);
+            EXPECT_EQ(admin.GetComponent<CMapComponent>(id)->m_value, 2);
+            EXPECT_EQ(admin.GetComponent<CSparseComponent>(id)->m_value, 3.f);
+            EXPECT_FALSE(admin.HasComponent<CUnusedComponent>(id));
+        }
+        EXPECT_EQ(admin.GetSparseSetStorage<CSparseComponent>().Count(), 100);
+
+        // Components are copies, changing one entity doesn't change the others or the prefab
+        admin.GetComponent<CArrayComponent>(ids[0])->m_value = 10;
+        EntityID single = admin.Instantiate(prefab);
+        EXPECT_EQ(admin.GetComponent<CArrayComponent>(single)->m_value, 1);
+        EXPECT_EQ(admin.GetComponent<CArrayComponent>(ids[1])->m_value, 1);
+
+        admin.Shutdown();
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // A batch takes the first gap big enough for all of it, and fills holes one by one when there isn't one
+    //
+    TEST(EntityPrefab, InstantiateFindsContiguousRun)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentArray<CArrayComponent>();
+
+        EntityPrefab prefab;
+        prefab.AddComponent(admin, CArrayComponent{ 5 });
+
+        // Entities at 0-9, then free 2-3 and 6-7
+        std::vector<EntityID> ids;
+        admin.Instantiate(prefab, 10, ids);
+        admin.DestroyEntity(ids[2]);
+        admin.DestroyEntity(ids[3]);
+        admin.DestroyEntity(ids[6]);
+        admin.DestroyEntity(ids[7]);
+
+        std::vector<EntityID> batch;
+        EXPECT_EQ(admin.Instantiate(prefab, 2, batch), 2);
+        EXPECT_EQ(batch[0].GetIndex(), 2);
+        EXPECT_EQ(batch[1].GetIndex(), 3);
+
+        batch.clear();
+        EXPECT_EQ(admin.Instantiate(prefab, 3, batch), 3);
+        EXPECT_EQ(batch[0].GetIndex(), 10);
+        EXPECT_EQ(batch[2].GetIndex(), 12);
+        EXPECT_EQ(admin.GetHighWatermarkEntityID(), 12);
+
+        // Singles fill the first hole, and the old ID for a reused index stays invalid
+        EntityID single = admin.Instantiate(prefab);
+        EXPECT_EQ(single.GetIndex(), 6);
+        EXPECT_TRUE(admin.IsValid(single));
+        EXPECT_FALSE(admin.IsValid(ids[6]));
+        EXPECT_FALSE(admin.IsValid(ids[2]));
+
+        admin.Shutdown();
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Queries that already exist pick up instantiated entities, same as adding the components one at a time
+    //
+    TEST(EntityPrefab, InstantiateUpdatesQueries)
+    {
+        AdminSystem admin;
+        admin.RegisterComponentArray<CArrayComponent>();
+        admin.RegisterComponentSparseSet<CSparseComponent>();
+
+        EntityQuery& arrayQuery = admin.GetOrCreateQuery(admin.GetComponentBitMask<CArrayComponent>());
+        EntityQuery& bothQuery = admin.GetOrCreateQuery(admin.GetComponentBitMask<CArrayComponent, CSparseComponent>());
+
+        EntityPrefab prefab;
+        prefab.AddComponent(admin, CArrayComponent{ 1 });
+
+        std::vector<EntityID> ids;
+        admin.Instantiate(prefab, 20, ids);
+        EXPECT_EQ(arrayQuery.Count(), 20);
+        EXPECT_EQ(bothQuery.Count(), 0);
+
+        prefab.AddComponent(admin, CSparseComponent{ 2.f });
+        admin.Instantiate(prefab, 5, ids);
+        EXPECT_EQ(arrayQuery.Count(), 25);
+        EXPECT_EQ(bothQuery.Count(), 5);
+        EXPECT_EQ((admin.Count<CArrayComponent, CSparseComponent>()), 5);
+
+        // Adding the same type again replaces the component instead of adding a second one
+        prefab.AddComponent(admin, CArrayComponent{ 9 });
+        EXPECT_EQ(prefab.GetNumComponents(), 2);
+        EXPECT_EQ(admin.GetComponent<CArrayComponent>(admin.Instantiate(prefab))->m_value, 9);
+
+        admin.Shutdown();
+    }
+}
@@ -0,0 +1,157 @@
+// Bradley Christensen 2022-2026
+#include "pch.h"
+#include "Engine/ECS/AdminSystem.h"
+#include "Engine/ECS/EntityQuery.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Entity Query Tests
+//
+namespace TestEntityQuery
+{
+    constexpr BitMask BIT_A = 1 << 0;
+    constexpr BitMask BIT_B = 1 << 1;
+    constexpr BitMask BIT_C = 1 << 2;
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Entities join the query only once they have every component in the group
+    //
+    TEST(EntityQuery, JoinsWhenCompositionMatches)
+    {
+        EntityQuery query(BIT_A | BIT_B);
+
+        query.OnCompositionChanged(4, 0, BIT_A);
+        EXPECT_EQ(query.Count(), 0);
+
+        query.OnCompositionChanged(4, BIT_A, BIT_A | BIT_B);
+        EXPECT_EQ(query.Count(), 1);
+        EXPECT_TRUE(query.Contains(4));
+
+        // Extra components don't matter
+        query.OnCompositionChanged(4, BIT_A | BIT_B, BIT_A | BIT_B | BIT_C);
+        EXPECT_EQ(query.Count(), 1);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Entities leave the query when any component in the group is removed, or the entity is destroyed
+    //
+    TEST(EntityQuery, LeavesWhenCompositionNoLongerMatches)
+    {
+        EntityQuery query(BIT_A | BIT_B);
+        query.OnCompositionChanged(1, 0, BIT_A | BIT_B);
+        query.OnCompositionChanged(2, 0, BIT_A | BIT_B);
+
+        query.OnCompositionChanged(1, BIT_A | BIT_B, BIT_A);
+        EXPECT_FALSE(query.Contains(1));
+        EXPECT_TRUE(query.Contains(2));
+
+        query.OnCompositionChanged(2, BIT_A | BIT_B, 0);
+        EXPECT_EQ(query.Count(), 0);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Removing from the middle keeps the list packed and the lookup table consistent
+    //
+    TEST(EntityQuery, RemoveKeepsListPacked)
+    {
+        EntityQuery query(BIT_A);
+        for (int i = 0; i < 50; ++i)
+        {
+            query.Add(i * 3);
+        }
+
+        query.Remove(0);
+        query.Remove(30);
+        query.Remove(31); // Never added, no-op
+
+        EXPECT_EQ(query.Count(), 48);
+        for (int denseIndex = 0; denseIndex < query.Count(); ++denseIndex)
+        {
+            int entityIndex = query.m_entities[denseIndex];
+            EXPECT_EQ(query.m_denseIndexByEntity[entityIndex], denseIndex);
+        }
+        EXPECT_EQ(std::count(query.m_entities.begin(), query.m_entities.end(), 30), 0);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Clear
+    //
+    TEST(EntityQuery, Clear)
+    {
+        EntityQuery query(BIT_A);
+        query.Add(7);
+        query.Clear();
+        EXPECT_EQ(query.Count(), 0);
+        EXPECT_FALSE(query.Contains(7));
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Many threads asking for the same groups at once all get the one query per group, seeded with the existing entities
+    //
+    TEST(EntityQuery, GetOrCreateQueryFromManyThreads)
+    {
+        struct CQueryA { int m_value = 0; };
+        struct CQueryB { int m_value = 0; };
+
+        AdminSystem admin;
+        admin.RegisterComponentArray<CQueryA>();
+        admin.RegisterComponentArray<CQueryB>();
+        for (int i = 0; i < 10; ++i)
+        {
+            EntityID id = admin.CreateEntity();
+            admin.AddComponent<CQueryA>(id);
+            if (i % 2 == 0)
+            {
+                admin.AddComponent<CQueryB>(id);
+            }
+        }
+
+        BitMask maskA = admin.GetComponentBitMask<CQueryA>();
+        BitMask maskAB = admin.GetComponentBitMask<CQueryA, CQueryB>();
+        constexpr int numThreads = 8;
+        std::vector<EntityQuery*> queriesA(numThreads, nullptr);
+        std::vector<EntityQuery*> queriesAB(numThreads, nullptr);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (int repeat = 0; repeat < 100; ++repeat)
+                {
+                    queriesA[t] = &admin.GetOrCreateQuery(maskA);
+                    queriesAB[t] = &admin.GetOrCreateQuery(maskAB);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (int t = 1; t < numThreads; ++t)
+        {
+            EXPECT_EQ(queriesA[t], queriesA[0]);
+            EXPECT_EQ(queriesAB[t], queriesAB[0]);
+        }
+        EXPECT_EQ(queriesA[0]->Count(), 10);
+        EXPECT_EQ(queriesAB[0]->Count(), 5);
+        EXPECT_EQ(admin.FindQuery(maskA), queriesA[0]);
+
+        admin.Shutdown();
+    }
+}
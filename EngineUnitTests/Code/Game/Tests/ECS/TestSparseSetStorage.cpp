@@ -0,0 +1,125 @@
+// Bradley Christensen 2022-2026
+#include "pch.h"
+#include "Engine/ECS/ComponentStorage.h"
+#include <gtest/gtest.h>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Sparse Set Storage Tests
+//
+namespace TestSparseSetStorage
+{
+    struct CTestComponent
+    {
+        int m_value = 0;
+    };
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Add and Get
+    //
+    TEST(SparseSetStorage, AddAndGet)
+    {
+        SparseSetStorage<CTestComponent> storage;
+        EXPECT_EQ(storage.Count(), 0);
+        EXPECT_EQ(storage.Get(5), nullptr);
+
+        storage.Add(5, CTestComponent{ 50 });
+        storage.Add(9000, CTestComponent{ 9 });
+
+        EXPECT_EQ(storage.Count(), 2);
+        EXPECT_TRUE(storage.Contains(5));
+        EXPECT_TRUE(storage.Contains(9000));
+        EXPECT_FALSE(storage.Contains(6));
+        EXPECT_EQ(storage[5].m_value, 50);
+        EXPECT_EQ(storage[9000].m_value, 9);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Adding twice overwrites the existing component instead of adding a second one
+    //
+    TEST(SparseSetStorage, AddTwiceOverwrites)
+    {
+        SparseSetStorage<CTestComponent> storage;
+        storage.Add(3, CTestComponent{ 1 });
+        storage.Add(3, CTestComponent{ 2 });
+
+        EXPECT_EQ(storage.Count(), 1);
+        EXPECT_EQ(storage[3].m_value, 2);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Destroy keeps the dense array packed and the sparse table consistent
+    //
+    TEST(SparseSetStorage, DestroySwapsLastIntoHole)
+    {
+        SparseSetStorage<CTestComponent> storage;
+        for (int i = 0; i < 100; ++i)
+        {
+            storage.Add(i * 7, CTestComponent{ i * 7 });
+        }
+
+        storage.Destroy(0);
+        storage.Destroy(14);
+        storage.Destroy(1); // Never added, no-op
+
+        EXPECT_EQ(storage.Count(), 98);
+        EXPECT_EQ(storage.Get(0), nullptr);
+        EXPECT_EQ(storage.Get(14), nullptr);
+        for (int denseIndex = 0; denseIndex < storage.Count(); ++denseIndex)
+        {
+            int entityIndex = storage.GetEntityIndex(denseIndex);
+            EXPECT_EQ(storage.GetDense(denseIndex).m_value, entityIndex);
+            EXPECT_EQ(storage.GetDenseIndex(entityIndex), denseIndex);
+        }
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Dense iteration only visits live components
+    //
+    TEST(SparseSetStorage, DenseIteration)
+    {
+        SparseSetStorage<CTestComponent> storage;
+        storage.Add(10, CTestComponent{ 1 });
+        storage.Add(20, CTestComponent{ 2 });
+        storage.Add(30, CTestComponent{ 3 });
+        storage.Destroy(20);
+
+        int sum = 0;
+        int count = 0;
+        for (CTestComponent const& component : storage)
+        {
+            sum += component.m_value;
+            ++count;
+        }
+        EXPECT_EQ(count, 2);
+        EXPECT_EQ(sum, 4);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Clear
+    //
+    TEST(SparseSetStorage, Clear)
+    {
+        SparseSetStorage<CTestComponent> storage;
+        storage.Add(1, CTestComponent{ 1 });
+        storage.Add(2, CTestComponent{ 2 });
+        storage.Clear();
+
+        EXPECT_EQ(storage.Count(), 0);
+        EXPECT_EQ(storage.Get(1), nullptr);
+
+        storage.Add(2, CTestComponent{ 5 });
+        EXPECT_EQ(storage[2].m_value, 5);
+    }
+}
@@ -136,4 +136,43 @@ namespace TestNoise
 
 
 
+    //----------------------------------------------------------------------------------------------------------------------
+    // Test 10: GetPerlinNoise2DGrid matches GetPerlinNoise2D at every sample
+    //
+    TEST(NoiseTests, GetPerlinNoise2DGrid_MatchesPerSample)
+    {
+        int originX = -37;
+        int originY = 12;
+        int width = 18;
+        int height = 11;
+        float scale = 13.7f;
+        unsigned int octaves = 6;
+        unsigned int seed = 42;
+
+        float persistences[18 * 11];
+        for (int i = 0; i < width * height; ++i)
+        {
+            persistences[i] = (float) (i % 9) / 9.f;
+        }
+
+        float grid[18 * 11];
+        float gridPerSample[18 * 11];
+        Noise::GetPerlinNoise2DGrid(grid, originX, originY, width, height, scale, octaves, 0.5f, 2.f, true, seed);
+        Noise::GetPerlinNoise2DGrid_01(gridPerSample, originX, originY, width, height, scale, octaves, 0.5f, 2.f, true, seed, persistences);
+
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                int index = y * width + x;
+                float sampleX = (float) (originX + x);
+                float sampleY = (float) (originY + y);
+                EXPECT_FLOAT_EQ(grid[index], Noise::GetPerlinNoise2D(sampleX, sampleY, scale, octaves, 0.5f, 2.f, true, seed));
+                EXPECT_FLOAT_EQ(gridPerSample[index], Noise::GetPerlinNoise2D_01(sampleX, sampleY, scale, octaves, persistences[index], 2.f, true, seed));
+            }
+        }
+    }
+
+
+
 }
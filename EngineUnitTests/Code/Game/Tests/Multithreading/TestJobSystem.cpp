@@ -0,0 +1,319 @@
+// Bradley Christensen 2022-2026
+#include "pch.h"
+#include "Engine/Core/NameTable.h"
+#include "Engine/Multithreading/Job.h"
+#include "Engine/Multithreading/JobGraph.h"
+#include "Engine/Multithreading/JobSystem.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Job System Tests
+//
+namespace TestJobSystem
+{
+
+    //----------------------------------------------------------------------------------------------------------------------
+    struct JobSystemScope
+    {
+        explicit JobSystemScope(int numGeneralWorkers)
+        {
+            g_nameTable = new NameTable();
+            g_nameTable->Startup();
+
+            JobSystemConfig config;
+            config.m_deditatedLoadingWorker = false;
+            config.m_threadCount = (uint32_t) numGeneralWorkers;
+            g_jobSystem = new JobSystem(config);
+            g_jobSystem->Startup();
+        }
+        ~JobSystemScope()
+        {
+            g_jobSystem->Shutdown();
+            delete g_jobSystem;
+            g_jobSystem = nullptr;
+
+            g_nameTable->Shutdown();
+            delete g_nameTable;
+            g_nameTable = nullptr;
+        }
+    };
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    class CountJob : public Job
+    {
+    public:
+
+        explicit CountJob(std::atomic<int>& counter) : m_counter(counter)
+        {
+            SetNeedsComplete(false);
+        }
+
+        virtual void Execute() override
+        {
+            m_counter.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::atomic<int>& m_counter;
+    };
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    class RecordOrderJob : public Job
+    {
+    public:
+
+        RecordOrderJob(std::vector<int>& order, int value, int priority) : m_order(order), m_value(value)
+        {
+            SetPriority(priority);
+            SetNeedsComplete(false);
+        }
+
+        virtual void Execute() override
+        {
+            m_order.push_back(m_value);
+        }
+
+        std::vector<int>& m_order;
+        int m_value = 0;
+    };
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Every posted job runs exactly once
+    //
+    TEST(JobSystem, AllJobsExecute)
+    {
+        JobSystemScope scope(4);
+
+        std::atomic<int> counter = 0;
+        constexpr int numJobs = 5000;
+        for (int i = 0; i < numJobs; ++i)
+        {
+            g_jobSystem->PostJob(new CountJob(counter));
+        }
+
+        g_jobSystem->WaitForAllJobs();
+        EXPECT_EQ(counter.load(), numJobs);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Jobs posted from inside other jobs (to the worker's local queue) still get picked up by everyone
+    //
+    class SpawnChildrenJob : public Job
+    {
+    public:
+
+        SpawnChildrenJob(std::atomic<int>& counter, int numChildren) : m_counter(counter), m_numChildren(numChildren)
+        {
+            SetNeedsComplete(false);
+        }
+
+        virtual void Execute() override
+        {
+            for (int i = 0; i < m_numChildren; ++i)
+            {
+                g_jobSystem->PostJob(new CountJob(m_counter));
+            }
+        }
+
+        std::atomic<int>& m_counter;
+        int m_numChildren = 0;
+    };
+
+    TEST(JobSystem, NestedPosting)
+    {
+        JobSystemScope scope(4);
+
+        std::atomic<int> counter = 0;
+        for (int i = 0; i < 20; ++i)
+        {
+            g_jobSystem->PostJob(new SpawnChildrenJob(counter, 100));
+        }
+
+        g_jobSystem->WaitForAllJobs();
+        EXPECT_EQ(counter.load(), 2000);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // With no workers, the thread that helps out runs jobs lowest priority value first, then in posting order
+    //
+    TEST(JobSystem, PriorityOrder)
+    {
+        JobSystemScope scope(0);
+
+        std::vector<int> order;
+        g_jobSystem->PostJob(new RecordOrderJob(order, 3, 5));
+        g_jobSystem->PostJob(new RecordOrderJob(order, 1, 0));
+        g_jobSystem->PostJob(new RecordOrderJob(order, 4, 5));
+        g_jobSystem->PostJob(new RecordOrderJob(order, 2, 1));
+
+        g_jobSystem->WaitForAllJobs();
+        ASSERT_EQ(order.size(), 4u);
+        EXPECT_EQ(order[0], 1);
+        EXPECT_EQ(order[1], 2);
+        EXPECT_EQ(order[2], 3);
+        EXPECT_EQ(order[3], 4);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Cancelling a job that hasn't been picked up yet removes it
+    //
+    TEST(JobSystem, CancelJob)
+    {
+        JobSystemScope scope(0);
+
+        std::atomic<int> counter = 0;
+        CountJob* job = new CountJob(counter);
+        JobID id = g_jobSystem->PostJob(job);
+
+        EXPECT_TRUE(g_jobSystem->TryCancelJob(id));
+        EXPECT_FALSE(g_jobSystem->TryCancelJob(id));
+        delete job;
+
+        g_jobSystem->WaitForAllJobs();
+        EXPECT_EQ(counter.load(), 0);
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    class GraphNodeJob : public Job
+    {
+    public:
+
+        GraphNodeJob(std::mutex& mutex, std::vector<int>& order, int value, int priority, uint64_t reads, uint64_t writes) : m_mutex(mutex), m_order(order), m_value(value)
+        {
+            SetPriority(priority);
+            m_jobDependencies = JobDependencies(reads, writes);
+        }
+
+        virtual void Execute() override
+        {
+            std::this_thread::yield();
+            std::unique_lock lock(m_mutex);
+            m_order.push_back(m_value);
+        }
+
+        std::mutex& m_mutex;
+        std::vector<int>& m_order;
+        int m_value = 0;
+    };
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Jobs that share dependencies run in priority order, and the graph can be executed repeatedly
+    //
+    TEST(JobSystem, JobGraphRespectsDependencies)
+    {
+        JobSystemScope scope(4);
+
+        std::mutex mutex;
+        std::vector<int> order;
+
+        JobGraph graph;
+        graph.AddJob(new GraphNodeJob(mutex, order, 2, 1, 0b001, 0b000));  // reads 0
+        graph.AddJob(new GraphNodeJob(mutex, order, 1, 0, 0b000, 0b001));  // writes 0
+        graph.AddJob(new GraphNodeJob(mutex, order, 3, 2, 0b000, 0b011));  // writes 0 and 1
+        graph.AddJob(new GraphNodeJob(mutex, order, 9, 3, 0b000, 0b100));  // independent
+
+        for (int i = 0; i < 50; ++i)
+        {
+            order.clear();
+            g_jobSystem->ExecuteJobGraph(graph, (i % 2) == 0);
+
+            ASSERT_EQ(order.size(), 4u);
+            auto position = [&order](int value) { return std::find(order.begin(), order.end(), value) - order.begin(); };
+            EXPECT_LT(position(1), position(2));
+            EXPECT_LT(position(2), position(3));
+            EXPECT_TRUE(graph.IsComplete());
+        }
+
+        graph.Cleanup();
+        g_jobSystem->WaitForAllJobs();
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // The thread executing a graph only helps with that graph's jobs, unrelated queued work is left for the workers
+    //
+    TEST(JobSystem, JobGraphHelperSkipsUnrelatedJobs)
+    {
+        JobSystemScope scope(0);
+
+        std::atomic<int> counter = 0;
+        g_jobSystem->PostJob(new CountJob(counter));
+
+        std::mutex mutex;
+        std::vector<int> order;
+
+        JobGraph graph;
+        graph.AddJob(new GraphNodeJob(mutex, order, 1, 0, 0b000, 0b001));  // writes 0
+        graph.AddJob(new GraphNodeJob(mutex, order, 2, 1, 0b001, 0b000));  // reads 0
+        graph.AddJob(new GraphNodeJob(mutex, order, 3, 2, 0b000, 0b010));  // independent
+
+        g_jobSystem->ExecuteJobGraph(graph, true);
+        EXPECT_TRUE(graph.IsComplete());
+        EXPECT_EQ(order.size(), 3u);
+        EXPECT_EQ(counter.load(), 0);
+
+        g_jobSystem->WaitForAllJobs();
+        EXPECT_EQ(counter.load(), 1);
+
+        graph.Cleanup();
+    }
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Throughput benchmark: jobs/sec for tiny jobs at 1..N worker threads. Not a pass/fail test, prints results.
+    //
+    TEST(JobSystem, ThroughputBenchmark)
+    {
+        int maxThreads = (int) std::thread::hardware_concurrency();
+        if (maxThreads < 1)
+        {
+            maxThreads = 1;
+        }
+
+        constexpr int numJobs = 200'000;
+        for (int numThreads = 1; numThreads <= maxThreads; ++numThreads)
+        {
+            JobSystemScope scope(numThreads);
+
+            std::atomic<int> counter = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < numJobs; ++i)
+            {
+                g_jobSystem->PostJob(new CountJob(counter));
+            }
+            g_jobSystem->WaitForAllJobs();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            EXPECT_EQ(counter.load(), numJobs);
+
+            double seconds = std::chrono::duration<double>(end - start).count();
+            std::printf("[ BENCH    ] JobSystem throughput: %2i threads, %10.0f jobs/sec\n", numThreads, (double) numJobs / seconds);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+// Bradley Christensen 2022-2026
+#include "pch.h"
+#include "Engine/Core/NameTable.h"
+#include "Engine/Math/IntVec2.h"
+#include "Engine/Renderer/Null/NullRenderer.h"
+#include "Engine/Renderer/RendererUtils.h"
+#include "Engine/Renderer/Shader.h"
+#include "Engine/Renderer/VertexBuffer.h"
+#include "Engine/Renderer/Vertex_PCU.h"
+#include <gtest/gtest.h>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Null Renderer Tests
+//
+namespace TestNullRenderer
+{
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // Not started up, that loads the default shader through the asset manager. The test binds its own shader and texture.
+    //
+    struct HeadlessRendererScope
+    {
+        HeadlessRendererScope()
+        {
+            g_nameTable = new NameTable();
+            g_nameTable->Startup();
+
+            RendererConfig config;
+            config.m_headless = true;
+            g_renderer = RendererUtils::MakeRenderer(config);
+        }
+        ~HeadlessRendererScope()
+        {
+            g_renderer->Shutdown();
+            delete g_renderer;
+            g_renderer = nullptr;
+
+            g_nameTable->Shutdown();
+            delete g_nameTable;
+            g_nameTable = nullptr;
+        }
+    };
+
+
+
+    //----------------------------------------------------------------------------------------------------------------------
+    // m_headless picks the null renderer, and every draw and state change in a frame is counted
+    //
+    TEST(NullRenderer, CountsDrawsAndStateChanges)
+    {
+        HeadlessRendererScope scope;
+        NullRenderer* renderer = NullRenderer::Get();
+        ASSERT_NE(renderer, nullptr);
+
+        RenderTargetID renderTarget = renderer->MakeSwapchainRenderTarget(nullptr, IntVec2(64, 64));
+        ShaderID shader = renderer->MakeShader(ShaderConfig());
+        TextureID texture = renderer->MakeTexture();
+        VertexBufferID vboID = g_renderer->MakeVertexBuffer<Vertex_PCU>(); // Hidden by NullRenderer::MakeVertexBuffer()
+        VertexBuffer& vbo = *renderer->GetVertexBuffer(vboID);
+        vbo.AddVert(Vertex_PCU(Vec2(0.f, 0.f)));
+        vbo.AddVert(Vertex_PCU(Vec2(1.f, 0.f)));
+        vbo.AddVert(Vertex_PCU(Vec2(0.f, 1.f)));
+
+        renderer->BeginFrame();
+        renderer->BindRenderTarget(renderTarget);
+        renderer->ClearScreen(Rgba8::Black);
+        renderer->BindShader(shader);
+        renderer->BindTexture(texture);
+        renderer->DrawVertexBuffer(vbo);
+        renderer->DrawVertexBuffer(vbo);
+        renderer->EndFrame();
+
+        NullRendererStats const& frameStats = renderer->GetFrameStats();
+        EXPECT_EQ(frameStats.m_numDrawCalls, 2);
+        EXPECT_EQ(frameStats.m_numVertsDrawn, 6);
+        EXPECT_EQ(frameStats.m_numVertexBufferBinds, 2);
+        EXPECT_EQ(frameStats.m_numBufferUploads, 1);   // The second bind has nothing new to upload
+        EXPECT_EQ(frameStats.m_numBufferUploadBytes, 3 * sizeof(Vertex_PCU));
+        EXPECT_EQ(frameStats.m_numShaderChanges, 1);   // State is only updated when it changes
+        EXPECT_EQ(frameStats.m_numTextureChanges, 1);
+        EXPECT_EQ(frameStats.m_numRenderTargetBinds, 1);
+        EXPECT_EQ(frameStats.m_numClears, 1);
+        EXPECT_EQ(frameStats.m_numPresents, 1);
+
+        // An empty frame resets the frame stats, but not the totals
+        renderer->BeginFrame();
+        renderer->BindRenderTarget(renderTarget);
+        renderer->EndFrame();
+
+        EXPECT_EQ(renderer->GetFrameStats().m_numDrawCalls, 0);
+        EXPECT_EQ(renderer->GetFrameStats().m_numPresents, 1);
+        EXPECT_EQ(renderer->GetTotalStats().m_numDrawCalls, 2);
+        EXPECT_EQ(renderer->GetTotalStats().m_numPresents, 2);
+
+        renderer->ResetTotalStats();
+        EXPECT_EQ(renderer->GetTotalStats().m_numDrawCalls, 0);
+    }
+}
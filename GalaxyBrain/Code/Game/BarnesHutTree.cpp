@@ -0,0 +1,214 @@
+﻿// Bradley Christensen - 2023
+#include "BarnesHutTree.h"
+#include "Engine/Math/MathUtils.h"
+#include <algorithm>
+#include <cfloat>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+constexpr float MIN_GRAVITY_DISTANCE_SQUARED = 0.001f;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void BarnesHutTree::Build(std::vector<Vec2> const& positions, std::vector<float> const& masses)
+{
+    Clear();
+
+    Vec2 mins = Vec2(FLT_MAX, FLT_MAX);
+    Vec2 maxs = Vec2(-FLT_MAX, -FLT_MAX);
+    for (int i = 0; i < (int) positions.size(); ++i)
+    {
+        if (masses[i] == 0.f)
+        {
+            continue;
+        }
+        m_bodyIndices.push_back((int) m_positions.size());
+        m_positions.push_back(positions[i]);
+        m_masses.push_back(masses[i]);
+
+        mins.x = MathUtils::Min(mins.x, positions[i].x);
+        mins.y = MathUtils::Min(mins.y, positions[i].y);
+        maxs.x = MathUtils::Max(maxs.x, positions[i].x);
+        maxs.y = MathUtils::Max(maxs.y, positions[i].y);
+    }
+
+    if (m_positions.empty())
+    {
+        return;
+    }
+
+    BarnesHutNode& root = m_nodes.emplace_back();
+    root.m_center = (mins + maxs) * 0.5f;
+    root.m_halfSize = MathUtils::Max(maxs.x - mins.x, maxs.y - mins.y) * 0.5f + 1.f;
+    root.m_firstBody = 0;
+    root.m_numBodies = (int) m_positions.size();
+    Subdivide(0, 0);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void BarnesHutTree::Clear()
+{
+    m_nodes.clear();
+    m_bodyIndices.clear();
+    m_positions.clear();
+    m_masses.clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Splits the node's bodies into quadrants and fills in the mass and center of mass, bottom up
+//
+void BarnesHutTree::Subdivide(int nodeIndex, int depth)
+{
+    // m_nodes can grow while recursing, so copy out what's needed instead of holding a reference
+    BarnesHutNode node = m_nodes[nodeIndex];
+    int* firstBody = m_bodyIndices.data() + node.m_firstBody;
+    int* endBody = firstBody + node.m_numBodies;
+
+    if (node.m_numBodies <= s_maxBodiesPerLeaf || depth >= s_maxDepth)
+    {
+        Vec2 weightedPosSum;
+        float massSum = 0.f;
+        for (int* body = firstBody; body != endBody; ++body)
+        {
+            weightedPosSum += m_positions[*body] * m_masses[*body];
+            massSum += m_masses[*body];
+        }
+        m_nodes[nodeIndex].m_mass = massSum;
+        m_nodes[nodeIndex].m_centerOfMass = weightedPosSum / massSum;
+        return;
+    }
+
+    // Quadrants in order: bottom left, bottom right, top left, top right
+    int* splitY = std::partition(firstBody, endBody, [&](int body) { return m_positions[body].y < node.m_center.y; });
+    int* splitBottomX = std::partition(firstBody, splitY, [&](int body) { return m_positions[body].x < node.m_center.x; });
+    int* splitTopX = std::partition(splitY, endBody, [&](int body) { return m_positions[body].x < node.m_center.x; });
+    int* quadrantBounds[5] = { firstBody, splitBottomX, splitY, splitTopX, endBody };
+
+    int firstChild = (int) m_nodes.size();
+    m_nodes[nodeIndex].m_firstChild = firstChild;
+    m_nodes.resize(m_nodes.size() + 4);
+
+    float childHalfSize = node.m_halfSize * 0.5f;
+    for (int quadrant = 0; quadrant < 4; ++quadrant)
+    {
+        BarnesHutNode& child = m_nodes[firstChild + quadrant];
+        child.m_halfSize = childHalfSize;
+        child.m_center.x = node.m_center.x + ((quadrant & 1) ? childHalfSize : -childHalfSize);
+        child.m_center.y = node.m_center.y + ((quadrant & 2) ? childHalfSize : -childHalfSize);
+        child.m_firstBody = (int) (quadrantBounds[quadrant] - m_bodyIndices.data());
+        child.m_numBodies = (int) (quadrantBounds[quadrant + 1] - quadrantBounds[quadrant]);
+    }
+
+    Vec2 weightedPosSum;
+    float massSum = 0.f;
+    for (int quadrant = 0; quadrant < 4; ++quadrant)
+    {
+        int childIndex = firstChild + quadrant;
+        if (m_nodes[childIndex].m_numBodies == 0)
+        {
+            continue;
+        }
+        Subdivide(childIndex, depth + 1);
+        weightedPosSum += m_nodes[childIndex].m_centerOfMass * m_nodes[childIndex].m_mass;
+        massSum += m_nodes[childIndex].m_mass;
+    }
+    m_nodes[nodeIndex].m_mass = massSum;
+    m_nodes[nodeIndex].m_centerOfMass = weightedPosSum / massSum;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Vec2 BarnesHutTree::GetAccelerationAt(Vec2 const& pos, float openingAngle, float gravitationalConstant) const
+{
+    if (m_nodes.empty())
+    {
+        return Vec2::ZeroVector;
+    }
+
+    // Each level pushes at most 4 children after popping their parent
+    int nodeStack[3 * s_maxDepth + 4];
+    int stackSize = 0;
+    nodeStack[stackSize++] = 0;
+
+    float openingAngleSquared = openingAngle * openingAngle;
+    Vec2 acceleration;
+    while (stackSize > 0)
+    {
+        BarnesHutNode const& node = m_nodes[nodeStack[--stackSize]];
+        if (node.m_numBodies == 0)
+        {
+            continue;
+        }
+
+        Vec2 toCenterOfMass = node.m_centerOfMass - pos;
+        float distanceSquared = toCenterOfMass.GetLengthSquared();
+        float size = 2.f * node.m_halfSize;
+        if (size * size < openingAngleSquared * distanceSquared)
+        {
+            acceleration += toCenterOfMass * (gravitationalConstant * node.m_mass / distanceSquared);
+            continue;
+        }
+
+        if (node.m_firstChild == -1)
+        {
+            for (int i = node.m_firstBody; i < node.m_firstBody + node.m_numBodies; ++i)
+            {
+                int body = m_bodyIndices[i];
+                Vec2 toBody = m_positions[body] - pos;
+                float bodyDistanceSquared = toBody.GetLengthSquared();
+                if (bodyDistanceSquared > MIN_GRAVITY_DISTANCE_SQUARED)
+                {
+                    acceleration += toBody * (gravitationalConstant * m_masses[body] / bodyDistanceSquared);
+                }
+            }
+            continue;
+        }
+
+        for (int quadrant = 0; quadrant < 4; ++quadrant)
+        {
+            nodeStack[stackSize++] = node.m_firstChild + quadrant;
+        }
+    }
+    return acceleration;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Vec2 BarnesHutTree::GetExactAccelerationAt(Vec2 const& pos, float gravitationalConstant) const
+{
+    Vec2 acceleration;
+    for (int body = 0; body < (int) m_positions.size(); ++body)
+    {
+        Vec2 toBody = m_positions[body] - pos;
+        float distanceSquared = toBody.GetLengthSquared();
+        if (distanceSquared > MIN_GRAVITY_DISTANCE_SQUARED)
+        {
+            acceleration += toBody * (gravitationalConstant * m_masses[body] / distanceSquared);
+        }
+    }
+    return acceleration;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int BarnesHutTree::GetNumNodes() const
+{
+    return (int) m_nodes.size();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int BarnesHutTree::GetNumBodies() const
+{
+    return (int) m_positions.size();
+}
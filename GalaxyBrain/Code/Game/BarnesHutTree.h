@@ -0,0 +1,56 @@
+﻿// Bradley Christensen - 2023
+#pragma once
+#include "Engine/Math/Vec2.h"
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+struct BarnesHutNode
+{
+    Vec2 m_center;                  // Center of the node's square bounds
+    float m_halfSize        = 0.f;
+    Vec2 m_centerOfMass;
+    float m_mass            = 0.f;
+    int m_firstChild        = -1;   // Children are 4 consecutive nodes, -1 for leaves
+    int m_firstBody         = 0;    // Range into m_bodyIndices
+    int m_numBodies         = 0;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Barnes-Hut Tree
+//
+// Quadtree over the bodies that have mass, for approximate gravity in O(n log n). A node whose size over its distance
+// to the sample point is under the opening angle pulls as one body at its center of mass, closer nodes open up into
+// their children. An opening angle of 0 opens every node, which is the exact sum.
+//
+class BarnesHutTree
+{
+public:
+
+    void Build(std::vector<Vec2> const& positions, std::vector<float> const& masses);
+    void Clear();
+
+    // Same formula as the exact solver, a = G * m * (source - pos) / d^2, skipping sources closer than sqrt(0.001)
+    Vec2 GetAccelerationAt(Vec2 const& pos, float openingAngle, float gravitationalConstant) const;
+    Vec2 GetExactAccelerationAt(Vec2 const& pos, float gravitationalConstant) const;
+
+    int GetNumNodes() const;
+    int GetNumBodies() const;
+
+protected:
+
+    void Subdivide(int nodeIndex, int depth);
+
+protected:
+
+    static constexpr int s_maxBodiesPerLeaf = 8;
+    static constexpr int s_maxDepth = 24;       // Stops bodies stacked on the same point from subdividing forever
+
+    std::vector<BarnesHutNode> m_nodes;         // Root is 0
+    std::vector<int> m_bodyIndices;             // Sorted so each node's bodies are consecutive
+    std::vector<Vec2> m_positions;              // Only bodies with mass
+    std::vector<float> m_masses;
+};
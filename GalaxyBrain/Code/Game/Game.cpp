@@ -8,6 +8,7 @@
 #include "Engine/Events/EventSystem.h"
 #include "Engine/ECS/AdminSystem.h"
 #include "Engine/Renderer/Renderer.h"
+#include "Engine/Math/MathUtils.h"
 #include "Engine/Math/RandomNumberGenerator.h"
 #include "Engine/Multithreading/JobSystem.h"
 #include "Engine/Renderer/Window.h"
@@ -174,6 +175,16 @@ void Game::RegisterDevConsoleCommands() const
     DevConsoleCommandInfo systemActiveInfo("SystemActive");
     systemActiveInfo.AddArg("on", DevConsoleArgType::Bool);
     g_devConsole->AddDevConsoleCommandInfo(systemActiveInfo);
+
+    SubscribeEventCallbackFunction("BenchmarkGravity", Game::OnBenchmarkGravityCommand);
+    DevConsoleCommandInfo benchmarkGravityInfo("BenchmarkGravity");
+    benchmarkGravityInfo.AddArg("numBodies", DevConsoleArgType::Int);
+    g_devConsole->AddDevConsoleCommandInfo(benchmarkGravityInfo);
+
+    SubscribeEventCallbackFunction("SetGravityOpeningAngle", Game::OnSetGravityOpeningAngleCommand);
+    DevConsoleCommandInfo openingAngleInfo("SetGravityOpeningAngle");
+    openingAngleInfo.AddArg("angle", DevConsoleArgType::Float);
+    g_devConsole->AddDevConsoleCommandInfo(openingAngleInfo);
 }
 
 
@@ -193,3 +204,29 @@ bool Game::OnSystemActiveCommand(NamedProperties& eventArgs)
     g_ecs->SetSystemActive(name, active);
     return true;
 }
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool Game::OnBenchmarkGravityCommand(NamedProperties& eventArgs)
+{
+    int numBodies = eventArgs.Get("numBodies", 10000);
+    SGravity::RunBenchmark(numBodies);
+    return true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool Game::OnSetGravityOpeningAngleCommand(NamedProperties& eventArgs)
+{
+    SGravity* gravity = dynamic_cast<SGravity*>(g_ecs->GetSystemByName("Gravity"));
+    if (!gravity)
+    {
+        g_devConsole->LogErrorF("SetGravityOpeningAngle - Gravity system not found");
+        return false;
+    }
+    gravity->m_openingAngle = MathUtils::ClampMin(eventArgs.Get("angle", gravity->m_openingAngle), 0.f);
+    g_devConsole->LogSuccessF("Gravity opening angle: %.2f", gravity->m_openingAngle);
+    return true;
+}
@@ -28,4 +28,6 @@ private:
     void UnRegisterDevConsoleCommands() const;
 
     static bool OnSystemActiveCommand(NamedProperties& eventArgs);
+    static bool OnBenchmarkGravityCommand(NamedProperties& eventArgs);
+    static bool OnSetGravityOpeningAngleCommand(NamedProperties& eventArgs);
 };
@@ -7,6 +7,7 @@
 #include "Engine/Input/InputSystem.h"
 #include "Engine/Math/GeometryUtils.h"
 #include "Engine/Math/MathUtils.h"
+#include <algorithm>
 
 
 
@@ -21,87 +22,124 @@ void SCollision::Startup()
 
 
 //----------------------------------------------------------------------------------------------------------------------
+// Sweep and prune on x instead of testing every pair, only pairs whose x extents overlap get to CollideEntities
+//
 void SCollision::Run(SystemContext const& context)
 {
     auto& transStorage = g_ecs->GetArrayStorage<CTransform>();
     auto& physStorage  = g_ecs->GetArrayStorage<CPhysics>();
     auto& collStorage  = g_ecs->GetArrayStorage<CCollision>();
 
-    auto itA = g_ecs->Iterate<CTransform, CCollision, CPhysics>(context);
-    auto itB = itA;
-
-    for (/*init above*/; itA.IsValid(); ++itA)
+    m_proxies.clear();
+    for (auto it = g_ecs->Iterate<CTransform, CCollision, CPhysics>(context); it.IsValid(); ++it)
     {
-        CTransform& transA = transStorage[itA.m_currentIndex];
-        CCollision& collA = *collStorage.Get(itA.m_currentIndex);
-        CPhysics& physA = *physStorage.Get(itA.m_currentIndex); // optional
-
-        Vec2& posA = transA.m_pos;
-        float& radiusA = collA.m_radius;
+        CTransform& trans = transStorage[it.m_currentIndex];
+        CCollision& coll = *collStorage.Get(it.m_currentIndex);
 
-        // Start iterator B at one entity after iterator A (without copying a bunch of data every iteration by calling itB = itA;
-        itB.m_currentIndex = itA.m_currentIndex;
-        ++itB;
-
-        for (/*init above*/; itB.IsValid(); ++itB)
+        // Attached pairs are never collided, but detach them once they stop overlapping. They won't be in the same
+        // broadphase pair when that happens, so check them here instead.
+        if (trans.m_attachedToEntity != ENTITY_ID_INVALID)
         {
-            CTransform& transB = transStorage[itB.m_currentIndex];
-            CCollision& collB = *collStorage.Get(itB.m_currentIndex);
-
-            Vec2& posB = transB.m_pos;
-            float& radiusB = collB.m_radius;
-
-            if (transB.m_attachedToEntity == itA.m_currentIndex || transA.m_attachedToEntity == itB.m_currentIndex)
+            CCollision* parentColl = collStorage.Get(trans.m_attachedToEntity);
+            if (parentColl && physStorage.Get(trans.m_attachedToEntity))
             {
-                // Ignore collision with attached actors, but detach them if they are no longer overlapping
-                if (!DoDiscsOverlap2D(posB, radiusB, posA, radiusA))
+                CTransform& parentTrans = transStorage[trans.m_attachedToEntity];
+                if (!DoDiscsOverlap2D(trans.m_pos, coll.m_radius, parentTrans.m_pos, parentColl->m_radius))
                 {
-                    DetachEntities(itA.m_currentIndex, itB.m_currentIndex);
+                    DetachEntities(it.m_currentIndex, trans.m_attachedToEntity);
                 }
-                continue;
             }
+        }
 
-            CPhysics& physB = *physStorage.Get(itB.m_currentIndex); // optional
+        CollisionProxy& proxy = m_proxies.emplace_back();
+        proxy.m_entity = it.m_currentIndex;
+        proxy.m_minX = trans.m_pos.x - coll.m_radius;
+        proxy.m_maxX = trans.m_pos.x + coll.m_radius;
+    }
 
-            bool ACanPushB = (collA.m_type == CollisionType::Static && collB.m_type == CollisionType::Mobile);
-            bool BCanPushA = (collA.m_type == CollisionType::Mobile && collB.m_type == CollisionType::Static);
-            bool PushEachOther = (collA.m_type == CollisionType::Mobile && collB.m_type == CollisionType::Mobile);
+    std::sort(m_proxies.begin(), m_proxies.end(), [](CollisionProxy const& a, CollisionProxy const& b) { return a.m_minX < b.m_minX; });
 
-            bool didPush = false;
-            if (ACanPushB)
-            {
-                didPush = PushDiscOutOfDisc2D(posB, radiusB, posA, radiusA);
-            }
-            else if (BCanPushA)
-            {
-                didPush = PushDiscOutOfDisc2D(posA, radiusA, posB, radiusB);
-            }
-            else if (PushEachOther)
+    int numProxies = (int) m_proxies.size();
+    for (int a = 0; a < numProxies; ++a)
+    {
+        CollisionProxy const& proxyA = m_proxies[a];
+        for (int b = a + 1; b < numProxies; ++b)
+        {
+            CollisionProxy const& proxyB = m_proxies[b];
+            if (proxyB.m_minX > proxyA.m_maxX)
             {
-                didPush = BounceDiscsOffEachOther2D(posA, radiusA, physA.m_velocity, physA.m_mass, posB, radiusB, physB.m_velocity, physB.m_mass, 0.f);
+                // Sorted, so nothing after this overlaps A either
+                break;
             }
+            CollideEntities(proxyA.m_entity, proxyB.m_entity);
+        }
+    }
+}
 
-            if (didPush)
-            {
-                bool ACanAttachToB = (collA.m_attachType == AttachmentType::CanAttach && collB.m_attachType == AttachmentType::CanHaveAttachedEntities);
-                if (ACanAttachToB)
-                {
-                    transA.m_attachedToEntity = itB.m_currentIndex;
-                    Vec2 toCenter = (transA.m_pos - transB.m_pos);
-                    float relativeAngle = toCenter.GetAngleDegrees() - transB.m_orientation;
-                    transA.m_polarCoords = Vec2(relativeAngle, toCenter.GetLength() * 0.999f); // Move in just a bit to prevent skating along the edge
-                    physA.m_velocity = Vec2::ZeroVector;
-                }
-                bool BCanAttachToA = (collA.m_attachType == AttachmentType::CanHaveAttachedEntities && collB.m_attachType == AttachmentType::CanAttach);
-                if (BCanAttachToA)
-                {
-                    transB.m_attachedToEntity = itA.m_currentIndex;
-                    Vec2 toCenter = (transB.m_pos - transA.m_pos);
-                    float relativeAngle = toCenter.GetAngleDegrees() - transA.m_orientation;
-                    transB.m_polarCoords = Vec2(relativeAngle, toCenter.GetLength());
-                    physB.m_velocity = Vec2::ZeroVector;
-                }
-            }
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void SCollision::CollideEntities(EntityID a, EntityID b) const
+{
+    auto& transStorage = g_ecs->GetArrayStorage<CTransform>();
+    auto& physStorage  = g_ecs->GetArrayStorage<CPhysics>();
+    auto& collStorage  = g_ecs->GetArrayStorage<CCollision>();
+
+    CTransform& transA = transStorage[a];
+    CTransform& transB = transStorage[b];
+    if (transB.m_attachedToEntity == a || transA.m_attachedToEntity == b)
+    {
+        // Ignore collision with attached actors, detaching is handled in Run
+        return;
+    }
+
+    CCollision& collA = *collStorage.Get(a);
+    CCollision& collB = *collStorage.Get(b);
+    CPhysics& physA = *physStorage.Get(a); // optional
+    CPhysics& physB = *physStorage.Get(b); // optional
+
+    Vec2& posA = transA.m_pos;
+    Vec2& posB = transB.m_pos;
+    float& radiusA = collA.m_radius;
+    float& radiusB = collB.m_radius;
+
+    bool ACanPushB = (collA.m_type == CollisionType::Static && collB.m_type == CollisionType::Mobile);
+    bool BCanPushA = (collA.m_type == CollisionType::Mobile && collB.m_type == CollisionType::Static);
+    bool PushEachOther = (collA.m_type == CollisionType::Mobile && collB.m_type == CollisionType::Mobile);
+
+    bool didPush = false;
+    if (ACanPushB)
+    {
+        didPush = PushDiscOutOfDisc2D(posB, radiusB, posA, radiusA);
+    }
+    else if (BCanPushA)
+    {
+        didPush = PushDiscOutOfDisc2D(posA, radiusA, posB, radiusB);
+    }
+    else if (PushEachOther)
+    {
+        didPush = BounceDiscsOffEachOther2D(posA, radiusA, physA.m_velocity, physA.m_mass, posB, radiusB, physB.m_velocity, physB.m_mass, 0.f);
+    }
+
+    if (didPush)
+    {
+        bool ACanAttachToB = (collA.m_attachType == AttachmentType::CanAttach && collB.m_attachType == AttachmentType::CanHaveAttachedEntities);
+        if (ACanAttachToB)
+        {
+            transA.m_attachedToEntity = b;
+            Vec2 toCenter = (transA.m_pos - transB.m_pos);
+            float relativeAngle = toCenter.GetAngleDegrees() - transB.m_orientation;
+            transA.m_polarCoords = Vec2(relativeAngle, toCenter.GetLength() * 0.999f); // Move in just a bit to prevent skating along the edge
+            physA.m_velocity = Vec2::ZeroVector;
+        }
+        bool BCanAttachToA = (collA.m_attachType == AttachmentType::CanHaveAttachedEntities && collB.m_attachType == AttachmentType::CanAttach);
+        if (BCanAttachToA)
+        {
+            transB.m_attachedToEntity = a;
+            Vec2 toCenter = (transB.m_pos - transA.m_pos);
+            float relativeAngle = toCenter.GetAngleDegrees() - transA.m_orientation;
+            transB.m_polarCoords = Vec2(relativeAngle, toCenter.GetLength());
+            physB.m_velocity = Vec2::ZeroVector;
         }
     }
 }
@@ -1,6 +1,19 @@
 ﻿// Bradley Christensen - 2023
 #pragma once
 #include "Engine/ECS/System.h"
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// An entity's extents on the sweep axis, for the broadphase
+//
+struct CollisionProxy
+{
+    EntityID m_entity = ENTITY_ID_INVALID;
+    float m_minX = 0.f;
+    float m_maxX = 0.f;
+};
 
 
 
@@ -14,4 +27,12 @@ public:
     void Run(SystemContext const& context) override;
 
     void DetachEntities(EntityID a, EntityID b) const;
+
+protected:
+
+    void CollideEntities(EntityID a, EntityID b) const;
+
+protected:
+
+    std::vector<CollisionProxy> m_proxies; // Sorted by m_minX each frame, kept around so it doesn't reallocate
 };
@@ -2,7 +2,14 @@
 #include "SGravity.h"
 #include "Game/CPhysics.h"
 #include "Game/CTransform.h"
+#include "Engine/Debug/DevConsole.h"
 #include "Engine/ECS/SystemContext.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Math/RandomNumberGenerator.h"
+#include "Engine/Multithreading/Job.h"
+#include "Engine/Multithreading/JobSystem.h"
+#include "Engine/Time/Time.h"
+#include <thread>
 
 
 
@@ -11,66 +18,158 @@ constexpr float GRAVITATIONAL_CONSTANT = 100.f;
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Evaluates the tree for a range of bodies, each job writes to its own range of m_accelerations
+//
+class GravityJob : public Job
+{
+public:
+
+    GravityJob(SGravity& gravity, int firstBody, int numBodies) : m_gravity(gravity), m_firstBody(firstBody), m_numBodies(numBodies) {}
+
+    virtual void Execute() override
+    {
+        m_gravity.CalculateAccelerations(m_firstBody, m_numBodies);
+    }
+
+    SGravity& m_gravity;
+    int m_firstBody = 0;
+    int m_numBodies = 0;
+};
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void SGravity::Startup()
 {
     AddWriteDependencies<CPhysics>();
     AddReadDependencies<CTransform>();
+
+    // Every body needs the whole tree, so split it up here instead of letting the scheduler split the iteration
+    m_systemSplittingNumJobs = 1;
+
+    int numThreads = (int) std::thread::hardware_concurrency() - 1;
+    m_maxNumJobs = MathUtils::Max(numThreads, 1);
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
+// Barnes-Hut instead of summing every pair, see BarnesHutTree
+//
 void SGravity::Run(SystemContext const& context)
 {
     auto& physStorage = g_ecs->GetArrayStorage<CPhysics>();
     auto& transforms = g_ecs->GetArrayStorage<CTransform>();
-    
-    for (auto itA = g_ecs->Iterate<CTransform, CPhysics>(context); itA.IsValid(); ++itA)
+
+    m_entities.clear();
+    m_positions.clear();
+    m_masses.clear();
+    for (auto it = g_ecs->Iterate<CTransform, CPhysics>(context); it.IsValid(); ++it)
     {
-        EntityID& entA = itA.m_currentIndex;
-        auto& physA = physStorage[entA];
-        if (physA.m_mass == 0.f)
-        {
-            continue;
-        }
-        
-        auto& transA = transforms[entA];
-        if (transA.m_attachedToEntity != ENTITY_ID_INVALID)
+        EntityID& ent = it.m_currentIndex;
+        auto& trans = transforms[ent];
+        if (trans.m_attachedToEntity != ENTITY_ID_INVALID)
         {
             // Ignore gravity altogether if attached (the attaching actor will move with gravity and that will affect the attached)
             continue;
         }
 
-        for (auto itB = g_ecs->Iterate<CTransform, CPhysics>(context); itB.IsValid(); ++itB)
+        m_entities.push_back(ent);
+        m_positions.push_back(trans.m_pos);
+        m_masses.push_back(physStorage[ent].m_mass);
+    }
+
+    int numBodies = (int) m_entities.size();
+    m_tree.Build(m_positions, m_masses);
+    m_accelerations.resize(numBodies);
+
+    int numJobs = MathUtils::Min(m_maxNumJobs, numBodies / s_minBodiesPerJob);
+    if (numJobs <= 1)
+    {
+        CalculateAccelerations(0, numBodies);
+    }
+    else
+    {
+        std::vector<JobID> jobReceipts;
+        int bodiesPerJob = (numBodies + numJobs - 1) / numJobs;
+        for (int firstBody = 0; firstBody < numBodies; firstBody += bodiesPerJob)
         {
-            EntityID& entB = itB.m_currentIndex;
-            if (entA == entB)
-            {
-                continue;
-            }
-            
-            auto& transB = transforms[entB];
-            if (transB.m_attachedToEntity != ENTITY_ID_INVALID)
-            {
-                // Ignore gravity altogether if attached (the attaching actor will move with gravity and that will affect the attached)
-                continue;
-            }
+            GravityJob* job = new GravityJob(*this, firstBody, MathUtils::Min(bodiesPerJob, numBodies - firstBody));
+            jobReceipts.push_back(g_jobSystem->PostJob(job));
+        }
+        g_jobSystem->CompleteJobs(jobReceipts);
+    }
 
-            Vec2 bToA = transA.m_pos - transB.m_pos;
-            float distanceSquared = bToA.GetLengthSquared();
-            if (distanceSquared <= 0.001f)
+    for (int i = 0; i < numBodies; ++i)
+    {
+        physStorage[m_entities[i]].m_frameAcceleration += m_accelerations[i];
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void SGravity::CalculateAccelerations(int firstBody, int numBodies)
+{
+    for (int i = firstBody; i < firstBody + numBodies; ++i)
+    {
+        m_accelerations[i] = m_tree.GetAccelerationAt(m_positions[i], m_openingAngle, GRAVITATIONAL_CONSTANT);
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Single threaded both ways, so the times compare the algorithms and not the job split
+//
+void SGravity::RunBenchmark(int numBodies)
+{
+    RandomNumberGenerator rng;
+    std::vector<Vec2> positions(numBodies);
+    std::vector<float> masses(numBodies);
+    for (int i = 0; i < numBodies; ++i)
+    {
+        // Clumped towards the middle like a solar system, with some massless bodies mixed in
+        float radius = 250'000.f * rng.GetRandomFloatZeroToOne() * rng.GetRandomFloatZeroToOne();
+        positions[i] = Vec2::MakeFromPolarCoords(rng.GetRandomFloatInRange(0.f, 360.f), radius);
+        masses[i] = (i % 10 == 0) ? 0.f : rng.GetRandomFloatInRange(1.f, 100.f);
+    }
+
+    BarnesHutTree tree;
+    tree.Build(positions, masses);
+
+    std::vector<Vec2> exactAccelerations(numBodies);
+    double exactStartTime = Time::GetCurrentTimeSeconds();
+    for (int i = 0; i < numBodies; ++i)
+    {
+        exactAccelerations[i] = tree.GetExactAccelerationAt(positions[i], GRAVITATIONAL_CONSTANT);
+    }
+    double exactSeconds = Time::GetCurrentTimeSeconds() - exactStartTime;
+    g_devConsole->LogSuccessF("Gravity benchmark, %i bodies: exact %.2f ms", numBodies, exactSeconds * 1000.0);
+
+    float const openingAngles[] = { 0.25f, 0.5f, 0.75f, 1.f };
+    for (float openingAngle : openingAngles)
+    {
+        double startTime = Time::GetCurrentTimeSeconds();
+        tree.Build(positions, masses);
+        double sumSquaredError = 0.0;
+        float maxError = 0.f;
+        for (int i = 0; i < numBodies; ++i)
+        {
+            Vec2 acceleration = tree.GetAccelerationAt(positions[i], openingAngle, GRAVITATIONAL_CONSTANT);
+            float exactLength = exactAccelerations[i].GetLength();
+            if (exactLength > 0.f)
             {
-                continue;
+                float relativeError = (acceleration - exactAccelerations[i]).GetLength() / exactLength;
+                sumSquaredError += relativeError * relativeError;
+                maxError = MathUtils::Max(maxError, relativeError);
             }
-
-            // Gravtity equations: 
-            // F = ma
-            // F = G(m1 * m2) / d^2
-            // a = (G * m2) / r^2
-            
-            auto& physB = physStorage[entB];
-            physB.m_frameAcceleration += (bToA * GRAVITATIONAL_CONSTANT * physA.m_mass) / distanceSquared;
         }
+        double seconds = Time::GetCurrentTimeSeconds() - startTime;
+
+        // Error math is in the timed loop, but is tiny next to the tree walk
+        g_devConsole->LogSuccessF("  opening angle %.2f: %.2f ms (%.1fx), rms error %.4f%%, max error %.3f%%", openingAngle, seconds * 1000.0, exactSeconds / seconds,
+            100.0 * sqrt(sumSquaredError / numBodies), 100.f * maxError);
     }
 }
@@ -1,6 +1,8 @@
 ﻿// Bradley Christensen - 2023
 #pragma once
 #include "Engine/ECS/System.h"
+#include "Game/BarnesHutTree.h"
+#include <vector>
 
 
 
@@ -12,4 +14,26 @@ public:
     SGravity(std::string const& name = "Gravity") : System(name) {};
     void Startup() override;
     void Run(SystemContext const& context) override;
+
+    static void RunBenchmark(int numBodies); // Logs time and error against the exact O(n^2) sum for a few opening angles
+
+public:
+
+    float m_openingAngle = 0.5f; // Barnes-Hut opening angle, 0 is exact, higher is faster and less accurate
+
+protected:
+
+    void CalculateAccelerations(int firstBody, int numBodies);
+
+protected:
+
+    friend class GravityJob;
+    static constexpr int s_minBodiesPerJob = 512; // Fewer bodies than this per job and it runs inline
+
+    int m_maxNumJobs = 1;
+    BarnesHutTree m_tree;
+    std::vector<EntityID> m_entities;
+    std::vector<Vec2> m_positions;
+    std::vector<float> m_masses;
+    std::vector<Vec2> m_accelerations;
 };
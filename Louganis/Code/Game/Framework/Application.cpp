@@ -3,6 +3,7 @@
 #include "Game/Game/Game.h"
 #include "Engine/Core/Engine.h"
 #include "Engine/Core/EngineCommon.h"
+#include "Engine/Core/StringUtils.h"
 #include "Engine/Time/Time.h"
 #include "Engine/Input/InputSystem.h"
 #include "Engine/Window/Window.h"
@@ -79,3 +80,27 @@ bool Application::IsQuitting() const
 {
     return m_isQuitting;
 }
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void Application::SetCommandLine(char const* commandLine)
+{
+    m_commandLine = commandLine ? commandLine : "";
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool Application::HasCommandLineArg(char const* arg) const
+{
+    Strings args = StringUtils::SplitStringOnAnyDelimiter(m_commandLine, " \t");
+    for (std::string const& commandLineArg : args)
+    {
+        if (StringUtils::CaseInsensitiveStringEquals()(commandLineArg, arg))
+        {
+            return true;
+        }
+    }
+    return false;
+}
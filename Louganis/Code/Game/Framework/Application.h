@@ -1,5 +1,6 @@
 // Bradley Christensen - 2022-2025
 #pragma once
+#include <string>
 
 
 
@@ -33,10 +34,14 @@ public:
     virtual void Quit();
     virtual bool HandleQuit(NamedProperties& args);
     virtual bool IsQuitting() const;
+
+    void SetCommandLine(char const* commandLine);
+    bool HasCommandLineArg(char const* arg) const; // Case insensitive, e.g. "-headless"
     
 private:
 
     bool m_isQuitting = false;
+    std::string m_commandLine;
 
     Game* m_game = nullptr;
     Clock* m_gameClock = nullptr;
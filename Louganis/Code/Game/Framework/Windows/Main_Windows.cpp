@@ -20,7 +20,7 @@
 //
 // Simply creates the Application and runs it until it decides to quit
 //
-int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int)
+int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR commandLine, _In_ int)
 {
 	#if defined(DEBUG_MEMORY_LEAKS)
 		_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
@@ -28,6 +28,7 @@ int WINAPI WinMain(_In_ HINSTANCE, _In_opt_ HINSTANCE, _In_ LPSTR, _In_ int)
 	#endif 
 
 	g_app = new Application();
+	g_app->SetCommandLine(commandLine);
 	g_app->Startup();
 	g_app->Run();
 	g_app->Shutdown();
@@ -9,7 +9,7 @@
 // Update:
 //  1. Write constructor that takes an xml element
 //  2. EntityDef header and constructor (EntityDef::EntityDef)
-//	3. SEntityFactory::CreateEntityFromDef
+//	3. EntityDef::CompilePrefab
 //  4. Register component in Game.cpp
 
 
@@ -20,6 +20,7 @@
 #include "CAbility.h"
 #include "CAIController.h"
 #include "CAnimation.h"
+#include "CAwake.h"
 #include "CCollision.h"
 #include "CDeath.h"
 #include "CHealth.h"
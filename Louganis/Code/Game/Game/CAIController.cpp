@@ -0,0 +1,19 @@
+﻿// Bradley Christensen - 2022-2025
+#include "CAIController.h"
+#include "Engine/Core/XmlUtils.h"
+#include <climits>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+CAIController::CAIController(void const* xmlElement)
+{
+    XmlElement const& elem = *reinterpret_cast<XmlElement const*>(xmlElement);
+
+    // AI with a goal tile share a cached flow field towards it instead of chasing the player
+    IntVec2 goalTile = XmlUtils::ParseXmlAttribute(elem, "goalTile", IntVec2(INT_MAX, INT_MAX));
+    if (goalTile != IntVec2(INT_MAX, INT_MAX))
+    {
+        m_flowFieldKey = FlowFieldKey::ToTile(WorldCoords::FromGlobalTileCoords(goalTile));
+    }
+}
@@ -1,5 +1,6 @@
 // Bradley Christensen - 2022-2025
 #pragma once
+#include "FlowFieldKey.h"
 
 
 
@@ -7,6 +8,8 @@
 struct CAIController
 {
     CAIController() = default;
-    CAIController(void const*) {};
+    CAIController(void const* xmlElement);
+
+    FlowFieldKey m_flowFieldKey; // Defaults to the player, or the def's goalTile (global tile coords) if it has one
 };
 
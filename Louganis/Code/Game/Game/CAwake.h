@@ -0,0 +1,12 @@
+﻿// Bradley Christensen - 2022-2025
+#pragma once
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Tag for entities near the player or still moving, maintained by SActivity. Systems that only matter for active
+// entities iterate with CAwake so idle entities out in loaded chunks cost nothing.
+//
+struct CAwake
+{
+};
@@ -15,6 +15,7 @@
 #include "Engine/DataStructures/NamedProperties.h"
 #include "EntityDef.h"
 #include "TileDef.h"
+#include "TileGenerationNoise.h"
 #include "WorldShaderCPU.h"
 
 
@@ -37,12 +38,23 @@ constexpr float DEEP_WATER_TERRAIN_HEIGHT		= 0.25f;
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void Chunk::Generate(IntVec2 const& chunkCoords, WorldSettings const& worldSettings, std::vector<SpawnInfo>& out_spawnInfos)
+void Chunk::SetChunkCoords(IntVec2 const& chunkCoords)
 {
 	m_chunkCoords = chunkCoords;
 	Vec2 chunkOrigin = Vec2(chunkCoords.x, chunkCoords.y) * StaticWorldSettings::s_chunkWidth;
 	Vec2 tileDims = Vec2(StaticWorldSettings::s_tileWidth, StaticWorldSettings::s_tileWidth);
 	m_chunkBounds = AABB2(chunkOrigin, chunkOrigin + tileDims * StaticWorldSettings::s_numTilesInRowF);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void Chunk::Generate(IntVec2 const& chunkCoords, WorldSettings const& worldSettings, std::vector<SpawnInfo>& out_spawnInfos)
+{
+	SetChunkCoords(chunkCoords);
+	m_worldSeed = worldSettings.m_worldSeed;
+	Vec2 chunkOrigin = m_chunkBounds.mins;
+	Vec2 tileDims = Vec2(StaticWorldSettings::s_tileWidth, StaticWorldSettings::s_tileWidth);
 
 	Tile grassTile				= TileDef::GetDefaultTile("grass");
 	Tile forestGrassTile		= TileDef::GetDefaultTile("forestGrass");
@@ -59,13 +71,18 @@ void Chunk::Generate(IntVec2 const& chunkCoords, WorldSettings const& worldSetti
 	Tile& defaultTile = grassTile;
 	m_tiles.Initialize(IntVec2(StaticWorldSettings::s_numTilesInRow, StaticWorldSettings::s_numTilesInRow), defaultTile);
 
+	// Batch generate the noise for every tile in the chunk up front, instead of sampling it tile by tile
+	TileGenerationNoise noise;
+	IntVec2 chunkMinsGlobalTileCoords = WorldCoords(m_chunkCoords, IntVec2::ZeroVector).GetGlobalTileCoords();
+	noise.Generate(chunkMinsGlobalTileCoords, IntVec2(StaticWorldSettings::s_numTilesInRow, StaticWorldSettings::s_numTilesInRow), worldSettings);
+
 	// Generate tile IDs
 	for (int y = 0; y < StaticWorldSettings::s_numTilesInRow; ++y)
 	{
 		for (int x = 0; x < StaticWorldSettings::s_numTilesInRow; ++x)
 		{
 			WorldCoords tileWorldCoords = WorldCoords(m_chunkCoords, IntVec2(x, y));
-			TileGeneratedData tileGenData = GenerateTileData(tileWorldCoords.GetGlobalTileCoords(), worldSettings); // could cache this off but would increase the memory usage of each chunk by an order of magnitude or more
+			TileGeneratedData tileGenData = GenerateTileData(tileWorldCoords.GetGlobalTileCoords(), worldSettings, noise); // could cache this off but would increase the memory usage of each chunk by an order of magnitude or more
 			Vec2 tileOrigin = chunkOrigin + Vec2(x, y) * StaticWorldSettings::s_tileWidth;
 
 			int index = m_tiles.GetIndexForCoords(x, y);
@@ -154,6 +171,15 @@ void Chunk::Generate(IntVec2 const& chunkCoords, WorldSettings const& worldSetti
 		}
 	}
 
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Generate can run on a worker thread, so anything that needs the renderer waits until here
+//
+void Chunk::GenerateDebugVBO()
+{
 	#if defined(_DEBUG)
 		m_debugVBO = g_renderer->MakeVertexBuffer<Vertex_PCU>();
 		VertexBuffer& debugVBO = *g_renderer->GetVertexBuffer(m_debugVBO);
@@ -245,16 +271,9 @@ void Chunk::GenerateVBO()
 //----------------------------------------------------------------------------------------------------------------------
 void Chunk::GenerateLightmap()
 {
-	if (m_lightmap == RendererUtils::InvalidID)
-	{
-		m_lightmap = g_renderer->MakeTexture();
-	}
-
 	Image image(IntVec2(StaticWorldSettings::s_numTilesInRow, StaticWorldSettings::s_numTilesInRow), Rgba8::TransparentBlack);
 	GenerateLightmapImage(image);
-
-	Texture* lightmapTex = g_renderer->GetTexture(m_lightmap);
-	lightmapTex->CreateFromImage(image, false, false);
+	UploadLightmap(image);
 }
 
 
@@ -282,35 +301,62 @@ void Chunk::GenerateLightmapImage(Image& out_image)
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Main thread only, the image can be made anywhere with GenerateLightmapImage
+//
+void Chunk::UploadLightmap(Image const& lightmapImage)
+{
+	if (m_lightmap == RendererUtils::InvalidID)
+	{
+		m_lightmap = g_renderer->MakeTexture();
+	}
+
+	Texture* lightmapTex = g_renderer->GetTexture(m_lightmap);
+	lightmapTex->CreateFromImage(lightmapImage, false, false);
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 TileGeneratedData Chunk::GenerateTileData(IntVec2 const& globalTileCoords, WorldSettings const& worldSettings)
+{
+	TileGenerationNoise noise;
+	noise.Generate(globalTileCoords, IntVec2(1, 1), worldSettings);
+	return GenerateTileData(globalTileCoords, worldSettings, noise);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+TileGeneratedData Chunk::GenerateTileData(IntVec2 const& globalTileCoords, WorldSettings const& worldSettings, TileGenerationNoise const& noise)
 {
 	TileGeneratedData tileGenData;
 
 	Vec2 worldTileLocation = Vec2(globalTileCoords);
+	int noiseIndex = noise.GetIndex(globalTileCoords);
+	int apronNoiseIndex = noise.GetApronIndex(globalTileCoords);
 
 	// Mountainness
-	tileGenData.m_mountainness = GetPerlinNoise2D(worldTileLocation.x, worldTileLocation.y, worldSettings.m_mountainnessScale, worldSettings.m_mountainnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed));
+	tileGenData.m_mountainness = noise.m_mountainness[noiseIndex];
 	tileGenData.m_mountainness = MathUtils::AbsF(tileGenData.m_mountainness);
 	tileGenData.m_mountainness = MathUtils::SmoothStep3(tileGenData.m_mountainness);
 
 	// Terrain Height
-	tileGenData.m_terrainHeightOffset = GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, worldSettings.m_terrainHeightOffsetScale, worldSettings.m_terrainHeightDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 1));
+	tileGenData.m_terrainHeightOffset = noise.m_terrainHeightOffset[noiseIndex];
 	tileGenData.m_terrainHeightOffset *= tileGenData.m_mountainness;
 
 	// Humidity
-	tileGenData.m_humidity = GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, worldSettings.m_humidityScale, worldSettings.m_humidityDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 2));
+	tileGenData.m_humidity = noise.m_humidity[noiseIndex];
 	tileGenData.m_humidity = MathUtils::SmoothStep3(tileGenData.m_humidity);
 	tileGenData.m_humidity *= -1.f; // Invert so higher moisture is lower value
 	tileGenData.m_humidity = MathUtils::RangeMapClamped(tileGenData.m_humidity, -1.f, 0.f, 0.f, 0.5f);
 
 	// Oceanness
-	tileGenData.m_oceanness = GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, worldSettings.m_oceannessScale, worldSettings.m_oceannessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 3));
+	tileGenData.m_oceanness = noise.m_oceanness[noiseIndex];
 	tileGenData.m_oceanness = MathUtils::SmoothStep3(tileGenData.m_oceanness);
 
 	// Riverness
-	float rivernessScale = worldSettings.m_rivernessScale;
-	tileGenData.m_riverness = GetPerlinNoise2D(worldTileLocation.x, worldTileLocation.y, rivernessScale, worldSettings.m_rivernessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 4));
+	tileGenData.m_riverness = noise.m_riverness[noiseIndex];
 	tileGenData.m_riverness = MathUtils::AbsF(tileGenData.m_riverness);
 
 	// River
@@ -318,16 +364,15 @@ TileGeneratedData Chunk::GenerateTileData(IntVec2 const& globalTileCoords, World
 	float riverThreshold = MathUtils::RangeMapClamped(tileGenData.m_humidity, 1.f, 0.f, worldSettings.m_riverThreshold, 0.f);
 
 	// Island
-	tileGenData.m_islandness = GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, worldSettings.m_islandnessScale, worldSettings.m_islandnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 5));
+	tileGenData.m_islandness = noise.m_islandness[noiseIndex];
 	tileGenData.m_islandness = MathUtils::SmoothStep3(tileGenData.m_islandness);
 
 	// Temperature
-	tileGenData.m_temperature = GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, worldSettings.m_temperatureScale, worldSettings.m_temperatureDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 6));
+	tileGenData.m_temperature = noise.m_temperature[noiseIndex];
 	tileGenData.m_temperature = MathUtils::SmoothStep3(tileGenData.m_temperature);
 
 	// Forestness
-	tileGenData.m_forestness = GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7));
-	tileGenData.m_forestness = MathUtils::SmoothStep3(tileGenData.m_forestness);
+	tileGenData.m_forestness = noise.m_forestness[apronNoiseIndex]; // Already smooth stepped
 
 	tileGenData.m_isIsland = tileGenData.m_islandness > worldSettings.m_islandThreshold;
 	tileGenData.m_isRiver = tileGenData.m_riverness < riverThreshold;
@@ -390,41 +435,24 @@ TileGeneratedData Chunk::GenerateTileData(IntVec2 const& globalTileCoords, World
 
 	tileGenData.m_terrainHeight = MathUtils::Clamp01F(tileGenData.m_terrainHeight);
 
-	// Trees
-	float treeScale = worldSettings.m_treeBaseScale;
-	if (tileGenData.m_isDesert)
-	{
-		treeScale /= worldSettings.m_desertTreeMultiplier; // make scale larger when multiplier is < 1
-	}
-	float localTreeness = GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, treeScale, 5, tileGenData.m_forestness, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8));
-	tileGenData.m_treeness = localTreeness;
+	// Trees, desert trees are sampled at a larger scale
+	std::vector<float> const& treeness = tileGenData.m_isDesert ? noise.m_desertTreeness : noise.m_treeness;
+	tileGenData.m_treeness = treeness[apronNoiseIndex];
 
 	tileGenData.m_canGrowTrees = tileGenData.m_terrainHeight >= SEA_LEVEL && tileGenData.m_terrainHeight < MOUNTAIN_TERRAIN_HEIGHT;
 
 	if (tileGenData.m_canGrowTrees)
 	{
-		float neighborForestness[8] =
-		{
-			MathUtils::SmoothStep3(GetPerlinNoise2D_01(worldTileLocation.x + 1.f, worldTileLocation.y,	     worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7))),
-			MathUtils::SmoothStep3(GetPerlinNoise2D_01(worldTileLocation.x - 1.f, worldTileLocation.y,	     worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7))),
-			MathUtils::SmoothStep3(GetPerlinNoise2D_01(worldTileLocation.x,		  worldTileLocation.y + 1.f, worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7))),
-			MathUtils::SmoothStep3(GetPerlinNoise2D_01(worldTileLocation.x,		  worldTileLocation.y - 1.f, worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7))),
-			MathUtils::SmoothStep3(GetPerlinNoise2D_01(worldTileLocation.x + 1.f, worldTileLocation.y + 1.f, worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7))),
-			MathUtils::SmoothStep3(GetPerlinNoise2D_01(worldTileLocation.x + 1.f, worldTileLocation.y - 1.f, worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7))),
-			MathUtils::SmoothStep3(GetPerlinNoise2D_01(worldTileLocation.x - 1.f, worldTileLocation.y + 1.f, worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7))),
-			MathUtils::SmoothStep3(GetPerlinNoise2D_01(worldTileLocation.x - 1.f, worldTileLocation.y - 1.f, worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 7))),
-		};
-
 		float neighborTreeness[8] =
 		{
-			GetPerlinNoise2D_01(worldTileLocation.x + 1.f, worldTileLocation.y,		  treeScale, 5, neighborForestness[0], 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8)),
-			GetPerlinNoise2D_01(worldTileLocation.x - 1.f, worldTileLocation.y,		  treeScale, 5, neighborForestness[1], 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8)),
-			GetPerlinNoise2D_01(worldTileLocation.x,	   worldTileLocation.y + 1.f, treeScale, 5, neighborForestness[2], 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8)),
-			GetPerlinNoise2D_01(worldTileLocation.x,	   worldTileLocation.y - 1.f, treeScale, 5, neighborForestness[3], 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8)),
-			GetPerlinNoise2D_01(worldTileLocation.x + 1.f, worldTileLocation.y + 1.f, treeScale, 5, neighborForestness[4], 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8)),
-			GetPerlinNoise2D_01(worldTileLocation.x + 1.f, worldTileLocation.y - 1.f, treeScale, 5, neighborForestness[5], 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8)),
-			GetPerlinNoise2D_01(worldTileLocation.x - 1.f, worldTileLocation.y + 1.f, treeScale, 5, neighborForestness[6], 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8)),
-			GetPerlinNoise2D_01(worldTileLocation.x - 1.f, worldTileLocation.y - 1.f, treeScale, 5, neighborForestness[7], 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed + 8)),
+			treeness[noise.GetApronIndex(globalTileCoords + IntVec2( 1,  0))],
+			treeness[noise.GetApronIndex(globalTileCoords + IntVec2(-1,  0))],
+			treeness[noise.GetApronIndex(globalTileCoords + IntVec2( 0,  1))],
+			treeness[noise.GetApronIndex(globalTileCoords + IntVec2( 0, -1))],
+			treeness[noise.GetApronIndex(globalTileCoords + IntVec2( 1,  1))],
+			treeness[noise.GetApronIndex(globalTileCoords + IntVec2( 1, -1))],
+			treeness[noise.GetApronIndex(globalTileCoords + IntVec2(-1,  1))],
+			treeness[noise.GetApronIndex(globalTileCoords + IntVec2(-1, -1))],
 		};
 
 		// If this tile has the highest treeness of its neighbors and is above a certain threshold, it has a tree
@@ -446,9 +474,9 @@ TileGeneratedData Chunk::GenerateTileData(IntVec2 const& globalTileCoords, World
 			}
 		}
 		float averageTreeHeight = 2.f + tileGenData.m_forestness * 2.f;
-		float treeHeightOffset = GetPerlinNoise2D(worldTileLocation.x, worldTileLocation.y, tileGenData.m_forestness, 1, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed));
+		float treeHeightOffset = Noise::GetPerlinNoise2D(worldTileLocation.x, worldTileLocation.y, tileGenData.m_forestness, 1, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed));
 		tileGenData.m_treeScale = averageTreeHeight + treeHeightOffset;
-		float t = GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, 25.f, 2, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed));
+		float t = Noise::GetPerlinNoise2D_01(worldTileLocation.x, worldTileLocation.y, 25.f, 2, 0.5f, 2.f, true, static_cast<unsigned int>(worldSettings.m_worldSeed));
 		t = t * 0.5f;
 		tileGenData.m_treeTint = Rgba8::Lerp(Rgba8::White, Rgba8::ForestGreen, t);
 	}
@@ -478,6 +506,7 @@ TileGeneratedData Chunk::GenerateTileData(IntVec2 const& globalTileCoords, World
 void Chunk::Destroy()
 {
 	m_tiles.Clear();
+	m_solidEdges.Clear();
 
 	g_renderer->ReleaseTexture(m_lightmap);
 
@@ -530,11 +559,18 @@ void Chunk::SetTile(IntVec2 const& localTileCoords, Tile tile)
 		return; // No change
 	}
 
-	m_solidnessChanged = prevTile.IsSolid() != tile.IsSolid();
+	bool solidnessChanged = prevTile.IsSolid() != tile.IsSolid();
+	m_solidnessChanged = solidnessChanged;
 
 	tile.SetLightingDirty(true);
 	m_tiles.Set(localTileCoords, tile);
 
+	if (solidnessChanged)
+	{
+		m_solidEdges.Build(*this);
+	}
+
 	m_isLightingDirty = true;
 	m_isVBODirty = true;
+	m_hasUnsavedChanges = true;
 }
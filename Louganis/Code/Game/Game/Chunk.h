@@ -5,6 +5,7 @@
 #include "Engine/Math/AABB2.h"
 #include "Engine/Math/FastGrid.h"
 #include "Engine/Renderer/RendererUtils.h"
+#include "ChunkSolidEdges.h"
 #include "SpawnInfo.h"
 #include "Tile.h"
 #include "TileGeneratedData.h"
@@ -14,6 +15,7 @@
 
 
 struct WorldSettings;
+struct TileGenerationNoise;
 class WorldCoords;
 class Image;
 
@@ -24,11 +26,15 @@ class Chunk
 {
 public:
 
+	void SetChunkCoords(IntVec2 const& chunkCoords);
 	void Generate(IntVec2 const& chunkCoords, WorldSettings const& worldSettings, std::vector<SpawnInfo>& out_spawnInfos);
+	void GenerateDebugVBO();
 	void GenerateVBO();
 	void GenerateLightmap();
 	void GenerateLightmapImage(Image& out_image);
+	void UploadLightmap(Image const& lightmapImage);
 	static TileGeneratedData GenerateTileData(IntVec2 const& globalTileCoords, WorldSettings const& worldSettings);
+	static TileGeneratedData GenerateTileData(IntVec2 const& globalTileCoords, WorldSettings const& worldSettings, TileGenerationNoise const& noise);
 	void Destroy();
 
 	bool IsTileSolid(IntVec2 const& localTileCoords) const;
@@ -41,9 +47,12 @@ public:
 
 	IntVec2 m_chunkCoords;
 	AABB2 m_chunkBounds;
+	size_t m_worldSeed = 0;
+	bool m_hasUnsavedChanges = false; // Edited since it was generated or loaded, so the disk cache is out of date
 	bool m_isLightingDirty = true;
 	bool m_isVBODirty = true;
 	bool m_solidnessChanged = false;
+	ChunkSolidEdges m_solidEdges; // Built by whoever generates or loads the chunk, rebuilt by SetTile
 	FastGrid<Tile, StaticWorldSettings::s_worldChunkSizePowerOfTwo> m_tiles;
 	VertexBufferID m_vbo = RendererUtils::InvalidID;
 	TextureID m_lightmap = RendererUtils::InvalidID; // R8G8
@@ -0,0 +1,241 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include "Engine/Math/IntVec2.h"
+#include <cstdint>
+#include <vector>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Chunk Directory
+//
+// Open addressing hash map from chunk coords to chunk pointers, linear probing over a power of two table. Finding a
+// chunk is one hash and a short scan of neighboring slots instead of a tree walk. Erasing shifts the rest of the probe
+// run back, so there are no tombstones and lookups don't slow down as chunks stream in and out.
+//
+// Iterates in table order, not sorted by coords. Don't insert or erase while iterating.
+//
+template<typename ChunkType>
+class ChunkDirectory
+{
+public:
+
+	struct Entry
+	{
+		IntVec2 m_coords;
+		ChunkType* m_chunk = nullptr; // nullptr means the slot is empty
+	};
+
+	class Iterator
+	{
+	public:
+
+		Iterator(Entry const* entry, Entry const* end) : m_entry(entry), m_end(end) { SkipEmpty(); }
+
+		Entry const& operator*() const				{ return *m_entry; }
+		Entry const* operator->() const				{ return m_entry; }
+		Iterator& operator++()						{ ++m_entry; SkipEmpty(); return *this; }
+		bool operator!=(Iterator const& rhs) const	{ return m_entry != rhs.m_entry; }
+
+	private:
+
+		void SkipEmpty()							{ while (m_entry != m_end && !m_entry->m_chunk) { ++m_entry; } }
+
+		Entry const* m_entry	= nullptr;
+		Entry const* m_end		= nullptr;
+	};
+
+public:
+
+	ChunkType* Find(IntVec2 const& coords) const;
+	ChunkType* FindNeighbor(ChunkType* currentChunk, IntVec2 const& currentCoords, IntVec2 const& neighborCoords) const;
+	bool Contains(IntVec2 const& coords) const;
+
+	bool Insert(IntVec2 const& coords, ChunkType* chunk);	// False if there is already a chunk at coords
+	ChunkType* Erase(IntVec2 const& coords);				// Returns the erased chunk, nullptr if there wasn't one
+	void Clear();
+
+	int Size() const										{ return m_size; }
+	bool IsEmpty() const									{ return m_size == 0; }
+
+	Iterator begin() const									{ return Iterator(m_entries.data(), m_entries.data() + m_entries.size()); }
+	Iterator end() const									{ return Iterator(m_entries.data() + m_entries.size(), m_entries.data() + m_entries.size()); }
+
+private:
+
+	int GetHomeSlot(IntVec2 const& coords) const;
+	int FindSlot(IntVec2 const& coords) const;				// -1 if not found
+	void Rehash(int newCapacity);
+
+private:
+
+	static constexpr int s_minCapacity = 64;
+
+	std::vector<Entry> m_entries;							// Size is always 0 or a power of two
+	int m_size = 0;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ChunkType>
+ChunkType* ChunkDirectory<ChunkType>::Find(IntVec2 const& coords) const
+{
+	int slot = FindSlot(coords);
+	return (slot == -1) ? nullptr : m_entries[slot].m_chunk;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Most neighbor lookups stay in the current chunk, so only hash when the neighbor is in a different one
+//
+template<typename ChunkType>
+ChunkType* ChunkDirectory<ChunkType>::FindNeighbor(ChunkType* currentChunk, IntVec2 const& currentCoords, IntVec2 const& neighborCoords) const
+{
+	if (neighborCoords == currentCoords)
+	{
+		return currentChunk;
+	}
+	return Find(neighborCoords);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ChunkType>
+bool ChunkDirectory<ChunkType>::Contains(IntVec2 const& coords) const
+{
+	return FindSlot(coords) != -1;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ChunkType>
+bool ChunkDirectory<ChunkType>::Insert(IntVec2 const& coords, ChunkType* chunk)
+{
+	// Keep the load factor at or under 1/2, so probe runs stay short
+	if ((m_size + 1) * 2 > (int) m_entries.size())
+	{
+		Rehash(m_entries.empty() ? s_minCapacity : (int) m_entries.size() * 2);
+	}
+
+	int mask = (int) m_entries.size() - 1;
+	for (int slot = GetHomeSlot(coords); ; slot = (slot + 1) & mask)
+	{
+		Entry& entry = m_entries[slot];
+		if (!entry.m_chunk)
+		{
+			entry.m_coords = coords;
+			entry.m_chunk = chunk;
+			++m_size;
+			return true;
+		}
+		if (entry.m_coords == coords)
+		{
+			return false;
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ChunkType>
+ChunkType* ChunkDirectory<ChunkType>::Erase(IntVec2 const& coords)
+{
+	int emptySlot = FindSlot(coords);
+	if (emptySlot == -1)
+	{
+		return nullptr;
+	}
+
+	ChunkType* erasedChunk = m_entries[emptySlot].m_chunk;
+	m_entries[emptySlot].m_chunk = nullptr;
+	--m_size;
+
+	// Shift back any later entries in the run that can no longer be reached from their home slot
+	int mask = (int) m_entries.size() - 1;
+	for (int slot = (emptySlot + 1) & mask; m_entries[slot].m_chunk; slot = (slot + 1) & mask)
+	{
+		int homeSlot = GetHomeSlot(m_entries[slot].m_coords);
+		bool isHomeInGap = (emptySlot <= slot) ? (emptySlot < homeSlot && homeSlot <= slot) : (emptySlot < homeSlot || homeSlot <= slot);
+		if (isHomeInGap)
+		{
+			continue;
+		}
+
+		m_entries[emptySlot] = m_entries[slot];
+		m_entries[slot].m_chunk = nullptr;
+		emptySlot = slot;
+	}
+
+	return erasedChunk;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ChunkType>
+void ChunkDirectory<ChunkType>::Clear()
+{
+	for (Entry& entry : m_entries)
+	{
+		entry.m_chunk = nullptr;
+	}
+	m_size = 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ChunkType>
+int ChunkDirectory<ChunkType>::GetHomeSlot(IntVec2 const& coords) const
+{
+	uint32_t hash = ((uint32_t) coords.x * 0x9E3779B1u) ^ ((uint32_t) coords.y * 0x85EBCA77u);
+	hash ^= hash >> 16;
+	return (int) (hash & (uint32_t) (m_entries.size() - 1));
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ChunkType>
+int ChunkDirectory<ChunkType>::FindSlot(IntVec2 const& coords) const
+{
+	if (m_size == 0)
+	{
+		return -1;
+	}
+
+	int mask = (int) m_entries.size() - 1;
+	for (int slot = GetHomeSlot(coords); m_entries[slot].m_chunk; slot = (slot + 1) & mask)
+	{
+		if (m_entries[slot].m_coords == coords)
+		{
+			return slot;
+		}
+	}
+	return -1;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename ChunkType>
+void ChunkDirectory<ChunkType>::Rehash(int newCapacity)
+{
+	std::vector<Entry> oldEntries;
+	oldEntries.swap(m_entries);
+	m_entries.resize(newCapacity);
+	m_size = 0;
+
+	for (Entry const& entry : oldEntries)
+	{
+		if (entry.m_chunk)
+		{
+			Insert(entry.m_coords, entry.m_chunk);
+		}
+	}
+}
@@ -0,0 +1,663 @@
+// Bradley Christensen - 2022-2025
+#include "ChunkDiskCache.h"
+#include "Chunk.h"
+#include "EntityDef.h"
+#include "TileDef.h"
+#include "WorldSettings.h"
+#include "Engine/Core/BinaryUtils.h"
+#include "Engine/Core/FileUtils.h"
+#include "Engine/Core/StringUtils.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Multithreading/JobSystem.h"
+#include <cstring>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+constexpr uint32_t REGION_FILE_MAGIC		= 0x4752434C;	// "LCRG"
+constexpr uint16_t REGION_FILE_VERSION		= 2;			// Bump when the format changes, settings and defs are covered by the content hash
+
+constexpr uint8_t SPAWN_FLAG_SCALE			= 1 << 0;
+constexpr uint8_t SPAWN_FLAG_TINT			= 1 << 1;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+struct RegionFileHeader
+{
+	uint32_t m_magic		= REGION_FILE_MAGIC;
+	uint16_t m_version		= REGION_FILE_VERSION;
+	uint16_t m_numChunks	= ChunkDiskCache::s_numChunksInRegion;
+	uint64_t m_contentHash	= 0;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+class WriteChunkRegionJob : public Job
+{
+public:
+
+	WriteChunkRegionJob(ChunkDiskCache& cache, ChunkDiskCache::Region* region) : m_cache(cache), m_region(region)
+	{
+		SetNeedsComplete(false);
+	}
+
+	virtual void Execute() override
+	{
+		m_cache.WriteRegion(m_region);
+	}
+
+	ChunkDiskCache& m_cache;
+	ChunkDiskCache::Region* m_region = nullptr;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// The seed is already in the region file path, so this is the generation settings and the def tables
+//
+uint64_t CalculateContentHash(WorldSettings const& worldSettings)
+{
+	// Cached tiles and spawns are stored as indexes into the def tables, and static lighting comes from the tile defs
+	uint64_t hash = TileDef::GetTableHash();
+	uint64_t entityDefTableHash = EntityDef::GetTableHash();
+	hash = BinaryUtils::HashBytes(&entityDefTableHash, sizeof(entityDefTableHash), hash);
+
+	// Field by field, so padding never makes it into the hash
+	auto hashField = [&hash](auto const& field)
+	{
+		hash = BinaryUtils::HashBytes(&field, sizeof(field), hash);
+	};
+	hashField(worldSettings.m_terrainHeightOffsetScale);
+	hashField(worldSettings.m_humidityScale);
+	hashField(worldSettings.m_mountainnessScale);
+	hashField(worldSettings.m_oceannessScale);
+	hashField(worldSettings.m_rivernessScale);
+	hashField(worldSettings.m_forestnessScale);
+	hashField(worldSettings.m_treeBaseScale);
+	hashField(worldSettings.m_islandnessScale);
+	hashField(worldSettings.m_temperatureScale);
+	hashField(worldSettings.m_forestnessDetailLevel);
+	hashField(worldSettings.m_temperatureDetailLevel);
+	hashField(worldSettings.m_rivernessDetailLevel);
+	hashField(worldSettings.m_islandnessDetailLevel);
+	hashField(worldSettings.m_terrainHeightDetailLevel);
+	hashField(worldSettings.m_humidityDetailLevel);
+	hashField(worldSettings.m_mountainnessDetailLevel);
+	hashField(worldSettings.m_oceannessDetailLevel);
+	hashField(worldSettings.m_coldThreshold);
+	hashField(worldSettings.m_forestThreshold);
+	hashField(worldSettings.m_deepForestThreshold);
+	hashField(worldSettings.m_desertHumidityThreshold);
+	hashField(worldSettings.m_oceanSandThreshold);
+	hashField(worldSettings.m_oceanShallowWaterThreshold);
+	hashField(worldSettings.m_oceanWaterThreshold);
+	hashField(worldSettings.m_oceanDeepWaterThreshold);
+	hashField(worldSettings.m_riverThreshold);
+	hashField(worldSettings.m_riverMaxDepth);
+	hashField(worldSettings.m_desertRiverMaxDepth);
+	hashField(worldSettings.m_riverToOceanTransitionSpeed);
+	hashField(worldSettings.m_riverToDesertTransitionSpeed);
+	hashField(worldSettings.m_islandThreshold);
+	hashField(worldSettings.m_desertTreeMultiplier);
+	return hash;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+void AppendBytes(std::vector<uint8_t>& out_bytes, T const& value)
+{
+	size_t offset = out_bytes.size();
+	out_bytes.resize(offset + sizeof(T));
+	memcpy(out_bytes.data() + offset, &value, sizeof(T));
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+template<typename T>
+bool ReadBytes(uint8_t const*& readPos, uint8_t const* end, T& out_value)
+{
+	if (end - readPos < (int) sizeof(T))
+	{
+		return false;
+	}
+	memcpy(&out_value, readPos, sizeof(T));
+	readPos += sizeof(T);
+	return true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Runs of up to 255 equal values, as (run length, value) pairs
+//
+void EncodeRLE(uint8_t const* values, int numValues, std::vector<uint8_t>& out_bytes)
+{
+	for (int i = 0; i < numValues;)
+	{
+		uint8_t value = values[i];
+		int runLength = 1;
+		while (i + runLength < numValues && runLength < 255 && values[i + runLength] == value)
+		{
+			++runLength;
+		}
+		out_bytes.push_back(static_cast<uint8_t>(runLength));
+		out_bytes.push_back(value);
+		i += runLength;
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool DecodeRLE(uint8_t const*& readPos, uint8_t const* end, uint8_t* out_values, int numValues)
+{
+	int numDecoded = 0;
+	while (numDecoded < numValues)
+	{
+		if (end - readPos < 2)
+		{
+			return false;
+		}
+		int runLength = readPos[0];
+		uint8_t value = readPos[1];
+		readPos += 2;
+		if (runLength == 0 || numDecoded + runLength > numValues)
+		{
+			return false;
+		}
+		memset(out_values + numDecoded, value, runLength);
+		numDecoded += runLength;
+	}
+	return true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Blob layout: uint16 tile section size | tile ids (RLE) | static lighting deltas (RLE) | spawn section
+//
+void EncodeChunkTiles(Chunk const& chunk, std::vector<uint8_t>& out_bytes)
+{
+	uint8_t tileIDs[StaticWorldSettings::s_numTilesInChunk];
+	uint8_t staticLightingDeltas[StaticWorldSettings::s_numTilesInChunk];
+	uint8_t prevStaticLighting = 0;
+	for (int index = 0; index < StaticWorldSettings::s_numTilesInChunk; ++index)
+	{
+		Tile const& tile = chunk.m_tiles.GetRef(index);
+		tileIDs[index] = tile.m_id;
+
+		// Static lighting changes smoothly across the chunk, so the deltas have long runs
+		staticLightingDeltas[index] = static_cast<uint8_t>(tile.m_staticLighting - prevStaticLighting);
+		prevStaticLighting = tile.m_staticLighting;
+	}
+
+	size_t sizeOffset = out_bytes.size();
+	AppendBytes(out_bytes, uint16_t(0));
+	EncodeRLE(tileIDs, StaticWorldSettings::s_numTilesInChunk, out_bytes);
+	EncodeRLE(staticLightingDeltas, StaticWorldSettings::s_numTilesInChunk, out_bytes);
+
+	uint16_t tileSectionSize = static_cast<uint16_t>(out_bytes.size() - sizeOffset - sizeof(uint16_t));
+	memcpy(out_bytes.data() + sizeOffset, &tileSectionSize, sizeof(uint16_t));
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Generation always spawns at tile centers, so spawns are stored by local tile index
+//
+void EncodeSpawnInfos(Chunk const& chunk, std::vector<SpawnInfo> const& spawnInfos, std::vector<uint8_t>& out_bytes)
+{
+	AppendBytes(out_bytes, static_cast<uint16_t>(spawnInfos.size()));
+	for (SpawnInfo const& spawnInfo : spawnInfos)
+	{
+		Vec2 localPos = (spawnInfo.m_spawnPos - chunk.m_chunkBounds.mins) / StaticWorldSettings::s_tileWidth;
+		int localTileX = MathUtils::Clamp(static_cast<int>(localPos.x), 0, StaticWorldSettings::s_numTilesInRow - 1);
+		int localTileY = MathUtils::Clamp(static_cast<int>(localPos.y), 0, StaticWorldSettings::s_numTilesInRow - 1);
+
+		uint8_t flags = 0;
+		flags |= (spawnInfo.m_spawnScale != 1.f) ? SPAWN_FLAG_SCALE : 0;
+		flags |= (spawnInfo.m_spawnTint != Rgba8::White) ? SPAWN_FLAG_TINT : 0;
+
+		AppendBytes(out_bytes, static_cast<uint8_t>(EntityDef::GetEntityDefID(spawnInfo.m_def->m_name)));
+		AppendBytes(out_bytes, static_cast<uint8_t>(chunk.m_tiles.GetIndexForCoords(localTileX, localTileY)));
+		AppendBytes(out_bytes, flags);
+		if (flags & SPAWN_FLAG_SCALE)
+		{
+			AppendBytes(out_bytes, spawnInfo.m_spawnScale);
+		}
+		if (flags & SPAWN_FLAG_TINT)
+		{
+			AppendBytes(out_bytes, spawnInfo.m_spawnTint);
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Returns false if the blob is corrupt or refers to defs that don't exist anymore, in which case the chunk is regenerated
+//
+bool DecodeChunk(std::vector<uint8_t> const& blob, IntVec2 const& chunkCoords, size_t worldSeed, Chunk& out_chunk, std::vector<SpawnInfo>& out_spawnInfos)
+{
+	uint8_t const* readPos = blob.data();
+	uint8_t const* end = blob.data() + blob.size();
+
+	uint16_t tileSectionSize = 0;
+	uint8_t tileIDs[StaticWorldSettings::s_numTilesInChunk];
+	uint8_t staticLighting[StaticWorldSettings::s_numTilesInChunk];
+	if (!ReadBytes(readPos, end, tileSectionSize) ||
+		!DecodeRLE(readPos, end, tileIDs, StaticWorldSettings::s_numTilesInChunk) ||
+		!DecodeRLE(readPos, end, staticLighting, StaticWorldSettings::s_numTilesInChunk))
+	{
+		return false;
+	}
+
+	// Tiles start as their def's default tile, the same as Chunk::Generate, so look each def up once
+	Tile defaultTiles[256];
+	bool hasDefaultTile[256] = {};
+	for (uint8_t tileID : tileIDs)
+	{
+		if (hasDefaultTile[tileID])
+		{
+			continue;
+		}
+		if (!TileDef::GetTileDef(tileID))
+		{
+			return false;
+		}
+		defaultTiles[tileID] = TileDef::GetDefaultTile(tileID);
+		hasDefaultTile[tileID] = true;
+	}
+
+	out_chunk.SetChunkCoords(chunkCoords);
+	out_chunk.m_worldSeed = worldSeed;
+	out_chunk.m_tiles.Initialize(IntVec2(StaticWorldSettings::s_numTilesInRow, StaticWorldSettings::s_numTilesInRow), Tile());
+
+	uint8_t prevStaticLighting = 0;
+	for (int index = 0; index < StaticWorldSettings::s_numTilesInChunk; ++index)
+	{
+		Tile tile = defaultTiles[tileIDs[index]];
+		tile.m_staticLighting = static_cast<uint8_t>(prevStaticLighting + staticLighting[index]);
+		prevStaticLighting = tile.m_staticLighting;
+
+		// Set all edge tiles as dirty
+		if (out_chunk.m_tiles.IsOnEdge(out_chunk.m_tiles.GetCoordsForIndex(index)))
+		{
+			tile.SetLightingDirty(true);
+			out_chunk.m_isLightingDirty = true;
+		}
+		out_chunk.m_tiles.Set(index, tile);
+	}
+
+	uint16_t numSpawnInfos = 0;
+	if (!ReadBytes(readPos, end, numSpawnInfos))
+	{
+		return false;
+	}
+
+	Vec2 tileDims = Vec2(StaticWorldSettings::s_tileWidth, StaticWorldSettings::s_tileWidth);
+	for (int i = 0; i < (int) numSpawnInfos; ++i)
+	{
+		uint8_t defID = 0;
+		uint8_t tileIndex = 0;
+		uint8_t flags = 0;
+		if (!ReadBytes(readPos, end, defID) || !ReadBytes(readPos, end, tileIndex) || !ReadBytes(readPos, end, flags))
+		{
+			return false;
+		}
+
+		SpawnInfo spawnInfo;
+		spawnInfo.m_def = EntityDef::GetEntityDef(defID);
+		if (!spawnInfo.m_def)
+		{
+			return false;
+		}
+		if ((flags & SPAWN_FLAG_SCALE) && !ReadBytes(readPos, end, spawnInfo.m_spawnScale))
+		{
+			return false;
+		}
+		if ((flags & SPAWN_FLAG_TINT) && !ReadBytes(readPos, end, spawnInfo.m_spawnTint))
+		{
+			return false;
+		}
+
+		IntVec2 localTileCoords = out_chunk.m_tiles.GetCoordsForIndex(tileIndex);
+		spawnInfo.m_spawnPos = out_chunk.m_chunkBounds.mins + Vec2(localTileCoords) * StaticWorldSettings::s_tileWidth + (tileDims * 0.5f);
+		out_spawnInfos.push_back(spawnInfo);
+	}
+	return true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EncodeRegionFile(std::vector<std::vector<uint8_t>> const& chunkBlobs, uint64_t contentHash, std::vector<uint8_t>& out_bytes)
+{
+	RegionFileHeader header;
+	header.m_contentHash = contentHash;
+	AppendBytes(out_bytes, header);
+
+	uint32_t blobOffset = static_cast<uint32_t>(sizeof(RegionFileHeader) + 2 * sizeof(uint32_t) * chunkBlobs.size());
+	for (std::vector<uint8_t> const& blob : chunkBlobs)
+	{
+		AppendBytes(out_bytes, blobOffset);
+		blobOffset += static_cast<uint32_t>(blob.size());
+	}
+	for (std::vector<uint8_t> const& blob : chunkBlobs)
+	{
+		AppendBytes(out_bytes, static_cast<uint32_t>(blob.size()));
+	}
+	for (std::vector<uint8_t> const& blob : chunkBlobs)
+	{
+		out_bytes.insert(out_bytes.end(), blob.begin(), blob.end());
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Leaves out_chunkBlobs empty for any chunk that can't be read, a bad or stale region file just means regenerating its chunks
+//
+void DecodeRegionFile(std::vector<uint8_t> const& fileBytes, uint64_t contentHash, std::vector<std::vector<uint8_t>>& out_chunkBlobs)
+{
+	uint8_t const* readPos = fileBytes.data();
+	uint8_t const* end = fileBytes.data() + fileBytes.size();
+
+	RegionFileHeader header;
+	if (!ReadBytes(readPos, end, header) || header.m_magic != REGION_FILE_MAGIC || header.m_version != REGION_FILE_VERSION || header.m_numChunks != ChunkDiskCache::s_numChunksInRegion || header.m_contentHash != contentHash)
+	{
+		return;
+	}
+
+	uint32_t offsets[ChunkDiskCache::s_numChunksInRegion];
+	uint32_t sizes[ChunkDiskCache::s_numChunksInRegion];
+	if (!ReadBytes(readPos, end, offsets) || !ReadBytes(readPos, end, sizes))
+	{
+		return;
+	}
+
+	for (int i = 0; i < ChunkDiskCache::s_numChunksInRegion; ++i)
+	{
+		if ((uint64_t) offsets[i] + sizes[i] <= fileBytes.size())
+		{
+			out_chunkBlobs[i].assign(fileBytes.begin() + offsets[i], fileBytes.begin() + offsets[i] + sizes[i]);
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+ChunkDiskCache::~ChunkDiskCache()
+{
+	Flush();
+	for (Region* region : m_regions)
+	{
+		delete region;
+	}
+	m_regions.clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool ChunkDiskCache::TryLoadChunk(IntVec2 const& chunkCoords, WorldSettings const& worldSettings, Chunk& out_chunk, std::vector<SpawnInfo>& out_spawnInfos)
+{
+	uint64_t contentHash = CalculateContentHash(worldSettings);
+
+	// Copy the blob out so decoding doesn't hold up other threads
+	std::vector<uint8_t> blob;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		Region* region = GetOrAddRegion(worldSettings.m_worldSeed, contentHash, GetRegionCoords(chunkCoords));
+		LoadRegion(region, lock);
+		blob = region->m_chunkBlobs[GetChunkIndexInRegion(chunkCoords)];
+	}
+
+	if (blob.empty())
+	{
+		return false;
+	}
+
+	size_t numSpawnInfosBefore = out_spawnInfos.size();
+	if (!DecodeChunk(blob, chunkCoords, worldSettings.m_worldSeed, out_chunk, out_spawnInfos))
+	{
+		out_spawnInfos.resize(numSpawnInfosBefore);
+		return false;
+	}
+	return true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void ChunkDiskCache::SaveChunk(Chunk const& chunk, WorldSettings const& worldSettings, std::vector<SpawnInfo> const* spawnInfos)
+{
+	uint64_t contentHash = CalculateContentHash(worldSettings);
+
+	std::vector<uint8_t> blob;
+	EncodeChunkTiles(chunk, blob);
+	if (spawnInfos)
+	{
+		EncodeSpawnInfos(chunk, *spawnInfos, blob);
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	Region* region = GetOrAddRegion(chunk.m_worldSeed, contentHash, GetRegionCoords(chunk.m_chunkCoords));
+	int chunkIndex = GetChunkIndexInRegion(chunk.m_chunkCoords);
+	if (region->m_isLoaded)
+	{
+		StoreChunkBlob(region, chunkIndex, blob, !spawnInfos);
+	}
+	else
+	{
+		// Chunks are saved from the main thread when they unload, so leave reading the region file to the write job
+		PendingSave& pendingSave = region->m_pendingSaves.emplace_back();
+		pendingSave.m_chunkIndex = chunkIndex;
+		pendingSave.m_blob.swap(blob);
+		pendingSave.m_keepCachedSpawnInfos = !spawnInfos;
+	}
+
+	if (!region->m_isWriteQueued)
+	{
+		region->m_isWriteQueued = true;
+		region->m_numWritesInFlight++;
+		m_numWritesInFlight++;
+		g_jobSystem->PostLoadingJob(new WriteChunkRegionJob(*this, region));
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void ChunkDiskCache::Flush()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_writesFinishedCondition.wait(lock, [this]() { return m_numWritesInFlight == 0; });
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+IntVec2 ChunkDiskCache::GetRegionCoords(IntVec2 const& chunkCoords)
+{
+	return IntVec2(chunkCoords.x >> s_regionSizePowerOfTwo, chunkCoords.y >> s_regionSizePowerOfTwo);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int ChunkDiskCache::GetChunkIndexInRegion(IntVec2 const& chunkCoords)
+{
+	int localX = chunkCoords.x & (s_numChunksInRegionRow - 1);
+	int localY = chunkCoords.y & (s_numChunksInRegionRow - 1);
+	return (localY << s_regionSizePowerOfTwo) + localX;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+std::string ChunkDiskCache::GetRegionFilePath(size_t worldSeed, IntVec2 const& regionCoords)
+{
+	return StringUtils::StringF("%s/%llu/%d_%d.region", s_cacheDirectory, (unsigned long long) worldSeed, regionCoords.x, regionCoords.y);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+ChunkDiskCache::Region* ChunkDiskCache::GetOrAddRegion(size_t worldSeed, uint64_t contentHash, IntVec2 const& regionCoords)
+{
+	++m_useCounter;
+	for (Region* region : m_regions)
+	{
+		if (region->m_worldSeed == worldSeed && region->m_contentHash == contentHash && region->m_regionCoords == regionCoords)
+		{
+			region->m_lastUsed = m_useCounter;
+			return region;
+		}
+	}
+
+	EvictRegions();
+
+	Region* region = new Region();
+	region->m_worldSeed = worldSeed;
+	region->m_contentHash = contentHash;
+	region->m_regionCoords = regionCoords;
+	region->m_lastUsed = m_useCounter;
+	m_regions.push_back(region);
+	return region;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Only one thread reads a region's file, anyone else that needs the region waits for it. m_mutex is unlocked while the
+// file is read and decoded so threads using other regions aren't held up.
+//
+void ChunkDiskCache::LoadRegion(Region* region, std::unique_lock<std::mutex>& lock)
+{
+	region->m_numThreadsUsing++;
+	while (!region->m_isLoaded)
+	{
+		if (region->m_isLoading)
+		{
+			m_regionLoadedCondition.wait(lock);
+			continue;
+		}
+
+		region->m_isLoading = true;
+		std::string filePath = GetRegionFilePath(region->m_worldSeed, region->m_regionCoords);
+		uint64_t contentHash = region->m_contentHash;
+		lock.unlock();
+
+		std::vector<std::vector<uint8_t>> chunkBlobs(s_numChunksInRegion);
+		std::vector<uint8_t> fileBytes;
+		if (FileUtils::FileReadToBuffer(filePath, fileBytes) > 0)
+		{
+			DecodeRegionFile(fileBytes, contentHash, chunkBlobs);
+		}
+
+		lock.lock();
+		region->m_chunkBlobs.swap(chunkBlobs);
+		for (PendingSave& pendingSave : region->m_pendingSaves)
+		{
+			StoreChunkBlob(region, pendingSave.m_chunkIndex, pendingSave.m_blob, pendingSave.m_keepCachedSpawnInfos);
+		}
+		region->m_pendingSaves.clear();
+		region->m_isLoading = false;
+		region->m_isLoaded = true;
+		m_regionLoadedCondition.notify_all();
+	}
+	region->m_numThreadsUsing--;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void ChunkDiskCache::StoreChunkBlob(Region* region, int chunkIndex, std::vector<uint8_t>& blob, bool keepCachedSpawnInfos)
+{
+	std::vector<uint8_t>& cachedBlob = region->m_chunkBlobs[chunkIndex];
+	if (keepCachedSpawnInfos)
+	{
+		// Keep the spawn section of the blob that's already cached, it's everything after the tile section
+		uint16_t cachedTileSectionSize = 0;
+		uint8_t const* readPos = cachedBlob.data();
+		if (ReadBytes(readPos, cachedBlob.data() + cachedBlob.size(), cachedTileSectionSize) && sizeof(uint16_t) + cachedTileSectionSize <= cachedBlob.size())
+		{
+			blob.insert(blob.end(), cachedBlob.begin() + sizeof(uint16_t) + cachedTileSectionSize, cachedBlob.end());
+		}
+		else
+		{
+			AppendBytes(blob, uint16_t(0));
+		}
+	}
+	cachedBlob.swap(blob);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Drop the least recently used regions that are already on disk, and that nobody is loading, until there's room for one more
+//
+void ChunkDiskCache::EvictRegions()
+{
+	while ((int) m_regions.size() >= s_maxNumRegionsInMemory)
+	{
+		int oldestIndex = -1;
+		for (int i = 0; i < (int) m_regions.size(); ++i)
+		{
+			Region* region = m_regions[i];
+			if (region->m_numWritesInFlight > 0 || region->m_numThreadsUsing > 0 || !region->m_isLoaded)
+			{
+				continue;
+			}
+			if (oldestIndex == -1 || region->m_lastUsed < m_regions[oldestIndex]->m_lastUsed)
+			{
+				oldestIndex = i;
+			}
+		}
+
+		if (oldestIndex == -1)
+		{
+			// Everything is waiting to be written, go over the limit for now
+			return;
+		}
+
+		delete m_regions[oldestIndex];
+		m_regions[oldestIndex] = m_regions.back();
+		m_regions.pop_back();
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void ChunkDiskCache::WriteRegion(Region* region)
+{
+	std::unique_lock<std::mutex> fileWriteLock(m_fileWriteMutex);
+
+	std::string filePath;
+	std::vector<uint8_t> fileBytes;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		LoadRegion(region, lock);
+		region->m_isWriteQueued = false;
+		filePath = GetRegionFilePath(region->m_worldSeed, region->m_regionCoords);
+		EncodeRegionFile(region->m_chunkBlobs, region->m_contentHash, fileBytes);
+	}
+
+	FileUtils::FileWriteFromBuffer(filePath, fileBytes);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	region->m_numWritesInFlight--;
+	m_numWritesInFlight--;
+	if (m_numWritesInFlight == 0)
+	{
+		m_writesFinishedCondition.notify_all();
+	}
+}
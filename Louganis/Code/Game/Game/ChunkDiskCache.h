@@ -0,0 +1,100 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include "SpawnInfo.h"
+#include "Engine/Math/IntVec2.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+
+class Chunk;
+struct WorldSettings;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Chunk Disk Cache
+//
+// Keeps generated and edited chunks on disk, so coming back to an area decodes it instead of regenerating it from noise.
+// Chunks are grouped into region files of s_numChunksInRegion chunks, one directory per world seed:
+//
+//		RegionFileHeader | uint32 blob offsets[s_numChunksInRegion] | uint32 blob sizes[s_numChunksInRegion] | blobs
+//
+// A chunk blob is its tile ids (RLE), its static lighting (delta + RLE), and the spawn infos generation made for it.
+// Everything else on a tile comes from its TileDef, the same way Chunk::Generate sets it up.
+//
+// Region files are read whole and kept in memory (up to s_maxNumRegionsInMemory), so loading a chunk from a region
+// that's already been touched is just decoding its blob. Saving updates the region in memory and queues a loading job
+// to write the region file. Saving never reads a region file, saves to a region that isn't in memory yet are held until
+// the write job (or a generation job) loads it. Thread safe, generation jobs load from it while loading jobs write it out.
+//
+// The header holds a hash of the generation settings and the tile/entity def tables, so cached chunks made with
+// different settings or defs are regenerated instead of decoded into the wrong tiles.
+//
+class ChunkDiskCache
+{
+	friend class WriteChunkRegionJob;
+
+public:
+
+	~ChunkDiskCache();
+
+	bool TryLoadChunk(IntVec2 const& chunkCoords, WorldSettings const& worldSettings, Chunk& out_chunk, std::vector<SpawnInfo>& out_spawnInfos);
+	void SaveChunk(Chunk const& chunk, WorldSettings const& worldSettings, std::vector<SpawnInfo> const* spawnInfos);	// nullptr keeps the spawn infos already cached for the chunk
+	void Flush();																	// Blocks until everything saved so far is on disk
+
+	static IntVec2 GetRegionCoords(IntVec2 const& chunkCoords);
+	static int GetChunkIndexInRegion(IntVec2 const& chunkCoords);
+	static std::string GetRegionFilePath(size_t worldSeed, IntVec2 const& regionCoords);
+
+public:
+
+	static constexpr int s_regionSizePowerOfTwo		= 4;						// In chunks
+	static constexpr int s_numChunksInRegionRow		= (1 << s_regionSizePowerOfTwo);
+	static constexpr int s_numChunksInRegion		= s_numChunksInRegionRow * s_numChunksInRegionRow;
+	static constexpr int s_maxNumRegionsInMemory	= 32;
+	static constexpr char const* s_cacheDirectory	= "Saved/ChunkCache";
+
+private:
+
+	struct PendingSave
+	{
+		int m_chunkIndex				= 0;
+		std::vector<uint8_t> m_blob;
+		bool m_keepCachedSpawnInfos		= false;
+	};
+
+	struct Region
+	{
+		size_t m_worldSeed			= 0;
+		uint64_t m_contentHash		= 0;
+		IntVec2 m_regionCoords;
+		std::vector<std::vector<uint8_t>> m_chunkBlobs;							// Per chunk in the region, empty if it isn't cached
+		std::vector<PendingSave> m_pendingSaves;								// Saved before the region was loaded, applied on top of it in order
+		uint32_t m_lastUsed			= 0;
+		bool m_isLoaded				= false;
+		bool m_isLoading			= false;									// Some thread is reading the region file, with m_mutex unlocked
+		int m_numThreadsUsing		= 0;										// Waiting on or doing the load, can't evict until they're done
+		bool m_isWriteQueued		= false;									// Cleared once the write job has copied the region
+		int m_numWritesInFlight		= 0;										// Can't evict until the file on disk is up to date
+	};
+
+	Region* GetOrAddRegion(size_t worldSeed, uint64_t contentHash, IntVec2 const& regionCoords);	// m_mutex must be locked, doesn't load the region
+	void LoadRegion(Region* region, std::unique_lock<std::mutex>& lock);		// Unlocks m_mutex while reading the region file
+	void StoreChunkBlob(Region* region, int chunkIndex, std::vector<uint8_t>& blob, bool keepCachedSpawnInfos);	// m_mutex must be locked, region must be loaded
+	void EvictRegions();														// m_mutex must be locked
+	void WriteRegion(Region* region);											// Called from the write job
+
+private:
+
+	std::mutex m_mutex;
+	std::mutex m_fileWriteMutex;												// Keeps writes to the same region file in order
+	std::condition_variable m_regionLoadedCondition;
+	std::condition_variable m_writesFinishedCondition;
+	std::vector<Region*> m_regions;
+	uint32_t m_useCounter					= 0;
+	int m_numWritesInFlight					= 0;								// Guarded by m_mutex
+};
@@ -0,0 +1,131 @@
+// Bradley Christensen - 2022-2025
+#include "ChunkSolidEdges.h"
+#include "Chunk.h"
+#include "WorldSettings.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void ChunkSolidEdges::Build(Chunk const& chunk)
+{
+	Clear();
+
+	constexpr int numTiles = StaticWorldSettings::s_numTilesInRow;
+	constexpr float tileWidth = StaticWorldSettings::s_tileWidth;
+	Vec2 const& chunkMins = chunk.m_chunkBounds.mins;
+
+	// Solidness indexed [y + 1][x + 1], with a ring of non solid tiles around the chunk so the border needs no special case
+	bool isSolid[numTiles + 2][numTiles + 2] = {};
+	for (int y = 0; y < numTiles; ++y)
+	{
+		for (int x = 0; x < numTiles; ++x)
+		{
+			isSolid[y + 1][x + 1] = chunk.IsTileSolid(IntVec2(x, y));
+		}
+	}
+
+	// Horizontal edges between row y - 1 and row y, merging neighbors that face the same way
+	for (int y = 0; y <= numTiles; ++y)
+	{
+		float runNormal = 0.f;
+		int runBeginX = 0;
+		for (int x = 0; x <= numTiles; ++x)
+		{
+			float normal = 0.f;
+			if (x < numTiles)
+			{
+				bool isBelowSolid = isSolid[y][x + 1];
+				bool isAboveSolid = isSolid[y + 1][x + 1];
+				if (isBelowSolid != isAboveSolid)
+				{
+					normal = isBelowSolid ? 1.f : -1.f;
+				}
+			}
+
+			if (normal != runNormal)
+			{
+				if (runNormal != 0.f)
+				{
+					m_horizontalY.push_back(chunkMins.y + (float) y * tileWidth);
+					m_horizontalMinX.push_back(chunkMins.x + (float) runBeginX * tileWidth);
+					m_horizontalMaxX.push_back(chunkMins.x + (float) x * tileWidth);
+					m_horizontalNormalY.push_back(runNormal);
+				}
+				runNormal = normal;
+				runBeginX = x;
+			}
+		}
+	}
+
+	// Vertical edges between column x - 1 and column x
+	for (int x = 0; x <= numTiles; ++x)
+	{
+		float runNormal = 0.f;
+		int runBeginY = 0;
+		for (int y = 0; y <= numTiles; ++y)
+		{
+			float normal = 0.f;
+			if (y < numTiles)
+			{
+				bool isLeftSolid = isSolid[y + 1][x];
+				bool isRightSolid = isSolid[y + 1][x + 1];
+				if (isLeftSolid != isRightSolid)
+				{
+					normal = isLeftSolid ? 1.f : -1.f;
+				}
+			}
+
+			if (normal != runNormal)
+			{
+				if (runNormal != 0.f)
+				{
+					m_verticalX.push_back(chunkMins.x + (float) x * tileWidth);
+					m_verticalMinY.push_back(chunkMins.y + (float) runBeginY * tileWidth);
+					m_verticalMaxY.push_back(chunkMins.y + (float) y * tileWidth);
+					m_verticalNormalX.push_back(runNormal);
+				}
+				runNormal = normal;
+				runBeginY = y;
+			}
+		}
+	}
+
+	// Convex corners, where only one of the 4 tiles touching the vertex is solid, or two diagonal ones are
+	for (int y = 0; y <= numTiles; ++y)
+	{
+		for (int x = 0; x <= numTiles; ++x)
+		{
+			bool isBottomLeftSolid = isSolid[y][x];
+			bool isBottomRightSolid = isSolid[y][x + 1];
+			bool isTopLeftSolid = isSolid[y + 1][x];
+			bool isTopRightSolid = isSolid[y + 1][x + 1];
+
+			int numSolid = (int) isBottomLeftSolid + (int) isBottomRightSolid + (int) isTopLeftSolid + (int) isTopRightSolid;
+			bool isDiagonal = numSolid == 2 && isBottomLeftSolid == isTopRightSolid;
+			if (numSolid == 1 || isDiagonal)
+			{
+				m_cornerX.push_back(chunkMins.x + (float) x * tileWidth);
+				m_cornerY.push_back(chunkMins.y + (float) y * tileWidth);
+			}
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void ChunkSolidEdges::Clear()
+{
+	m_horizontalY.clear();
+	m_horizontalMinX.clear();
+	m_horizontalMaxX.clear();
+	m_horizontalNormalY.clear();
+
+	m_verticalX.clear();
+	m_verticalMinY.clear();
+	m_verticalMaxY.clear();
+	m_verticalNormalX.clear();
+
+	m_cornerX.clear();
+	m_cornerY.clear();
+}
@@ -0,0 +1,51 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include <vector>
+
+
+
+class Chunk;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Chunk Solid Edges
+//
+// The outline of a chunk's solid tiles as merged axis aligned edges plus the convex corners, in world space, so disc
+// casts test a handful of edges instead of 4 sides and 4 corners of every solid tile they overlap. Tiles outside the
+// chunk count as not solid, so walls that cross a chunk border get an extra edge and corner there, which are never hit
+// before the real wall is.
+//
+// Stored as parallel arrays so the sweep loops in WorldRaycast run straight down them. Rebuilt when the chunk is
+// generated or loaded, and when a tile's solidness changes.
+//
+struct ChunkSolidEdges
+{
+public:
+
+	void Build(Chunk const& chunk);
+	void Clear();
+
+	int GetNumHorizontalEdges() const	{ return (int) m_horizontalY.size(); }
+	int GetNumVerticalEdges() const		{ return (int) m_verticalX.size(); }
+	int GetNumCorners() const			{ return (int) m_cornerX.size(); }
+
+public:
+
+	// Edges along x at m_horizontalY. Normal is +1 on top of solid tiles (facing up) and -1 underneath.
+	std::vector<float> m_horizontalY;
+	std::vector<float> m_horizontalMinX;
+	std::vector<float> m_horizontalMaxX;
+	std::vector<float> m_horizontalNormalY;
+
+	// Edges along y at m_verticalX. Normal is +1 on the right of solid tiles (facing right) and -1 on the left.
+	std::vector<float> m_verticalX;
+	std::vector<float> m_verticalMinY;
+	std::vector<float> m_verticalMaxY;
+	std::vector<float> m_verticalNormalX;
+
+	// Corners with one solid tile around them (or two diagonal ones). Concave corners are left out, a disc always hits
+	// one of the edges next to them first.
+	std::vector<float> m_cornerX;
+	std::vector<float> m_cornerY;
+};
@@ -2,6 +2,7 @@
 #include "EntityDef.h"
 #include "Engine/Debug/DevConsole.h"
 #include "Engine/Core/StringUtils.h"
+#include "Engine/Core/BinaryUtils.h"
 #include "Engine/Renderer/Texture.h"
 
 
@@ -9,6 +10,7 @@
 //----------------------------------------------------------------------------------------------------------------------
 const char* s_entityDefsFilePath = "Data/Definitions/EntityDefs.xml";
 std::vector<EntityDef> EntityDef::s_entityDefs;
+uint64_t EntityDef::s_tableHash = BinaryUtils::HASH_BYTES_SEED;
 
 
 
@@ -35,9 +37,51 @@ void EntityDef::LoadFromXML()
 
         // Emplace new definition using the constructor that takes an Xml Element
         s_entityDefs.emplace_back(entityDefElem);
+        s_entityDefs.back().CompilePrefab(*g_ecs);
 
         entityDefElem = entityDefElem->NextSiblingElement("EntityDef");
     }
+
+    s_tableHash = BinaryUtils::HASH_BYTES_SEED;
+    for (EntityDef const& def : s_entityDefs)
+    {
+        std::string const& name = def.m_name.ToString();
+        s_tableHash = BinaryUtils::HashBytes(name.data(), name.size(), s_tableHash);
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void EntityDef::Shutdown()
+{
+    s_entityDefs.clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Components must be registered before this, which they are by the time SEntityFactory::Startup loads the defs
+//
+void EntityDef::CompilePrefab(AdminSystem const& admin)
+{
+    m_prefab.Clear();
+
+    if (m_ability.has_value())              m_prefab.AddComponent<CAbility>(admin, *m_ability);
+    if (m_ai.has_value())                   m_prefab.AddComponent<CAIController>(admin, *m_ai);
+    if (m_animation.has_value())            m_prefab.AddComponent<CAnimation>(admin, *m_animation);
+    if (m_collision.has_value())            m_prefab.AddComponent<CCollision>(admin, *m_collision);
+    if (m_death.has_value())                m_prefab.AddComponent<CDeath>(admin, *m_death);
+    if (m_health.has_value())               m_prefab.AddComponent<CHealth>(admin, *m_health);
+    if (m_lifetime.has_value())             m_prefab.AddComponent<CLifetime>(admin, *m_lifetime);
+    if (m_movement.has_value())             m_prefab.AddComponent<CMovement>(admin, *m_movement);
+    if (m_playerController.has_value())     m_prefab.AddComponent<CPlayerController>(admin, *m_playerController);
+    if (m_render.has_value())               m_prefab.AddComponent<CRender>(admin, *m_render);
+    if (m_time.has_value())                 m_prefab.AddComponent<CTime>(admin, *m_time);
+    if (m_transform.has_value())            m_prefab.AddComponent<CTransform>(admin, *m_transform);
+
+    // Movers start awake, SActivity puts them to sleep once they're settled outside the awake zone
+    if (m_movement.has_value())             m_prefab.AddComponent<CAwake>(admin, CAwake());
 }
 
 
@@ -46,6 +90,10 @@ void EntityDef::LoadFromXML()
 EntityDef const* EntityDef::GetEntityDef(uint8_t id)
 {
     size_t index = static_cast<size_t>(id);
+    if (index >= s_entityDefs.size())
+    {
+        return nullptr;
+    }
     return &s_entityDefs[index];
 }
 
@@ -83,6 +131,14 @@ int EntityDef::GetEntityDefID(Name name)
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+uint64_t EntityDef::GetTableHash()
+{
+    return s_tableHash;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 EntityDef::EntityDef(XmlElement const* xmlElement)
 {
@@ -3,6 +3,7 @@
 #include "AllComponents.h"
 #include "Engine/Core/XmlUtils.h"
 #include "Engine/Core/Name.h"
+#include "Engine/ECS/EntityPrefab.h"
 #include <vector>
 #include <optional>
 
@@ -16,13 +17,18 @@ public:
     explicit EntityDef(XmlElement const* xmlElement);
 
     static void LoadFromXML();
+    static void Shutdown();
     static EntityDef const* GetEntityDef(uint8_t id);
     static EntityDef const* GetEntityDef(Name name);
     static int GetEntityDefID(Name name);
+    static uint64_t GetTableHash();
 
 private:
 
+    void CompilePrefab(AdminSystem const& admin);
+
     static std::vector<EntityDef> s_entityDefs;
+    static uint64_t s_tableHash; // Recomputed every LoadFromXML, for invalidating data that stores entity def ids
 
 public:
 
@@ -41,5 +47,8 @@ public:
 	std::optional<CRender>              m_render;
     std::optional<CTime>                m_time;
     std::optional<CTransform>           m_transform;
+
+    // Every component above plus CAwake for movers, compiled once on load so spawning skips the per component RTTI lookups
+    EntityPrefab                        m_prefab;
 };
     
\ No newline at end of file
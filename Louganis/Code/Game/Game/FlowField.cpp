@@ -7,12 +7,15 @@
 //----------------------------------------------------------------------------------------------------------------------
 FlowFieldChunk* FlowField::GetActiveChunk(IntVec2 const& chunkCoords) const
 {
-	auto it = m_activeFlowFieldChunks.find(chunkCoords);
-	if (it != m_activeFlowFieldChunks.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_activeFlowFieldChunks.Find(chunkCoords);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+FlowFieldChunk* FlowField::GetActiveNeighborChunk(FlowFieldChunk* chunk, IntVec2 const& chunkCoords, IntVec2 const& neighborChunkCoords) const
+{
+	return m_activeFlowFieldChunks.FindNeighbor(chunk, chunkCoords, neighborChunkCoords);
 }
 
 
@@ -30,17 +33,61 @@ bool FlowField::Seed(WorldCoords const& worldCoords)
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+void FlowField::PushOpenList(WorldCoords const& worldCoords, float distance)
+{
+	FlowFieldChunk* chunk = GetActiveChunk(worldCoords.m_chunkCoords);
+	if (chunk)
+	{
+		int& queuedBucket = chunk->m_queuedBuckets.GetRef(worldCoords.m_localTileCoords);
+		m_openList.PushOrUpdate(FlowGenerationCoords(worldCoords, distance), distance, queuedBucket);
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool FlowField::PopOpenList(FlowGenerationCoords& out_coords)
+{
+	while (!m_openList.IsEmpty())
+	{
+		int bucket = 0;
+		FlowGenerationCoords coords = m_openList.Pop(&bucket);
+		FlowFieldChunk* chunk = GetActiveChunk(coords.m_chunkCoords);
+		if (!chunk)
+		{
+			continue;
+		}
+
+		// Entries left behind in a higher bucket when the cell's distance went down are stale
+		int& queuedBucket = chunk->m_queuedBuckets.GetRef(coords.m_localTileCoords);
+		if (queuedBucket != bucket)
+		{
+			continue;
+		}
+		queuedBucket = BucketQueue<FlowGenerationCoords>::s_notQueued;
+		out_coords = coords;
+		return true;
+	}
+	return false;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void FlowField::HardReset()
 {
 	for (auto& it : m_activeFlowFieldChunks)
 	{
-		FlowFieldChunk* chunk = it.second;
+		FlowFieldChunk* chunk = it.m_chunk;
 		chunk->HardReset();
 		delete chunk;
 	}
 
-	m_activeFlowFieldChunks.clear();
+	m_activeFlowFieldChunks.Clear();
+	m_openList.Clear();
+	m_solvedGoal = WorldCoords::s_invalidWorldCoords;
+	ClearGoalWindow();
 }
 
 
@@ -50,9 +97,12 @@ void FlowField::SoftReset()
 {
 	for (auto& it : m_activeFlowFieldChunks)
 	{
-		FlowFieldChunk* chunk = it.second;
+		FlowFieldChunk* chunk = it.m_chunk;
 		chunk->SoftReset();
 	}
+	m_openList.Clear();
+	m_solvedGoal = WorldCoords::s_invalidWorldCoords;
+	ClearGoalWindow();
 }
 
 
@@ -62,16 +112,65 @@ void FlowField::ResetConsideredCells()
 {
 	for (auto& it : m_activeFlowFieldChunks)
 	{
-		FlowFieldChunk* chunk = it.second;
+		FlowFieldChunk* chunk = it.m_chunk;
 		chunk->ResetConsideredCells();
 	}
 }
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+void FlowField::ResetGoalWindow(IntVec2 const& globalTileMins, int width)
+{
+	int numCells = width * width;
+	m_hasGoalWindow = true;
+	m_goalWindowMins = globalTileMins;
+	m_goalWindowWidth = width;
+	m_goalWindowDistances.assign(numCells, MAX_DISTANCE);
+	m_goalWindowGradient.assign(numCells, Vec2::ZeroVector);
+	m_goalWindowConsideredCells.assign(numCells, 0);
+	m_goalWindowQueuedBuckets.assign(numCells, BucketQueue<FlowGenerationCoords>::s_notQueued);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowField::ClearGoalWindow()
+{
+	m_hasGoalWindow = false;
+	m_goalWindowWidth = 0;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int FlowField::GetGoalWindowIndex(IntVec2 const& globalTileCoords) const
+{
+	if (!m_hasGoalWindow)
+	{
+		return -1;
+	}
+
+	IntVec2 relativeCoords = globalTileCoords - m_goalWindowMins;
+	if (relativeCoords.x < 0 || relativeCoords.y < 0 || relativeCoords.x >= m_goalWindowWidth || relativeCoords.y >= m_goalWindowWidth)
+	{
+		return -1;
+	}
+	return relativeCoords.y * m_goalWindowWidth + relativeCoords.x;
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 Vec2 FlowField::GetFlowAtWorldCoords(WorldCoords const& worldCoords) const
 {
+	// Cells the goal window couldn't reach fall back to the chunks, which still flow towards m_solvedGoal
+	int windowIndex = GetGoalWindowIndex(worldCoords.GetGlobalTileCoords());
+	if (windowIndex != -1 && m_goalWindowDistances[windowIndex] < MAX_DISTANCE)
+	{
+		return m_goalWindowGradient[windowIndex];
+	}
+
 	FlowFieldChunk const* chunk = GetActiveChunk(worldCoords.m_chunkCoords);
 	if (chunk)
 	{
@@ -1,9 +1,12 @@
 // Bradley Christensen - 2022-2025
 #pragma once
 #include "Engine/Math/IntVec2.h"
+#include "Engine/Math/Vec2.h"
+#include "Engine/DataStructures/BucketQueue.h"
+#include "ChunkDirectory.h"
 #include "FlowGenerationCoords.h"
-#include <map>
-#include <queue>
+#include <cstdint>
+#include <vector>
 
 
 
@@ -17,17 +20,36 @@ class FlowField
 public:
 
 	FlowFieldChunk* GetActiveChunk(IntVec2 const& chunkCoords) const;
+	FlowFieldChunk* GetActiveNeighborChunk(FlowFieldChunk* chunk, IntVec2 const& chunkCoords, IntVec2 const& neighborChunkCoords) const; // Skips the lookup if the coords match
 	bool Seed(WorldCoords const& worldCoords);
 
+	void PushOpenList(WorldCoords const& worldCoords, float distance);		// Decrease-key if the cell is already queued
+	bool PopOpenList(FlowGenerationCoords& out_coords);					// Skips stale entries, false once the open list is empty
+
 	void HardReset();
 	void SoftReset();
 	void ResetConsideredCells();
 
+	void ResetGoalWindow(IntVec2 const& globalTileMins, int width);
+	void ClearGoalWindow();
+	int GetGoalWindowIndex(IntVec2 const& globalTileCoords) const; // -1 if outside the goal window
+
 	Vec2 GetFlowAtWorldCoords(WorldCoords const& worldCoords) const;
 
 public:
 
-	std::priority_queue<FlowGenerationCoords> m_openList;
-	std::map<IntVec2, FlowFieldChunk*> m_activeFlowFieldChunks;
+	BucketQueue<FlowGenerationCoords> m_openList;					// Each chunk tracks which bucket its cells are queued in
+	ChunkDirectory<FlowFieldChunk> m_activeFlowFieldChunks;
+	WorldCoords m_solvedGoal = WorldCoords::s_invalidWorldCoords;	// Goal the chunk distance fields were solved for
+
+	// Small field solved around the current goal while it is within s_flowFieldMaxGoalDrift of m_solvedGoal, so moving
+	// the goal a few tiles doesn't regenerate every chunk. Its gradient takes priority over the chunks' inside it.
+	bool m_hasGoalWindow = false;
+	IntVec2 m_goalWindowMins;										// Global tile coords
+	int m_goalWindowWidth = 0;
+	std::vector<float> m_goalWindowDistances;
+	std::vector<Vec2> m_goalWindowGradient;
+	std::vector<uint8_t> m_goalWindowConsideredCells;
+	std::vector<int> m_goalWindowQueuedBuckets;
 };
 
@@ -0,0 +1,310 @@
+// Bradley Christensen - 2022-2025
+#include "FlowFieldCache.h"
+#include "FlowField.h"
+#include "TargetFlowField.h"
+#include "WorldSettings.h"
+#include "Engine/Multithreading/Job.h"
+#include "Engine/Multithreading/JobSystem.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Owned by its cache entry from post until it finishes or is thrown away, so it is not deleted after completion
+//
+class SolveTargetFlowFieldJob : public Job
+{
+public:
+
+	SolveTargetFlowFieldJob(TargetFlowField* field, int priority) : m_field(field)
+	{
+		SetPriority(priority);
+		SetDeleteAfterCompletion(false);
+	}
+
+	virtual ~SolveTargetFlowFieldJob() override
+	{
+		delete m_field;
+	}
+
+	virtual void Execute() override
+	{
+		m_field->Solve();
+	}
+
+	TargetFlowField* ReleaseField()
+	{
+		TargetFlowField* field = m_field;
+		m_field = nullptr;
+		return field;
+	}
+
+	TargetFlowField* m_field	= nullptr;
+	JobID m_jobID				= JobID::Invalid;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+FlowFieldCache::~FlowFieldCache()
+{
+	Clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldCache::Request(FlowFieldKey const& key)
+{
+	Entry* entry = FindEntry(key);
+	if (!entry)
+	{
+		entry = new Entry();
+		entry->m_key = key;
+		m_entries.push_back(entry);
+	}
+	entry->m_lastRequestedFrame = m_frame;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldCache::Update(FlowField const& playerFlowField, bool hasWorldChanged)
+{
+	if (hasWorldChanged)
+	{
+		m_worldVersion++;
+	}
+
+	for (Entry* entry : m_entries)
+	{
+		PollJob(*entry);
+	}
+
+	ScheduleSolves(playerFlowField);
+	EvictFields();
+	m_frame++;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldCache::Clear()
+{
+	for (Entry* entry : m_entries)
+	{
+		SolveTargetFlowFieldJob* job = entry->m_job;
+		if (job && !g_jobSystem->TryCancelJob(job->m_jobID))
+		{
+			// Already running, wait for it so it isn't reading a snapshot we're about to delete
+			g_jobSystem->CompleteJob(job->m_jobID, true);
+		}
+		DeleteEntry(entry);
+	}
+	m_entries.clear();
+	m_numJobsInFlight = 0;
+
+	for (FlowFieldSnapshot* snapshot : m_snapshots)
+	{
+		delete snapshot;
+	}
+	m_snapshots.clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+TargetFlowField const* FlowFieldCache::Find(FlowFieldKey const& key) const
+{
+	Entry* entry = FindEntry(key);
+	return entry ? entry->m_field : nullptr;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t FlowFieldCache::GetMemoryUsage() const
+{
+	size_t memoryUsage = 0;
+	for (Entry const* entry : m_entries)
+	{
+		memoryUsage += sizeof(Entry);
+		if (entry->m_field)
+		{
+			memoryUsage += entry->m_field->GetMemoryUsage();
+		}
+		if (entry->m_job)
+		{
+			memoryUsage += entry->m_job->m_field->GetMemoryUsage();
+		}
+	}
+	for (FlowFieldSnapshot const* snapshot : m_snapshots)
+	{
+		memoryUsage += snapshot->GetMemoryUsage();
+	}
+	return memoryUsage;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int FlowFieldCache::GetNumFields() const
+{
+	return (int) m_entries.size();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+FlowFieldCache::Entry* FlowFieldCache::FindEntry(FlowFieldKey const& key) const
+{
+	// Only a handful of targets are alive at once, a linear search beats hashing them
+	for (Entry* entry : m_entries)
+	{
+		if (entry->m_key == key)
+		{
+			return entry;
+		}
+	}
+	return nullptr;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldCache::PollJob(Entry& entry)
+{
+	if (!entry.m_job || !g_jobSystem->CompleteJob(entry.m_job->m_jobID, false))
+	{
+		return;
+	}
+
+	delete entry.m_field;
+	entry.m_field = entry.m_job->ReleaseField();
+	delete entry.m_job;
+	entry.m_job = nullptr;
+	m_numJobsInFlight--;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldCache::ScheduleSolves(FlowField const& playerFlowField)
+{
+	if (playerFlowField.m_activeFlowFieldChunks.IsEmpty())
+	{
+		return;
+	}
+
+	// Fields that don't exist yet go first, AI using them are standing still
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		for (Entry* entry : m_entries)
+		{
+			if (m_numJobsInFlight >= StaticWorldSettings::s_maxNumFlowFieldSolveJobs)
+			{
+				return;
+			}
+			if (entry->m_lastRequestedFrame != m_frame || entry->m_job)
+			{
+				continue;
+			}
+
+			bool needsSolve = false;
+			if (pass == 0)
+			{
+				needsSolve = !entry->m_field;
+			}
+			else if (entry->m_field)
+			{
+				bool isStale = entry->m_field->m_snapshot->m_version != m_worldVersion;
+				needsSolve = isStale && (m_frame - entry->m_lastSolveFrame) >= StaticWorldSettings::s_flowFieldCacheRefreshFrames;
+			}
+			if (!needsSolve)
+			{
+				continue;
+			}
+
+			if (m_snapshots.empty() || m_snapshots.back()->m_version != m_worldVersion)
+			{
+				m_snapshots.push_back(new FlowFieldSnapshot(playerFlowField, m_worldVersion));
+			}
+
+			TargetFlowField* field = new TargetFlowField(m_snapshots.back(), entry->m_key.m_goal);
+			entry->m_job = new SolveTargetFlowFieldJob(field, StaticWorldSettings::s_flowFieldSolveJobPriority);
+			entry->m_job->m_jobID = g_jobSystem->PostJob(entry->m_job);
+			entry->m_lastSolveFrame = m_frame;
+			m_numJobsInFlight++;
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldCache::EvictFields()
+{
+	DeleteUnusedSnapshots();
+
+	while (GetMemoryUsage() > StaticWorldSettings::s_flowFieldCacheMemoryBudget || (int) m_entries.size() > StaticWorldSettings::s_maxNumCachedFlowFields)
+	{
+		// Least recently requested first. Fields in use this frame, or with a solve in flight, can't be evicted.
+		int lruIndex = -1;
+		for (int i = 0; i < (int) m_entries.size(); ++i)
+		{
+			Entry* entry = m_entries[i];
+			if (entry->m_lastRequestedFrame == m_frame || entry->m_job)
+			{
+				continue;
+			}
+			if (lruIndex == -1 || entry->m_lastRequestedFrame < m_entries[lruIndex]->m_lastRequestedFrame)
+			{
+				lruIndex = i;
+			}
+		}
+		if (lruIndex == -1)
+		{
+			break;
+		}
+
+		DeleteEntry(m_entries[lruIndex]);
+		m_entries[lruIndex] = m_entries.back();
+		m_entries.pop_back();
+		DeleteUnusedSnapshots();
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldCache::DeleteUnusedSnapshots()
+{
+	for (int i = (int) m_snapshots.size() - 1; i >= 0; --i)
+	{
+		FlowFieldSnapshot* snapshot = m_snapshots[i];
+		bool isInUse = false;
+		for (Entry const* entry : m_entries)
+		{
+			if ((entry->m_field && entry->m_field->m_snapshot == snapshot) || (entry->m_job && entry->m_job->m_field->m_snapshot == snapshot))
+			{
+				isInUse = true;
+				break;
+			}
+		}
+
+		if (!isInUse)
+		{
+			delete snapshot;
+			m_snapshots.erase(m_snapshots.begin() + i);
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldCache::DeleteEntry(Entry* entry)
+{
+	delete entry->m_job;
+	delete entry->m_field;
+	delete entry;
+}
@@ -0,0 +1,69 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include "FlowFieldKey.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+class FlowField;
+class FlowFieldSnapshot;
+class TargetFlowField;
+class SolveTargetFlowFieldJob;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Flow Field Cache
+//
+// Flow fields towards targets other than the player, shared by every AI heading to the same target. Fields are solved
+// on jobs over a snapshot of the player flow field's chunks (see TargetFlowField), so asking for a new target costs a
+// frame or two of latency instead of a full solve on the main thread.
+//
+// Each frame the fields in use are requested. Requested fields that are missing, or solved on an older snapshot than
+// the world's current state, get (re)solved, at most s_maxNumFlowFieldSolveJobs at a time. The previous solve keeps
+// being used until the new one lands. Least recently requested fields are evicted to stay under the memory budget.
+//
+// Main thread only.
+//
+class FlowFieldCache
+{
+public:
+
+	~FlowFieldCache();
+
+	void Request(FlowFieldKey const& key);
+	void Update(FlowField const& playerFlowField, bool hasWorldChanged);
+	void Clear(); // Cancels or waits on any solves in flight
+
+	TargetFlowField const* Find(FlowFieldKey const& key) const; // nullptr until the first solve for the key finishes
+	size_t GetMemoryUsage() const;
+	int GetNumFields() const;
+
+private:
+
+	struct Entry
+	{
+		FlowFieldKey m_key;
+		TargetFlowField* m_field			= nullptr;	// Latest finished solve, possibly on an older snapshot
+		SolveTargetFlowFieldJob* m_job		= nullptr;	// Solve in flight, replaces m_field when it finishes
+		uint32_t m_lastRequestedFrame		= 0;
+		uint32_t m_lastSolveFrame			= 0;
+	};
+
+	Entry* FindEntry(FlowFieldKey const& key) const;
+	void PollJob(Entry& entry);
+	void ScheduleSolves(FlowField const& playerFlowField);
+	void EvictFields();
+	void DeleteUnusedSnapshots();
+	void DeleteEntry(Entry* entry);
+
+private:
+
+	std::vector<Entry*> m_entries;
+	std::vector<FlowFieldSnapshot*> m_snapshots;	// Newest last, kept while any field or job still uses them
+	uint32_t m_frame			= 1;
+	uint32_t m_worldVersion		= 0;				// Bumped whenever the player flow field's chunks or tiles change
+	int m_numJobsInFlight		= 0;
+};
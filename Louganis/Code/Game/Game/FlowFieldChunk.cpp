@@ -1,5 +1,6 @@
 // Bradley Christensen - 2022-2025
 #include "FlowFieldChunk.h"
+#include "FlowGenerationCoords.h"
 #include "Chunk.h"
 #include "SCWorld.h"
 #include "Engine/Renderer/VertexBuffer.h"
@@ -7,10 +8,6 @@
 
 
 
-constexpr float MAX_DISTANCE = 999.f;
-
-
-
 //----------------------------------------------------------------------------------------------------------------------
 FlowFieldChunk::FlowFieldChunk(Chunk* chunk, SCWorld* world) :
 	m_world(world),
@@ -20,7 +17,9 @@ FlowFieldChunk::FlowFieldChunk(Chunk* chunk, SCWorld* world) :
 	m_costField(0),
 	m_distanceField(MAX_DISTANCE),
 	m_gradient(Vec2::ZeroVector),
-	m_consideredCells(false)
+	m_consideredCells(false),
+	m_solidCells(false),
+	m_queuedBuckets(BucketQueue<FlowGenerationCoords>::s_notQueued)
 {
 	m_debugVBO = g_renderer->MakeVertexBuffer<Vertex_PCU>();
 }
@@ -39,7 +38,9 @@ FlowFieldChunk::~FlowFieldChunk()
 void FlowFieldChunk::HardReset()
 {
 	m_consideredCells.SetAll(false);
+	m_queuedBuckets.SetAll(BucketQueue<FlowGenerationCoords>::s_notQueued);
 	m_costField.SetAll(0);
+	m_solidCells.SetAll(false);
 	m_distanceField.SetAll(MAX_DISTANCE);
 	m_gradient.SetAll(Vec2::ZeroVector);
 	g_renderer->GetVertexBuffer(m_debugVBO)->ClearVerts();
@@ -52,6 +53,7 @@ void FlowFieldChunk::SoftReset()
 {
 	// Don't need to reset cost field if we're resetting to generate again
 	m_consideredCells.SetAll(false);
+	m_queuedBuckets.SetAll(BucketQueue<FlowGenerationCoords>::s_notQueued);
 	m_distanceField.SetAll(MAX_DISTANCE);
 	m_gradient.SetAll(Vec2());
 	g_renderer->GetVertexBuffer(m_debugVBO)->ClearVerts();
@@ -111,6 +113,10 @@ void FlowFieldChunk::GenerateCostField()
 		for (int i = 0; i < m_costField.Count(); ++i)
 		{
 			m_costField.Set(i, m_chunk->GetCost(i));
+			if (m_chunk->IsTileSolid(i))
+			{
+				m_solidCells.Set(i);
+			}
 		}
 	}
 	else
@@ -129,3 +135,35 @@ void FlowFieldChunk::ResetConsideredCells()
 {
 	m_consideredCells.SetAll(false);
 }
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void FlowFieldChunk::UpdateChangedTiles(std::vector<WorldCoords>& out_changedTiles)
+{
+	if (!m_chunk)
+	{
+		return;
+	}
+
+	for (int i = 0; i < m_costField.Count(); ++i)
+	{
+		bool isSolid = m_chunk->IsTileSolid(i);
+		uint8_t cost = m_chunk->GetCost(i);
+		if (isSolid == m_solidCells.Get(i) && cost == m_costField.Get(i))
+		{
+			continue;
+		}
+
+		if (isSolid)
+		{
+			m_solidCells.Set(i);
+		}
+		else
+		{
+			m_solidCells.Unset(i);
+		}
+		m_costField.Set(i, cost);
+		out_changedTiles.emplace_back(m_chunkCoords, m_costField.GetCoordsForIndex(i));
+	}
+}
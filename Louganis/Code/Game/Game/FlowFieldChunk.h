@@ -1,10 +1,13 @@
 // Bradley Christensen - 2022-2025
 #pragma once
 #include "Engine/DataStructures/BitArray.h"
+#include "Engine/DataStructures/BucketQueue.h"
 #include "Engine/Math/AABB2.h"
 #include "Engine/Math/FastGrid.h"
 #include "Engine/Renderer/RendererUtils.h"
+#include "WorldCoords.h"
 #include "WorldSettings.h"
+#include <vector>
 
 
 
@@ -14,6 +17,10 @@ struct NamedProperties;
 
 
 
+constexpr float MAX_DISTANCE = 999.f;
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 class FlowFieldChunk
 {
@@ -28,6 +35,7 @@ public:
 	IntVec2 GetChunkCoords() const;
 	void SetDistanceFieldAt(IntVec2 const& localTileCoords, float distance);
 	void GenerateCostField();
+	void UpdateChangedTiles(std::vector<WorldCoords>& out_changedTiles); // Tiles whose solidity or cost changed since the last call
 	void ResetConsideredCells();
 
 	Chunk* GetChunk() const;
@@ -47,5 +55,7 @@ public:
 	FastGrid<float, StaticWorldSettings::s_worldChunkSizePowerOfTwo> m_distanceField;
 	FastGrid<Vec2, StaticWorldSettings::s_worldChunkSizePowerOfTwo> m_gradient;
 	BitArray<StaticWorldSettings::s_numTilesInChunk> m_consideredCells;
+	BitArray<StaticWorldSettings::s_numTilesInChunk> m_solidCells; // Solidity the field was last solved with
+	FastGrid<int, StaticWorldSettings::s_worldChunkSizePowerOfTwo> m_queuedBuckets; // Open list bucket each cell is queued in, for decrease-key
 	VertexBufferID m_debugVBO = RendererUtils::InvalidID;
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+// Bradley Christensen - 2022-2025
+#include "FlowFieldKey.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+FlowFieldKey FlowFieldKey::ToPlayer()
+{
+	return FlowFieldKey();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+FlowFieldKey FlowFieldKey::ToTile(WorldCoords const& goal)
+{
+	FlowFieldKey key;
+	key.m_target = FlowFieldTarget::Tile;
+	key.m_goal = goal;
+	return key;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool FlowFieldKey::operator==(FlowFieldKey const& other) const
+{
+	return m_target == other.m_target && m_goal == other.m_goal;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+bool FlowFieldKey::operator!=(FlowFieldKey const& other) const
+{
+	return !(*this == other);
+}
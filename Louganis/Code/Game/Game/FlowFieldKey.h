@@ -0,0 +1,30 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include "WorldCoords.h"
+#include <cstdint>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+enum class FlowFieldTarget : uint8_t
+{
+	Player,		// SCFlowField::m_toPlayerFlowField, repaired every frame by SFlowField
+	Tile,		// Cached in SCFlowField::m_targetFlowFields and solved on jobs. Points of interest target their tile.
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Which flow field an AI follows. Every AI with the same key shares the same field.
+//
+struct FlowFieldKey
+{
+	static FlowFieldKey ToPlayer();
+	static FlowFieldKey ToTile(WorldCoords const& goal);
+
+	bool operator==(FlowFieldKey const& other) const;
+	bool operator!=(FlowFieldKey const& other) const;
+
+	FlowFieldTarget m_target	= FlowFieldTarget::Player;
+	WorldCoords m_goal			= WorldCoords::s_invalidWorldCoords;	// Only for FlowFieldTarget::Tile
+};
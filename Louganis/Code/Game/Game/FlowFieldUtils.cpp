@@ -0,0 +1,76 @@
+// Bradley Christensen - 2022-2025
+#include "FlowFieldUtils.h"
+#include "Engine/Math/MathUtils.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+IntVec2 const FlowFieldUtils::s_neighborOffsets[4] = { IntVec2(1,  0),
+                                                       IntVec2(-1,  0),
+                                                       IntVec2(0,  1),
+                                                       IntVec2(0, -1) };
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Fast marching update for a cell, given the smallest known neighbor distance along each axis
+//
+float FlowFieldUtils::SolveEikonal(float dx, float dy, int cost)
+{
+    // Delta = 2 * neighborCost - (dx-dy)^2;
+    // if Delta >= 0 and the solution is upwind of both neighbors
+    //     D(j) = (dx + dy + sqrt(Delta)) / 2;
+    // else
+    //     D(j) = min(dx + W(j), dy + W(j));
+    // end
+
+    // The upwind check keeps a cell from ever solving lower than a neighbor it was solved from, which the open list's
+    // buckets rely on, since cells in the same bucket pop in no particular order
+    float delta = 2 * cost - MathUtils::PowF(dx - dy, 2);
+    if (delta >= 0)
+    {
+        float distance = (dx + dy + MathUtils::SqrtF(delta)) / 2.f;
+        if (distance >= MathUtils::Max(dx, dy))
+        {
+            return distance;
+        }
+    }
+    return MathUtils::Min(dx + cost, dy + cost);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Gradient of the distance field at a cell from its neighbors, given in s_neighborOffsets order
+//
+Vec2 FlowFieldUtils::CalculateGradient(float currentDistance, bool const* hasNeighbor, float const* neighborDistances, bool const* isNeighborSolid)
+{
+    Vec2 gradient = Vec2::ZeroVector;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (!hasNeighbor[i])
+        {
+            continue;
+        }
+
+        float dDist = currentDistance - neighborDistances[i];
+        if (isNeighborSolid[i])
+        {
+            // Always treat solid walls as being 0.5 distance away in that direction, so that flow always generates away from walls without skewing too much
+            // If we leave this as the actual distance, which is very large (999), then gradient will point away from walls too strongly
+            dDist = -0.5;
+        }
+
+        IntVec2 const& neighborOffset = s_neighborOffsets[i];
+        if (neighborOffset.x != 0.f)
+        {
+            gradient.x += dDist * MathUtils::Sign(neighborOffset.x);
+        }
+        else
+        {
+            gradient.y += dDist * MathUtils::Sign(neighborOffset.y);
+        }
+    }
+    gradient.Normalize();
+    return gradient;
+}
@@ -0,0 +1,19 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include "Engine/Math/IntVec2.h"
+#include "Engine/Math/Vec2.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Flow Field Utils
+//
+// Math shared by the player flow field (SFlowField) and the cached target flow fields (TargetFlowField).
+//
+namespace FlowFieldUtils
+{
+    extern IntVec2 const s_neighborOffsets[4];  // East, west, north, south. Neighbor arrays below are in this order.
+
+    float SolveEikonal(float dx, float dy, int cost);
+    Vec2 CalculateGradient(float currentDistance, bool const* hasNeighbor, float const* neighborDistances, bool const* isNeighborSolid);
+}
@@ -150,6 +150,7 @@ void Game::ConfigureEngine(Engine* engine)
     engine->RegisterSubsystem(g_audioSystem);
 
     RendererConfig rendererConfig;
+    rendererConfig.m_headless = g_app->HasCommandLineArg("-headless"); // No GPU, draws and state changes are only counted
 	rendererConfig.m_startupUserSettings.m_vsyncEnabled = false;
 	rendererConfig.m_startupUserSettings.m_msaaEnabled = false;
     g_renderer = RendererUtils::MakeRenderer(rendererConfig);
@@ -198,21 +199,26 @@ void Game::ConfigureECS()
     // 
 
     // Array components
-    g_ecs->RegisterComponentArray<CAbility>();
-    g_ecs->RegisterComponentArray<CAIController>();
     g_ecs->RegisterComponentArray<CAnimation>();
     g_ecs->RegisterComponentArray<CCollision>();
-    g_ecs->RegisterComponentArray<CDeath>();
-    g_ecs->RegisterComponentArray<CHealth>();
-    g_ecs->RegisterComponentArray<CLifetime>();
     g_ecs->RegisterComponentArray<CMovement>();
     g_ecs->RegisterComponentArray<CRender>();
     g_ecs->RegisterComponentArray<CTime>();
     g_ecs->RegisterComponentArray<CTransform>();
 
+    // Sparse set components (only used by a subset of entities, packed so they can be iterated densely)
+    g_ecs->RegisterComponentSparseSet<CAbility>();
+    g_ecs->RegisterComponentSparseSet<CAIController>();
+    g_ecs->RegisterComponentSparseSet<CDeath>();
+    g_ecs->RegisterComponentSparseSet<CHealth>();
+    g_ecs->RegisterComponentSparseSet<CLifetime>();
+
     // Map components
     g_ecs->RegisterComponentMap<CPlayerController>();
 
+    // Tags
+    g_ecs->RegisterTag<CAwake>();
+
     // Singleton components
     g_ecs->RegisterComponentSingleton<SCAudio>();
     g_ecs->RegisterComponentSingleton<SCCamera>();
@@ -251,6 +257,7 @@ void Game::ConfigureECS()
     g_ecs->RegisterSystem<SUnloadChunks>((int) FramePhase::PrePhysics);
     g_ecs->RegisterSystem<SBackgroundMusic>((int) FramePhase::PrePhysics);
     g_ecs->RegisterSystem<SFlowField>((int) FramePhase::PrePhysics);
+    g_ecs->RegisterSystem<SActivity>((int) FramePhase::PrePhysics);
     g_ecs->RegisterSystem<SAIController>((int) FramePhase::PrePhysics);
 
     // Physics
@@ -0,0 +1,52 @@
+// Bradley Christensen - 2022-2025
+#include "GenerateChunkJob.h"
+#include "Chunk.h"
+#include "ChunkDiskCache.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+GenerateChunkJob::GenerateChunkJob(IntVec2 const& chunkCoords, WorldSettings const& worldSettings, ChunkDiskCache* chunkDiskCache, int priority) : m_chunkCoords(chunkCoords), m_worldSettings(worldSettings), m_chunkDiskCache(chunkDiskCache)
+{
+    m_chunk = new Chunk();
+    SetPriority(priority);
+    SetDeleteAfterCompletion(false);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+GenerateChunkJob::~GenerateChunkJob()
+{
+    // Only still set if the chunk was never committed, in which case it never made any renderer resources
+    delete m_chunk;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void GenerateChunkJob::Execute()
+{
+    // Only touches the chunk, read only defs, and the (thread safe) disk cache. Renderer resources are made on the main
+    // thread when it's committed.
+    if (!m_chunkDiskCache || !m_chunkDiskCache->TryLoadChunk(m_chunkCoords, m_worldSettings, *m_chunk, m_spawnInfos))
+    {
+        m_chunk->Generate(m_chunkCoords, m_worldSettings, m_spawnInfos);
+        if (m_chunkDiskCache)
+        {
+            m_chunkDiskCache->SaveChunk(*m_chunk, m_worldSettings, &m_spawnInfos);
+        }
+    }
+
+    m_chunk->m_solidEdges.Build(*m_chunk);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Chunk* GenerateChunkJob::ReleaseChunk()
+{
+    Chunk* chunk = m_chunk;
+    m_chunk = nullptr;
+    return chunk;
+}
@@ -0,0 +1,40 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include "SpawnInfo.h"
+#include "WorldSettings.h"
+#include "Engine/Math/IntVec2.h"
+#include "Engine/Multithreading/Job.h"
+#include <vector>
+
+
+
+class Chunk;
+class ChunkDiskCache;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Loads one chunk from the disk cache, or generates its tiles and spawn infos if it isn't cached, on a worker thread.
+// Owned by SCLoadChunks from post until it is committed to the world or thrown away, so it is not deleted after completion.
+//
+class GenerateChunkJob : public Job
+{
+public:
+
+    GenerateChunkJob(IntVec2 const& chunkCoords, WorldSettings const& worldSettings, ChunkDiskCache* chunkDiskCache, int priority);
+    virtual ~GenerateChunkJob() override;
+
+    virtual void Execute() override;
+
+    Chunk* ReleaseChunk();
+
+public:
+
+    IntVec2 m_chunkCoords;
+    WorldSettings m_worldSettings;              // Copy, so changing settings mid-generation can't tear the chunk
+    ChunkDiskCache* m_chunkDiskCache    = nullptr;
+    Chunk* m_chunk                      = nullptr;
+    std::vector<SpawnInfo> m_spawnInfos;
+    JobID m_jobID                       = JobID::Invalid;
+    bool m_isFinished                   = false;    // Set once CompleteJob has returned true, it won't return true again
+};
@@ -3,6 +3,7 @@
 #include "CTransform.h"
 #include "CMovement.h"
 #include "CAIController.h"
+#include "CAwake.h"
 #include "SCWorld.h"
 #include "SCFlowField.h"
 #include "Engine/ECS/SystemContext.h"
@@ -13,7 +14,7 @@
 void SAIController::Startup()
 {
     AddWriteDependencies<CMovement>();
-    AddReadDependencies<CTransform, SCFlowField, SCWorld>();
+    AddReadDependencies<CTransform, CAIController, CAwake, SCFlowField, SCWorld>();
 }
 
 
@@ -23,25 +24,27 @@ void SAIController::Run(SystemContext const& context)
 {
     auto& transStorage = g_ecs->GetArrayStorage<CTransform>();
     auto& moveStorage = g_ecs->GetArrayStorage<CMovement>();
+    auto& aiStorage = g_ecs->GetSparseSetStorage<CAIController>();
     SCFlowField const& scFlow = g_ecs->GetSingleton<SCFlowField>();
     SCWorld const& scWorld = g_ecs->GetSingleton<SCWorld>(); // not a true dependency bc we are just calling GetWorldCoordsAtLocation, which is essentially a static function
 
 	WorldCoords playerWorldCoords = scWorld.m_lastKnownPlayerWorldCoords;
     Vec2 playerWorldPos = scWorld.GetTileBounds(playerWorldCoords).GetCenter();
 
-    for (auto it = g_ecs->Iterate<CTransform, CMovement, CAIController>(context); it.IsValid(); ++it)
+    for (auto it = g_ecs->Iterate<CTransform, CMovement, CAIController, CAwake>(context); it.IsValid(); ++it)
     {
         CTransform const& transform = *transStorage.Get(it);
         float distSquaredToPlayer = playerWorldPos.GetDistanceSquaredTo(transform.m_pos);
         if (distSquaredToPlayer > StaticWorldSettings::s_flowFieldGenerationRadiusSquared)
         {
-            // AI go into 'sleep' mode when outside the flow radius
+            // Still awake from movement it hasn't finished, but there's no flow field out here to follow
             continue;
 		}
 
         CMovement& movement = *moveStorage.Get(it);
+        CAIController const& ai = *aiStorage.Get(it);
 		WorldCoords worldCoords = scWorld.GetWorldCoordsAtLocation(transform.m_pos);
-		movement.m_frameMoveDir = scFlow.m_toPlayerFlowField.GetFlowAtWorldCoords(worldCoords);
+		movement.m_frameMoveDir = scFlow.GetFlowAtWorldCoords(ai.m_flowFieldKey, worldCoords);
     }
 }
 
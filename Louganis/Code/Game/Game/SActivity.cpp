@@ -0,0 +1,101 @@
+﻿// Bradley Christensen - 2022-2025
+#include "SActivity.h"
+#include "CAIController.h"
+#include "CAwake.h"
+#include "CMovement.h"
+#include "CTransform.h"
+#include "SCWorld.h"
+#include "Engine/ECS/EntityCommandBuffer.h"
+#include "Engine/ECS/SystemContext.h"
+#include "Engine/Math/MathUtils.h"
+#include <thread>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Centered on the player's chunk, and padded by half the chunk's diagonal so it holds the flow field radius around the
+// player from anywhere in that chunk. It only moves when the player changes chunk.
+//
+constexpr float AWAKE_ZONE_RADIUS = StaticWorldSettings::s_flowFieldGenerationRadius + StaticWorldSettings::s_chunkHalfWidth * MathUtils::SQRT2F;
+constexpr float AWAKE_ZONE_RADIUS_SQUARED = AWAKE_ZONE_RADIUS * AWAKE_ZONE_RADIUS;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void SActivity::Startup()
+{
+    // CAwake changes go through the command buffer, and take effect at the end of the pre physics phase
+    AddWriteDependencies<CMovement>();
+    AddReadDependencies<CTransform, CAIController, CAwake, SCWorld>();
+
+    // Sized by the awake set, which is all most frames visit
+    int numThreads = std::thread::hardware_concurrency() - 1;
+    m_systemSplittingNumJobs = numThreads - 1;
+    SetSystemSplittingGroup<CTransform, CMovement, CAwake>();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Only awake entities move: every system that writes movement iterates CAwake, or only touches the player. So a sleeping
+// entity can only need waking when the awake zone moves over it. Every mover is re-checked when the player changes
+// chunk, and every other frame only the awake set is, to put entities to sleep as they settle outside the zone.
+// New movers are spawned awake (see SEntityFactory).
+//
+void SActivity::Run(SystemContext const& context)
+{
+    auto& transStorage = g_ecs->GetArrayStorage<CTransform>();
+    auto& moveStorage = g_ecs->GetArrayStorage<CMovement>();
+    auto& awakeStorage = g_ecs->GetTagStorage<CAwake>();
+    SCWorld const& scWorld = g_ecs->GetSingleton<SCWorld>();
+    EntityCommandBuffer& commandBuffer = context.GetCommandBuffer();
+
+    BitMask aiBitMask = g_ecs->GetComponentBitMask<CAIController>();
+    WorldCoords const& playerWorldCoords = scWorld.m_lastKnownPlayerWorldCoords;
+    Vec2 playerWorldPos = scWorld.GetTileBounds(playerWorldCoords).GetCenter();
+    Vec2 awakeZoneCenter = scWorld.CalculateChunkCenter(playerWorldCoords.m_chunkCoords.x, playerWorldCoords.m_chunkCoords.y);
+
+    auto updateActivity = [&](GroupIter const& it)
+    {
+        CTransform const& transform = transStorage[it];
+        CMovement& move = moveStorage[it];
+
+        bool isNearPlayer = playerWorldPos.GetDistanceSquaredTo(transform.m_pos) <= StaticWorldSettings::s_flowFieldGenerationRadiusSquared;
+        if (!isNearPlayer && g_ecs->HasComponentsUnsafe(it.m_currentIndex, aiBitMask))
+        {
+            // AI have no flow field to follow outside the radius, so they stop where they are instead of walking blind
+            move.m_frameMoveDir = Vec2::ZeroVector;
+        }
+
+        // Anything with movement left stays awake until it settles, so knockbacks and teleports far away still resolve
+        bool isInAwakeZone = awakeZoneCenter.GetDistanceSquaredTo(transform.m_pos) <= AWAKE_ZONE_RADIUS_SQUARED;
+        bool isAwake = isInAwakeZone || !move.m_frameMoveDir.IsZero() || !move.m_frameMovement.IsZero() || move.GetIsTeleporting();
+        if (isAwake != awakeStorage[it])
+        {
+            commandBuffer.SetTag<CAwake>(it.GetEntityID(), isAwake);
+        }
+    };
+
+    if (scWorld.m_playerChangedChunkThisFrame)
+    {
+        for (auto it = g_ecs->Iterate<CTransform, CMovement>(context); it.IsValid(); ++it)
+        {
+            updateActivity(it);
+        }
+    }
+    else
+    {
+        for (auto it = g_ecs->Iterate<CTransform, CMovement, CAwake>(context); it.IsValid(); ++it)
+        {
+            updateActivity(it);
+        }
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void SActivity::Shutdown()
+{
+
+}
@@ -0,0 +1,16 @@
+﻿// Bradley Christensen - 2022-2025
+#pragma once
+#include "Engine/ECS/System.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+class SActivity : public System
+{
+public:
+
+    SActivity(Name name = "Activity", Rgba8 const& debugTint = Rgba8::LightGreen) : System(name, debugTint) {};
+    void Startup() override;
+    void Run(SystemContext const& context) override;
+    void Shutdown() override;
+};
@@ -1,2 +1,90 @@
 // Bradley Christensen - 2022-2025
-#include "SCCollision.h"
\ No newline at end of file
+#include "SCCollision.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void SCCollision::ResetHashedChunks(IntVec2 const& mins, IntVec2 const& maxs)
+{
+	m_hashedChunksMins = mins;
+	m_hashedChunksDims = maxs - mins + IntVec2(1, 1);
+
+	int numChunks = m_hashedChunksDims.x * m_hashedChunksDims.y;
+	m_hashedChunks.assign(numChunks, nullptr);
+	m_tileOffsets.assign(numChunks * StaticWorldSettings::s_numTilesInChunk + 1, 0);
+	m_tileEntities.clear();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int SCCollision::GetNumTileSlots() const
+{
+	return (int) m_hashedChunks.size() * StaticWorldSettings::s_numTilesInChunk;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int SCCollision::GetChunkSlot(IntVec2 const& chunkCoords) const
+{
+	IntVec2 relativeCoords = chunkCoords - m_hashedChunksMins;
+	if (relativeCoords.x < 0 || relativeCoords.y < 0 || relativeCoords.x >= m_hashedChunksDims.x || relativeCoords.y >= m_hashedChunksDims.y)
+	{
+		return -1;
+	}
+	return relativeCoords.y * m_hashedChunksDims.x + relativeCoords.x;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int SCCollision::GetTileSlot(IntVec2 const& chunkCoords, int localTileIndex) const
+{
+	int chunkSlot = GetChunkSlot(chunkCoords);
+	if (chunkSlot == -1)
+	{
+		return -1;
+	}
+	return chunkSlot * StaticWorldSettings::s_numTilesInChunk + localTileIndex;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int SCCollision::GetTileSlotAtGlobalTileCoords(IntVec2 const& globalTileCoords) const
+{
+	// Chunks are a power of two tiles wide, so shifting/masking the global tile coords splits them into chunk and local
+	IntVec2 chunkCoords = IntVec2(globalTileCoords.x >> StaticWorldSettings::s_worldChunkSizePowerOfTwo, globalTileCoords.y >> StaticWorldSettings::s_worldChunkSizePowerOfTwo);
+	int localX = globalTileCoords.x & StaticWorldSettings::s_numTilesInRowMinusOne;
+	int localY = globalTileCoords.y & StaticWorldSettings::s_numTilesInRowMinusOne;
+	return GetTileSlot(chunkCoords, (localY << StaticWorldSettings::s_worldChunkSizePowerOfTwo) + localX);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Chunk* SCCollision::GetHashedChunk(int chunkSlot) const
+{
+	if (chunkSlot < 0 || chunkSlot >= (int) m_hashedChunks.size())
+	{
+		return nullptr;
+	}
+	return m_hashedChunks[chunkSlot];
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int SCCollision::GetNumEntitiesInTileSlot(int tileSlot) const
+{
+	return m_tileOffsets[tileSlot + 1] - m_tileOffsets[tileSlot];
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int const* SCCollision::GetEntitiesInTileSlot(int tileSlot) const
+{
+	return m_tileEntities.data() + m_tileOffsets[tileSlot];
+}
@@ -1,36 +1,56 @@
 // Bradley Christensen - 2022-2025
 #pragma once
+#include "WorldSettings.h"
 #include "Engine/Math/AABB2.h"
 #include "Engine/Math/IntVec2.h"
-#include "Engine/ECS/EntityID.h"
-#include <unordered_map>
 #include <vector>
 
 
 
-//----------------------------------------------------------------------------------------------------------------------
-typedef std::vector<EntityID> EntityBucket;
+class Chunk;
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-struct ChunkCollisionData
+// One entity overlapping one tile. Written by the split collision hash jobs, then counting sorted by tile slot.
+struct CollisionHashEntry
 {
-	EntityBucket m_chunkBucket;
-	std::unordered_map<int, EntityBucket> m_tileBuckets;
+	int m_tileSlot		= -1;
+	int m_entityIndex	= -1;
 };
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
+// Flat spatial hash over the rectangle of chunks overlapping m_collisionUpdateBounds. Each of those chunks owns
+// s_numTilesInChunk consecutive tile slots, and the entities overlapping tile slot s are
+// m_tileEntities[m_tileOffsets[s]] to m_tileEntities[m_tileOffsets[s + 1] - 1].
+//
 class SCCollision
 {
+public:
+
+	void ResetHashedChunks(IntVec2 const& mins, IntVec2 const& maxs);
+
+	int GetNumTileSlots() const;
+	int GetChunkSlot(IntVec2 const& chunkCoords) const;								// -1 if the chunk isn't hashed
+	int GetTileSlot(IntVec2 const& chunkCoords, int localTileIndex) const;			// -1 if the chunk isn't hashed
+	int GetTileSlotAtGlobalTileCoords(IntVec2 const& globalTileCoords) const;		// -1 if the chunk isn't hashed
+	Chunk* GetHashedChunk(int chunkSlot) const;
+
+	int GetNumEntitiesInTileSlot(int tileSlot) const;
+	int const* GetEntitiesInTileSlot(int tileSlot) const;
+
 public:
 
 	AABB2 m_collisionUpdateBounds = AABB2::ZeroToOne;						// Updated by collision hash system
-	std::unordered_map<IntVec2, ChunkCollisionData> m_chunkCollisionData;
 
-	// Used by collision hash system to split work, then is combined into m_chunkCollisionData in Post-Run
-	std::vector<std::unordered_map<IntVec2, ChunkCollisionData>> m_perThreadCollisionData;
-};
+	IntVec2 m_hashedChunksMins;
+	IntVec2 m_hashedChunksDims;
+	std::vector<Chunk*> m_hashedChunks;										// Per chunk slot, nullptr if that chunk isn't loaded
+	std::vector<int> m_tileOffsets;											// Per tile slot, plus one past the end
+	std::vector<int> m_tileEntities;										// Entity indices, sorted by tile slot
 
+	// One flat list per split job, counting sorted into m_tileEntities in Post-Run
+	std::vector<std::vector<CollisionHashEntry>> m_perThreadEntries;
+};
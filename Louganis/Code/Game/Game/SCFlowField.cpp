@@ -0,0 +1,18 @@
+// Bradley Christensen - 2022-2025
+#include "SCFlowField.h"
+#include "TargetFlowField.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Vec2 SCFlowField::GetFlowAtWorldCoords(FlowFieldKey const& key, WorldCoords const& worldCoords) const
+{
+	if (key.m_target == FlowFieldTarget::Player)
+	{
+		return m_toPlayerFlowField.GetFlowAtWorldCoords(worldCoords);
+	}
+
+	// Not solved yet, stand still until it is
+	TargetFlowField const* targetFlowField = m_targetFlowFields.Find(key);
+	return targetFlowField ? targetFlowField->GetFlowAtWorldCoords(worldCoords) : Vec2::ZeroVector;
+}
@@ -1,22 +1,21 @@
 // Bradley Christensen - 2022-2025
 #pragma once
 #include "FlowField.h"
+#include "FlowFieldCache.h"
+#include "FlowFieldKey.h"
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-struct FlowFieldKey
+class SCFlowField
 {
+public:
 
-};
-
-
+	Vec2 GetFlowAtWorldCoords(FlowFieldKey const& key, WorldCoords const& worldCoords) const;
 
-//----------------------------------------------------------------------------------------------------------------------
-class SCFlowField
-{
 public:
 
-	FlowField m_toPlayerFlowField; // Flow field that always flows towards the player
+	FlowField m_toPlayerFlowField;		// Flow field that always flows towards the player
+	FlowFieldCache m_targetFlowFields;	// Flow fields towards every other target AI are heading to
 };
 
@@ -1,7 +1,10 @@
 // Bradley Christensen - 2022-2025
 #pragma once
-#include "WorldCoords.h"
-#include <unordered_set>
+#include "Tile.h"
+#include "WorldSettings.h"
+#include "Engine/Assets/Image.h"
+#include <unordered_map>
+#include <vector>
 
 
 
@@ -9,13 +12,32 @@ class Chunk;
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// A chunk with lighting to propagate this frame. Tiles across the borders are read from a copy taken before each round,
+// so every chunk can be propagated by a different job, and border tiles that change are handed to the neighbor chunk
+// between rounds.
+//
+struct LightingChunk
+{
+	Chunk* m_chunk = nullptr;
+	Chunk* m_neighbors[4] = {};																// East, west, north, south, null if not active
+	Tile m_borderTiles[4][StaticWorldSettings::s_numTilesInRow];							// Each neighbor's row or column touching this chunk
+	std::vector<int> m_queue;																// FIFO of dirty local tile indices
+	std::vector<int> m_outgoingBorderTiles;													// (direction * s_numTilesInRow + index along the border) of changed border tiles
+	Image m_lightmapImage;
+	bool m_hasLightmapImage = false;
+};
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 class SCLighting
 {
 public:	
 
 	bool m_isLightingEnabled = true;
-	std::unordered_set<WorldCoords> m_dirtyLightingTiles;
-	std::unordered_set<Chunk*> m_dirtyChunks; // Lightmaps need to be rebuild
-};
 
+	// Only valid during SLighting::Run
+	std::vector<LightingChunk> m_lightingChunks;
+	std::unordered_map<Chunk*, int> m_lightingChunkIndices;
+};
@@ -1,5 +1,10 @@
 // Bradley Christensen - 2022-2025
 #pragma once
+#include "ChunkDirectory.h"
+
+
+
+class GenerateChunkJob;
 
 
 
@@ -11,5 +16,7 @@ public:
 	bool m_unloadedChunksInRadius		= true;
 	int m_numLoadedChunksThisFrame		= 0;
 	int m_numUnloadedChunksThisFrame	= 0;
-};
 
+	// Chunks being generated on worker threads, or finished and waiting to be committed to the world
+	ChunkDirectory<GenerateChunkJob> m_pendingChunks;
+};
@@ -27,12 +27,15 @@ IntVec2 s_neighborOffsets[8] =
 //----------------------------------------------------------------------------------------------------------------------
 Chunk* SCWorld::GetActiveChunk(IntVec2 const& chunkCoords) const
 {
-	auto it = m_activeChunks.find(chunkCoords);
-	if (it != m_activeChunks.end())
-	{
-		return it->second;
-	}
-	return nullptr;
+	return m_activeChunks.Find(chunkCoords);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Chunk* SCWorld::GetActiveNeighborChunk(Chunk* chunk, WorldCoords const& neighborCoords) const
+{
+	return m_activeChunks.FindNeighbor(chunk, chunk->m_chunkCoords, neighborCoords.m_chunkCoords);
 }
 
 
@@ -159,16 +162,7 @@ WorldCoords SCWorld::GetWorldCoordsAtLocation(Vec2 const& worldLocation) const
 //----------------------------------------------------------------------------------------------------------------------
 WorldCoords SCWorld::GetWorldCoordsAtGlobalTileCoords(IntVec2 const& globalTileCoords) const
 {
-	WorldCoords result;
-	Vec2 chunkCoordsF = Vec2(globalTileCoords) * StaticWorldSettings::s_oneOverNumTilesInRow;
-	result.m_chunkCoords = IntVec2(chunkCoordsF.GetFloor());
-
-	IntVec2 chunkOriginGlobalTileCoords = result.m_chunkCoords * StaticWorldSettings::s_numTilesInRow;
-	result.m_localTileCoords = globalTileCoords - chunkOriginGlobalTileCoords;
-	result.m_localTileCoords.x = MathUtils::Clamp(result.m_localTileCoords.x, 0, StaticWorldSettings::s_numTilesInRowMinusOne);
-	result.m_localTileCoords.y = MathUtils::Clamp(result.m_localTileCoords.y, 0, StaticWorldSettings::s_numTilesInRowMinusOne);
-
-	return result;
+	return WorldCoords::FromGlobalTileCoords(globalTileCoords);
 }
 
 
@@ -314,7 +308,7 @@ void SCWorld::ForEachChunkOverlappingAABB(AABB2 const& aabb, const std::function
 		// Faster to iterate through all chunks
 		for (auto& chunk : m_activeChunks)
 		{
-			if (!func(*chunk.second))
+			if (!func(*chunk.m_chunk))
 			{
 				return;
 			}
@@ -555,17 +549,31 @@ AABB2 SCWorld::GetTileBounds(IntVec2 const& worldTileCoords) const
 Chunk* SCWorld::LoadChunk(IntVec2 const& chunkCoords, std::vector<SpawnInfo>& out_entitiesToSpawn)
 {
 	Chunk* chunk = new Chunk();
-	chunk->Generate(chunkCoords, m_worldSettings, out_entitiesToSpawn);
-	m_activeChunks.emplace(chunkCoords, chunk);
+	if (!m_chunkDiskCache.TryLoadChunk(chunkCoords, m_worldSettings, *chunk, out_entitiesToSpawn))
+	{
+		chunk->Generate(chunkCoords, m_worldSettings, out_entitiesToSpawn);
+		m_chunkDiskCache.SaveChunk(*chunk, m_worldSettings, &out_entitiesToSpawn);
+	}
+	chunk->m_solidEdges.Build(*chunk);
+	chunk->GenerateDebugVBO();
+	AddActiveChunk(chunk);
 	return chunk;
 }
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+bool SCWorld::AddActiveChunk(Chunk* chunk)
+{
+	return m_activeChunks.Insert(chunk->m_chunkCoords, chunk);
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 bool SCWorld::IsChunkLoaded(IntVec2 const& chunkCoords) const
 {
-	return m_activeChunks.find(chunkCoords) != m_activeChunks.end();
+	return m_activeChunks.Contains(chunkCoords);
 }
 
 
@@ -573,13 +581,11 @@ bool SCWorld::IsChunkLoaded(IntVec2 const& chunkCoords) const
 //----------------------------------------------------------------------------------------------------------------------
 bool SCWorld::RemoveActiveChunk(IntVec2 const& coords)
 {
-	auto it = m_activeChunks.find(coords);
-	if (it != m_activeChunks.end())
+	Chunk* chunk = m_activeChunks.Erase(coords);
+	if (chunk)
 	{
-		Chunk* chunk = it->second;
 		chunk->Destroy();
 		delete chunk;
-		m_activeChunks.erase(it);
 		return true;
 	}
 	return false;
@@ -610,12 +616,12 @@ void SCWorld::RemoveActiveChunks(std::vector<IntVec2> const& coordsList)
 //----------------------------------------------------------------------------------------------------------------------
 void SCWorld::ClearActiveChunks()
 {
-	for (auto chunk : m_activeChunks)
+	for (auto const& chunk : m_activeChunks)
 	{
-		chunk.second->Destroy();
-		delete chunk.second;
+		chunk.m_chunk->Destroy();
+		delete chunk.m_chunk;
 	}
-	m_activeChunks.clear();
+	m_activeChunks.Clear();
 }
 
 
@@ -1,12 +1,14 @@
 // Bradley Christensen - 2022-2025
 #pragma once
+#include "ChunkDirectory.h"
+#include "ChunkDiskCache.h"
 #include "SpawnInfo.h"
 #include "WorldCoords.h"
 #include "WorldSettings.h"
 #include "Engine/Assets/AssetID.h"
 #include "Engine/Math/AABB2.h"
 #include "Engine/Math/IntVec2.h"
-#include <map>
+#include <functional>
 #include <vector>
 
 
@@ -25,6 +27,7 @@ public:
     Chunk* GetActiveChunk(int chunkX, int chunkY) const;
     Chunk* GetActiveChunk(WorldCoords const& worldCoords) const;
     Chunk* GetActiveChunkAtLocation(Vec2 const& worldLocation) const;
+    Chunk* GetActiveNeighborChunk(Chunk* chunk, WorldCoords const& neighborCoords) const; // Skips the lookup if neighborCoords are in chunk
 
     IntVec2 GetChunkCoordsAtLocation(Vec2 const& worldLocation) const;
     IntVec2 GetGlobalTileCoordsAtLocation(Vec2 const& worldLocation) const;
@@ -57,6 +60,7 @@ public:
     AABB2 GetTileBounds(IntVec2 const& worldTileCoords) const;
     
     Chunk* LoadChunk(IntVec2 const& chunkCoords, std::vector<SpawnInfo>& out_entitiesToSpawn);
+    bool AddActiveChunk(Chunk* chunk); // Takes ownership of an already generated chunk, false if one is already loaded there
     bool IsChunkLoaded(IntVec2 const& chunkCoords) const;
     bool RemoveActiveChunk(IntVec2 const& coords);
     void RemoveActiveChunk(int chunkX, int chunkY);
@@ -72,12 +76,14 @@ public:
     bool m_isWorldSeedDirty                     = true; // flag that is set when the world seed changes, so we can regenerate the world
     WorldSettings m_worldSettings;
 
-    std::map<IntVec2, Chunk*> m_activeChunks;   // Owned by SWorld
+    ChunkDirectory<Chunk> m_activeChunks;       // Owned by SWorld
+    ChunkDiskCache m_chunkDiskCache;            // Chunks that have been generated before, loaded instead of regenerated
 
 	AssetID m_worldSpriteSheet                  = AssetID::Invalid; // cached in SRenderWorld startup
 
     // Tracks if the player has moved. todo: move to maybe movement component?
     bool m_playerChangedWorldCoordsThisFrame    = true;
+    bool m_playerChangedChunkThisFrame          = true;
     WorldCoords m_lastKnownPlayerWorldCoords    = WorldCoords::s_invalidWorldCoords;
 };
 
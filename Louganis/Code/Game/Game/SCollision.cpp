@@ -1,90 +1,219 @@
 ﻿// Bradley Christensen - 2022-2025
 #include "SCollision.h"
 #include "CCollision.h"
+#include "Chunk.h"
 #include "SCCollision.h"
 #include "SCWorld.h"
 #include "CTransform.h"
 #include "Engine/Math/GeometryUtils.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Multithreading/Job.h"
+#include "Engine/Multithreading/JobSystem.h"
+#include <thread>
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void SCollision::Startup()
+// Wall test for resolved positions. Looks the tile up through the chunk pointers cached by the collision hash, and
+// only falls back to the world's chunk map for points pushed outside the hashed chunks.
+//
+bool IsPointInsideSolidTile(SCCollision const& scCollision, SCWorld const& scWorld, Vec2 const& worldPos)
 {
-    AddWriteDependencies<CTransform>();
-    AddReadDependencies<SCCollision, SCWorld, CCollision>();
+    int tileSlot = scCollision.GetTileSlotAtGlobalTileCoords(scWorld.GetGlobalTileCoordsAtLocation(worldPos));
+    if (tileSlot == -1)
+    {
+        return scWorld.IsPointInsideSolidTile(worldPos);
+    }
+
+    Chunk* chunk = scCollision.GetHashedChunk(tileSlot / StaticWorldSettings::s_numTilesInChunk);
+    return chunk && chunk->IsTileSolid(tileSlot % StaticWorldSettings::s_numTilesInChunk);
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void SCollision::Run(SystemContext const&)
+void ResolveCollisionInChunk(SCCollision const& scCollision, SCWorld const& scWorld, int chunkSlot)
 {
-    SCCollision& scCollision = g_ecs->GetSingleton<SCCollision>();
-
 	auto& transformStorage = g_ecs->GetArrayStorage<CTransform>();
 	auto& collisionStorage = g_ecs->GetArrayStorage<CCollision>();
 
-	SCWorld const& scWorld = g_ecs->GetSingleton<SCWorld>();
-    scWorld.ForEachChunkCoordsOverlappingAABB(scCollision.m_collisionUpdateBounds, [&](IntVec2 const& chunkCoords)
+    // Tile slots are laid out chunk by chunk, so this walks the chunk's hashed entities in memory order
+    int firstTileSlot = chunkSlot * StaticWorldSettings::s_numTilesInChunk;
+    int endTileSlot = firstTileSlot + StaticWorldSettings::s_numTilesInChunk;
+    for (int tileSlot = firstTileSlot; tileSlot < endTileSlot; ++tileSlot)
     {
-        ChunkCollisionData const& chunkCollisionData = scCollision.m_chunkCollisionData[chunkCoords];
-        auto& tileBuckets = chunkCollisionData.m_tileBuckets;
+        int numEntitiesInTile = scCollision.GetNumEntitiesInTileSlot(tileSlot);
+        if (numEntitiesInTile < 2)
+        {
+            continue;
+        }
 
-        for (auto tileIt = tileBuckets.begin(); tileIt != tileBuckets.end(); ++tileIt)
+        int const* tileEntities = scCollision.GetEntitiesInTileSlot(tileSlot);
+
+        // Handle collision inside tile
+        for (int a = 0; a < numEntitiesInTile; ++a)
         {
-            EntityBucket const& tileBucket = tileIt->second;
+            int entityA = tileEntities[a];
+            CTransform& transformA = transformStorage[entityA];
+            CCollision const& collisionA = collisionStorage[entityA];
+
+            bool canBpushA = !collisionA.IsImmovable();
 
-            // Handle collision inside tile
-            for (size_t a = 0; a < tileBucket.size(); ++a)
+            for (int b = a + 1; b < numEntitiesInTile; ++b)
             {
-                EntityID const& entityA = tileBucket[a];
-                CTransform& transformA = transformStorage[entityA];
-                CCollision const& collisionA = collisionStorage[entityA];
+                int entityB = tileEntities[b];
+                CTransform& transformB = transformStorage[entityB];
+                CCollision const& collisionB = collisionStorage[entityB];
 
-                bool canBpushA = !collisionA.IsImmovable();
+				Vec2 newPosA = transformA.m_pos + collisionA.m_offset;
+				Vec2 newPosB = transformB.m_pos + collisionB.m_offset;
 
-                for (size_t b = a + 1; b < tileBucket.size(); ++b)
-                {
-                    EntityID const& entityB = tileBucket[b];
-                    CTransform& transformB = transformStorage[entityB];
-                    CCollision const& collisionB = collisionStorage[entityB];
+                bool canApushB = !collisionB.IsImmovable();
 
-					Vec2 newPosA = transformA.m_pos + collisionA.m_offset;
-					Vec2 newPosB = transformB.m_pos + collisionB.m_offset;
-
-                    bool canApushB = !collisionB.IsImmovable();
+                bool collisionResolved = false;
+                if (canApushB && canBpushA)
+                {
+                    collisionResolved = GeometryUtils::PushDiscsOutOfEachOther2D(newPosA, collisionA.m_radius, newPosB, collisionB.m_radius, true, 0.75);
+                }
+                else if (canApushB) // && !canBpushA
+                {
+                    collisionResolved = GeometryUtils::PushDiscOutOfDisc2D(newPosB, collisionB.m_radius, newPosA, collisionA.m_radius);
+                }
+                else if (canBpushA) // && !canApushB
+                {
+                    collisionResolved = GeometryUtils::PushDiscOutOfDisc2D(newPosA, collisionA.m_radius, newPosB, collisionB.m_radius);
+                }
 
-                    bool collisionResolved = false;
-                    if (canApushB && canBpushA)
-                    {
-                        collisionResolved = GeometryUtils::PushDiscsOutOfEachOther2D(newPosA, collisionA.m_radius, newPosB, collisionB.m_radius, true, 0.75);
-                    }
-                    else if (canApushB) // && !canBpushA
-                    {
-                        collisionResolved = GeometryUtils::PushDiscOutOfDisc2D(newPosB, collisionB.m_radius, newPosA, collisionA.m_radius);
-                    }
-                    else if (canBpushA) // && !canApushB
+                if (collisionResolved)
+                {
+                    // Make sure we didnt push into a wall
+                    if (!IsPointInsideSolidTile(scCollision, scWorld, newPosA))
                     {
-                        collisionResolved = GeometryUtils::PushDiscOutOfDisc2D(newPosA, collisionA.m_radius, newPosB, collisionB.m_radius);
+                        transformA.m_pos = newPosA - collisionA.m_offset;
                     }
-
-                    if (collisionResolved)
+                    if (!IsPointInsideSolidTile(scCollision, scWorld, newPosB))
                     {
-                        // Make sure we didnt push into a wall
-                        if (!scWorld.IsPointInsideSolidTile(newPosA))
-                        {
-                            transformA.m_pos = newPosA - collisionA.m_offset;
-                        }
-                        if (!scWorld.IsPointInsideSolidTile(newPosB))
-                        {
-                            transformB.m_pos = newPosB - collisionB.m_offset;
-                        }
+                        transformB.m_pos = newPosB - collisionB.m_offset;
                     }
                 }
             }
         }
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Resolves a run of same colored chunks, which never share an entity with chunks resolved by other jobs in the pass
+//
+class ResolveCollisionJob : public Job
+{
+public:
+
+    ResolveCollisionJob(SCCollision const& scCollision, SCWorld const& scWorld, int const* chunkSlots, int numChunkSlots) :
+        m_scCollision(scCollision), m_scWorld(scWorld), m_chunkSlots(chunkSlots, chunkSlots + numChunkSlots) {}
+
+    virtual void Execute() override
+    {
+        for (int chunkSlot : m_chunkSlots)
+        {
+            ResolveCollisionInChunk(m_scCollision, m_scWorld, chunkSlot);
+        }
+    }
+
+    SCCollision const& m_scCollision;
+    SCWorld const& m_scWorld;
+    std::vector<int> m_chunkSlots;
+};
+
+
 
-        return true; // keep iterating
-	});
-}
\ No newline at end of file
+//----------------------------------------------------------------------------------------------------------------------
+void SCollision::Startup()
+{
+    AddWriteDependencies<CTransform>();
+    AddReadDependencies<SCCollision, SCWorld, CCollision>();
+
+    int numThreads = std::thread::hardware_concurrency() - 1;
+    m_maxNumResolveJobs = MathUtils::Max(numThreads - 1, 1);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Hashed chunks are resolved in 4 passes, one per color of a 2x2 checkerboard. Chunks of the same color are a full
+// chunk apart, and entities are much smaller than a chunk, so no entity is hashed into 2 chunks of the same color and
+// each pass can resolve its chunks in parallel. Passes run in a fixed order, so results don't depend on thread timing.
+//
+void SCollision::Run(SystemContext const&)
+{
+    SCCollision const& scCollision = g_ecs->GetSingleton<SCCollision>();
+	SCWorld const& scWorld = g_ecs->GetSingleton<SCWorld>();
+
+    int numChunkSlots = (int) scCollision.m_hashedChunks.size();
+    int chunksWide = scCollision.m_hashedChunksDims.x;
+
+    std::vector<int> chunkSlots;
+    chunkSlots.reserve(numChunkSlots);
+    std::vector<JobID> jobReceipts;
+
+    for (int color = 0; color < 4; ++color)
+    {
+        // Gather this color's chunks that have anything to resolve
+        chunkSlots.clear();
+        int numEntriesInColor = 0;
+        for (int chunkSlot = 0; chunkSlot < numChunkSlots; ++chunkSlot)
+        {
+            int chunkColor = ((chunkSlot % chunksWide) & 1) | (((chunkSlot / chunksWide) & 1) << 1);
+            if (chunkColor != color)
+            {
+                continue;
+            }
+
+            int firstTileSlot = chunkSlot * StaticWorldSettings::s_numTilesInChunk;
+            int endTileSlot = firstTileSlot + StaticWorldSettings::s_numTilesInChunk;
+            int numEntriesInChunk = scCollision.m_tileOffsets[endTileSlot] - scCollision.m_tileOffsets[firstTileSlot];
+            if (numEntriesInChunk < 2)
+            {
+                continue;
+            }
+
+            chunkSlots.push_back(chunkSlot);
+            numEntriesInColor += numEntriesInChunk;
+        }
+
+        int numJobs = MathUtils::Min(m_maxNumResolveJobs, (int) chunkSlots.size());
+        numJobs = MathUtils::Min(numJobs, numEntriesInColor / s_minEntriesPerResolveJob);
+        if (numJobs <= 1)
+        {
+            for (int chunkSlot : chunkSlots)
+            {
+                ResolveCollisionInChunk(scCollision, scWorld, chunkSlot);
+            }
+            continue;
+        }
+
+        // Cut the chunks into consecutive runs with roughly the same number of entries each
+        int targetEntriesPerJob = numEntriesInColor / numJobs;
+        int runStartIndex = 0;
+        int numEntriesInRun = 0;
+        for (int i = 0; i < (int) chunkSlots.size(); ++i)
+        {
+            int chunkSlot = chunkSlots[i];
+            int firstTileSlot = chunkSlot * StaticWorldSettings::s_numTilesInChunk;
+            numEntriesInRun += scCollision.m_tileOffsets[firstTileSlot + StaticWorldSettings::s_numTilesInChunk] - scCollision.m_tileOffsets[firstTileSlot];
+
+            bool isLastChunk = (i == (int) chunkSlots.size() - 1);
+            if (numEntriesInRun >= targetEntriesPerJob || isLastChunk)
+            {
+                ResolveCollisionJob* job = new ResolveCollisionJob(scCollision, scWorld, chunkSlots.data() + runStartIndex, i - runStartIndex + 1);
+                jobReceipts.push_back(g_jobSystem->PostJob(job));
+                runStartIndex = i + 1;
+                numEntriesInRun = 0;
+            }
+        }
+
+        // Block until this color is done, the next color touches the same entities
+        g_jobSystem->CompleteJobs(jobReceipts);
+    }
+}
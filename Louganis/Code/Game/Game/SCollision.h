@@ -12,4 +12,10 @@ public:
     SCollision(Name name = "Collision", Rgba8 const& debugTint = Rgba8::Red) : System(name, debugTint) {};
     void Startup() override;
     void Run(SystemContext const& context) override;
+
+protected:
+
+    static constexpr int s_minEntriesPerResolveJob = 256; // Fewer hashed entries than this per job and it runs inline
+
+    int m_maxNumResolveJobs = 1;
 };
@@ -7,6 +7,8 @@
 #include "SCCollision.h"
 #include "Chunk.h"
 #include "Engine/Core/ErrorUtils.h"
+#include "Engine/Math/GeometryUtils.h"
+#include "Engine/Math/MathUtils.h"
 #include <thread>
 
 
@@ -14,12 +16,13 @@
 //----------------------------------------------------------------------------------------------------------------------
 void SCollisionHash::Startup()
 {
-	AddWriteDependencies<SCWorld, SCCollision>();
-    AddReadDependencies<CCollision, CTransform, SCCamera>();
+	AddWriteDependencies<SCCollision>();
+    AddReadDependencies<CCollision, CTransform, SCCamera, SCWorld>();
 
-    // Hashing entities can be split, since it is a read only operation until the combine phase
+    // Hashing entities can be split, since each job only writes its own entry list until the sort in PostRun
     int numThreads = std::thread::hardware_concurrency() - 1;
 	m_systemSplittingNumJobs = numThreads - 1;
+	SetSystemSplittingGroup<CTransform, CCollision>();
 }
 
 
@@ -31,41 +34,31 @@ void SCollisionHash::PreRun()
 	SCCamera& camera = g_ecs->GetSingleton<SCCamera>();
     SCCollision& scCollision = g_ecs->GetSingleton<SCCollision>();
 
-    // clear out stale data and remove any chunk entries that are no longer loaded
-    for (auto it = scCollision.m_chunkCollisionData.begin(); it != scCollision.m_chunkCollisionData.end();)
-    {
-		IntVec2 chunkCoords = it->first;
-		ChunkCollisionData& chunkCollisionData = it->second;
-
-        // Clear out stale data
-        chunkCollisionData.m_chunkBucket.clear();
-        for (auto& tileBucket : chunkCollisionData.m_tileBuckets)
-        {
-            tileBucket.second.clear();
-        }
-
-        if (!world.IsChunkLoaded(chunkCoords))
-        {
-            // Erase the main collision data for this chunk
-            it = scCollision.m_chunkCollisionData.erase(it);
-
-			// Erase the per-thread collision data for this chunk
-            for (auto& perThreadCollisionData : scCollision.m_perThreadCollisionData)
-            {
-                perThreadCollisionData.erase(chunkCoords);
-			}
-        }
-        else
-        {
-            it++;
-        }
-    }
-
 	// Optimization: only update collision hashes for entities that are within the collision hash radius of the active camera
     scCollision.m_collisionUpdateBounds = AABB2::ZeroToOne;
     scCollision.m_collisionUpdateBounds = camera.m_camera.GetTranslatedOrthoBounds2D();
     scCollision.m_collisionUpdateBounds.SetDimsAboutCenter(Vec2(StaticWorldSettings::s_collisionHashRadius * 2.f, StaticWorldSettings::s_collisionHashRadius * 2.f));
-	scCollision.m_perThreadCollisionData.resize(m_systemSplittingNumJobs);
+
+	// Hash every chunk overlapping the update bounds. Chunk pointers are cached for the collision systems, and stay valid
+	// until chunks are next unloaded in the pre-physics phase.
+	IntVec2 minChunkCoords = world.GetChunkCoordsAtLocation(scCollision.m_collisionUpdateBounds.mins);
+	IntVec2 maxChunkCoords = world.GetChunkCoordsAtLocation(scCollision.m_collisionUpdateBounds.maxs);
+	scCollision.ResetHashedChunks(minChunkCoords, maxChunkCoords);
+	for (int chunkY = minChunkCoords.y; chunkY <= maxChunkCoords.y; ++chunkY)
+	{
+		for (int chunkX = minChunkCoords.x; chunkX <= maxChunkCoords.x; ++chunkX)
+		{
+			int chunkSlot = scCollision.GetChunkSlot(IntVec2(chunkX, chunkY));
+			scCollision.m_hashedChunks[chunkSlot] = world.GetActiveChunk(chunkX, chunkY);
+		}
+	}
+
+	// Sized for the max num jobs, the scheduler may split into fewer and leave the rest empty. Clearing keeps capacity.
+	scCollision.m_perThreadEntries.resize(MathUtils::Max(m_systemSplittingNumJobs, 1));
+	for (std::vector<CollisionHashEntry>& entries : scCollision.m_perThreadEntries)
+	{
+		entries.clear();
+	}
 }
 
 
@@ -78,6 +71,9 @@ void SCollisionHash::Run(SystemContext const& context)
     auto& transStorage = g_ecs->GetArrayStorage<CTransform>();
     auto& collStorage = g_ecs->GetArrayStorage<CCollision>();
 
+	int threadIndex = context.m_didSystemSplit ? context.m_systemSplittingJobID : 0;
+	std::vector<CollisionHashEntry>& thisThreadEntries = scCollision.m_perThreadEntries[threadIndex];
+
     // Hash entities for this split system
     for (GroupIter it = g_ecs->Iterate<CTransform, CCollision>(context); it.IsValid(); ++it)
     {
@@ -97,21 +93,30 @@ void SCollisionHash::Run(SystemContext const& context)
             continue;
 		}
 
-		std::unordered_map<IntVec2, ChunkCollisionData>& thisThreadCollisionData = context.m_didSystemSplit ? scCollision.m_perThreadCollisionData[context.m_systemSplittingJobID] : scCollision.m_chunkCollisionData;
-
-        world.ForEachActiveChunkOverlappingCircle(pos, radius, [&](Chunk const& chunk)
-        {
-            thisThreadCollisionData[chunk.m_chunkCoords].m_chunkBucket.push_back(it.m_currentIndex);
-            return true; // continue iterating
-        });
-
-        world.ForEachWorldCoordsOverlappingCircle(pos, radius, [&](WorldCoords const& worldCoords, Chunk& chunk)
-        {
-            ChunkCollisionData& threadChunkCollisionData = thisThreadCollisionData[worldCoords.m_chunkCoords];
-            int tileIndex = chunk.m_tiles.GetIndexForCoords(worldCoords.m_localTileCoords);
-            threadChunkCollisionData.m_tileBuckets[tileIndex].push_back(it.m_currentIndex);
-            return true; // continue iterating
-        });
+		// Walk the tiles under the disc's bounds directly, no chunk map lookups
+		IntVec2 minTileCoords = world.GetGlobalTileCoordsAtLocation(pos - Vec2(radius, radius));
+		IntVec2 maxTileCoords = world.GetGlobalTileCoordsAtLocation(pos + Vec2(radius, radius));
+		for (int tileY = minTileCoords.y; tileY <= maxTileCoords.y; ++tileY)
+		{
+			for (int tileX = minTileCoords.x; tileX <= maxTileCoords.x; ++tileX)
+			{
+				IntVec2 globalTileCoords(tileX, tileY);
+				int tileSlot = scCollision.GetTileSlotAtGlobalTileCoords(globalTileCoords);
+				if (tileSlot == -1 || !scCollision.GetHashedChunk(tileSlot / StaticWorldSettings::s_numTilesInChunk))
+				{
+					continue;
+				}
+
+				if (!GeometryUtils::DoesDiscOverlapAABB(pos, radius, world.GetTileBounds(globalTileCoords)))
+				{
+					continue;
+				}
+
+				CollisionHashEntry& entry = thisThreadEntries.emplace_back();
+				entry.m_tileSlot = tileSlot;
+				entry.m_entityIndex = it.m_currentIndex;
+			}
+		}
     }
 }
 
@@ -122,33 +127,34 @@ void SCollisionHash::PostRun()
 {
     auto& scCollision = g_ecs->GetSingleton<SCCollision>();
 
-    int numEntitiesHashed = 0;
-    int numEntitiesHashedTiles = 0;
+	// Counting sort the entries by tile slot. First count entries per slot, then prefix sum so each slot holds the end
+	// of its range, then scatter back to front so each slot ends up holding its start, with entities in hash order.
+	std::vector<int>& tileOffsets = scCollision.m_tileOffsets;
+	int numTileSlots = scCollision.GetNumTileSlots();
 
-    for (auto& perThreadCollisionData : scCollision.m_perThreadCollisionData)
+	int numEntries = 0;
+    for (std::vector<CollisionHashEntry> const& entries : scCollision.m_perThreadEntries)
     {
-        for (auto& chunkCollisionPair : perThreadCollisionData)
-        {
-            IntVec2 const& chunkCoords = chunkCollisionPair.first;
-            ChunkCollisionData& threadChunkCollisionData = chunkCollisionPair.second;
-            ChunkCollisionData& mainChunkCollisionData = scCollision.m_chunkCollisionData[chunkCoords];
-
-            mainChunkCollisionData.m_chunkBucket.insert(mainChunkCollisionData.m_chunkBucket.end(), threadChunkCollisionData.m_chunkBucket.begin(), threadChunkCollisionData.m_chunkBucket.end());
-			numEntitiesHashed += static_cast<int>(threadChunkCollisionData.m_chunkBucket.size());
-
-            threadChunkCollisionData.m_chunkBucket.clear();
+		for (CollisionHashEntry const& entry : entries)
+		{
+			++tileOffsets[entry.m_tileSlot];
+		}
+		numEntries += (int) entries.size();
+	}
 
-            for (auto it = threadChunkCollisionData.m_tileBuckets.begin(); it != threadChunkCollisionData.m_tileBuckets.end(); ++it)
-            {
-                EntityBucket& threadTileBucket = it->second;
-                EntityBucket& mainTileBucket = mainChunkCollisionData.m_tileBuckets[it->first];
-                mainTileBucket.insert(mainTileBucket.end(), threadTileBucket.begin(), threadTileBucket.end());
-				numEntitiesHashedTiles += static_cast<int>(threadTileBucket.size());
+	for (int tileSlot = 1; tileSlot <= numTileSlots; ++tileSlot)
+	{
+		tileOffsets[tileSlot] += tileOffsets[tileSlot - 1];
+	}
 
-                threadTileBucket.clear();
-            }
-        }
+	scCollision.m_tileEntities.resize(numEntries);
+	for (auto threadIt = scCollision.m_perThreadEntries.rbegin(); threadIt != scCollision.m_perThreadEntries.rend(); ++threadIt)
+	{
+		for (auto entryIt = threadIt->rbegin(); entryIt != threadIt->rend(); ++entryIt)
+		{
+			scCollision.m_tileEntities[--tileOffsets[entryIt->m_tileSlot]] = entryIt->m_entityIndex;
+		}
 	}
 
-	ASSERT_OR_DIE(numEntitiesHashedTiles >= numEntitiesHashed, "SCollisionHash::PostRun - Mismatch in number of entities hashed between chunk and tile buckets.");
+	ASSERT_OR_DIE(tileOffsets[0] == 0 && tileOffsets[numTileSlots] == numEntries, "SCollisionHash::PostRun - Tile offsets do not cover every hashed entry.");
 }
@@ -20,9 +20,9 @@ void SDeath::Startup()
 //----------------------------------------------------------------------------------------------------------------------
 void SDeath::Run(SystemContext const& context)
 {
-	auto& healthStorage = g_ecs->GetArrayStorage<CHealth>();
-	auto& deathStorage = g_ecs->GetArrayStorage<CDeath>();
-	auto& lifetimeStorage = g_ecs->GetArrayStorage<CLifetime>();
+	auto& healthStorage = g_ecs->GetSparseSetStorage<CHealth>();
+	auto& deathStorage = g_ecs->GetSparseSetStorage<CDeath>();
+	auto& lifetimeStorage = g_ecs->GetSparseSetStorage<CLifetime>();
 	auto& animStorage = g_ecs->GetArrayStorage<CAnimation>();
 
 	for (auto it = g_ecs->Iterate<CHealth, CDeath, CLifetime>(context); it.IsValid(); ++it)
@@ -160,7 +160,7 @@ void SDebugRender::Run(SystemContext const& context)
     {
         for (auto const& it : flowField.m_activeFlowFieldChunks)
         {
-            FlowFieldChunk* ffChunk = it.second;
+            FlowFieldChunk* ffChunk = it.m_chunk;
             WorldCoords currentWorldCoords;
             currentWorldCoords.m_chunkCoords = ffChunk->GetChunkCoords();
 
@@ -182,9 +182,9 @@ void SDebugRender::Run(SystemContext const& context)
     // Render Distance Field
     if (scDebug.m_debugRenderDistanceField)
     {
-        for (auto it : flowField.m_activeFlowFieldChunks)
+        for (auto const& it : flowField.m_activeFlowFieldChunks)
         {
-            FlowFieldChunk* ffChunk = it.second;
+            FlowFieldChunk* ffChunk = it.m_chunk;
             WorldCoords currentWorldCoords;
             currentWorldCoords.m_chunkCoords = ffChunk->GetChunkCoords();
 
@@ -208,9 +208,9 @@ void SDebugRender::Run(SystemContext const& context)
     // Render Flow Field
     if (scDebug.m_debugRenderFlowField)
     {
-        for (auto it : flowField.m_activeFlowFieldChunks)
+        for (auto const& it : flowField.m_activeFlowFieldChunks)
         {
-            FlowFieldChunk* ffChunk = it.second;
+            FlowFieldChunk* ffChunk = it.m_chunk;
             WorldCoords currentWorldCoords;
             currentWorldCoords.m_chunkCoords = ffChunk->GetChunkCoords();
 
@@ -220,7 +220,7 @@ void SDebugRender::Run(SystemContext const& context)
                 {
                     currentWorldCoords.m_localTileCoords = IntVec2(x, y);
                     AABB2 tileBounds = world.GetTileBounds(currentWorldCoords);
-                    Vec2 gradient = ffChunk->m_gradient.Get(x, y);
+                    Vec2 gradient = flowField.GetFlowAtWorldCoords(currentWorldCoords);
 
                     VertexUtils::AddVertsForArrow2D(frameVerts, tileBounds.GetCenter(), tileBounds.GetCenter() + gradient, 0.05f, Rgba8::Yellow);
                 }
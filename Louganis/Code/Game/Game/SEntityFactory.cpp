@@ -2,9 +2,12 @@
 #include "SEntityFactory.h"
 #include "EntityDef.h"
 #include "CTransform.h"
+#include "SpawnInfo.h"
 #include "SCEntityFactory.h"
 #include "Engine/Debug/DevConsoleUtils.h"
 #include "Engine/Core/ErrorUtils.h"
+#include <algorithm>
+#include <functional>
 
 
 
@@ -54,7 +57,8 @@ void SEntityFactory::Run(SystemContext const&)
 //----------------------------------------------------------------------------------------------------------------------
 void SEntityFactory::Shutdown()
 {
-
+    // Def prefabs point into the ECS storage
+    EntityDef::Shutdown();
 }
 
 
@@ -64,27 +68,13 @@ EntityID SEntityFactory::CreateEntityFromDef(EntityDef const* def)
 {
 	ASSERT_OR_DIE(def != nullptr, "Null entity definition passed to SEntityFactory::CreateEntityFromDef");
 
-    EntityID id = g_ecs->CreateEntity();
-    if (id == ENTITY_ID_INVALID)
+    EntityID id = g_ecs->Instantiate(def->m_prefab);
+    if (id == EntityID::Invalid)
     {
         DevConsoleUtils::LogError("Max entities (%i) reached, cannot spawn entity from definition: %s", MAX_ENTITIES, def->m_name.ToCStr());
-        return ENTITY_ID_INVALID;
+        return EntityID::Invalid;
     }
 
-    // Add components that exist in the def
-    if (def->m_transform.has_value())           g_ecs->AddComponent<CTransform>(id);
-    if (def->m_time.has_value())                g_ecs->AddComponent<CTime>(id);
-    if (def->m_ai.has_value())                  g_ecs->AddComponent<CAIController>(id);
-	if (def->m_ability.has_value())             g_ecs->AddComponent<CAbility>(id, *def->m_ability);
-	if (def->m_animation.has_value())           g_ecs->AddComponent<CAnimation>(id, *def->m_animation);
-	if (def->m_collision.has_value())           g_ecs->AddComponent<CCollision>(id, *def->m_collision);
-	if (def->m_playerController.has_value())    g_ecs->AddComponent<CPlayerController>(id, *def->m_playerController);
-    if (def->m_movement.has_value())            g_ecs->AddComponent<CMovement>(id, *def->m_movement);
-    if (def->m_render.has_value())              g_ecs->AddComponent<CRender>(id, *def->m_render);
-	if (def->m_lifetime.has_value())            g_ecs->AddComponent<CLifetime>(id, *def->m_lifetime);
-	if (def->m_health.has_value())              g_ecs->AddComponent<CHealth>(id, *def->m_health);
-	if (def->m_death.has_value())               g_ecs->AddComponent<CDeath>(id, *def->m_death);
-
     return id;
 }
 
@@ -93,12 +83,87 @@ EntityID SEntityFactory::CreateEntityFromDef(EntityDef const* def)
 //----------------------------------------------------------------------------------------------------------------------
 EntityID SEntityFactory::SpawnEntity(SpawnInfo const& spawnInfo)
 {
-    EntityID id = SEntityFactory::CreateEntityFromDef(spawnInfo.m_def);
-    if (id == ENTITY_ID_INVALID)
+    EntityID id = CreateEntityFromDef(spawnInfo.m_def);
+    if (id == EntityID::Invalid)
+    {
+        return EntityID::Invalid;
+    }
+
+    ApplySpawnInfo(id, spawnInfo);
+    return id;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+DeferredEntityID SEntityFactory::SpawnEntity(EntityCommandBuffer& commandBuffer, SpawnInfo const& spawnInfo)
+{
+	ASSERT_OR_DIE(spawnInfo.m_def != nullptr, "Null entity definition passed to SEntityFactory::SpawnEntity");
+
+    DeferredEntityID id = commandBuffer.Instantiate(spawnInfo.m_def->m_prefab);
+    commandBuffer.OnEntityCreated(id, [spawnInfo](EntityID entityID)
+    {
+        ApplySpawnInfo(entityID, spawnInfo);
+    });
+    return id;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Sorting by def makes each run of the same def one Instantiate during playback
+//
+DeferredEntityID SEntityFactory::SpawnEntities(EntityCommandBuffer& commandBuffer, std::vector<SpawnInfo>& spawnInfos)
+{
+    std::sort(spawnInfos.begin(), spawnInfos.end(), [](SpawnInfo const& a, SpawnInfo const& b)
     {
-        return ENTITY_ID_INVALID;
+        return std::less<EntityDef const*>()(a.m_def, b.m_def);
+    });
+
+    DeferredEntityID first;
+    int runBegin = 0;
+    while (runBegin < (int) spawnInfos.size())
+    {
+        EntityDef const* def = spawnInfos[runBegin].m_def;
+        ASSERT_OR_DIE(def != nullptr, "Null entity definition passed to SEntityFactory::SpawnEntities");
+
+        int runEnd = runBegin + 1;
+        while (runEnd < (int) spawnInfos.size() && spawnInfos[runEnd].m_def == def)
+        {
+            ++runEnd;
+        }
+
+        DeferredEntityID runFirst = commandBuffer.Instantiate(def->m_prefab, runEnd - runBegin);
+        if (runBegin == 0)
+        {
+            first = runFirst;
+        }
+        runBegin = runEnd;
     }
 
+    if (first.IsValid())
+    {
+        commandBuffer.OnEntitiesCreated(first, (int) spawnInfos.size(), [spawnInfos](EntityID const* entityIDs, int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                if (g_ecs->IsValid(entityIDs[i]))
+                {
+                    ApplySpawnInfo(entityIDs[i], spawnInfos[i]);
+                }
+            }
+        });
+    }
+    return first;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// The per spawn changes on top of the def's prefab
+//
+void SEntityFactory::ApplySpawnInfo(EntityID id, SpawnInfo const& spawnInfo)
+{
     if (CTransform* transform = g_ecs->GetComponent<CTransform>(id))
     {
         transform->m_pos = spawnInfo.m_spawnPos;
@@ -108,13 +173,13 @@ EntityID SEntityFactory::SpawnEntity(SpawnInfo const& spawnInfo)
     if (CCollision* collision = g_ecs->GetComponent<CCollision>(id))
     {
         collision->m_radius *= spawnInfo.m_spawnScale;
-		collision->m_offset *= spawnInfo.m_spawnScale;
+        collision->m_offset *= spawnInfo.m_spawnScale;
     }
 
     if (CRender* render = g_ecs->GetComponent<CRender>(id))
     {
         render->m_renderRadius *= spawnInfo.m_spawnScale;
-		render->m_tint = spawnInfo.m_spawnTint;
+        render->m_tint = spawnInfo.m_spawnTint;
     }
 
     CLifetime* lifetime = g_ecs->GetComponent<CLifetime>(id);
@@ -122,12 +187,9 @@ EntityID SEntityFactory::SpawnEntity(SpawnInfo const& spawnInfo)
     {
         lifetime = g_ecs->AddComponent<CLifetime>(id);
     }
-
     if (lifetime)
     {
-		lifetime->m_lifetime = spawnInfo.m_spawnLifetime;
+        lifetime->m_lifetime = spawnInfo.m_spawnLifetime;
         lifetime->m_lifetimeRemaining = spawnInfo.m_spawnLifetime;
-	}
-
-    return id;
+    }
 }
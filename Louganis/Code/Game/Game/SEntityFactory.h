@@ -1,6 +1,8 @@
 ﻿// Bradley Christensen - 2022-2025
 #pragma once
 #include "Engine/ECS/System.h"
+#include "Engine/ECS/EntityCommandBuffer.h"
+#include <vector>
 
 
 
@@ -21,6 +23,9 @@ public:
 
     static EntityID CreateEntityFromDef(EntityDef const* def);
 	static EntityID SpawnEntity(SpawnInfo const& spawnInfo); // Usage requires write all dependencies
+	static DeferredEntityID SpawnEntity(EntityCommandBuffer& commandBuffer, SpawnInfo const& spawnInfo); // Safe from any system
+	static DeferredEntityID SpawnEntities(EntityCommandBuffer& commandBuffer, std::vector<SpawnInfo>& spawnInfos); // Sorts spawnInfos by def, returns the first of spawnInfos.size() consecutive IDs
+	static void ApplySpawnInfo(EntityID id, SpawnInfo const& spawnInfo);
 
 private:
 
@@ -1,38 +1,37 @@
 ﻿// Bradley Christensen - 2022-2025
 #include "SFlowField.h"
 #include "CTransform.h"
+#include "CAIController.h"
 #include "SCWorld.h"
 #include "SCLoadChunks.h"
 #include "SCFlowField.h"
 #include "CPlayerController.h"
 #include "FlowFieldChunk.h"
+#include "FlowFieldUtils.h"
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Performance/ScopedTimer.h"
 #include "Engine/Debug/DevConsoleUtils.h"
 #include "Chunk.h"
+#include <algorithm>
 #include <cfloat>
-#include <queue>
-
-
-
-//----------------------------------------------------------------------------------------------------------------------
-IntVec2 neighborOffsets[4] = { IntVec2(1,  0),
-                               IntVec2(-1,  0),
-                               IntVec2(0,  1),
-                               IntVec2(0, -1) };
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
 void SFlowField::Startup()
 {
-    AddReadDependencies<CTransform, SCWorld, SCLoadChunks>();
+    AddReadDependencies<CTransform, CAIController, SCWorld, SCLoadChunks>();
     AddWriteDependencies<SCFlowField>();
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
+// Moving the goal, loading chunks, and changing a few tiles repair the existing field instead of regenerating it:
+//  - Chunk changes and solidity changes repair just the cells that depended on them (RepairDistanceField)
+//  - Goal moves within s_flowFieldMaxGoalDrift of the solved goal re-solve a small window around the goal (SolveGoalWindow)
+// Anything bigger regenerates the whole field.
+//
 void SFlowField::Run(SystemContext const& context)
 {
     Vec2 firstPlayerLocation;
@@ -49,32 +48,77 @@ void SFlowField::Run(SystemContext const& context)
     SCWorld& world = g_ecs->GetSingleton<SCWorld>();
     SCLoadChunks& scLoadChunks = g_ecs->GetSingleton<SCLoadChunks>();
     bool playerChangedCoords = world.GetPlayerChangedWorldCoordsThisFrame();
+    WorldCoords const& goal = world.m_lastKnownPlayerWorldCoords;
+
+    // Cells that might have depended on something that was removed or blocked
+    static std::vector<WorldCoords> raiseSeeds;
+    raiseSeeds.clear();
+
+    static std::vector<FlowFieldChunk*> createdChunks;
+    createdChunks.clear();
 
-    int chunksCreated = 0;
+    int numDestroyedChunks = 0;
     if (world.m_isWorldSeedDirty || playerChangedCoords || scLoadChunks.m_numLoadedChunksThisFrame > 0)
     {
-        DestroyStaleFlowFieldChunks(firstPlayerLocation);
-        chunksCreated = CreateMissingFlowFieldChunks(firstPlayerLocation);
+        numDestroyedChunks = DestroyStaleFlowFieldChunks(firstPlayerLocation, raiseSeeds);
+        CreateMissingFlowFieldChunks(firstPlayerLocation, createdChunks);
     }
 
-    bool needsGenerate = world.m_isWorldSeedDirty || playerChangedCoords || chunksCreated > 0;
-
     for (auto& it : flowField.m_activeFlowFieldChunks)
     {
-        FlowFieldChunk* flowFieldChunk = it.second;
+        FlowFieldChunk* flowFieldChunk = it.m_chunk;
 		Chunk* chunk = flowFieldChunk->GetChunk();
         if (chunk->m_solidnessChanged)
         {
-            needsGenerate = true;
-            break;
+            flowFieldChunk->UpdateChangedTiles(raiseSeeds);
         }
 	}
 
+    IntVec2 goalDrift = goal.GetGlobalTileCoords() - flowField.m_solvedGoal.GetGlobalTileCoords();
+    bool needsGenerate = world.m_isWorldSeedDirty || !flowField.m_solvedGoal.IsValid() || !flowField.GetActiveChunk(flowField.m_solvedGoal.m_chunkCoords);
+    needsGenerate = needsGenerate || MathUtils::Abs(goalDrift.x) > StaticWorldSettings::s_flowFieldMaxGoalDrift || MathUtils::Abs(goalDrift.y) > StaticWorldSettings::s_flowFieldMaxGoalDrift;
+
+    bool fieldChanged = needsGenerate;
+    if (!needsGenerate && (!raiseSeeds.empty() || !createdChunks.empty()))
+    {
+        needsGenerate = !RepairDistanceField(flowField, createdChunks, raiseSeeds);
+        fieldChanged = true;
+    }
+
     if (needsGenerate)
     {
         flowField.SoftReset();
-        GenerateFlow(flowField, world.m_lastKnownPlayerWorldCoords);
+        GenerateFlow(flowField, goal);
+    }
+
+    if (fieldChanged || playerChangedCoords)
+    {
+        if (goal == flowField.m_solvedGoal)
+        {
+            flowField.ClearGoalWindow();
+        }
+        else
+        {
+            SolveGoalWindow(flowField, goal);
+        }
+    }
+
+    // Keep the fields towards other targets solved while any AI is following them. AI next to each other usually share
+    // a target, so skip repeats of the last key.
+    auto& aiStorage = g_ecs->GetSparseSetStorage<CAIController>();
+    FlowFieldKey lastRequestedKey;
+    for (auto it = g_ecs->Iterate<CAIController>(context); it.IsValid(); ++it)
+    {
+        FlowFieldKey const& key = aiStorage.Get(it)->m_flowFieldKey;
+        if (key.m_target != FlowFieldTarget::Player && key != lastRequestedKey)
+        {
+            scFlowField.m_targetFlowFields.Request(key);
+            lastRequestedKey = key;
+        }
     }
+
+    bool hasWorldChanged = world.m_isWorldSeedDirty || numDestroyedChunks > 0 || !createdChunks.empty() || !raiseSeeds.empty();
+    scFlowField.m_targetFlowFields.Update(flowField, hasWorldChanged);
 }
 
 
@@ -86,12 +130,13 @@ void SFlowField::Shutdown()
     FlowField& flowField = scFlowField.m_toPlayerFlowField;
 
     flowField.HardReset();
+    scFlowField.m_targetFlowFields.Clear();
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-int SFlowField::CreateMissingFlowFieldChunks(Vec2 const& anchorLocation)
+int SFlowField::CreateMissingFlowFieldChunks(Vec2 const& anchorLocation, std::vector<FlowFieldChunk*>& out_createdChunks)
 {
     SCFlowField& scFlowField = g_ecs->GetSingleton<SCFlowField>();
     SCWorld& world = g_ecs->GetSingleton<SCWorld>();
@@ -100,7 +145,7 @@ int SFlowField::CreateMissingFlowFieldChunks(Vec2 const& anchorLocation)
     int numCreated = 0;
 
     AABB2 flowFieldBounds = AABB2(anchorLocation - Vec2(StaticWorldSettings::s_flowFieldGenerationRadius, StaticWorldSettings::s_flowFieldGenerationRadius), anchorLocation + Vec2(StaticWorldSettings::s_flowFieldGenerationRadius, StaticWorldSettings::s_flowFieldGenerationRadius));
-    world.ForEachChunkOverlappingAABB(flowFieldBounds, [&flowField, &world, &numCreated, &anchorLocation](Chunk& chunk)
+    world.ForEachChunkOverlappingAABB(flowFieldBounds, [&flowField, &world, &numCreated, &anchorLocation, &out_createdChunks](Chunk& chunk)
     {
         FlowFieldChunk* flowFieldChunk = flowField.GetActiveChunk(chunk.m_chunkCoords);
         if (!flowFieldChunk)
@@ -111,7 +156,8 @@ int SFlowField::CreateMissingFlowFieldChunks(Vec2 const& anchorLocation)
             {
                 flowFieldChunk = new FlowFieldChunk(&chunk, &world);
                 flowFieldChunk->GenerateCostField();
-                flowField.m_activeFlowFieldChunks.emplace(chunk.m_chunkCoords, flowFieldChunk);
+                flowField.m_activeFlowFieldChunks.Insert(chunk.m_chunkCoords, flowFieldChunk);
+                out_createdChunks.push_back(flowFieldChunk);
                 numCreated++;
             }
         }
@@ -123,7 +169,7 @@ int SFlowField::CreateMissingFlowFieldChunks(Vec2 const& anchorLocation)
 
 
 //----------------------------------------------------------------------------------------------------------------------
-int SFlowField::DestroyStaleFlowFieldChunks(Vec2 const& anchorLocation)
+int SFlowField::DestroyStaleFlowFieldChunks(Vec2 const& anchorLocation, std::vector<WorldCoords>& out_raiseSeeds)
 {
     SCFlowField& scFlowField = g_ecs->GetSingleton<SCFlowField>();
     SCWorld& world = g_ecs->GetSingleton<SCWorld>();
@@ -132,11 +178,11 @@ int SFlowField::DestroyStaleFlowFieldChunks(Vec2 const& anchorLocation)
     // Destroy flow field chunks that no longer have a valid chunk
     static std::vector<IntVec2> coordsToRemove;
     coordsToRemove.clear();
-    coordsToRemove.reserve(flowField.m_activeFlowFieldChunks.size());
+    coordsToRemove.reserve(flowField.m_activeFlowFieldChunks.Size());
 
-    for (auto it : flowField.m_activeFlowFieldChunks)
+    for (auto const& it : flowField.m_activeFlowFieldChunks)
     {
-        FlowFieldChunk*& flowFieldChunk = it.second;
+        FlowFieldChunk* flowFieldChunk = it.m_chunk;
         if (!world.GetActiveChunk(flowFieldChunk->GetChunkCoords()))
         {
             coordsToRemove.push_back(flowFieldChunk->GetChunkCoords());
@@ -151,12 +197,37 @@ int SFlowField::DestroyStaleFlowFieldChunks(Vec2 const& anchorLocation)
             }
         }
     }
+    // Cells just outside a destroyed chunk might have been reached through it
+    for (IntVec2 const& coords : coordsToRemove)
+    {
+        FlowFieldChunk* flowChunk = flowField.GetActiveChunk(coords);
+        for (int index = 0; index < StaticWorldSettings::s_numTilesInChunk; ++index)
+        {
+            WorldCoords edgeCoords(coords, flowChunk->m_distanceField.GetCoordsForIndex(index));
+            float edgeDistance = flowChunk->m_distanceField.Get(index);
+            if (!flowChunk->m_distanceField.IsOnEdge(edgeCoords.m_localTileCoords) || edgeDistance >= MAX_DISTANCE)
+            {
+                continue;
+            }
+
+            for (IntVec2 const& neighborOffset : FlowFieldUtils::s_neighborOffsets)
+            {
+                WorldCoords neighborCoords = world.GetWorldCoordsAtOffset(edgeCoords, neighborOffset);
+                bool isNeighborRemoved = std::find(coordsToRemove.begin(), coordsToRemove.end(), neighborCoords.m_chunkCoords) != coordsToRemove.end();
+                FlowFieldChunk* neighborChunk = isNeighborRemoved ? nullptr : flowField.GetActiveChunk(neighborCoords.m_chunkCoords);
+                if (neighborChunk && neighborChunk->m_distanceField.Get(neighborCoords.m_localTileCoords) > edgeDistance)
+                {
+                    out_raiseSeeds.push_back(neighborCoords);
+                }
+            }
+        }
+    }
+
     for (IntVec2 const& coords : coordsToRemove)
     {
-        FlowFieldChunk*& flowChunk = flowField.m_activeFlowFieldChunks[coords];
+        FlowFieldChunk* flowChunk = flowField.m_activeFlowFieldChunks.Erase(coords);
         flowChunk->HardReset();
         delete flowChunk;
-        flowField.m_activeFlowFieldChunks.erase(coords);
     }
 
     return static_cast<int>(coordsToRemove.size());
@@ -175,26 +246,24 @@ void SFlowField::GenerateFlow(FlowField& flowField, WorldCoords const& destinati
         DevConsoleUtils::LogError("Failed to seed flow field");
     }
 
-    flowField.m_openList.emplace(destination, 0.f);
+    flowField.PushOpenList(destination, 0.f);
     GenerateDistanceField(flowField);
-
-    flowField.m_openList.emplace(destination, 0.f);
     GenerateGradient(flowField);
+
+    flowField.m_solvedGoal = destination;
 }
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
-void SFlowField::GenerateDistanceField(FlowField& flowField)
+void SFlowField::GenerateDistanceField(FlowField& flowField, std::vector<WorldCoords>* out_solvedCells /*= nullptr*/)
 {
     //ScopedTimer timer("- Generate Distance Field");
     SCWorld& world = g_ecs->GetSingleton<SCWorld>();
 
-    while (!flowField.m_openList.empty())
+    FlowGenerationCoords flowGenCoords(WorldCoords::s_invalidWorldCoords, 0.f);
+    while (flowField.PopOpenList(flowGenCoords))
     {
-        FlowGenerationCoords flowGenCoords = flowField.m_openList.top();
-        flowField.m_openList.pop();
-
         IntVec2 const& currentChunkCoords = flowGenCoords.m_chunkCoords;
         IntVec2 const& currentLocalTileCoords = flowGenCoords.m_localTileCoords;
 
@@ -215,11 +284,15 @@ void SFlowField::GenerateDistanceField(FlowField& flowField)
             continue;
         }
         currentChunk->m_consideredCells.Set(currentIndex);
+        if (out_solvedCells)
+        {
+            out_solvedCells->push_back(flowGenCoords);
+        }
 
-        for (IntVec2 const& neighborOffset : neighborOffsets)
+        for (IntVec2 const& neighborOffset : FlowFieldUtils::s_neighborOffsets)
         {
             WorldCoords neighborWorldCoords = world.GetWorldCoordsAtOffset(flowGenCoords, neighborOffset);
-            FlowFieldChunk* neighborChunk = flowField.GetActiveChunk(neighborWorldCoords.m_chunkCoords);
+            FlowFieldChunk* neighborChunk = flowField.GetActiveNeighborChunk(currentChunk, currentChunkCoords, neighborWorldCoords.m_chunkCoords);
             if (!neighborChunk)
             {
                 continue;
@@ -240,10 +313,10 @@ void SFlowField::GenerateDistanceField(FlowField& flowField)
             float dy = FLT_MAX; // dy = min( neighborNorthDistance, neighborSouthDistance );
 
             // nofn = neighbor of neighbor
-            for (IntVec2 const& nofnOffset : neighborOffsets)
+            for (IntVec2 const& nofnOffset : FlowFieldUtils::s_neighborOffsets)
             {
                 WorldCoords nofnWorldCoords = world.GetWorldCoordsAtOffset(neighborWorldCoords, nofnOffset);
-                FlowFieldChunk* nofnChunk = flowField.GetActiveChunk(nofnWorldCoords.m_chunkCoords);
+                FlowFieldChunk* nofnChunk = flowField.GetActiveNeighborChunk(neighborChunk, neighborWorldCoords.m_chunkCoords, nofnWorldCoords.m_chunkCoords);
                 if (!nofnChunk)
                 {
                     continue;
@@ -263,103 +336,345 @@ void SFlowField::GenerateDistanceField(FlowField& flowField)
                 }
             }
 
-            // Delta = 2 * neighborCost - (dx-dy)^2;
-            // if Delta >= 0
-            //     D(j) = (dx + dy + sqrt(Delta)) / 2;
-            // else
-            //     D(j) = min(dx + W(j), dy + W(j));
-            // end
-
-            float delta = 2 * neighborCost - MathUtils::PowF(dx - dy, 2);
-            float calculatedNeighborDistance;
-            if (delta >= 0)
-            {
-                calculatedNeighborDistance = (dx + dy + MathUtils::SqrtF(delta)) / 2.f;
-            }
-            else
-            {
-                calculatedNeighborDistance = MathUtils::Min(dx + neighborCost, dy + neighborCost);
-            }
+            float calculatedNeighborDistance = FlowFieldUtils::SolveEikonal(dx, dy, neighborCost);
 
             if (calculatedNeighborDistance < neighborChunk->m_distanceField.Get(neighborWorldCoords.m_localTileCoords))
             {
                 neighborChunk->m_distanceField.Set(neighborWorldCoords.m_localTileCoords, calculatedNeighborDistance);
-                flowField.m_openList.push({ neighborWorldCoords.m_chunkCoords, neighborWorldCoords.m_localTileCoords, calculatedNeighborDistance });
+                flowField.PushOpenList(neighborWorldCoords, calculatedNeighborDistance);
             }
         }
     }
 }
 
+
+
+//----------------------------------------------------------------------------------------------------------------------
 void SFlowField::GenerateGradient(FlowField& flowField)
 {
     //ScopedTimer timer("- Generate Gradient");
+
+    // A cell's gradient only depends on its neighbors' final distances, so this doesn't need to go in distance order
+    for (auto& it : flowField.m_activeFlowFieldChunks)
+    {
+        FlowFieldChunk* chunk = it.m_chunk;
+        for (int index = 0; index < StaticWorldSettings::s_numTilesInChunk; ++index)
+        {
+            UpdateGradientAt(flowField, WorldCoords(chunk->GetChunkCoords(), chunk->m_gradient.GetCoordsForIndex(index)));
+        }
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Gradient for a single cell, for repairs that only touch part of the field
+//
+void SFlowField::UpdateGradientAt(FlowField& flowField, WorldCoords const& worldCoords)
+{
     SCWorld& world = g_ecs->GetSingleton<SCWorld>();
 
-    flowField.ResetConsideredCells();
+    FlowFieldChunk* chunk = flowField.GetActiveChunk(worldCoords.m_chunkCoords);
+    if (!chunk)
+    {
+        return;
+    }
 
-    while (!flowField.m_openList.empty())
+    float currentTileDistance = chunk->m_distanceField.Get(worldCoords.m_localTileCoords);
+    if (chunk->IsTileSolid(worldCoords.m_localTileCoords) || currentTileDistance >= MAX_DISTANCE)
     {
-        FlowGenerationCoords currentWorldCoords = flowField.m_openList.top();
-        flowField.m_openList.pop();
+        chunk->m_gradient.Set(worldCoords.m_localTileCoords, Vec2::ZeroVector);
+        return;
+    }
 
-        FlowFieldChunk* currentChunk = flowField.GetActiveChunk(currentWorldCoords.m_chunkCoords);
-        if (!currentChunk)
+    bool hasNeighbor[4] = { false, false, false, false };
+    float neighborDistances[4];
+    bool isNeighborSolid[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        WorldCoords neighborWorldCoords = world.GetWorldCoordsAtOffset(worldCoords, FlowFieldUtils::s_neighborOffsets[i]);
+        FlowFieldChunk* neighborChunk = flowField.GetActiveNeighborChunk(chunk, worldCoords.m_chunkCoords, neighborWorldCoords.m_chunkCoords);
+        if (neighborChunk)
         {
-            continue;
+            hasNeighbor[i] = true;
+            neighborDistances[i] = neighborChunk->m_distanceField.Get(neighborWorldCoords.m_localTileCoords);
+            isNeighborSolid[i] = neighborChunk->IsTileSolid(neighborWorldCoords.m_localTileCoords);
         }
+    }
 
-        int currentIndex = currentChunk->m_gradient.GetIndexForCoords(currentWorldCoords.m_localTileCoords);
+    chunk->m_gradient.Set(worldCoords.m_localTileCoords, FlowFieldUtils::CalculateGradient(currentTileDistance, hasNeighbor, neighborDistances, isNeighborSolid));
+}
 
-        if (currentChunk->m_consideredCells.Get(currentIndex))
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Lifelong repair of the distance field after tiles changed or chunks came and went, without moving the goal.
+//
+// Every cell whose distance could have come through a raise seed has a larger distance than it, so sweeping out along
+// increasing distances from the seeds finds all of them (and maybe a few extra, which is fine). Those get invalidated,
+// then fast marching re-solves them from the valid cells around them, which also lowers any cells that a new chunk or
+// an opened up tile gave a shorter path. Created chunks start fully invalid.
+//
+// Returns false if the repair would touch more than s_flowFieldMaxRepairedTiles, in which case a full regenerate is
+// about as fast and the field is left untouched.
+//
+bool SFlowField::RepairDistanceField(FlowField& flowField, std::vector<FlowFieldChunk*> const& createdChunks, std::vector<WorldCoords> const& raiseSeeds)
+{
+    SCWorld& world = g_ecs->GetSingleton<SCWorld>();
+
+    static std::vector<WorldCoords> invalidatedCells;
+    static std::vector<WorldCoords> sweepStack;
+    static std::vector<WorldCoords> solvedCells;
+    invalidatedCells.clear();
+    sweepStack.clear();
+    solvedCells.clear();
+
+    // Sweep out the cells that might depend on the seeds, using the considered cells as the visited set
+    flowField.ResetConsideredCells();
+    for (WorldCoords const& seed : raiseSeeds)
+    {
+        FlowFieldChunk* seedChunk = flowField.GetActiveChunk(seed.m_chunkCoords);
+        if (!seedChunk)
         {
             continue;
         }
-        if (currentChunk->IsTileSolid(currentWorldCoords.m_localTileCoords))
+        int seedIndex = seedChunk->m_distanceField.GetIndexForCoords(seed.m_localTileCoords);
+        if (!seedChunk->m_consideredCells.Get(seedIndex))
         {
-            continue;
+            seedChunk->m_consideredCells.Set(seedIndex);
+            sweepStack.push_back(seed);
         }
-        currentChunk->m_consideredCells.Set(currentIndex);
+    }
+
+    while (!sweepStack.empty())
+    {
+        WorldCoords currentCoords = sweepStack.back();
+        sweepStack.pop_back();
+        if (currentCoords == flowField.m_solvedGoal || (int) invalidatedCells.size() >= StaticWorldSettings::s_flowFieldMaxRepairedTiles)
+        {
+            // Everything depends on the goal
+            return false;
+        }
+        invalidatedCells.push_back(currentCoords);
 
-        float currentTileDistance = currentChunk->m_distanceField.Get(currentWorldCoords.m_localTileCoords);
+        FlowFieldChunk* currentChunk = flowField.GetActiveChunk(currentCoords.m_chunkCoords);
+        float currentDistance = currentChunk->m_distanceField.Get(currentCoords.m_localTileCoords);
+        if (currentDistance >= MAX_DISTANCE)
+        {
+            continue;
+        }
 
-        Vec2 gradient = Vec2::ZeroVector;
-        for (IntVec2 const& neighborOffset : neighborOffsets)
+        for (IntVec2 const& neighborOffset : FlowFieldUtils::s_neighborOffsets)
         {
-            WorldCoords neighborWorldCoords = world.GetWorldCoordsAtOffset(currentWorldCoords, neighborOffset);
-            FlowFieldChunk* neighborChunk = flowField.GetActiveChunk(neighborWorldCoords.m_chunkCoords);
-            if (!neighborChunk)
+            WorldCoords neighborCoords = world.GetWorldCoordsAtOffset(currentCoords, neighborOffset);
+            FlowFieldChunk* neighborChunk = flowField.GetActiveNeighborChunk(currentChunk, currentCoords.m_chunkCoords, neighborCoords.m_chunkCoords);
+            if (!neighborChunk || neighborChunk->IsTileSolid(neighborCoords.m_localTileCoords))
             {
                 continue;
             }
 
-            float currentNeighborDistance = (float) neighborChunk->m_distanceField.Get(neighborWorldCoords.m_localTileCoords);
-            float dDist = currentTileDistance - currentNeighborDistance;
+            int neighborIndex = neighborChunk->m_distanceField.GetIndexForCoords(neighborCoords.m_localTileCoords);
+            float neighborDistance = neighborChunk->m_distanceField.Get(neighborIndex);
+            if (neighborChunk->m_consideredCells.Get(neighborIndex) || neighborDistance <= currentDistance || neighborDistance >= MAX_DISTANCE)
+            {
+                continue;
+            }
+            neighborChunk->m_consideredCells.Set(neighborIndex);
+            sweepStack.push_back(neighborCoords);
+        }
+    }
+
+    for (WorldCoords const& cell : invalidatedCells)
+    {
+        flowField.GetActiveChunk(cell.m_chunkCoords)->SetDistanceFieldAt(cell.m_localTileCoords, MAX_DISTANCE);
+    }
 
-            if (neighborChunk->IsTileSolid(neighborWorldCoords.m_localTileCoords))
+    // Re-solve from the valid cells bordering the invalidated ones and the created chunks
+    flowField.ResetConsideredCells();
+    auto pushValidNeighbors = [&flowField, &world](WorldCoords const& cell)
+    {
+        for (IntVec2 const& neighborOffset : FlowFieldUtils::s_neighborOffsets)
+        {
+            WorldCoords neighborCoords = world.GetWorldCoordsAtOffset(cell, neighborOffset);
+            FlowFieldChunk* neighborChunk = flowField.GetActiveChunk(neighborCoords.m_chunkCoords);
+            if (!neighborChunk || neighborChunk->IsTileSolid(neighborCoords.m_localTileCoords))
+            {
+                continue;
+            }
+            float neighborDistance = neighborChunk->m_distanceField.Get(neighborCoords.m_localTileCoords);
+            if (neighborDistance < MAX_DISTANCE)
+            {
+                flowField.PushOpenList(neighborCoords, neighborDistance);
+            }
+        }
+    };
+
+    for (WorldCoords const& cell : invalidatedCells)
+    {
+        pushValidNeighbors(cell);
+    }
+    for (FlowFieldChunk* createdChunk : createdChunks)
+    {
+        for (int index = 0; index < StaticWorldSettings::s_numTilesInChunk; ++index)
+        {
+            IntVec2 localTileCoords = createdChunk->m_distanceField.GetCoordsForIndex(index);
+            if (createdChunk->m_distanceField.IsOnEdge(localTileCoords))
             {
-                // Always treat solid walls as being 0.5 distance away in that direction, so that flow always generates away from walls without skewing too much
-                // If we leave this as the actual distance, which is very large (999), then gradient will point away from walls too strongly
-                dDist = -0.5;
+                pushValidNeighbors(WorldCoords(createdChunk->GetChunkCoords(), localTileCoords));
             }
+        }
+    }
+
+    GenerateDistanceField(flowField, &solvedCells);
+
+    // Only cells whose distance changed, and their neighbors, can have a different gradient
+    auto updateGradientAround = [this, &flowField, &world](WorldCoords const& cell)
+    {
+        UpdateGradientAt(flowField, cell);
+        for (IntVec2 const& neighborOffset : FlowFieldUtils::s_neighborOffsets)
+        {
+            UpdateGradientAt(flowField, world.GetWorldCoordsAtOffset(cell, neighborOffset));
+        }
+    };
+
+    for (WorldCoords const& cell : invalidatedCells)
+    {
+        updateGradientAround(cell);
+    }
+    for (WorldCoords const& cell : solvedCells)
+    {
+        updateGradientAround(cell);
+    }
+    return true;
+}
+
+
 
-            if (neighborOffset.x != 0.f)
+//----------------------------------------------------------------------------------------------------------------------
+// Solves a small distance field around the goal, limited to the goal window. Used while the goal is close enough to
+// m_solvedGoal that the chunks still flow the right way everywhere outside the window.
+//
+void SFlowField::SolveGoalWindow(FlowField& flowField, WorldCoords const& goal)
+{
+    SCWorld& world = g_ecs->GetSingleton<SCWorld>();
+
+    int radius = StaticWorldSettings::s_flowFieldGoalWindowRadius;
+    IntVec2 goalGlobalTileCoords = goal.GetGlobalTileCoords();
+    flowField.ResetGoalWindow(goalGlobalTileCoords - IntVec2(radius, radius), 2 * radius + 1);
+
+    FlowFieldChunk* goalChunk = flowField.GetActiveChunk(goal.m_chunkCoords);
+    if (!goalChunk)
+    {
+        flowField.ClearGoalWindow();
+        return;
+    }
+
+    // Index of a cell in the window, or -1 if it's outside the window, not loaded, or solid
+    auto getWindowIndex = [&flowField](WorldCoords const& worldCoords, FlowFieldChunk*& out_chunk)
+    {
+        int windowIndex = flowField.GetGoalWindowIndex(worldCoords.GetGlobalTileCoords());
+        if (windowIndex == -1)
+        {
+            return -1;
+        }
+        out_chunk = flowField.GetActiveChunk(worldCoords.m_chunkCoords);
+        if (!out_chunk || out_chunk->IsTileSolid(worldCoords.m_localTileCoords))
+        {
+            return -1;
+        }
+        return windowIndex;
+    };
+
+    // The window tracks its own queued buckets, since its cells are also in the chunks' fields
+    int goalWindowIndex = flowField.GetGoalWindowIndex(goalGlobalTileCoords);
+    flowField.m_goalWindowDistances[goalWindowIndex] = 0.f;
+    flowField.m_openList.PushOrUpdate(FlowGenerationCoords(goal, 0.f), 0.f, flowField.m_goalWindowQueuedBuckets[goalWindowIndex]);
+    while (!flowField.m_openList.IsEmpty())
+    {
+        int bucket = 0;
+        FlowGenerationCoords currentCoords = flowField.m_openList.Pop(&bucket);
+
+        FlowFieldChunk* currentChunk = nullptr;
+        int currentIndex = getWindowIndex(currentCoords, currentChunk);
+        if (currentIndex == -1 || flowField.m_goalWindowQueuedBuckets[currentIndex] != bucket)
+        {
+            continue;
+        }
+        flowField.m_goalWindowQueuedBuckets[currentIndex] = BucketQueue<FlowGenerationCoords>::s_notQueued;
+        flowField.m_goalWindowConsideredCells[currentIndex] = 1;
+
+        for (IntVec2 const& neighborOffset : FlowFieldUtils::s_neighborOffsets)
+        {
+            WorldCoords neighborCoords = world.GetWorldCoordsAtOffset(currentCoords, neighborOffset);
+            FlowFieldChunk* neighborChunk = nullptr;
+            int neighborIndex = getWindowIndex(neighborCoords, neighborChunk);
+            if (neighborIndex == -1 || flowField.m_goalWindowConsideredCells[neighborIndex])
             {
-                gradient.x += dDist * MathUtils::Sign(neighborOffset.x);
+                continue;
             }
-            else
+
+            float dx = FLT_MAX;
+            float dy = FLT_MAX;
+            for (IntVec2 const& nofnOffset : FlowFieldUtils::s_neighborOffsets)
             {
-                gradient.y += dDist * MathUtils::Sign(neighborOffset.y);
+                FlowFieldChunk* nofnChunk = nullptr;
+                int nofnIndex = getWindowIndex(world.GetWorldCoordsAtOffset(neighborCoords, nofnOffset), nofnChunk);
+                if (nofnIndex == -1)
+                {
+                    continue;
+                }
+                float nofnDistance = flowField.m_goalWindowDistances[nofnIndex];
+                if (nofnOffset.x != 0 && dx > nofnDistance)
+                {
+                    dx = nofnDistance;
+                }
+                else if (nofnOffset.y != 0 && dy > nofnDistance)
+                {
+                    dy = nofnDistance;
+                }
             }
 
-            int neighborIndex = neighborChunk->m_gradient.GetIndexForCoords(neighborWorldCoords.m_localTileCoords);
-            if (neighborChunk->m_consideredCells.Get(neighborIndex) == false)
+            int neighborCost = (int) neighborChunk->m_costField.Get(neighborCoords.m_localTileCoords);
+            float calculatedNeighborDistance = FlowFieldUtils::SolveEikonal(dx, dy, neighborCost);
+            if (calculatedNeighborDistance < flowField.m_goalWindowDistances[neighborIndex])
             {
-                flowField.m_openList.push({ neighborWorldCoords.m_chunkCoords, neighborWorldCoords.m_localTileCoords, currentNeighborDistance });
+                flowField.m_goalWindowDistances[neighborIndex] = calculatedNeighborDistance;
+                flowField.m_openList.PushOrUpdate(FlowGenerationCoords(neighborCoords, calculatedNeighborDistance), calculatedNeighborDistance, flowField.m_goalWindowQueuedBuckets[neighborIndex]);
             }
         }
+    }
+
+    // Gradient, treating cells outside the window as missing
+    for (int y = 0; y < flowField.m_goalWindowWidth; ++y)
+    {
+        for (int x = 0; x < flowField.m_goalWindowWidth; ++x)
+        {
+            int windowIndex = y * flowField.m_goalWindowWidth + x;
+            float currentDistance = flowField.m_goalWindowDistances[windowIndex];
+            if (currentDistance >= MAX_DISTANCE)
+            {
+                continue;
+            }
 
-        gradient.Normalize();
+            WorldCoords currentCoords = world.GetWorldCoordsAtOffset(goal, flowField.m_goalWindowMins + IntVec2(x, y) - goalGlobalTileCoords);
+            bool hasNeighbor[4] = { false, false, false, false };
+            float neighborDistances[4];
+            bool isNeighborSolid[4];
+            for (int i = 0; i < 4; ++i)
+            {
+                WorldCoords neighborCoords = world.GetWorldCoordsAtOffset(currentCoords, FlowFieldUtils::s_neighborOffsets[i]);
+                int neighborIndex = flowField.GetGoalWindowIndex(neighborCoords.GetGlobalTileCoords());
+                FlowFieldChunk* neighborChunk = flowField.GetActiveChunk(neighborCoords.m_chunkCoords);
+                if (neighborIndex == -1 || !neighborChunk)
+                {
+                    continue;
+                }
+                hasNeighbor[i] = true;
+                neighborDistances[i] = flowField.m_goalWindowDistances[neighborIndex];
+                isNeighborSolid[i] = neighborChunk->IsTileSolid(neighborCoords.m_localTileCoords);
+            }
 
-        currentChunk->m_gradient.Set(currentWorldCoords.m_localTileCoords, gradient);
+            flowField.m_goalWindowGradient[windowIndex] = FlowFieldUtils::CalculateGradient(currentDistance, hasNeighbor, neighborDistances, isNeighborSolid);
+        }
     }
 }
@@ -1,6 +1,7 @@
 ﻿// Bradley Christensen - 2022-2025
 #pragma once
 #include "Engine/ECS/System.h"
+#include <vector>
 
 
 
@@ -21,12 +22,15 @@ public:
     void Startup() override;
     void Run(SystemContext const& context) override;
     void Shutdown() override;
-    int CreateMissingFlowFieldChunks(Vec2 const& anchorLocation);
-    int DestroyStaleFlowFieldChunks(Vec2 const& anchorLocation);
+    int CreateMissingFlowFieldChunks(Vec2 const& anchorLocation, std::vector<FlowFieldChunk*>& out_createdChunks);
+    int DestroyStaleFlowFieldChunks(Vec2 const& anchorLocation, std::vector<WorldCoords>& out_raiseSeeds);
 
 private:
     
     void GenerateFlow(FlowField& flowField, WorldCoords const& destination);
-    void GenerateDistanceField(FlowField& flowField);
+    void GenerateDistanceField(FlowField& flowField, std::vector<WorldCoords>* out_solvedCells = nullptr);
     void GenerateGradient(FlowField& flowField);
+    void UpdateGradientAt(FlowField& flowField, WorldCoords const& worldCoords);
+    bool RepairDistanceField(FlowField& flowField, std::vector<FlowFieldChunk*> const& createdChunks, std::vector<WorldCoords> const& raiseSeeds);
+    void SolveGoalWindow(FlowField& flowField, WorldCoords const& goal);
 };
@@ -16,12 +16,11 @@ void SHealth::Startup()
 //----------------------------------------------------------------------------------------------------------------------
 void SHealth::Run(SystemContext const& context)
 {
-	auto& healthStorage = g_ecs->GetArrayStorage<CHealth>();
+	auto& healthStorage = g_ecs->GetSparseSetStorage<CHealth>();
 
 	for (auto it = g_ecs->Iterate<CHealth>(context); it.IsValid(); ++it)
 	{
 		CHealth& health = healthStorage[it];
-
 		if (health.m_currentHealth <= 0.f)
 		{
 			// Pre-regen death check, read by Death system
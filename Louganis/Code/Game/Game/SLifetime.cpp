@@ -19,7 +19,7 @@ void SLifetime::Startup()
 void SLifetime::Run(SystemContext const& context)
 {
 	SCEntityFactory& entityFactory = g_ecs->GetSingleton<SCEntityFactory>();
-	auto& lifetimeStorage = g_ecs->GetArrayStorage<CLifetime>();
+	auto& lifetimeStorage = g_ecs->GetSparseSetStorage<CLifetime>();
 	auto& timeStorage = g_ecs->GetArrayStorage<CTime>();
 
 	BitMask timeBitMask = g_ecs->GetComponentBitMask<CTime>();
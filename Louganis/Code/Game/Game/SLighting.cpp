@@ -12,6 +12,201 @@
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Renderer/ConstantBuffer.h"
+#include "Engine/Multithreading/Job.h"
+#include "Engine/Multithreading/JobSystem.h"
+#include <thread>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// East, west, north, south, so the opposite direction is (direction ^ 1)
+//
+static IntVec2 const s_lightingNeighborOffsets[4] = { IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1) };
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Local coords of the tile at edgeIndex along the border of a chunk, on the side facing direction
+//
+IntVec2 GetBorderTileCoords(int direction, int edgeIndex)
+{
+    constexpr int lastTileInRow = StaticWorldSettings::s_numTilesInRow - 1;
+    switch (direction)
+    {
+        case 0:  return IntVec2(lastTileInRow, edgeIndex);
+        case 1:  return IntVec2(0, edgeIndex);
+        case 2:  return IntVec2(edgeIndex, lastTileInRow);
+        default: return IntVec2(edgeIndex, 0);
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Adds the chunk to this frame's propagation if it isn't already, queueing any tiles it already has dirty
+//
+int GetOrAddLightingChunk(SCLighting& scLighting, SCWorld const& scWorld, Chunk* chunk)
+{
+    auto it = scLighting.m_lightingChunkIndices.find(chunk);
+    if (it != scLighting.m_lightingChunkIndices.end())
+    {
+        return it->second;
+    }
+
+    int lightingChunkIndex = (int) scLighting.m_lightingChunks.size();
+    scLighting.m_lightingChunkIndices.emplace(chunk, lightingChunkIndex);
+    LightingChunk& lightingChunk = scLighting.m_lightingChunks.emplace_back();
+    lightingChunk.m_chunk = chunk;
+    for (int direction = 0; direction < 4; ++direction)
+    {
+        lightingChunk.m_neighbors[direction] = scWorld.GetActiveChunk(chunk->m_chunkCoords + s_lightingNeighborOffsets[direction]);
+    }
+
+    if (chunk->m_isLightingDirty)
+    {
+        for (int tileIndex = 0; tileIndex < chunk->m_tiles.Size(); ++tileIndex)
+        {
+            if (chunk->m_tiles.GetRef(tileIndex).IsLightingDirty())
+            {
+                lightingChunk.m_queue.push_back(tileIndex);
+            }
+        }
+    }
+    chunk->m_isLightingDirty = true;
+    return lightingChunkIndex;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Copies the neighbors' tiles along this chunk's borders. Done on the main thread between rounds, when no job is writing.
+//
+void CopyLightingBorderTiles(LightingChunk& lightingChunk)
+{
+    for (int direction = 0; direction < 4; ++direction)
+    {
+        Chunk const* neighbor = lightingChunk.m_neighbors[direction];
+        if (!neighbor)
+        {
+            continue;
+        }
+
+        int oppositeDirection = direction ^ 1;
+        for (int edgeIndex = 0; edgeIndex < StaticWorldSettings::s_numTilesInRow; ++edgeIndex)
+        {
+            lightingChunk.m_borderTiles[direction][edgeIndex] = neighbor->m_tiles.GetRef(GetBorderTileCoords(oppositeDirection, edgeIndex));
+        }
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Flood fills the chunk's queue until it is empty, then rebuilds its lightmap image. Only writes to this chunk.
+//
+void PropagateLightingInChunk(LightingChunk& lightingChunk)
+{
+    Chunk& chunk = *lightingChunk.m_chunk;
+    std::vector<int>& queue = lightingChunk.m_queue;
+    for (int queueIndex = 0; queueIndex < (int) queue.size(); ++queueIndex)
+    {
+        int tileIndex = queue[queueIndex];
+        IntVec2 localTileCoords = chunk.m_tiles.GetCoordsForIndex(tileIndex);
+        Tile& tile = chunk.m_tiles.GetRef(tileIndex);
+        tile.SetLightingDirty(false);
+        TileDef const& tileDef = *TileDef::GetTileDef(tile.m_id);
+
+        uint8_t currentIndoorLighting = tile.GetIndoorLighting();
+        uint8_t currentOutdoorLighting = tile.GetOutdoorLighting();
+
+        uint8_t correctOutdoorLighting = tile.IsOpaque() ? 0 : StaticWorldSettings::s_maxOutdoorLighting; // All tiles that are not Opaque get full outdoor light (for now)
+        uint8_t correctIndoorLighting = tileDef.m_indoorLight;
+
+        for (int direction = 0; direction < 4; ++direction)
+        {
+            IntVec2 neighborCoords = localTileCoords + s_lightingNeighborOffsets[direction];
+            Tile const* neighborTile = nullptr;
+            if (chunk.m_tiles.IsValidCoords(neighborCoords))
+            {
+                neighborTile = &chunk.m_tiles.GetRef(neighborCoords);
+            }
+            else if (lightingChunk.m_neighbors[direction])
+            {
+                int edgeIndex = (direction < 2) ? localTileCoords.y : localTileCoords.x;
+                neighborTile = &lightingChunk.m_borderTiles[direction][edgeIndex];
+            }
+            else
+            {
+                continue;
+            }
+
+            uint8_t neighborOutdoorLight = neighborTile->GetOutdoorLighting();
+            if (neighborOutdoorLight > correctOutdoorLighting + 1)
+            {
+                correctOutdoorLighting = neighborOutdoorLight - 1;
+            }
+            uint8_t neighborIndoorLight = neighborTile->GetIndoorLighting();
+            if (neighborIndoorLight > correctIndoorLighting + 1)
+            {
+                correctIndoorLighting = neighborIndoorLight - 1;
+            }
+        }
+
+        if (correctIndoorLighting == currentIndoorLighting && correctOutdoorLighting == currentOutdoorLighting)
+        {
+            continue;
+        }
+
+        tile.SetIndoorLighting(correctIndoorLighting);
+        tile.SetOutdoorLighting(correctOutdoorLighting);
+
+        for (int direction = 0; direction < 4; ++direction)
+        {
+            IntVec2 neighborCoords = localTileCoords + s_lightingNeighborOffsets[direction];
+            if (chunk.m_tiles.IsValidCoords(neighborCoords))
+            {
+                Tile& neighborTile = chunk.m_tiles.GetRef(neighborCoords);
+                if (!neighborTile.IsLightingDirty())
+                {
+                    neighborTile.SetLightingDirty(true);
+                    queue.push_back(chunk.m_tiles.GetIndexForCoords(neighborCoords));
+                }
+            }
+            else if (lightingChunk.m_neighbors[direction])
+            {
+                int edgeIndex = (direction < 2) ? localTileCoords.y : localTileCoords.x;
+                lightingChunk.m_outgoingBorderTiles.push_back(direction * StaticWorldSettings::s_numTilesInRow + edgeIndex);
+            }
+        }
+    }
+    queue.clear();
+
+    chunk.GenerateLightmapImage(lightingChunk.m_lightmapImage);
+    lightingChunk.m_hasLightmapImage = true;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Propagates a run of chunks for one round. Each chunk is in exactly one job, and reads its neighbors through the border copy.
+//
+class PropagateLightingJob : public Job
+{
+public:
+
+    PropagateLightingJob(LightingChunk* const* lightingChunks, int numLightingChunks) :
+        m_lightingChunks(lightingChunks, lightingChunks + numLightingChunks) {}
+
+    virtual void Execute() override
+    {
+        for (LightingChunk* lightingChunk : m_lightingChunks)
+        {
+            PropagateLightingInChunk(*lightingChunk);
+        }
+    }
+
+    std::vector<LightingChunk*> m_lightingChunks;
+};
 
 
 
@@ -25,6 +220,9 @@ void SLighting::Startup()
     scRender.m_lightingConstantsBuffer = g_renderer->MakeConstantBuffer(sizeof(LightingConstants));
 
 	DevConsoleUtils::AddDevConsoleCommand("ToggleLighting", &SLighting::ToggleLighting);
+
+    int numThreads = std::thread::hardware_concurrency() - 1;
+    m_maxNumPropagateJobs = MathUtils::Max(numThreads - 1, 1);
 }
 
 
@@ -38,8 +236,6 @@ void SLighting::Run(SystemContext const&)
 	SCCamera const& scCamera = g_ecs->GetSingleton<SCCamera>();
 	SCLighting& scLighting = g_ecs->GetSingleton<SCLighting>();
 
-    static IntVec2 neighborOffsets[4] = { IntVec2(1, 0), IntVec2(-1, 0), IntVec2(0, 1), IntVec2(0, -1) };
-
 	Rgba8 timeOfDayTint = scWorld.m_worldSettings.m_timeOfDayTints[(size_t) scTime.m_timeOfDay];
     TimeOfDay nextTimeOfDay = (TimeOfDay) MathUtils::IncrementIntInRange((int) scTime.m_timeOfDay, 0, (int) TimeOfDay::Count - 1, true);
 	Rgba8 nextTimeOfDayTint = scWorld.m_worldSettings.m_timeOfDayTints[(size_t) nextTimeOfDay];
@@ -58,108 +254,91 @@ void SLighting::Run(SystemContext const&)
 	AABB2 cameraBounds = scCamera.m_camera.GetTranslatedOrthoBounds2D();
     scWorld.ForEachChunkOverlappingAABB(cameraBounds, [&](Chunk& chunk)
     {
-        if (!chunk.m_isLightingDirty)
+        if (chunk.m_isLightingDirty)
         {
-            return true;
+            GetOrAddLightingChunk(scLighting, scWorld, &chunk);
         }
-
-        scLighting.m_dirtyChunks.insert(&chunk);
-
-        for (int tileIndex = 0; tileIndex < chunk.m_tiles.Size(); ++tileIndex)
-        {
-            Tile& tile = chunk.m_tiles.GetRef(tileIndex);
-            if (tile.IsLightingDirty())
-            {
-				scLighting.m_dirtyLightingTiles.insert(WorldCoords(chunk.m_chunkCoords, chunk.m_tiles.GetCoordsForIndex(tileIndex)));
-            }
-		}
         return true; // keep iterating
 	});
 
-	for (auto it = scLighting.m_dirtyLightingTiles.begin(); it != scLighting.m_dirtyLightingTiles.end();)
+    // Rounds run until no chunk has anything queued. Light crossing a border takes one round per chunk it enters.
+    std::vector<LightingChunk*> roundChunks;
+    std::vector<JobID> jobReceipts;
+    std::vector<int> outgoingBorderTiles;
+    while (true)
     {
-        WorldCoords worldCoords = *it;
-        it = scLighting.m_dirtyLightingTiles.erase(it);
-
-        Chunk* chunk = scWorld.GetActiveChunk(worldCoords);
-        if (!chunk)
+        roundChunks.clear();
+        for (LightingChunk& lightingChunk : scLighting.m_lightingChunks)
         {
-            continue;
+            if (!lightingChunk.m_queue.empty())
+            {
+                CopyLightingBorderTiles(lightingChunk);
+                roundChunks.push_back(&lightingChunk);
+            }
+        }
+        if (roundChunks.empty())
+        {
+            break;
         }
 
-		Tile& tile = chunk->m_tiles.GetRef(worldCoords.m_localTileCoords);
-        tile.SetLightingDirty(false);
-		TileDef const& tileDef = *TileDef::GetTileDef(tile.m_id);
-
-		uint8_t currentIndoorLighting = tile.GetIndoorLighting();
-		uint8_t currentOutdoorLighting = tile.GetOutdoorLighting();
-
-		uint8_t innateOutdoorLight = tile.IsOpaque() ? 0 : StaticWorldSettings::s_maxOutdoorLighting; // All tiles that are not Opaque get full outdoor light (for now)
-		uint8_t innateIndoorLight = tileDef.m_indoorLight;
-
-		uint8_t correctOutdoorLighting = innateOutdoorLight; // All tiles that are not Opaque get full outdoor light (for now)
-        uint8_t correctIndoorLighting = innateIndoorLight;
-
-        bool lightingChanged = false;
-        for (IntVec2 const& neighborOffset : neighborOffsets)
+        int numJobs = MathUtils::Min(m_maxNumPropagateJobs, (int) roundChunks.size());
+        if (numJobs <= 1)
         {
-			WorldCoords neighborCoords = scWorld.GetWorldCoordsAtOffset(worldCoords, neighborOffset);
-            Chunk* neighborChunk = scWorld.GetActiveChunk(neighborCoords);
-            if (!neighborChunk)
-            {
-                continue;
-			}
-			Tile& neighborTile = neighborChunk->m_tiles.GetRef(neighborCoords.m_localTileCoords);
-			uint8_t neighborOutdoorLight = neighborTile.GetOutdoorLighting();
-            if (neighborOutdoorLight > correctOutdoorLighting + 1)
+            for (LightingChunk* lightingChunk : roundChunks)
             {
-                correctOutdoorLighting = neighborOutdoorLight - 1;
-			}
-			uint8_t neighborIndoorLight = neighborTile.GetIndoorLighting();
-            if (neighborIndoorLight > correctIndoorLighting + 1)
-            {
-                correctIndoorLighting = neighborIndoorLight - 1;
+                PropagateLightingInChunk(*lightingChunk);
             }
         }
-
-        if (correctIndoorLighting != currentIndoorLighting)
+        else
         {
-			tile.SetIndoorLighting(correctIndoorLighting);
-            lightingChanged = true;
+            int numChunksPerJob = ((int) roundChunks.size() + numJobs - 1) / numJobs;
+            for (int runStartIndex = 0; runStartIndex < (int) roundChunks.size(); runStartIndex += numChunksPerJob)
+            {
+                int numChunksInRun = MathUtils::Min(numChunksPerJob, (int) roundChunks.size() - runStartIndex);
+                PropagateLightingJob* job = new PropagateLightingJob(roundChunks.data() + runStartIndex, numChunksInRun);
+                jobReceipts.push_back(g_jobSystem->PostJob(job));
+            }
+            g_jobSystem->CompleteJobs(jobReceipts);
         }
 
-        if (correctOutdoorLighting != currentOutdoorLighting)
-		{
-            tile.SetOutdoorLighting(correctOutdoorLighting);
-            lightingChanged = true;
-		}
-
-        if (lightingChanged)
+        // Border exchange, changed border tiles dirty the tile across the border in the neighbor chunk. Indices instead of
+        // pointers from here, adding neighbors can grow m_lightingChunks.
+        int numLightingChunks = (int) scLighting.m_lightingChunks.size();
+        for (int lightingChunkIndex = 0; lightingChunkIndex < numLightingChunks; ++lightingChunkIndex)
         {
-			scLighting.m_dirtyChunks.insert(chunk);
-
-            for (auto& neighborOffset : neighborOffsets)
+            outgoingBorderTiles.swap(scLighting.m_lightingChunks[lightingChunkIndex].m_outgoingBorderTiles);
+            for (int outgoingBorderTile : outgoingBorderTiles)
             {
-                WorldCoords neighborCoords = scWorld.GetWorldCoordsAtOffset(worldCoords, neighborOffset);
-                Chunk* neighborChunk = scWorld.GetActiveChunk(neighborCoords);
-                if (!neighborChunk)
+                int direction = outgoingBorderTile / StaticWorldSettings::s_numTilesInRow;
+                int edgeIndex = outgoingBorderTile % StaticWorldSettings::s_numTilesInRow;
+                Chunk* neighborChunk = scLighting.m_lightingChunks[lightingChunkIndex].m_neighbors[direction];
+                int neighborIndex = GetOrAddLightingChunk(scLighting, scWorld, neighborChunk);
+
+                IntVec2 neighborTileCoords = GetBorderTileCoords(direction ^ 1, edgeIndex);
+                Tile& neighborTile = neighborChunk->m_tiles.GetRef(neighborTileCoords);
+                if (!neighborTile.IsLightingDirty())
                 {
-                    continue;
+                    neighborTile.SetLightingDirty(true);
+                    scLighting.m_lightingChunks[neighborIndex].m_queue.push_back(neighborChunk->m_tiles.GetIndexForCoords(neighborTileCoords));
                 }
-                Tile& neighborTile = neighborChunk->m_tiles.GetRef(neighborCoords.m_localTileCoords);
-                neighborTile.SetLightingDirty(true);
-                neighborChunk->m_isLightingDirty = true;
-				scLighting.m_dirtyLightingTiles.insert(neighborCoords);
             }
+            outgoingBorderTiles.clear();
         }
-        it = scLighting.m_dirtyLightingTiles.begin();
     }
 
-    for (Chunk* dirtyChunk : scLighting.m_dirtyChunks)
+    for (LightingChunk& lightingChunk : scLighting.m_lightingChunks)
     {
-        dirtyChunk->GenerateLightmap();
-	}
-    scLighting.m_dirtyChunks.clear();
+        Chunk* chunk = lightingChunk.m_chunk;
+        if (!lightingChunk.m_hasLightmapImage)
+        {
+            // Dirty without any dirty tiles, still needs its first lightmap
+            chunk->GenerateLightmapImage(lightingChunk.m_lightmapImage);
+        }
+        chunk->UploadLightmap(lightingChunk.m_lightmapImage);
+        chunk->m_isLightingDirty = false;
+    }
+    scLighting.m_lightingChunks.clear();
+    scLighting.m_lightingChunkIndices.clear();
 }
 
 
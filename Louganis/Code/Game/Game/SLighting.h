@@ -22,4 +22,8 @@ public:
 public:
 
 	static bool ToggleLighting(NamedProperties& args);
+
+protected:
+
+	int m_maxNumPropagateJobs = 1;
 };
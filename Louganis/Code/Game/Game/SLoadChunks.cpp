@@ -6,18 +6,26 @@
 #include "CTransform.h"
 #include "EntityDef.h"
 #include "Chunk.h"
+#include "GenerateChunkJob.h"
 #include "SEntityFactory.h"
 #include "SCEntityFactory.h"
 #include "TileDef.h"
+#include "Engine/Assets/AssetManager.h"
 #include "Engine/Debug/DevConsole.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Multithreading/JobSystem.h"
 #include "Engine/Performance/ScopedTimer.h"
+#include "Engine/Renderer/Renderer.h"
+#include <cfloat>
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
 void SLoadChunks::Startup()
 {
-	AddWriteAllDependencies();
+	// Spawns go through the command buffer, so chunk loading doesn't need to lock the whole ECS
+	AddWriteDependencies<SCWorld, SCLoadChunks, Renderer, AssetManager>();
+	AddReadDependencies<CTransform, CPlayerController>();
 
 	TileDef::LoadFromXML();
 }
@@ -25,26 +33,78 @@ void SLoadChunks::Startup()
 
 
 //----------------------------------------------------------------------------------------------------------------------
+// Distance in chunks from the chunk's center to the closest player, FLT_MAX if there are no players
+//
+float GetChunkDistanceToClosestPlayer(SCWorld const& world, IntVec2 const& chunkCoords, std::vector<Vec2> const& playerPositions)
+{
+	Vec2 chunkCenter = world.CalculateChunkCenter(chunkCoords.x, chunkCoords.y);
+	float closestDistanceSquared = FLT_MAX;
+	for (Vec2 const& playerPos : playerPositions)
+	{
+		closestDistanceSquared = MathUtils::Min(closestDistanceSquared, chunkCenter.GetDistanceSquaredTo(playerPos));
+	}
+	return (closestDistanceSquared == FLT_MAX) ? FLT_MAX : MathUtils::SqrtF(closestDistanceSquared) / StaticWorldSettings::s_chunkWidth;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void CommitGeneratedChunk(SCWorld& world, GenerateChunkJob& job, EntityCommandBuffer& commandBuffer)
+{
+	Chunk* chunk = job.ReleaseChunk();
+	chunk->GenerateDebugVBO();
+	world.AddActiveChunk(chunk);
+
+	IntVec2 chunkCoords = job.m_chunkCoords;
+	int numSpawns = (int) job.m_spawnInfos.size();
+	DeferredEntityID firstSpawned = SEntityFactory::SpawnEntities(commandBuffer, job.m_spawnInfos);
+	if (numSpawns == 0)
+	{
+		return;
+	}
+
+	// Look the chunk up again at playback, it may have been unloaded by then
+	commandBuffer.OnEntitiesCreated(firstSpawned, numSpawns, [&world, chunkCoords](EntityID const* entityIDs, int count)
+	{
+		Chunk* chunk = world.GetActiveChunk(chunkCoords);
+		for (int i = 0; i < count; ++i)
+		{
+			if (!g_ecs->IsValid(entityIDs[i]))
+			{
+				continue;
+			}
+			if (chunk)
+			{
+				chunk->m_spawnedEntities.push_back(entityIDs[i]);
+			}
+			else g_ecs->DestroyEntity(entityIDs[i]);
+		}
+	});
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Chunks are generated by jobs on the job system, nearest first. Each frame, finished chunks are committed to the world
+// (up to s_maxNumChunksToLoadPerFrame), chunks nobody wants anymore are cancelled, and new jobs are posted.
+//
 void SLoadChunks::Run(SystemContext const& context)
 {
 	SCWorld& world = g_ecs->GetSingleton<SCWorld>();
 	SCLoadChunks& scLoadChunks = g_ecs->GetSingleton<SCLoadChunks>();
 	auto& transformStorage = g_ecs->GetArrayStorage<CTransform>();
+	EntityCommandBuffer& commandBuffer = context.GetCommandBuffer();
 
 	scLoadChunks.m_numLoadedChunksThisFrame = 0;
-	if (!world.m_isWorldSeedDirty && !(scLoadChunks.m_unloadedChunksInRadius || world.GetPlayerChangedWorldCoordsThisFrame()))
+	if (!world.m_isWorldSeedDirty && scLoadChunks.m_pendingChunks.IsEmpty() && !(scLoadChunks.m_unloadedChunksInRadius || world.GetPlayerChangedWorldCoordsThisFrame()))
 	{
 		// This loop needs to run if:
 		// A - chunk loading was completely finished
 		// B - player moved coords, so maybe we need to load more chunks
+		// C - chunks are still generating
 		return;
 	}
 
-	if (world.m_activeChunks.empty())
-	{
-		world.m_isWorldSeedDirty = false;
-	}
-
 	WorldSettings const& worldSettings = world.m_worldSettings;
 	float chunkLoadRadius = worldSettings.m_chunkLoadRadius;
 	float chunkUnloadRadius = worldSettings.m_chunkUnloadRadius;
@@ -53,38 +113,82 @@ void SLoadChunks::Run(SystemContext const& context)
 		g_devConsole->LogWarning("Chunk unload radius was smaller than the load radius, clamping to match");
 		chunkUnloadRadius = chunkLoadRadius;
 	}
+	float chunkUnloadRadiusInChunks = chunkUnloadRadius / StaticWorldSettings::s_chunkWidth;
+
+	static std::vector<Vec2> playerPositions;
+	playerPositions.clear();
+	for (auto it = g_ecs->Iterate<CTransform, CPlayerController>(context); it.IsValid(); ++it)
+	{
+		playerPositions.push_back(transformStorage.Get(it)->m_pos);
+	}
+
+	// Commit finished chunks, and throw away or cancel ones that are stale because of a new seed or that every player
+	// has moved away from. Gather first, the chunk directory can't be erased from while iterating it.
+	static std::vector<GenerateChunkJob*> pendingJobs;
+	pendingJobs.clear();
+	for (auto const& it : scLoadChunks.m_pendingChunks)
+	{
+		pendingJobs.push_back(it.m_chunk);
+	}
+
+	for (GenerateChunkJob* job : pendingJobs)
+	{
+		if (!job->m_isFinished)
+		{
+			job->m_isFinished = g_jobSystem->CompleteJob(job->m_jobID, false);
+		}
+
+		bool isStale = world.m_isWorldSeedDirty || GetChunkDistanceToClosestPlayer(world, job->m_chunkCoords, playerPositions) > chunkUnloadRadiusInChunks;
+		bool shouldCommit = job->m_isFinished && !isStale && scLoadChunks.m_numLoadedChunksThisFrame < StaticWorldSettings::s_maxNumChunksToLoadPerFrame;
+		bool shouldDiscard = isStale && (job->m_isFinished || g_jobSystem->TryCancelJob(job->m_jobID));
+		if (!shouldCommit && !shouldDiscard)
+		{
+			// Still generating, or over the commit limit for this frame
+			continue;
+		}
+
+		if (shouldCommit)
+		{
+			CommitGeneratedChunk(world, *job, commandBuffer);
+			scLoadChunks.m_numLoadedChunksThisFrame++;
+		}
+		scLoadChunks.m_pendingChunks.Erase(job->m_chunkCoords);
+		delete job;
+	}
 
-	// Shared storage to avoid extra allocations
-	std::vector<SpawnInfo> sharedEntitiesToSpawn;
-	sharedEntitiesToSpawn.reserve(100);
+	if (world.m_isWorldSeedDirty)
+	{
+		// Wait for the old world to be fully unloaded, and any jobs generating it to finish, before loading the new one
+		if (!world.m_activeChunks.IsEmpty() || !scLoadChunks.m_pendingChunks.IsEmpty())
+		{
+			return;
+		}
+		world.m_isWorldSeedDirty = false;
+	}
 
 	scLoadChunks.m_unloadedChunksInRadius = false;
-	for (auto it = g_ecs->Iterate<CTransform, CPlayerController>(context); it.IsValid(); ++it)
+	for (Vec2 const& playerPos : playerPositions)
 	{
-		CTransform& playerTransform = *transformStorage.Get(it);
+		world.ForEachChunkCoordsOverlappingCircle_InRadialOrder(playerPos, chunkLoadRadius, [&world, &scLoadChunks, &worldSettings, &playerPos](IntVec2 const& chunkCoords)
+		{
+			if (world.IsChunkLoaded(chunkCoords) || scLoadChunks.m_pendingChunks.Contains(chunkCoords))
+			{
+				return true;
+			}
 
- 		world.ForEachChunkCoordsOverlappingCircle_InRadialOrder(playerTransform.m_pos, chunkLoadRadius, [&world, &scLoadChunks, &sharedEntitiesToSpawn](IntVec2 const& chunkCoords)
-		{ 
-			bool shouldContinueLooping = true;
-			if (!world.IsChunkLoaded(chunkCoords) && !world.m_isWorldSeedDirty)
+			if (scLoadChunks.m_pendingChunks.Size() >= StaticWorldSettings::s_maxNumChunkGenerationJobs)
 			{
-				Chunk* chunk = world.LoadChunk(chunkCoords, sharedEntitiesToSpawn);
-				scLoadChunks.m_numLoadedChunksThisFrame++;
-				bool hitLimit = scLoadChunks.m_numLoadedChunksThisFrame >= StaticWorldSettings::s_maxNumChunksToLoadPerFrame;
-				scLoadChunks.m_unloadedChunksInRadius = hitLimit;
-				shouldContinueLooping = !hitLimit;
-
-				for (SpawnInfo const& spawnInfo : sharedEntitiesToSpawn)
-				{
-					EntityID spawnedEntity = SEntityFactory::SpawnEntity(spawnInfo);
-					if (spawnedEntity != ENTITY_ID_INVALID)
-					{
-						chunk->m_spawnedEntities.push_back(spawnedEntity);
-					}
-				}
-				sharedEntitiesToSpawn.clear();
+				scLoadChunks.m_unloadedChunksInRadius = true;
+				return false;
 			}
-			return shouldContinueLooping;
+
+			float distanceInChunks = world.CalculateChunkCenter(chunkCoords.x, chunkCoords.y).GetDistanceTo(playerPos) / StaticWorldSettings::s_chunkWidth;
+			int priority = StaticWorldSettings::s_chunkGenerationJobPriority + static_cast<int>(distanceInChunks);
+
+			GenerateChunkJob* job = new GenerateChunkJob(chunkCoords, worldSettings, &world.m_chunkDiskCache, priority);
+			scLoadChunks.m_pendingChunks.Insert(chunkCoords, job);
+			job->m_jobID = g_jobSystem->PostJob(job);
+			return true;
 		});
 	}
 }
@@ -94,5 +198,16 @@ void SLoadChunks::Run(SystemContext const& context)
 //----------------------------------------------------------------------------------------------------------------------
 void SLoadChunks::Shutdown()
 {
-
+	SCLoadChunks& scLoadChunks = g_ecs->GetSingleton<SCLoadChunks>();
+	for (auto const& it : scLoadChunks.m_pendingChunks)
+	{
+		GenerateChunkJob* job = it.m_chunk;
+		if (!job->m_isFinished && !g_jobSystem->TryCancelJob(job->m_jobID))
+		{
+			// Already running, wait for it so it isn't writing into a chunk we're about to delete
+			g_jobSystem->CompleteJob(job->m_jobID, true);
+		}
+		delete job;
+	}
+	scLoadChunks.m_pendingChunks.Clear();
 }
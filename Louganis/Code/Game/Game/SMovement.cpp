@@ -1,5 +1,6 @@
 ﻿// Bradley Christensen - 2022-2025
 #include "SMovement.h"
+#include "CAwake.h"
 #include "CMovement.h"
 #include "CTransform.h"
 #include "CDeath.h"
@@ -11,7 +12,7 @@
 void SMovement::Startup()
 {
     AddWriteDependencies<CMovement, CTransform>();
-    AddReadDependencies<CTime, CDeath>();
+    AddReadDependencies<CTime, CDeath, CAwake>();
 }
 
 
@@ -20,13 +21,13 @@ void SMovement::Startup()
 void SMovement::Run(SystemContext const& context)
 {
     auto& moveStorage = g_ecs->GetArrayStorage<CMovement>();
-    auto& deathStorage = g_ecs->GetArrayStorage<CDeath>();
+    auto& deathStorage = g_ecs->GetSparseSetStorage<CDeath>();
     auto& transformStorage = g_ecs->GetArrayStorage<CTransform>();
     auto& timeStorage = g_ecs->GetArrayStorage<CTime>();
 
 	BitMask deathBitMask = g_ecs->GetComponentBitMask<CDeath>();
 
-    for (auto it = g_ecs->Iterate<CMovement, CTransform, CTime>(context); it.IsValid(); ++it)
+    for (auto it = g_ecs->Iterate<CMovement, CTransform, CTime, CAwake>(context); it.IsValid(); ++it)
     {
         CMovement& move = moveStorage[it];
         if (g_ecs->DoesEntityHaveComponents(it.m_currentIndex, deathBitMask))
@@ -1,5 +1,6 @@
 // Bradley Christensen - 2022-2025
 #include "SPhysics.h"
+#include "CAwake.h"
 #include "CCollision.h"
 #include "CMovement.h"
 #include "CTransform.h"
@@ -11,6 +12,7 @@
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Debug/DevConsoleUtils.h"
 #include <thread>
+#include <vector>
 
 
 
@@ -19,16 +21,29 @@ void SPhysics::Startup()
 {
     AddWriteDependencies<CMovement, CTransform>();
     AddWriteDependencies<Renderer>();
-    AddReadDependencies<CCollision, SCDebug, SCWorld>();
+    AddReadDependencies<CCollision, CAwake, SCDebug, SCWorld>();
 
 	DevConsoleUtils::AddDevConsoleCommand("DebugRenderPreventativePhysics", &SPhysics::DebugRenderPreventativePhysics);
 
     int numThreads = std::thread::hardware_concurrency() - 1;
     m_systemSplittingNumJobs = numThreads - 1;
+    SetSystemSplittingGroup<CMovement, CTransform, CCollision, CAwake>();
 }
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// An entity that still has movement left to resolve this frame
+//
+struct MovingBody
+{
+    int m_entityIndex = 0;
+    Vec2 m_collisionPos;
+    Vec2 m_originalFrameMovement;
+};
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void SPhysics::Run(SystemContext const& context)
 {
@@ -38,7 +53,12 @@ void SPhysics::Run(SystemContext const& context)
     SCWorld const& scWorld = g_ecs->GetSingleton<SCWorld>();
     SCDebug const& scDebug = g_ecs->GetSingleton<SCDebug>();
 
-    for (auto it = g_ecs->Iterate<CMovement, CTransform, CCollision>(context); it.IsValid(); ++it)
+    // Locals instead of members, system splitting runs this on several threads at once
+    std::vector<MovingBody> bodies;
+    std::vector<WorldDiscCast> discCasts;
+    std::vector<WorldDiscCastResult> results;
+
+    for (auto it = g_ecs->Iterate<CMovement, CTransform, CCollision, CAwake>(context); it.IsValid(); ++it)
     {
         CCollision const& collision = collisionStorage[it];
         CMovement& move = moveStorage[it];
@@ -50,26 +70,47 @@ void SPhysics::Run(SystemContext const& context)
             continue;
 		}
 
-        const float& radius = collision.m_radius;
-
-		Vec2 collisionPos = transform.m_pos + collision.m_offset;
-
-        // This is how much movement we want to do this frame, total
-        Vec2 originalFrameMovement = move.m_frameMovement;
-        Vec2& frameMovement = move.m_frameMovement;
+        if (!move.m_frameMovement.IsNearlyZero(0.000001f))
+        {
+            // Keep how much movement we want to do this frame, total
+            MovingBody& body = bodies.emplace_back();
+            body.m_entityIndex = it.m_currentIndex;
+            body.m_collisionPos = transform.m_pos + collision.m_offset;
+            body.m_originalFrameMovement = move.m_frameMovement;
+        }
+    }
 
-        constexpr int maxNumBounces = 3;
-        int numBounces = 0;
-        while (!frameMovement.IsNearlyZero(0.000001f) && numBounces < maxNumBounces)
+    // Each bounce casts every body that is still moving in one batch, then resolves the results
+    constexpr int maxNumBounces = 3;
+    for (int numBounces = 0; numBounces < maxNumBounces && !bodies.empty(); ++numBounces)
+    {
+        int numBodies = (int) bodies.size();
+        discCasts.resize(numBodies);
+        results.resize(numBodies);
+        for (int i = 0; i < numBodies; ++i)
         {
-            WorldDiscCast discCast;
-            discCast.m_start = collisionPos;
+            MovingBody const& body = bodies[i];
+            Vec2 const& frameMovement = moveStorage[body.m_entityIndex].m_frameMovement;
+
+            WorldDiscCast& discCast = discCasts[i];
+            discCast.m_start = body.m_collisionPos;
             discCast.m_direction = frameMovement.GetNormalized();
             discCast.m_maxDistance = frameMovement.GetLength();
-            discCast.m_discRadius = radius;
+            discCast.m_discRadius = collisionStorage[body.m_entityIndex].m_radius;
+        }
 
-            WorldDiscCastResult result;
-            result = DiscCast(scWorld, discCast);
+        DiscCastBatch(scWorld, discCasts.data(), results.data(), numBodies);
+
+        int numStillMoving = 0;
+        for (int i = 0; i < numBodies; ++i)
+        {
+            MovingBody& body = bodies[i];
+            WorldDiscCast const& discCast = discCasts[i];
+            WorldDiscCastResult const& result = results[i];
+            CCollision const& collision = collisionStorage[body.m_entityIndex];
+            CTransform& transform = transStorage[body.m_entityIndex];
+            Vec2& frameMovement = moveStorage[body.m_entityIndex].m_frameMovement;
+            Vec2& collisionPos = body.m_collisionPos;
 
             if (scDebug.m_debugRenderPreventativePhysics) 
             {
@@ -78,9 +119,9 @@ void SPhysics::Run(SystemContext const& context)
 
             if (result.m_immediateHit)
             {
-                GeometryUtils::PushDiscOutOfPoint2D(collisionPos, radius + scWorld.m_worldSettings.m_entityWallBuffer, result.m_hitLocation);
+                GeometryUtils::PushDiscOutOfPoint2D(collisionPos, collision.m_radius + scWorld.m_worldSettings.m_entityWallBuffer, result.m_hitLocation);
 				transform.m_pos = collisionPos - collision.m_offset;
-                break;
+                continue;
             }
             else if (result.m_blockingHit)
             {
@@ -89,9 +130,8 @@ void SPhysics::Run(SystemContext const& context)
 				transform.m_pos = collisionPos - collision.m_offset;
                 Vec2 lostMomentum = frameMovement.GetProjectedOntoNormal(result.m_hitNormal);
                 frameMovement -= lostMomentum;
-                numBounces++;
 
-                if (frameMovement.Dot(originalFrameMovement) < -0.001f)
+                if (frameMovement.Dot(body.m_originalFrameMovement) < -0.001f)
                 {
                     // Don't allow multiple bounces to change the direction we were originally going
                     frameMovement = Vec2::ZeroVector;
@@ -102,7 +142,13 @@ void SPhysics::Run(SystemContext const& context)
                 transform.m_pos = result.m_newDiscCenter;
                 frameMovement = Vec2::ZeroVector;
             }
+
+            if (!frameMovement.IsNearlyZero(0.000001f))
+            {
+                bodies[numStillMoving++] = body;
+            }
         }
+        bodies.resize(numStillMoving);
     }
 }
 
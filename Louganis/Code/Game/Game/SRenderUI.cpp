@@ -26,7 +26,7 @@ void SRenderUI::Startup()
 void SRenderUI::Run(SystemContext const& context)
 {
 	auto& renderStorage = g_ecs->GetArrayStorage<CRender>();
-	auto& healthStorage = g_ecs->GetArrayStorage<CHealth>();
+	auto& healthStorage = g_ecs->GetSparseSetStorage<CHealth>();
 	SCRender const& scRender = g_ecs->GetSingleton<SCRender>();
 
 	VertexBuffer& vbo = *g_renderer->GetVertexBuffer(scRender.m_uiVBO);
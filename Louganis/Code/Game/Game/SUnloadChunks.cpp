@@ -43,28 +43,34 @@ void SUnloadChunks::Run(SystemContext const& context)
 	float unloadRadius = world.GetChunkUnloadRadius();
 	float unloadRadiusSquared = unloadRadius * unloadRadius;
 
-	int numChunksUnloaded = 0;
-	for (auto chunkIt = world.m_activeChunks.begin(); chunkIt != world.m_activeChunks.end();)
+	// Gather first, the chunk directory can't be erased from while iterating it
+	static std::vector<Chunk*> chunksToUnload;
+	chunksToUnload.clear();
+	for (auto const& it : world.m_activeChunks)
 	{
-		Chunk* chunk = chunkIt->second;
-		IntVec2 const& chunkCoords = chunkIt->first;
+		IntVec2 const& chunkCoords = it.m_coords;
 		Vec2 chunkCenter = world.CalculateChunkCenter(chunkCoords.x, chunkCoords.y);
 
 		if (chunkCenter.GetDistanceSquaredTo(playerTransform.m_pos) > unloadRadiusSquared || world.m_isWorldSeedDirty)
 		{
-			chunkIt = world.m_activeChunks.erase(chunkIt);
-			entityFactory.m_entitiesToDestroy.insert(entityFactory.m_entitiesToDestroy.end(), chunk->m_spawnedEntities.begin(), chunk->m_spawnedEntities.end());
-			chunk->Destroy();
-			delete chunk;
-			numChunksUnloaded++;
+			chunksToUnload.push_back(it.m_chunk);
 		}
-		else
+	}
+
+	for (Chunk* chunk : chunksToUnload)
+	{
+		world.m_activeChunks.Erase(chunk->m_chunkCoords);
+		entityFactory.m_entitiesToDestroy.insert(entityFactory.m_entitiesToDestroy.end(), chunk->m_spawnedEntities.begin(), chunk->m_spawnedEntities.end());
+		if (chunk->m_hasUnsavedChanges)
 		{
-			chunkIt++;
+			// Written out on a loading job, keeping the spawn infos cached when it was generated
+			world.m_chunkDiskCache.SaveChunk(*chunk, world.m_worldSettings, nullptr);
 		}
+		chunk->Destroy();
+		delete chunk;
 	}
 
-	scLoadChunks.m_numUnloadedChunksThisFrame = numChunksUnloaded;
+	scLoadChunks.m_numUnloadedChunksThisFrame = (int) chunksToUnload.size();
 }
 
 
@@ -53,7 +53,7 @@ void SWorld::EndFrame()
 	SCWorld& world = g_ecs->GetSingleton<SCWorld>();
 	for (auto& it : world.m_activeChunks)
 	{
-		Chunk* chunk = it.second;
+		Chunk* chunk = it.m_chunk;
 		chunk->m_solidnessChanged = false;
 	}
 }
@@ -64,6 +64,15 @@ void SWorld::EndFrame()
 void SWorld::Shutdown()
 {
 	SCWorld& world = g_ecs->GetSingleton<SCWorld>();
+	for (auto& it : world.m_activeChunks)
+	{
+		Chunk* chunk = it.m_chunk;
+		if (chunk->m_hasUnsavedChanges)
+		{
+			world.m_chunkDiskCache.SaveChunk(*chunk, world.m_worldSettings, nullptr);
+		}
+	}
+	world.m_chunkDiskCache.Flush();
 	world.ClearActiveChunks();
 }
 
@@ -75,8 +84,10 @@ void SWorld::UpdateLastKnownPlayerLocation(SCWorld& world, Vec2 const& playerLoc
 	WorldCoords playerWorldCoords = world.GetWorldCoordsAtLocation(playerLocation);
 
 	world.m_playerChangedWorldCoordsThisFrame = false;
+	world.m_playerChangedChunkThisFrame = false;
 	if (playerWorldCoords != world.m_lastKnownPlayerWorldCoords || !world.m_lastKnownPlayerWorldCoords.IsValid())
 	{
+		world.m_playerChangedChunkThisFrame = !world.m_lastKnownPlayerWorldCoords.IsValid() || playerWorldCoords.m_chunkCoords != world.m_lastKnownPlayerWorldCoords.m_chunkCoords;
 		world.m_lastKnownPlayerWorldCoords = playerWorldCoords;
 		world.m_playerChangedWorldCoordsThisFrame = true;
 	}
@@ -33,28 +33,20 @@ void SWorldCollision::Run(SystemContext const&)
             return true; // keep iterating
         }
 
-		auto chunkCollisionDataIt = scCollision.m_chunkCollisionData.find(worldCoords.m_chunkCoords);
-        if (chunkCollisionDataIt == scCollision.m_chunkCollisionData.end())
-        {
-			return true; // keep iterating
-        }
-
-        ChunkCollisionData const& chunkCollisionData = chunkCollisionDataIt->second;
-        auto const& tileBuckets = chunkCollisionData.m_tileBuckets;
-
 		int tileIndex = chunk.m_tiles.GetIndexForCoords(worldCoords.m_localTileCoords);
-
-		auto tileBucketIt = tileBuckets.find(tileIndex);
-        if (tileBucketIt == tileBuckets.end())
+		int tileSlot = scCollision.GetTileSlot(worldCoords.m_chunkCoords, tileIndex);
+        if (tileSlot == -1)
         {
 			return true; // keep iterating
         }
 
-		EntityBucket const& tileBucket = tileBucketIt->second;
+		int numEntitiesInTile = scCollision.GetNumEntitiesInTileSlot(tileSlot);
+		int const* tileEntities = scCollision.GetEntitiesInTileSlot(tileSlot);
 		AABB2 tileBounds = scWorld.GetTileBounds(worldCoords);
         
-        for (EntityID const& entity : tileBucket)
+        for (int i = 0; i < numEntitiesInTile; ++i)
         {
+			int entity = tileEntities[i];
 			CCollision const& collision = collStorage[entity];
             CTransform& transform = transStorage[entity];
 
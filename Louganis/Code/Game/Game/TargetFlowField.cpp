@@ -0,0 +1,225 @@
+// Bradley Christensen - 2022-2025
+#include "TargetFlowField.h"
+#include "FlowField.h"
+#include "FlowFieldChunk.h"
+#include "FlowFieldUtils.h"
+#include "Engine/DataStructures/BucketQueue.h"
+#include <cfloat>
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+FlowFieldSnapshot::FlowFieldSnapshot(FlowField const& flowField, uint32_t version) : m_version(version)
+{
+	m_chunks.reserve(flowField.m_activeFlowFieldChunks.Size());
+	for (auto const& it : flowField.m_activeFlowFieldChunks)
+	{
+		FlowFieldChunk const* flowFieldChunk = it.m_chunk;
+
+		FlowFieldSnapshotChunk& snapshotChunk = m_chunks.emplace_back();
+		snapshotChunk.m_chunkCoords = it.m_coords;
+		snapshotChunk.m_index = (int) m_chunks.size() - 1;
+		snapshotChunk.m_costField = flowFieldChunk->m_costField;
+		snapshotChunk.m_solidCells = flowFieldChunk->m_solidCells;
+	}
+
+	for (FlowFieldSnapshotChunk& snapshotChunk : m_chunks)
+	{
+		m_chunkDirectory.Insert(snapshotChunk.m_chunkCoords, &snapshotChunk);
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+FlowFieldSnapshotChunk const* FlowFieldSnapshot::GetChunkAtGlobalTileCoords(IntVec2 const& globalTileCoords, int& out_tileIndex) const
+{
+	IntVec2 chunkCoords = IntVec2(globalTileCoords.x >> StaticWorldSettings::s_worldChunkSizePowerOfTwo, globalTileCoords.y >> StaticWorldSettings::s_worldChunkSizePowerOfTwo);
+	int localX = globalTileCoords.x & StaticWorldSettings::s_numTilesInRowMinusOne;
+	int localY = globalTileCoords.y & StaticWorldSettings::s_numTilesInRowMinusOne;
+	out_tileIndex = localY * StaticWorldSettings::s_numTilesInRow + localX;
+	return m_chunkDirectory.Find(chunkCoords);
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int FlowFieldSnapshot::GetNumChunks() const
+{
+	return (int) m_chunks.size();
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t FlowFieldSnapshot::GetMemoryUsage() const
+{
+	// The solid cells are inline in the chunk, the cost field's cells are on the heap
+	size_t memoryUsage = sizeof(FlowFieldSnapshot) + m_chunks.capacity() * sizeof(FlowFieldSnapshotChunk);
+	for (FlowFieldSnapshotChunk const& chunk : m_chunks)
+	{
+		memoryUsage += chunk.m_costField.m_data.capacity() * sizeof(uint8_t);
+	}
+	return memoryUsage;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+TargetFlowField::TargetFlowField(FlowFieldSnapshot const* snapshot, WorldCoords const& goal) : m_snapshot(snapshot), m_goal(goal)
+{
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Same fast marching and gradient as SFlowField, over the snapshot in global tile coords
+//
+void TargetFlowField::Solve()
+{
+	int numCells = m_snapshot->GetNumChunks() * StaticWorldSettings::s_numTilesInChunk;
+	m_distanceField.assign(numCells, MAX_DISTANCE);
+	m_gradient.assign(numCells, Vec2::ZeroVector);
+
+	// Cell index in the per chunk arrays, or -1 if it isn't in the snapshot or it's solid
+	auto getCellIndex = [this](IntVec2 const& globalTileCoords, FlowFieldSnapshotChunk const*& out_chunk, int& out_tileIndex)
+	{
+		out_chunk = m_snapshot->GetChunkAtGlobalTileCoords(globalTileCoords, out_tileIndex);
+		if (!out_chunk || out_chunk->m_solidCells.Get(out_tileIndex))
+		{
+			return -1;
+		}
+		return out_chunk->m_index * StaticWorldSettings::s_numTilesInChunk + out_tileIndex;
+	};
+
+	FlowFieldSnapshotChunk const* goalChunk = nullptr;
+	int goalTileIndex = 0;
+	IntVec2 goalGlobalTileCoords = m_goal.GetGlobalTileCoords();
+	int goalIndex = getCellIndex(goalGlobalTileCoords, goalChunk, goalTileIndex);
+	if (goalIndex == -1)
+	{
+		return;
+	}
+
+	// Open list of global tile coords, with the bucket each cell is queued in for decrease-key
+	std::vector<uint8_t> consideredCells(numCells, 0);
+	std::vector<int> queuedBuckets(numCells, BucketQueue<IntVec2>::s_notQueued);
+	BucketQueue<IntVec2> openList;
+	m_distanceField[goalIndex] = 0.f;
+	openList.PushOrUpdate(goalGlobalTileCoords, 0.f, queuedBuckets[goalIndex]);
+
+	while (!openList.IsEmpty())
+	{
+		int bucket = 0;
+		IntVec2 currentGlobalTileCoords = openList.Pop(&bucket);
+
+		FlowFieldSnapshotChunk const* currentChunk = nullptr;
+		int currentTileIndex = 0;
+		int currentIndex = getCellIndex(currentGlobalTileCoords, currentChunk, currentTileIndex);
+		if (currentIndex == -1 || queuedBuckets[currentIndex] != bucket)
+		{
+			continue;
+		}
+		queuedBuckets[currentIndex] = BucketQueue<IntVec2>::s_notQueued;
+		consideredCells[currentIndex] = 1;
+
+		for (IntVec2 const& neighborOffset : FlowFieldUtils::s_neighborOffsets)
+		{
+			IntVec2 neighborGlobalTileCoords = currentGlobalTileCoords + neighborOffset;
+			FlowFieldSnapshotChunk const* neighborChunk = nullptr;
+			int neighborTileIndex = 0;
+			int neighborIndex = getCellIndex(neighborGlobalTileCoords, neighborChunk, neighborTileIndex);
+			if (neighborIndex == -1 || consideredCells[neighborIndex])
+			{
+				continue;
+			}
+
+			float dx = FLT_MAX;
+			float dy = FLT_MAX;
+			for (IntVec2 const& nofnOffset : FlowFieldUtils::s_neighborOffsets)
+			{
+				FlowFieldSnapshotChunk const* nofnChunk = nullptr;
+				int nofnTileIndex = 0;
+				int nofnIndex = getCellIndex(neighborGlobalTileCoords + nofnOffset, nofnChunk, nofnTileIndex);
+				if (nofnIndex == -1)
+				{
+					continue;
+				}
+				float nofnDistance = m_distanceField[nofnIndex];
+				if (nofnOffset.x != 0 && dx > nofnDistance)
+				{
+					dx = nofnDistance;
+				}
+				else if (nofnOffset.y != 0 && dy > nofnDistance)
+				{
+					dy = nofnDistance;
+				}
+			}
+
+			int neighborCost = (int) neighborChunk->m_costField.Get(neighborTileIndex);
+			float calculatedNeighborDistance = FlowFieldUtils::SolveEikonal(dx, dy, neighborCost);
+			if (calculatedNeighborDistance < m_distanceField[neighborIndex])
+			{
+				m_distanceField[neighborIndex] = calculatedNeighborDistance;
+				openList.PushOrUpdate(neighborGlobalTileCoords, calculatedNeighborDistance, queuedBuckets[neighborIndex]);
+			}
+		}
+	}
+
+	for (FlowFieldSnapshotChunk const& chunk : m_snapshot->m_chunks)
+	{
+		IntVec2 chunkGlobalTileMins = chunk.m_chunkCoords * StaticWorldSettings::s_numTilesInRow;
+		for (int tileIndex = 0; tileIndex < StaticWorldSettings::s_numTilesInChunk; ++tileIndex)
+		{
+			int currentIndex = chunk.m_index * StaticWorldSettings::s_numTilesInChunk + tileIndex;
+			float currentDistance = m_distanceField[currentIndex];
+			if (currentDistance >= MAX_DISTANCE)
+			{
+				continue;
+			}
+
+			IntVec2 globalTileCoords = chunkGlobalTileMins + chunk.m_costField.GetCoordsForIndex(tileIndex);
+			bool hasNeighbor[4] = { false, false, false, false };
+			float neighborDistances[4];
+			bool isNeighborSolid[4];
+			for (int i = 0; i < 4; ++i)
+			{
+				int neighborTileIndex = 0;
+				FlowFieldSnapshotChunk const* neighborChunk = m_snapshot->GetChunkAtGlobalTileCoords(globalTileCoords + FlowFieldUtils::s_neighborOffsets[i], neighborTileIndex);
+				if (!neighborChunk)
+				{
+					continue;
+				}
+				hasNeighbor[i] = true;
+				neighborDistances[i] = m_distanceField[neighborChunk->m_index * StaticWorldSettings::s_numTilesInChunk + neighborTileIndex];
+				isNeighborSolid[i] = neighborChunk->m_solidCells.Get(neighborTileIndex);
+			}
+
+			m_gradient[currentIndex] = FlowFieldUtils::CalculateGradient(currentDistance, hasNeighbor, neighborDistances, isNeighborSolid);
+		}
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+Vec2 TargetFlowField::GetFlowAtWorldCoords(WorldCoords const& worldCoords) const
+{
+	int tileIndex = 0;
+	FlowFieldSnapshotChunk const* chunk = m_snapshot->GetChunkAtGlobalTileCoords(worldCoords.GetGlobalTileCoords(), tileIndex);
+	if (!chunk || m_gradient.empty())
+	{
+		return Vec2::ZeroVector;
+	}
+	return m_gradient[chunk->m_index * StaticWorldSettings::s_numTilesInChunk + tileIndex];
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+size_t TargetFlowField::GetMemoryUsage() const
+{
+	// Sized for the snapshot up front, so this is right before the solve finishes too
+	size_t numCells = (size_t) m_snapshot->GetNumChunks() * StaticWorldSettings::s_numTilesInChunk;
+	return sizeof(TargetFlowField) + numCells * (sizeof(float) + sizeof(Vec2));
+}
@@ -0,0 +1,77 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include "ChunkDirectory.h"
+#include "WorldCoords.h"
+#include "WorldSettings.h"
+#include "Engine/DataStructures/BitArray.h"
+#include "Engine/Math/FastGrid.h"
+#include "Engine/Math/Vec2.h"
+#include <cstdint>
+#include <vector>
+
+
+
+class FlowField;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+struct FlowFieldSnapshotChunk
+{
+	IntVec2 m_chunkCoords;
+	int m_index = 0;	// Into the per chunk arrays of target flow fields solved on this snapshot
+	FastGrid<uint8_t, StaticWorldSettings::s_worldChunkSizePowerOfTwo> m_costField;
+	BitArray<StaticWorldSettings::s_numTilesInChunk> m_solidCells;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Flow Field Snapshot
+//
+// Read only copy of the cost fields and solidity of the player flow field's chunks, so target flow fields can be solved
+// on worker threads while the main thread keeps editing tiles. Shared by every target field solved on it.
+//
+class FlowFieldSnapshot
+{
+public:
+
+	FlowFieldSnapshot(FlowField const& flowField, uint32_t version);
+
+	FlowFieldSnapshotChunk const* GetChunkAtGlobalTileCoords(IntVec2 const& globalTileCoords, int& out_tileIndex) const;
+	int GetNumChunks() const;
+	size_t GetMemoryUsage() const;
+
+public:
+
+	uint32_t m_version = 0;
+	std::vector<FlowFieldSnapshotChunk> m_chunks;		// Never resized after construction, the directory points into it
+	ChunkDirectory<FlowFieldSnapshotChunk> m_chunkDirectory;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Target Flow Field
+//
+// Distance field and gradient towards one goal, solved over a snapshot. Unlike the player flow field, it is solved all
+// at once and then only read, so it lives in flat arrays indexed by snapshot chunk instead of in FlowFieldChunks.
+//
+class TargetFlowField
+{
+public:
+
+	TargetFlowField(FlowFieldSnapshot const* snapshot, WorldCoords const& goal);
+
+	void Solve(); // Only touches this and the read only snapshot, safe on a worker thread
+
+	Vec2 GetFlowAtWorldCoords(WorldCoords const& worldCoords) const;
+	size_t GetMemoryUsage() const;
+
+public:
+
+	FlowFieldSnapshot const* m_snapshot = nullptr;
+	WorldCoords m_goal;
+	std::vector<float> m_distanceField;		// s_numTilesInChunk per snapshot chunk
+	std::vector<Vec2> m_gradient;			// s_numTilesInChunk per snapshot chunk
+};
@@ -3,12 +3,14 @@
 #include "WorldSettings.h"
 #include "Engine/Renderer/Renderer.h"
 #include "Engine/Core/ErrorUtils.h"
+#include "Engine/Core/BinaryUtils.h"
 
 
 
 //----------------------------------------------------------------------------------------------------------------------
 static const char* s_tileDefsFilePath = "Data/Definitions/TileDefs.xml";
 std::vector<TileDef> TileDef::s_tileDefs;
+uint64_t TileDef::s_tableHash = BinaryUtils::HASH_BYTES_SEED;
 
 
 
@@ -56,6 +58,21 @@ void TileDef::LoadFromXML()
 			tileDefElement = tileDefElement->NextSiblingElement();
 		}
 	}
+
+	s_tableHash = BinaryUtils::HASH_BYTES_SEED;
+	for (TileDef const& def : s_tileDefs)
+	{
+		std::string const& name = def.m_name.ToString();
+		s_tableHash = BinaryUtils::HashBytes(name.data(), name.size(), s_tableHash);
+		s_tableHash = BinaryUtils::HashBytes(&def.m_spriteIndex, sizeof(def.m_spriteIndex), s_tableHash);
+		s_tableHash = BinaryUtils::HashBytes(&def.m_tags, sizeof(def.m_tags), s_tableHash);
+		s_tableHash = BinaryUtils::HashBytes(&def.m_tint.r, sizeof(def.m_tint.r), s_tableHash);
+		s_tableHash = BinaryUtils::HashBytes(&def.m_tint.g, sizeof(def.m_tint.g), s_tableHash);
+		s_tableHash = BinaryUtils::HashBytes(&def.m_tint.b, sizeof(def.m_tint.b), s_tableHash);
+		s_tableHash = BinaryUtils::HashBytes(&def.m_tint.a, sizeof(def.m_tint.a), s_tableHash);
+		s_tableHash = BinaryUtils::HashBytes(&def.m_cost, sizeof(def.m_cost), s_tableHash);
+		s_tableHash = BinaryUtils::HashBytes(&def.m_indoorLight, sizeof(def.m_indoorLight), s_tableHash);
+	}
 }
 
 
@@ -133,3 +150,11 @@ Tile TileDef::GetDefaultTile(TileID id)
 	ASSERT_OR_DIE(def != nullptr, "TileDef::GetDefaultTile - failed to get tile def.");
 	return GetDefaultTile(def->m_name);
 }
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+uint64_t TileDef::GetTableHash()
+{
+	return s_tableHash;
+}
@@ -23,6 +23,7 @@ public:
 	static TileID GetTileDefID(Name name);
 	static Tile GetDefaultTile(Name name);
 	static Tile GetDefaultTile(TileID id);
+	static uint64_t GetTableHash();
 
 	inline bool IsVisible() const { return m_tags & static_cast<uint8_t>(TileTag::Visible); }
 	inline bool IsSolid()   const { return m_tags & static_cast<uint8_t>(TileTag::Solid); }
@@ -33,6 +34,7 @@ public:
 private:
 
 	static std::vector<TileDef> s_tileDefs;
+	static uint64_t s_tableHash; // Recomputed every LoadFromXML, for invalidating data that stores tile ids
 
 public:
 
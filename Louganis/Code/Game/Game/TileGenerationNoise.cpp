@@ -0,0 +1,79 @@
+// Bradley Christensen - 2022-2025
+#include "TileGenerationNoise.h"
+#include "WorldSettings.h"
+#include "Engine/Math/MathUtils.h"
+#include "Engine/Math/Noise.h"
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void TileGenerationNoise::Generate(IntVec2 const& minsGlobalTileCoords, IntVec2 const& dims, WorldSettings const& worldSettings)
+{
+	m_mins = minsGlobalTileCoords;
+	m_dims = dims;
+
+	unsigned int seed = static_cast<unsigned int>(worldSettings.m_worldSeed);
+	int numTiles = dims.x * dims.y;
+
+	m_mountainness.resize(numTiles);
+	m_terrainHeightOffset.resize(numTiles);
+	m_humidity.resize(numTiles);
+	m_oceanness.resize(numTiles);
+	m_riverness.resize(numTiles);
+	m_islandness.resize(numTiles);
+	m_temperature.resize(numTiles);
+
+	Noise::GetPerlinNoise2DGrid(m_mountainness.data(), m_mins.x, m_mins.y, dims.x, dims.y, worldSettings.m_mountainnessScale, worldSettings.m_mountainnessDetailLevel, 0.5f, 2.f, true, seed);
+	Noise::GetPerlinNoise2DGrid_01(m_terrainHeightOffset.data(), m_mins.x, m_mins.y, dims.x, dims.y, worldSettings.m_terrainHeightOffsetScale, worldSettings.m_terrainHeightDetailLevel, 0.5f, 2.f, true, seed + 1);
+	Noise::GetPerlinNoise2DGrid_01(m_humidity.data(), m_mins.x, m_mins.y, dims.x, dims.y, worldSettings.m_humidityScale, worldSettings.m_humidityDetailLevel, 0.5f, 2.f, true, seed + 2);
+	Noise::GetPerlinNoise2DGrid_01(m_oceanness.data(), m_mins.x, m_mins.y, dims.x, dims.y, worldSettings.m_oceannessScale, worldSettings.m_oceannessDetailLevel, 0.5f, 2.f, true, seed + 3);
+	Noise::GetPerlinNoise2DGrid(m_riverness.data(), m_mins.x, m_mins.y, dims.x, dims.y, worldSettings.m_rivernessScale, worldSettings.m_rivernessDetailLevel, 0.5f, 2.f, true, seed + 4);
+	Noise::GetPerlinNoise2DGrid_01(m_islandness.data(), m_mins.x, m_mins.y, dims.x, dims.y, worldSettings.m_islandnessScale, worldSettings.m_islandnessDetailLevel, 0.5f, 2.f, true, seed + 5);
+	Noise::GetPerlinNoise2DGrid_01(m_temperature.data(), m_mins.x, m_mins.y, dims.x, dims.y, worldSettings.m_temperatureScale, worldSettings.m_temperatureDetailLevel, 0.5f, 2.f, true, seed + 6);
+
+	// Apron fields
+	IntVec2 apronMins = m_mins - IntVec2(1, 1);
+	IntVec2 apronDims = dims + IntVec2(2, 2);
+	int numApronTiles = apronDims.x * apronDims.y;
+
+	m_forestness.resize(numApronTiles);
+	Noise::GetPerlinNoise2DGrid_01(m_forestness.data(), apronMins.x, apronMins.y, apronDims.x, apronDims.y, worldSettings.m_forestnessScale, worldSettings.m_forestnessDetailLevel, 0.5f, 2.f, true, seed + 7);
+	for (float& forestness : m_forestness)
+	{
+		forestness = MathUtils::SmoothStep3(forestness);
+	}
+
+	// Each tile's treeness uses its forestness as the octave persistence
+	float treeScale = worldSettings.m_treeBaseScale;
+	m_treeness.resize(numApronTiles);
+	Noise::GetPerlinNoise2DGrid_01(m_treeness.data(), apronMins.x, apronMins.y, apronDims.x, apronDims.y, treeScale, 5, 0.5f, 2.f, true, seed + 8, m_forestness.data());
+
+	float desertTreeScale = treeScale / worldSettings.m_desertTreeMultiplier; // make scale larger when multiplier is < 1
+	if (desertTreeScale == treeScale)
+	{
+		m_desertTreeness = m_treeness;
+	}
+	else
+	{
+		m_desertTreeness.resize(numApronTiles);
+		Noise::GetPerlinNoise2DGrid_01(m_desertTreeness.data(), apronMins.x, apronMins.y, apronDims.x, apronDims.y, desertTreeScale, 5, 0.5f, 2.f, true, seed + 8, m_forestness.data());
+	}
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int TileGenerationNoise::GetIndex(IntVec2 const& globalTileCoords) const
+{
+	IntVec2 relativeCoords = globalTileCoords - m_mins;
+	return relativeCoords.y * m_dims.x + relativeCoords.x;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+int TileGenerationNoise::GetApronIndex(IntVec2 const& globalTileCoords) const
+{
+	IntVec2 relativeCoords = globalTileCoords - m_mins + IntVec2(1, 1);
+	return relativeCoords.y * (m_dims.x + 2) + relativeCoords.x;
+}
@@ -0,0 +1,46 @@
+// Bradley Christensen - 2022-2025
+#pragma once
+#include "Engine/Math/IntVec2.h"
+#include <vector>
+
+
+
+struct WorldSettings;
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Tile Generation Noise
+//
+// All of the noise that tile generation samples, for a rectangle of tiles. Each field is batch generated for the whole
+// rectangle, instead of being sampled tile by tile. Forestness and treeness also cover a 1 tile apron around the
+// rectangle, because each tile compares its treeness against its 8 neighbors.
+//
+struct TileGenerationNoise
+{
+public:
+
+	void Generate(IntVec2 const& minsGlobalTileCoords, IntVec2 const& dims, WorldSettings const& worldSettings);
+
+	int GetIndex(IntVec2 const& globalTileCoords) const;		// Into the rect fields
+	int GetApronIndex(IntVec2 const& globalTileCoords) const;	// Into the apron fields, may be up to 1 tile outside the rect
+
+public:
+
+	IntVec2 m_mins;
+	IntVec2 m_dims;
+
+	// Rect fields, raw noise before any shaping
+	std::vector<float> m_mountainness;
+	std::vector<float> m_terrainHeightOffset;
+	std::vector<float> m_humidity;
+	std::vector<float> m_oceanness;
+	std::vector<float> m_riverness;
+	std::vector<float> m_islandness;
+	std::vector<float> m_temperature;
+
+	// Apron fields
+	std::vector<float> m_forestness;		// Smooth stepped
+	std::vector<float> m_treeness;			// At the base tree scale
+	std::vector<float> m_desertTreeness;	// At the desert tree scale
+};
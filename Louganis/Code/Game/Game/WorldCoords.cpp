@@ -16,6 +16,16 @@ WorldCoords::WorldCoords(IntVec2 const& chunkCoords, IntVec2 const& localTileCoo
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+WorldCoords WorldCoords::FromGlobalTileCoords(IntVec2 const& globalTileCoords)
+{
+	IntVec2 chunkCoords = IntVec2(globalTileCoords.x >> StaticWorldSettings::s_worldChunkSizePowerOfTwo, globalTileCoords.y >> StaticWorldSettings::s_worldChunkSizePowerOfTwo);
+	IntVec2 localTileCoords = IntVec2(globalTileCoords.x & StaticWorldSettings::s_numTilesInRowMinusOne, globalTileCoords.y & StaticWorldSettings::s_numTilesInRowMinusOne);
+	return WorldCoords(chunkCoords, localTileCoords);
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 IntVec2 WorldCoords::GetGlobalTileCoords() const
 {
@@ -15,6 +15,8 @@ public:
 	WorldCoords() = default;
 	WorldCoords(IntVec2 const& chunkCoords, IntVec2 const& localTileCoords);
 
+	static WorldCoords FromGlobalTileCoords(IntVec2 const& globalTileCoords);
+
 	IntVec2 GetGlobalTileCoords() const;
 
 	bool IsValid() const;
@@ -8,7 +8,11 @@
 #include "Engine/Math/MathUtils.h"
 #include "Engine/Math/GeometryUtils.h"
 #include "Engine/Performance/ScopedTimer.h"
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <tuple>
+#include <vector>
 
 
 
@@ -129,7 +133,203 @@ WorldRaycastResult Raycast(SCWorld const& world, WorldRaycast const& raycast)
 
 
 //----------------------------------------------------------------------------------------------------------------------
-WorldDiscCastResult DiscCast(SCWorld const& world, WorldDiscCast const& discCast)
+// Earliest thing a disc sweep has hit so far
+//
+struct DiscSweepHit
+{
+    bool m_isHit = false;
+    float m_t = 1.f;
+    Vec2 m_hitLocation;
+};
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void GetActiveChunksInRange(SCWorld const& world, IntVec2 const& minChunkCoords, IntVec2 const& maxChunkCoords, std::vector<Chunk const*>& out_chunks)
+{
+    out_chunks.clear();
+    for (int y = minChunkCoords.y; y <= maxChunkCoords.y; ++y)
+    {
+        for (int x = minChunkCoords.x; x <= maxChunkCoords.x; ++x)
+        {
+            if (Chunk const* chunk = world.GetActiveChunk(x, y))
+            {
+                out_chunks.push_back(chunk);
+            }
+        }
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+void GetNearestPointOnSolidEdges(ChunkSolidEdges const& edges, Vec2 const& point, float& io_nearestDistSquared, Vec2& io_nearestPoint)
+{
+    float const* horizontalY = edges.m_horizontalY.data();
+    float const* horizontalMinX = edges.m_horizontalMinX.data();
+    float const* horizontalMaxX = edges.m_horizontalMaxX.data();
+    int numHorizontalEdges = edges.GetNumHorizontalEdges();
+    for (int i = 0; i < numHorizontalEdges; ++i)
+    {
+        float nearestX = MathUtils::Clamp(point.x, horizontalMinX[i], horizontalMaxX[i]);
+        float deltaX = point.x - nearestX;
+        float deltaY = point.y - horizontalY[i];
+        float distSquared = deltaX * deltaX + deltaY * deltaY;
+        if (distSquared < io_nearestDistSquared)
+        {
+            io_nearestDistSquared = distSquared;
+            io_nearestPoint = Vec2(nearestX, horizontalY[i]);
+        }
+    }
+
+    float const* verticalX = edges.m_verticalX.data();
+    float const* verticalMinY = edges.m_verticalMinY.data();
+    float const* verticalMaxY = edges.m_verticalMaxY.data();
+    int numVerticalEdges = edges.GetNumVerticalEdges();
+    for (int i = 0; i < numVerticalEdges; ++i)
+    {
+        float nearestY = MathUtils::Clamp(point.y, verticalMinY[i], verticalMaxY[i]);
+        float deltaX = point.x - verticalX[i];
+        float deltaY = point.y - nearestY;
+        float distSquared = deltaX * deltaX + deltaY * deltaY;
+        if (distSquared < io_nearestDistSquared)
+        {
+            io_nearestDistSquared = distSquared;
+            io_nearestPoint = Vec2(verticalX[i], nearestY);
+        }
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Index of the smallest value, or -1 if none are below FLT_MAX
+//
+int GetIndexOfMinTime(float const* times, int count)
+{
+    int minIndex = -1;
+    float minTime = FLT_MAX;
+    for (int i = 0; i < count; ++i)
+    {
+        if (times[i] < minTime)
+        {
+            minTime = times[i];
+            minIndex = i;
+        }
+    }
+    return minIndex;
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Only edges facing against the velocity can stop the disc. It touches an edge when its center is radius out from it
+// along the normal, and the contact point is within the edge.
+//
+// Each kind of edge is done in two passes: the first writes every edge's t (FLT_MAX if it can't be hit) into scratch
+// with no branches in the loop body, the second picks the smallest. Keeping the passes apart leaves the first one as a
+// straight run of arithmetic and selects over the arrays that the compiler can vectorize.
+//
+void SweepDiscVsSolidEdges(ChunkSolidEdges const& edges, Vec2 const& start, Vec2 const& velocity, float radius, std::vector<float>& scratch_times, DiscSweepHit& io_hit)
+{
+    int maxNumTimes = std::max(std::max(edges.GetNumHorizontalEdges(), edges.GetNumVerticalEdges()), edges.GetNumCorners());
+    if ((int) scratch_times.size() < maxNumTimes)
+    {
+        scratch_times.resize(maxNumTimes);
+    }
+    float* times = scratch_times.data();
+
+    // Copied out, otherwise the stores to times could alias them and they'd be reloaded every iteration
+    float startX = start.x;
+    float startY = start.y;
+    float velocityX = velocity.x;
+    float velocityY = velocity.y;
+
+    if (velocityY != 0.f)
+    {
+        float oneOverVelocityY = 1.f / velocityY;
+        float const* horizontalY = edges.m_horizontalY.data();
+        float const* horizontalMinX = edges.m_horizontalMinX.data();
+        float const* horizontalMaxX = edges.m_horizontalMaxX.data();
+        float const* horizontalNormalY = edges.m_horizontalNormalY.data();
+        int numHorizontalEdges = edges.GetNumHorizontalEdges();
+        for (int i = 0; i < numHorizontalEdges; ++i)
+        {
+            float t = (horizontalY[i] + horizontalNormalY[i] * radius - startY) * oneOverVelocityY;
+            float contactX = startX + velocityX * t;
+            bool isHit = (velocityY * horizontalNormalY[i] < 0.f) & (contactX >= horizontalMinX[i]) & (contactX <= horizontalMaxX[i]) & (t >= 0.f);
+            times[i] = isHit ? t : FLT_MAX;
+        }
+
+        int hitIndex = GetIndexOfMinTime(times, numHorizontalEdges);
+        if (hitIndex != -1 && times[hitIndex] <= io_hit.m_t)
+        {
+            io_hit.m_isHit = true;
+            io_hit.m_t = times[hitIndex];
+            io_hit.m_hitLocation = Vec2(startX + velocityX * io_hit.m_t, horizontalY[hitIndex]);
+        }
+    }
+
+    if (velocityX != 0.f)
+    {
+        float oneOverVelocityX = 1.f / velocityX;
+        float const* verticalX = edges.m_verticalX.data();
+        float const* verticalMinY = edges.m_verticalMinY.data();
+        float const* verticalMaxY = edges.m_verticalMaxY.data();
+        float const* verticalNormalX = edges.m_verticalNormalX.data();
+        int numVerticalEdges = edges.GetNumVerticalEdges();
+        for (int i = 0; i < numVerticalEdges; ++i)
+        {
+            float t = (verticalX[i] + verticalNormalX[i] * radius - startX) * oneOverVelocityX;
+            float contactY = startY + velocityY * t;
+            bool isHit = (velocityX * verticalNormalX[i] < 0.f) & (contactY >= verticalMinY[i]) & (contactY <= verticalMaxY[i]) & (t >= 0.f);
+            times[i] = isHit ? t : FLT_MAX;
+        }
+
+        int hitIndex = GetIndexOfMinTime(times, numVerticalEdges);
+        if (hitIndex != -1 && times[hitIndex] <= io_hit.m_t)
+        {
+            io_hit.m_isHit = true;
+            io_hit.m_t = times[hitIndex];
+            io_hit.m_hitLocation = Vec2(verticalX[hitIndex], startY + velocityY * io_hit.m_t);
+        }
+    }
+
+    // Disc vs point is the first root of |start + velocity * t - corner| = radius, same as GeometryUtils::SweepDiscVsPoint.
+    // A negative discriminant is a miss, it is clamped before the sqrt so the loop doesn't need to branch around it.
+    float a = velocityX * velocityX + velocityY * velocityY;
+    float oneOverTwoA = 0.5f / a;
+    float radiusSquared = radius * radius;
+    float const* cornerX = edges.m_cornerX.data();
+    float const* cornerY = edges.m_cornerY.data();
+    int numCorners = edges.GetNumCorners();
+    for (int i = 0; i < numCorners; ++i)
+    {
+        float deltaX = startX - cornerX[i];
+        float deltaY = startY - cornerY[i];
+        float b = 2.f * (deltaX * velocityX + deltaY * velocityY);
+        float c = deltaX * deltaX + deltaY * deltaY - radiusSquared;
+        float discriminant = b * b - 4.f * a * c;
+        float t = (-b - sqrtf(std::max(discriminant, 0.f))) * oneOverTwoA;
+        bool isHit = (discriminant >= 0.f) & (t >= 0.f);
+        times[i] = isHit ? t : FLT_MAX;
+    }
+
+    int hitIndex = GetIndexOfMinTime(times, numCorners);
+    if (hitIndex != -1 && times[hitIndex] <= io_hit.m_t)
+    {
+        io_hit.m_isHit = true;
+        io_hit.m_t = times[hitIndex];
+        io_hit.m_hitLocation = Vec2(cornerX[hitIndex], cornerY[hitIndex]);
+    }
+}
+
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// chunks must be every active chunk the disc cast's capsule overlaps
+//
+WorldDiscCastResult DiscCastVsChunks(SCWorld const& world, std::vector<Chunk const*> const& chunks, WorldDiscCast const& discCast, std::vector<float>& scratch_times)
 {
     WorldDiscCastResult result;
     result.m_discCast = discCast;
@@ -142,100 +342,124 @@ WorldDiscCastResult DiscCast(SCWorld const& world, WorldDiscCast const& discCast
         return result;
     }
 
-    result.m_hitLocation = discCast.m_start + discCast.m_direction * discCast.m_maxDistance;
+    result.m_hitLocation = discCastEndPoint;
 
-    // Check for initial hit
+    // Check for initial hit, the nearest solid point within the radius (which is the start itself if it's inside a tile)
+    IntVec2 startChunkCoords = world.GetChunkCoordsAtLocation(discCast.m_start);
     float nearestDistSquared = FLT_MAX;
-    world.ForEachSolidWorldCoordsOverlappingCapsule(discCast.m_start, discCast.m_start, discCast.m_discRadius, [&world, &discCast, &result, &nearestDistSquared](WorldCoords const& coords)
+    Vec2 nearestPoint;
+    for (Chunk const* chunk : chunks)
     {
-        AABB2 tileBounds = world.GetTileBounds(coords);
-        Vec2 nearestPoint = tileBounds.GetNearestPoint(discCast.m_start);
-    
-        float distSquared = nearestPoint.GetDistanceSquaredTo(discCast.m_start);
-        if (distSquared < nearestDistSquared)
+        if (chunk->m_chunkCoords == startChunkCoords && chunk->IsTileSolid(world.GetLocalTileCoordsAtLocation(discCast.m_start, startChunkCoords)))
         {
-            nearestDistSquared = distSquared;
-    
-            result.m_blockingHit = true;
-            result.m_immediateHit = true;
-            result.m_newDiscCenter = discCast.m_start;
-            result.m_hitLocation = nearestPoint;
-            result.m_hitNormal = (result.m_newDiscCenter - result.m_hitLocation).GetNormalized();
-            result.m_t = 0.f;
-            result.m_distance = 0.f;
+            nearestDistSquared = 0.f;
+            nearestPoint = discCast.m_start;
+            break;
         }
-        return true;
-    });
+        GetNearestPointOnSolidEdges(chunk->m_solidEdges, discCast.m_start, nearestDistSquared, nearestPoint);
+    }
 
-    // Sweep against all the tiles in the path
-    world.ForEachSolidWorldCoordsOverlappingCapsule(discCast.m_start, discCastEndPoint, discCast.m_discRadius, [&world, &discCast, &result, &discCastEndPoint](WorldCoords const& coords)
+    if (nearestDistSquared <= discCast.m_discRadius * discCast.m_discRadius)
     {
-        // Line vs. expanded tile bounds for sweep test
-        AABB2 tileBounds = world.GetTileBounds(coords);
-        AABB2 expandedTileBounds = tileBounds.GetExpandedBy(discCast.m_discRadius);
+        result.m_blockingHit = true;
+        result.m_immediateHit = true;
+        result.m_newDiscCenter = discCast.m_start;
+        result.m_hitLocation = nearestPoint;
+        result.m_hitNormal = (result.m_newDiscCenter - result.m_hitLocation).GetNormalized();
+        result.m_t = 0.f;
+        result.m_distance = 0.f;
+        return result;
+    }
 
-        float tOfFirstIntersection;
-        if (GeometryUtils::GetFirstLineAABBIntersection(discCast.m_start, discCastEndPoint, expandedTileBounds, tOfFirstIntersection))
-        {
-            Vec2 newDiscCenter = discCast.m_start + discCast.m_direction * discCast.m_maxDistance * tOfFirstIntersection;
-            Vec2 nearestPoint = tileBounds.GetNearestPoint(newDiscCenter);
-            float distSquared = nearestPoint.GetDistanceSquaredTo(newDiscCenter);
+    if (discCast.m_maxDistance <= 0.f)
+    {
+        return result;
+    }
+
+    // Sweep against the edges and corners in the path
+    Vec2 velocity = discCastEndPoint - discCast.m_start;
+    DiscSweepHit hit;
+    for (Chunk const* chunk : chunks)
+    {
+        SweepDiscVsSolidEdges(chunk->m_solidEdges, discCast.m_start, velocity, discCast.m_discRadius, scratch_times, hit);
+    }
+
+    if (hit.m_isHit)
+    {
+        result.m_blockingHit = true;
+        result.m_t = hit.m_t;
+        result.m_distance = discCast.m_maxDistance * result.m_t;
+        result.m_newDiscCenter = discCast.m_start + discCast.m_direction * result.m_distance;
+        result.m_hitLocation = hit.m_hitLocation;
+        result.m_hitNormal = (result.m_newDiscCenter - result.m_hitLocation).GetNormalized();
+    }
+
+    return result;
+}
 
-            float radiusSquared = discCast.m_discRadius * discCast.m_discRadius;
-            if (distSquared > radiusSquared)
-            {
-                // Do Corner hit detection
-                Vec2 corners[4] = { tileBounds.mins, tileBounds.maxs, tileBounds.GetBottomRight(), tileBounds.GetTopLeft() };
-
-                float smallestCornerT = FLT_MAX;
-                int cornerHitIndex = -1;
-                for (int cornerIndex = 0; cornerIndex < 4; ++cornerIndex)
-                {
-                    Vec2 const& corner = corners[cornerIndex];
-                    float cornerT;
-                    if (GeometryUtils::SweepDiscVsPoint(discCast.m_start, discCastEndPoint, discCast.m_discRadius, corner, cornerT))
-                    {
-                        if (cornerT < smallestCornerT)
-                        {
-                            cornerHitIndex = cornerIndex;
-                            smallestCornerT = cornerT;
-                        }
-                    }
-                }
-
-                if (smallestCornerT >= 0.f 
-                    && smallestCornerT <= 1.f
-                    && smallestCornerT <= result.m_t)
-                {
-                    // Corner hit
-                    result.m_blockingHit = true;
-                    result.m_t = smallestCornerT;
-                    result.m_distance = discCast.m_maxDistance * result.m_t;
-                    result.m_newDiscCenter = discCast.m_start + discCast.m_direction * result.m_distance;
-                    result.m_hitLocation = corners[cornerHitIndex];
-                    result.m_hitNormal = (result.m_newDiscCenter - result.m_hitLocation).GetNormalized();
-                }
 
-            }
-            else if (tOfFirstIntersection <= result.m_t)
-            {
-                // Side wall hit
-                result.m_blockingHit = true;
-                result.m_t = tOfFirstIntersection;
-                result.m_distance = discCast.m_maxDistance * result.m_t;
-                result.m_newDiscCenter = newDiscCenter;
-                result.m_hitLocation = tileBounds.GetNearestPoint(result.m_newDiscCenter);
-                result.m_hitNormal = (result.m_newDiscCenter - result.m_hitLocation).GetNormalized();
-            }
-        }
-        return true;
-    });
 
+//----------------------------------------------------------------------------------------------------------------------
+WorldDiscCastResult DiscCast(SCWorld const& world, WorldDiscCast const& discCast)
+{
+    WorldDiscCastResult result;
+    DiscCastBatch(world, &discCast, &result, 1);
     return result;
 }
 
 
 
+//----------------------------------------------------------------------------------------------------------------------
+// Casts are run sorted by the chunks their capsules overlap, so every cast over the same chunks (most of them, since
+// casts are short) shares one chunk lookup no matter what order the caller gathered them in. Results are still written
+// at each cast's own index.
+//
+void DiscCastBatch(SCWorld const& world, WorldDiscCast const* discCasts, WorldDiscCastResult* out_results, int count)
+{
+    struct ChunkRange
+    {
+        IntVec2 m_min;
+        IntVec2 m_max;
+        int m_castIndex = 0;
+    };
+
+    std::vector<ChunkRange> castOrder;
+    castOrder.resize(count);
+    for (int i = 0; i < count; ++i)
+    {
+        WorldDiscCast const& discCast = discCasts[i];
+        Vec2 discCastEndPoint = discCast.m_start + discCast.m_direction * discCast.m_maxDistance;
+        AABB2 capsuleBounds = GeometryUtils::GetCapsuleBounds(discCast.m_start, discCastEndPoint, discCast.m_discRadius);
+        castOrder[i].m_min = world.GetChunkCoordsAtLocation(capsuleBounds.mins);
+        castOrder[i].m_max = world.GetChunkCoordsAtLocation(capsuleBounds.maxs);
+        castOrder[i].m_castIndex = i;
+    }
+
+    if (count > 1)
+    {
+        std::sort(castOrder.begin(), castOrder.end(), [](ChunkRange const& lhs, ChunkRange const& rhs)
+        {
+            return std::tie(lhs.m_min.y, lhs.m_min.x, lhs.m_max.y, lhs.m_max.x) < std::tie(rhs.m_min.y, rhs.m_min.x, rhs.m_max.y, rhs.m_max.x);
+        });
+    }
+
+    std::vector<Chunk const*> chunks;
+    std::vector<float> scratchTimes;
+    ChunkRange const* lastRange = nullptr;
+    for (ChunkRange const& range : castOrder)
+    {
+        if (!lastRange || range.m_min != lastRange->m_min || range.m_max != lastRange->m_max)
+        {
+            GetActiveChunksInRange(world, range.m_min, range.m_max, chunks);
+            lastRange = &range;
+        }
+
+        out_results[range.m_castIndex] = DiscCastVsChunks(world, chunks, discCasts[range.m_castIndex], scratchTimes);
+    }
+}
+
+
+
 //----------------------------------------------------------------------------------------------------------------------
 void DebugDrawRaycast(WorldRaycastResult const& result)
 {
@@ -64,6 +64,7 @@ struct WorldDiscCastResult
 //----------------------------------------------------------------------------------------------------------------------
 WorldRaycastResult Raycast(SCWorld const& world, WorldRaycast const& raycast);
 WorldDiscCastResult DiscCast(SCWorld const& world, WorldDiscCast const& discCast);
+void DiscCastBatch(SCWorld const& world, WorldDiscCast const* discCasts, WorldDiscCastResult* out_results, int count); // Same as DiscCast on each, sharing chunk lookups
 void DebugDrawRaycast(WorldRaycastResult const& result);
 void AddVertsForRaycast(VertexBuffer& vbo, WorldRaycastResult const& result, float scaleMultiplier = 1.f);
 void AddVertsForDiscCast(VertexBuffer& vbo, WorldDiscCastResult const& result, float scaleMultiplier = 1.f);
\ No newline at end of file
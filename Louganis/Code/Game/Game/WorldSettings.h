@@ -20,17 +20,32 @@ namespace StaticWorldSettings
     constexpr float s_collisionHashRadius                   = 35.f;
     constexpr float s_flowFieldGenerationRadius             = 35.f;
     constexpr int   s_maxNumChunksToLoadPerFrame            = 5;
+    constexpr int   s_maxNumChunkGenerationJobs             = 16;
 #else
     constexpr float s_defaultChunkLoadRadius                = 500.f;
     constexpr float s_defaultChunkUnloadRadius              = 550.f;
     constexpr float s_collisionHashRadius                   = 50.f;
     constexpr float s_flowFieldGenerationRadius             = 50.f;
     constexpr int   s_maxNumChunksToLoadPerFrame            = 10;
+    constexpr int   s_maxNumChunkGenerationJobs             = 64;
 #endif // _DEBUG
 
     constexpr float s_flowFieldGenerationRadiusSquared      = s_flowFieldGenerationRadius * s_flowFieldGenerationRadius;
     constexpr float s_collisionHashRadiusSquared            = s_collisionHashRadius * s_collisionHashRadius;
 
+    constexpr int   s_chunkGenerationJobPriority            = 100;      // Plus distance in chunks, so system jobs and closer chunks go first
+
+    constexpr int   s_flowFieldGoalWindowRadius             = 16;       // In tiles, solved around the goal while it's near the goal the chunks were solved for
+    constexpr int   s_flowFieldMaxGoalDrift                 = 8;        // In tiles, moving the goal further than this from the solved goal regenerates the whole field
+    constexpr int   s_flowFieldMaxRepairedTiles             = 2048;     // Repairs that would touch more tiles than this regenerate the whole field instead
+    static_assert(s_flowFieldMaxGoalDrift < s_flowFieldGoalWindowRadius, "The goal window must contain the solved goal, or flow outside it won't lead in");
+
+    constexpr int   s_flowFieldSolveJobPriority             = 50;       // Ahead of chunk generation, AI are waiting on these
+    constexpr int   s_maxNumFlowFieldSolveJobs              = 4;
+    constexpr int   s_maxNumCachedFlowFields                = 32;
+    constexpr size_t s_flowFieldCacheMemoryBudget           = 16 * 1024 * 1024; // In bytes, least recently used target flow fields are evicted past this
+    constexpr uint32_t s_flowFieldCacheRefreshFrames        = 10;       // Min frames between re-solving a target flow field after the world changes under it
+
 	constexpr uint8_t s_maxOutdoorLighting                  = 15;       // 4 bits (0-15)
 	constexpr uint8_t s_maxIndoorLighting                   = 15;       // 4 bits (0-15)
 
@@ -85,6 +100,7 @@ struct WorldSettings
 
     //----------------------------------------------------------------------------------------------------------------------
     // Generation Settings
+    // Every field through m_desertTreeMultiplier is hashed into the chunk disk cache's region files, keep CalculateContentHash in sync
 
     float m_terrainHeightOffsetScale            = 100.f;
 